@@ -63,6 +63,8 @@ namespace Internal {
    class TROOTAllocator;
 
    TROOT *GetROOT2();
+   void InitDeferredInterpreter();
+   void SetInterpreterAllocLock(void (*lock)(), void (*unlock)());
 
    // Manage parallel branch processing
    void EnableParBranchProcessing();
@@ -95,12 +97,28 @@ namespace ROOT {
    void DisableImplicitMT();
    Bool_t IsImplicitMTEnabled();
    UInt_t GetImplicitMTPoolSize();
+
+   /// Cost of the creation of the interpreter, see GetInterpreterInitInfo().
+   struct TInterpreterInitInfo {
+      Bool_t   fCreated = kFALSE;  ///< Whether the interpreter has been created
+      Bool_t   fLazy = kFALSE;     ///< Whether it is created on first use
+      Double_t fRealTime = 0;      ///< Time spent creating it, in seconds
+      Long_t   fMemResident = 0;   ///< Increase of the resident memory while creating it, in kB
+      Long_t   fMemVirtual = 0;    ///< Increase of the virtual memory while creating it, in kB
+   };
+   // Create the interpreter on its first use rather than at the first use of gROOT.
+   void EnableLazyInterpreter();
+   Bool_t IsLazyInterpreterEnabled();
+   TInterpreterInitInfo GetInterpreterInitInfo();
+   void EnableIndexedCleanup();
+   Bool_t IsIndexedCleanupEnabled();
 }
 
 class TROOT : public TDirectory {
 
 friend class TCling;
 friend TROOT *ROOT::Internal::GetROOT2();
+friend void ROOT::Internal::InitDeferredInterpreter();
 
 private:
    Int_t           fLineIsProcessing;     //To synchronize multi-threads
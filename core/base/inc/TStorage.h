@@ -43,6 +43,15 @@ public:
    static const UInt_t   kObjectAllocMemValue = 0x99999999;
                                                // magic number for ObjectAlloc
 
+public:
+   /// Usage of one size class of the object pool, see EnableObjectPool().
+   struct TObjectPoolStat {
+      size_t   fSize;      ///< Size of the blocks of the class
+      Long64_t fNAlloc;    ///< Number of blocks allocated
+      Long64_t fNFree;     ///< Number of blocks released
+      Long64_t fNBlocks;   ///< Number of blocks taken from the system
+   };
+
 public:
    virtual ~TStorage() { }
 
@@ -65,6 +74,7 @@ public:
    static void           ObjectDealloc(void *vp, size_t size);
 #endif
    static void           ObjectDealloc(void *vp, void *ptr);
+   static void          *ObjectPoolAlloc(size_t size);
 
    static void EnterStat(size_t size, void *p);
    static void RemoveStat(void *p);
@@ -74,6 +84,10 @@ public:
    static void SetReAllocHooks(ReAllocFun_t func1, ReAllocCFun_t func2);
    static void SetCustomNewDelete();
    static void EnableStatistics(int size= -1, int ix= -1);
+   static void EnableObjectPool(Bool_t enable = kTRUE);
+   static Bool_t IsObjectPoolEnabled();
+   static Int_t GetObjectPoolNClasses();
+   static TObjectPoolStat GetObjectPoolStat(Int_t sizeClass);
 
    static Bool_t HasCustomNewDelete();
 
@@ -113,6 +127,27 @@ R__INTENTIONALLY_UNINIT_BEGIN
 R__INTENTIONALLY_UNINIT_END
 }
 
+/// Allocate the objects of a TObject-derived class from the object pool of
+/// TStorage, independently of EnableObjectPool(). To be used in the class
+/// declaration, next to ClassDef, for classes whose objects are created and
+/// deleted at a high rate by many threads:
+/// ~~~ {.cpp}
+/// class TMyHit : public TObject {
+///    ...
+///    R__USE_OBJECT_POOL
+///    ClassDef(TMyHit, 1)
+/// };
+/// ~~~
+/// Objects larger than the largest size class of the pool are allocated by
+/// `::operator new`, as usual.
+#define R__USE_OBJECT_POOL                                                        \
+   public:                                                                        \
+   void *operator new(size_t sz) { return TStorage::ObjectPoolAlloc(sz); }       \
+   void *operator new[](size_t sz) { return TStorage::ObjectAllocArray(sz); }    \
+   void *operator new(size_t sz, void *vp) { return TStorage::ObjectAlloc(sz, vp); } \
+   void *operator new[](size_t sz, void *vp) { return TStorage::ObjectAlloc(sz, vp); } \
+   private:
+
 inline size_t TStorage::GetMaxBlockSize() { return fgMaxBlockSize; }
 
 inline void TStorage::SetMaxBlockSize(size_t size) { fgMaxBlockSize = size; }
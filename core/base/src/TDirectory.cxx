@@ -16,7 +16,9 @@
 #include "TClassTable.h"
 #include "TInterpreter.h"
 #include "THashList.h"
+#include "TConcurrentHashList.h"
 #include "TBrowser.h"
+#include "TObjString.h"
 #include "TROOT.h"
 #include "TError.h"
 #include "TClass.h"
@@ -40,6 +42,22 @@ Describe directory structure in memory.
 
 ClassImp(TDirectory);
 
+namespace {
+
+/// Named objects and strings hold no reference to other objects: the lists
+/// with indexed cleanup do not notify them of the deletions.
+Bool_t IsPassiveLeaf(const TObject *obj)
+{
+   TClass *cl = obj->IsA();
+   return cl == TNamed::Class() || cl == TObjString::Class();
+}
+
+struct TPassiveLeafInit {
+   TPassiveLeafInit() { TConcurrentHashList::AddPassiveFilter(IsPassiveLeaf); }
+} gPassiveLeafInit;
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Directory default constructor.
 
@@ -106,7 +124,7 @@ TDirectory::~TDirectory()
    }
 
    if (fList) {
-      if (!fList->IsUsingRWLock())
+      if (!fList->IsUsingRWLock() && !dynamic_cast<TConcurrentHashList*>(fList))
          Fatal("~TDirectory","In %s:%p the fList (%p) is not using the RWLock\n",
                GetName(),this,fList);
       fList->Delete("slow");
@@ -236,7 +254,14 @@ void TDirectory::Browse(TBrowser *b)
 
 void TDirectory::Build(TFile* /*motherFile*/, TDirectory* motherDir)
 {
-   fList       = new THashList(100,50);
+   if (ROOT::gCoreMutex) {
+      auto list = new TConcurrentHashList(100,50);
+      if (ROOT::IsIndexedCleanupEnabled())
+         list->SetIndexedCleanup();
+      fList    = list;
+   } else {
+      fList    = new THashList(100,50);
+   }
    fList->UseRWLock();
    fMother     = motherDir;
    SetBit(kCanDelete);
@@ -74,6 +74,7 @@ of a main program creating an interactive version is shown below:
 
 #include <string>
 #include <map>
+#include <chrono>
 #include <stdlib.h>
 #ifdef WIN32
 #include <io.h>
@@ -125,6 +126,7 @@ FARPROC dlsym(void *library, const char *function_name)
 #include "TClassTable.h"
 #include "TSystem.h"
 #include "THashList.h"
+#include "TConcurrentHashList.h"
 #include "TObjArray.h"
 #include "TEnv.h"
 #include "TError.h"
@@ -380,16 +382,70 @@ namespace Internal {
       return gROOTLocal;
    }
 
+   static std::atomic<Bool_t> gLazyInterpreter{kFALSE};     // Create the interpreter on first use.
+   static std::atomic<Bool_t> gIndexedCleanup{kFALSE};      // Index the holders of the objects of the directories.
+   static std::atomic<Bool_t> gInterpreterDeferred{kFALSE}; // The interpreter creation is pending.
+   static ROOT::TInterpreterInitInfo gInterpreterInitInfo;   // Cost of the interpreter creation.
+   static void (*gInterpreterAllocLock)() = nullptr;        // Installed in the interpreter once created.
+   static void (*gInterpreterAllocUnlock)() = nullptr;      // Installed in the interpreter once created.
+
    TROOT *GetROOT2() {
       static Bool_t initInterpreter = kFALSE;
       if (!initInterpreter) {
          initInterpreter = kTRUE;
-         gROOTLocal->InitInterpreter();
+         if (gLazyInterpreter || gEnv->GetValue("Root.LazyInterpreter", 0)) {
+            // Created by InitDeferredInterpreter(), at the first use of gInterpreter.
+            gLazyInterpreter = kTRUE;
+            gInterpreterDeferred = kTRUE;
+         } else {
+            gROOTLocal->InitInterpreter();
+         }
          // Load and init threads library
          gROOTLocal->InitThreads();
       }
       return gROOTLocal;
    }
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// Create the interpreter if its creation was deferred to its first use
+   /// (see ROOT::EnableLazyInterpreter()). Called by TInterpreter::Instance()
+   /// and by the TROOT functions that need the interpreter.
+   void InitDeferredInterpreter()
+   {
+      if (!gInterpreterDeferred)
+         return;
+      R__LOCKGUARD(gInterpreterMutex);
+      // The creation may use gInterpreter: do not recurse.
+      static Bool_t running = kFALSE;
+      if (!gInterpreterDeferred || running)
+         return;
+      running = kTRUE;
+      if (gDebug > 0) {
+         ::Info("TROOT::InitInterpreter", "creating the interpreter on first use, from:");
+         gSystem->StackTrace();
+      }
+      gROOTLocal->InitInterpreter();
+      if (gInterpreterAllocLock) {
+         gROOTLocal->fInterpreter->SetAlloclockfunc(gInterpreterAllocLock);
+         gROOTLocal->fInterpreter->SetAllocunlockfunc(gInterpreterAllocUnlock);
+      }
+      gInterpreterDeferred = kFALSE;
+   }
+
+   //////////////////////////////////////////////////////////////////////////////
+   /// Set the functions the interpreter calls around its allocations. If the
+   /// creation of the interpreter is deferred to its first use (see
+   /// ROOT::EnableLazyInterpreter()), they are installed when it is created.
+   void SetInterpreterAllocLock(void (*lock)(), void (*unlock)())
+   {
+      R__LOCKGUARD(gInterpreterMutex);
+      gInterpreterAllocLock = lock;
+      gInterpreterAllocUnlock = unlock;
+      if (gInterpreterDeferred)
+         return;
+      TInterpreter::Instance()->SetAlloclockfunc(lock);
+      TInterpreter::Instance()->SetAllocunlockfunc(unlock);
+   }
    typedef TROOT *(*GetROOTFun_t)();
 
    static GetROOTFun_t gGetROOT = &GetROOT1;
@@ -624,6 +680,60 @@ namespace Internal {
 #endif
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Create the interpreter only when it is first needed (gInterpreter is used,
+   /// e.g. to process a line, to jit code, to autoload the library of an unknown
+   /// class or to query the members of a class), instead of at the first use of
+   /// gROOT. Programs that only stream classes with compiled dictionaries may then
+   /// run without creating it. Must be called at the start of main(), before any
+   /// use of gROOT. Equivalent to setting the rootrc variable Root.LazyInterpreter.
+   void EnableLazyInterpreter()
+   {
+      Internal::gLazyInterpreter = kTRUE;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Returns true if the interpreter is created on first use.
+   Bool_t IsLazyInterpreterEnabled()
+   {
+      return Internal::gLazyInterpreter;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Index the objects held by the list of gROOT and by the lists of the
+   /// directories created afterwards, see TConcurrentHashList::SetIndexedCleanup():
+   /// deleting an object then removes it from the lists holding it without
+   /// searching the others, and only notifies the objects of these lists which
+   /// may hold references to it. Requires thread safety, see EnableThreadSafety().
+   void EnableIndexedCleanup()
+   {
+      if (!gCoreMutex) {
+         ::Warning("ROOT::EnableIndexedCleanup", "requires thread safety, call ROOT::EnableThreadSafety() first");
+         return;
+      }
+      Internal::gIndexedCleanup = kTRUE;
+      if (auto list = dynamic_cast<TConcurrentHashList *>(GetROOT()->GetList()))
+         list->SetIndexedCleanup();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Returns true if the lists of the directories use indexed cleanup.
+   Bool_t IsIndexedCleanupEnabled()
+   {
+      return Internal::gIndexedCleanup;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Returns whether, and at which cost in time and memory, the interpreter
+   /// has been created.
+   TInterpreterInitInfo GetInterpreterInitInfo()
+   {
+      R__LOCKGUARD(gInterpreterMutex);
+      TInterpreterInitInfo info = Internal::gInterpreterInitInfo;
+      info.fLazy = Internal::gLazyInterpreter;
+      return info;
+   }
+
 }
 
 TROOT *ROOT::Internal::gROOTLocal = ROOT::GetROOT();
@@ -780,9 +890,9 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
    fGlobalFunctions = 0;
    // fList was created in TDirectory::Build but with different sizing.
    delete fList;
-   fList        = new THashList(1000,3); fList->UseRWLock();
+   fList        = new TConcurrentHashList(1000,3);
    fClosedObjects = setNameLocked(new TList, "ClosedFiles");
-   fFiles       = setNameLocked(new TList, "Files");
+   fFiles       = setNameLocked(new TConcurrentHashList, "Files");
    fMappedFiles = setNameLocked(new TList, "MappedFiles");
    fSockets     = setNameLocked(new TList, "Sockets");
    fCanvases    = setNameLocked(new TList, "Canvases");
@@ -793,7 +903,7 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
    fBrowsers    = setNameLocked(new TList, "Browsers");
    fSpecials    = setNameLocked(new TList, "Specials");
    fBrowsables  = (TList*)setNameLocked(new TList, "Browsables");
-   fCleanups    = setNameLocked(new THashList, "Cleanups");
+   fCleanups    = setNameLocked(new TConcurrentHashList, "Cleanups");
    fMessageHandlers = setNameLocked(new TList, "MessageHandlers");
    fSecContexts = setNameLocked(new TList, "SecContexts");
    fProofs      = setNameLocked(new TList, "Proofs");
@@ -1252,7 +1362,8 @@ void TROOT::EndOfProcessCleanups()
    // they can still be 'reacheable' when ResetGlobals is run.
    CloseFiles();
 
-   if (gInterpreter) {
+   // An interpreter that was never needed is not created just to be reset.
+   if (!ROOT::Internal::gInterpreterDeferred && gInterpreter) {
       gInterpreter->ResetGlobals();
    }
 
@@ -1670,6 +1781,7 @@ TFunction *TROOT::GetGlobalFunction(const char *function, const char *params,
       R__LOCKGUARD(gROOTMutex);
       return (TFunction *)GetListOfGlobalFunctions(load)->FindObject(function);
    } else {
+      ROOT::Internal::InitDeferredInterpreter();
       if (!fInterpreter)
          Fatal("GetGlobalFunction", "fInterpreter not initialized");
 
@@ -1703,6 +1815,7 @@ TFunction *TROOT::GetGlobalFunctionWithPrototype(const char *function,
       R__LOCKGUARD(gROOTMutex);
       return (TFunction *)GetListOfGlobalFunctions(load)->FindObject(function);
    } else {
+      ROOT::Internal::InitDeferredInterpreter();
       if (!fInterpreter)
          Fatal("GetGlobalFunctionWithPrototype", "fInterpreter not initialized");
 
@@ -1787,6 +1900,8 @@ TCollection *TROOT::GetListOfGlobals(Bool_t load)
       TGlobalMappedFunction::GetEarlyRegisteredGlobals().Clear();
    }
 
+   ROOT::Internal::InitDeferredInterpreter();
+
    if (!fInterpreter)
       Fatal("GetListOfGlobals", "fInterpreter not initialized");
 
@@ -1811,6 +1926,8 @@ TCollection *TROOT::GetListOfGlobalFunctions(Bool_t load)
       fGlobalFunctions = new TListOfFunctions(0);
    }
 
+   ROOT::Internal::InitDeferredInterpreter();
+
    if (!fInterpreter)
       Fatal("GetListOfGlobalFunctions", "fInterpreter not initialized");
 
@@ -1844,6 +1961,7 @@ TCollection *TROOT::GetListOfGlobalFunctions(Bool_t load)
 
 TCollection *TROOT::GetListOfTypes(Bool_t /* load */)
 {
+   ROOT::Internal::InitDeferredInterpreter();
    if (!fInterpreter)
       Fatal("GetListOfTypes", "fInterpreter not initialized");
 
@@ -2007,6 +2125,9 @@ void TROOT::InitSystem()
 
       fgMemCheck = gEnv->GetValue("Root.MemCheck", 0);
 
+      if (gEnv->GetValue("Root.ObjectPool", 0))
+         TStorage::EnableObjectPool();
+
 #if defined(R__HAS_COCOA)
       // create and delete a dummy TUrl so that TObjectStat table does not contain
       // objects that are deleted after recording is turned-off (in next line),
@@ -2034,6 +2155,10 @@ void TROOT::InitThreads()
 
 void TROOT::InitInterpreter()
 {
+   ProcInfo_t procBefore;
+   gSystem->GetProcInfo(&procBefore);
+   const auto start = std::chrono::steady_clock::now();
+
    // usedToIdentifyRootClingByDlSym is available when TROOT is part of
    // rootcling.
    if (!dlsym(RTLD_DEFAULT, "usedToIdentifyRootClingByDlSym")
@@ -2148,6 +2273,14 @@ void TROOT::InitInterpreter()
 
    // Enable autoloading
    fInterpreter->EnableAutoLoading();
+
+   ProcInfo_t procAfter;
+   gSystem->GetProcInfo(&procAfter);
+   auto &initInfo = ROOT::Internal::gInterpreterInitInfo;
+   initInfo.fCreated = kTRUE;
+   initInfo.fRealTime = std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+   initInfo.fMemResident = procAfter.fMemResident - procBefore.fMemResident;
+   initInfo.fMemVirtual = procAfter.fMemVirtual - procBefore.fMemVirtual;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2269,6 +2402,7 @@ Int_t TROOT::LoadMacro(const char *filename, int *error, Bool_t check)
    else
       terr = &lerr;
 
+   ROOT::Internal::InitDeferredInterpreter();
    if (fInterpreter) {
       TString aclicMode;
       TString arguments;
@@ -2312,6 +2446,7 @@ Long_t TROOT::Macro(const char *filename, Int_t *error, Bool_t padUpdate)
 {
    Long_t result = 0;
 
+   ROOT::Internal::InitDeferredInterpreter();
    if (fInterpreter) {
       TString aclicMode;
       TString arguments;
@@ -2409,6 +2544,7 @@ Long_t TROOT::ProcessLineFast(const char *line, Int_t *error)
 
    Long_t result = 0;
 
+   ROOT::Internal::InitDeferredInterpreter();
    if (fInterpreter) {
       TInterpreter::EErrorCode *code = (TInterpreter::EErrorCode*)error;
       result = gInterpreter->Calc(sline, code);
@@ -2495,11 +2631,15 @@ const char *TROOT::GetGitDate()
 /// Typically RecursiveRemove is implemented by classes that can contain
 /// mulitple references to a same object or shared ownership of the object
 /// with others.
+///
+/// obj is first removed from the lists with indexed cleanup holding it,
+/// see ROOT::EnableIndexedCleanup().
 
 void TROOT::RecursiveRemove(TObject *obj)
 {
    R__READ_LOCKGUARD(ROOT::gCoreMutex);
 
+   TConcurrentHashList::RecursiveRemoveIndexed(obj);
    fCleanups->RecursiveRemove(obj);
 }
 
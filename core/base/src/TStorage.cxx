@@ -28,9 +28,26 @@ occur.
 
 Set the compile option R__NOSTATS to de-activate all memory checking
 and statistics gathering in the system.
+
+The storage manager also provides an object pool for the small TObject-derived
+objects which are created and deleted at a high rate (TObjString, TRef,
+TLorentzVector, the contents of TClonesArray...), possibly by many threads.
+The pool serves blocks of a few size classes from per-thread free lists,
+without locking; the threads exchange free blocks with a global pool by
+batches. The pool is used by all TObjects once enabled with
+TStorage::EnableObjectPool() or the resource Root.ObjectPool, or by the
+objects of the classes declared with R__USE_OBJECT_POOL. Its usage per size
+class is returned by TStorage::GetObjectPoolStat() and printed by
+TStorage::PrintStatistics().
 */
 
 #include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 #include "TROOT.h"
 #include "TObjectTable.h"
@@ -88,6 +105,353 @@ static Int_t    gTraceCapacity = 10, gTraceIndex = 0,
 ROOT::Internal::FreeIfTMapFile_t *ROOT::Internal::gFreeIfTMapFile = nullptr;
 void *ROOT::Internal::gMmallocDesc = 0; //is used and set in TMapFile
 
+//------------------------------------------------------------------------------
+// Object pool.
+
+namespace {
+
+const size_t kPoolGranularity = 16;                    // difference of size between size classes
+const Int_t  kPoolNClasses    = 32;                    // blocks of 16 to 512 bytes
+const size_t kPoolMaxSize     = kPoolGranularity * kPoolNClasses;
+const size_t kPoolChunkSize   = 1 << 20;               // memory taken from the system at once
+const size_t kPoolSpanSize    = 1 << 16;               // memory given to one size class at once
+const Int_t  kPoolNSpans      = kPoolChunkSize / kPoolSpanSize;
+const size_t kPoolHeaderSize  = 64;                    // chunk header, at the begin of the first span
+const Int_t  kPoolBatch       = 64;                    // blocks moved at once between a thread and the pool
+const Int_t  kPoolTableSize   = 1 << 14;               // capacity of the set of chunks
+
+/// A free block. The first block of a batch of free blocks links the next batch.
+struct TPoolBlock {
+   TPoolBlock *fNext;      // next block of the batch
+   TPoolBlock *fNextBatch; // next batch of the global free list
+};
+
+/// Header of a chunk: the size class of each of its spans.
+struct TPoolChunk {
+   UChar_t fSpanClass[kPoolNSpans];
+};
+
+class TPoolCache;
+
+/// The global part of the pool: the chunks and the batches of free blocks.
+/// It is never deleted, blocks may be released until the very end of the process.
+class TObjectPool {
+private:
+   std::atomic<std::uintptr_t> fChunks[kPoolTableSize]; // set of the chunks, read without locking
+   std::mutex  fMutex;                                 // protects all the members below
+   Int_t       fNChunks;                               // number of chunks in fChunks
+   char       *fChunk;                                 // chunk being split in spans
+   Int_t       fNextSpan;                              // next span of fChunk to hand out
+   TPoolBlock *fBatches[kPoolNClasses];                // batches of free blocks
+   Long64_t    fNBlocks[kPoolNClasses];                // blocks carved from the spans
+   Long64_t    fNAlloc[kPoolNClasses];                 // allocations of the threads which ended
+   Long64_t    fNFree[kPoolNClasses];                  // deallocations of the threads which ended
+   std::vector<TPoolCache *> fCaches;                  // caches of the running threads
+
+   static Int_t Slot(std::uintptr_t chunk) { return (Int_t)((chunk / kPoolChunkSize * 0x9E3779B1u) & (kPoolTableSize - 1)); }
+
+   char *NewChunk();
+   Bool_t NewSpan(Int_t cls);
+
+public:
+   TObjectPool();
+
+   Int_t ClassOf(void *vp) const;
+   TPoolBlock *GetBatch(Int_t cls);
+   void PutBatch(Int_t cls, TPoolBlock *batch);
+   void Release(void *vp, Int_t cls);
+   void Register(TPoolCache *cache);
+   void Unregister(TPoolCache *cache);
+   TStorage::TObjectPoolStat GetStat(Int_t cls);
+};
+
+/// The free lists of one thread. Only the statistics are read by other threads.
+class TPoolCache {
+private:
+   TPoolBlock *fFree[kPoolNClasses];   // free blocks
+   Int_t       fNFree[kPoolNClasses];  // number of blocks in fFree
+
+   static void Increment(std::atomic<Long64_t> &count)
+   {
+      // Only the owning thread writes the counters: no need for an atomic increment.
+      count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+   }
+
+public:
+   std::atomic<Long64_t> fNAlloc[kPoolNClasses];  // allocations done by the thread
+   std::atomic<Long64_t> fNFreed[kPoolNClasses];  // deallocations done by the thread
+
+   TPoolCache();
+   ~TPoolCache();
+
+   void *Alloc(Int_t cls);
+   void Free(void *vp, Int_t cls);
+   TPoolBlock *Take(Int_t cls);
+};
+
+std::atomic<TObjectPool *> gObjectPool(nullptr);
+std::atomic<bool> gObjectPoolEnabled(false);
+thread_local bool tPoolCacheDone = false;
+
+TObjectPool &GetObjectPool()
+{
+   static TObjectPool *pool = []() {
+      TObjectPool *p = new TObjectPool;
+      gObjectPool = p;
+      return p;
+   }();
+   return *pool;
+}
+
+/// Return the cache of the current thread, nullptr once the thread destroyed it.
+TPoolCache *GetPoolCache()
+{
+   if (tPoolCacheDone)
+      return nullptr;
+   thread_local TPoolCache cache;
+   return &cache;
+}
+
+TObjectPool::TObjectPool() : fNChunks(0), fChunk(nullptr), fNextSpan(kPoolNSpans)
+{
+   for (auto &chunk : fChunks)
+      chunk.store(0, std::memory_order_relaxed);
+   for (Int_t i = 0; i < kPoolNClasses; ++i) {
+      fBatches[i] = nullptr;
+      fNBlocks[i] = fNAlloc[i] = fNFree[i] = 0;
+   }
+}
+
+/// Return the size class of the pooled block vp, -1 if vp does not come from the pool.
+Int_t TObjectPool::ClassOf(void *vp) const
+{
+   const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(vp);
+   const std::uintptr_t chunk = addr & ~(std::uintptr_t)(kPoolChunkSize - 1);
+   for (Int_t i = Slot(chunk), n = 0; n < kPoolTableSize; i = (i + 1) & (kPoolTableSize - 1), ++n) {
+      const std::uintptr_t c = fChunks[i].load(std::memory_order_acquire);
+      if (c == chunk)
+         return reinterpret_cast<const TPoolChunk *>(chunk)->fSpanClass[(addr - chunk) / kPoolSpanSize];
+      if (!c)
+         break;
+   }
+   return -1;
+}
+
+/// Allocate a chunk from the system and add it to the set of chunks; called with fMutex held.
+/// Returns nullptr once the set is half full, to keep the lookups short.
+char *TObjectPool::NewChunk()
+{
+   if (fNChunks >= kPoolTableSize / 2)
+      return nullptr;
+   void *chunk = nullptr;
+#ifdef WIN32
+   chunk = _aligned_malloc(kPoolChunkSize, kPoolChunkSize);
+#else
+   if (posix_memalign(&chunk, kPoolChunkSize, kPoolChunkSize))
+      chunk = nullptr;
+#endif
+   if (!chunk)
+      return nullptr;
+   const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(chunk);
+   Int_t i = Slot(addr);
+   while (fChunks[i].load(std::memory_order_relaxed))
+      i = (i + 1) & (kPoolTableSize - 1);
+   fChunks[i].store(addr, std::memory_order_release);
+   ++fNChunks;
+   return static_cast<char *>(chunk);
+}
+
+/// Split a new span in batches of free blocks of class cls; called with fMutex held.
+Bool_t TObjectPool::NewSpan(Int_t cls)
+{
+   if (fNextSpan == kPoolNSpans) {
+      char *chunk = NewChunk();
+      if (!chunk)
+         return kFALSE;
+      fChunk = chunk;
+      fNextSpan = 0;
+   }
+   const Int_t span = fNextSpan++;
+   reinterpret_cast<TPoolChunk *>(fChunk)->fSpanClass[span] = cls;
+
+   const size_t size = (cls + 1) * kPoolGranularity;
+   char *begin = fChunk + span * kPoolSpanSize + (span == 0 ? kPoolHeaderSize : 0);
+   char *end = fChunk + (span + 1) * kPoolSpanSize;
+   TPoolBlock *last = nullptr;
+   Int_t n = 0;
+   for (char *p = begin; p + size <= end; p += size, ++n) {
+      auto block = reinterpret_cast<TPoolBlock *>(p);
+      block->fNext = nullptr;
+      if (n % kPoolBatch == 0) {
+         block->fNextBatch = fBatches[cls];
+         fBatches[cls] = block;
+      } else {
+         last->fNext = block;
+      }
+      last = block;
+   }
+   fNBlocks[cls] += n;
+   return kTRUE;
+}
+
+/// Return a batch of free blocks of class cls, nullptr if no memory can be found.
+TPoolBlock *TObjectPool::GetBatch(Int_t cls)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   if (!fBatches[cls] && !NewSpan(cls))
+      return nullptr;
+   TPoolBlock *batch = fBatches[cls];
+   fBatches[cls] = batch->fNextBatch;
+   return batch;
+}
+
+/// Give back a batch of free blocks of class cls.
+void TObjectPool::PutBatch(Int_t cls, TPoolBlock *batch)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   batch->fNextBatch = fBatches[cls];
+   fBatches[cls] = batch;
+}
+
+/// Release a block from a thread which already destroyed its cache.
+void TObjectPool::Release(void *vp, Int_t cls)
+{
+   auto block = static_cast<TPoolBlock *>(vp);
+   block->fNext = nullptr;
+   std::lock_guard<std::mutex> lock(fMutex);
+   block->fNextBatch = fBatches[cls];
+   fBatches[cls] = block;
+   ++fNFree[cls];
+}
+
+void TObjectPool::Register(TPoolCache *cache)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   fCaches.push_back(cache);
+}
+
+/// Forget the cache of an ending thread, keeping its statistics.
+void TObjectPool::Unregister(TPoolCache *cache)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   for (Int_t i = 0; i < kPoolNClasses; ++i) {
+      fNAlloc[i] += cache->fNAlloc[i].load(std::memory_order_relaxed);
+      fNFree[i] += cache->fNFreed[i].load(std::memory_order_relaxed);
+   }
+   for (auto &c : fCaches) {
+      if (c == cache) {
+         c = fCaches.back();
+         fCaches.pop_back();
+         break;
+      }
+   }
+}
+
+TStorage::TObjectPoolStat TObjectPool::GetStat(Int_t cls)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   TStorage::TObjectPoolStat stat;
+   stat.fSize = (cls + 1) * kPoolGranularity;
+   stat.fNAlloc = fNAlloc[cls];
+   stat.fNFree = fNFree[cls];
+   stat.fNBlocks = fNBlocks[cls];
+   for (auto cache : fCaches) {
+      stat.fNAlloc += cache->fNAlloc[cls].load(std::memory_order_relaxed);
+      stat.fNFree += cache->fNFreed[cls].load(std::memory_order_relaxed);
+   }
+   return stat;
+}
+
+TPoolCache::TPoolCache()
+{
+   for (Int_t i = 0; i < kPoolNClasses; ++i) {
+      fFree[i] = nullptr;
+      fNFree[i] = 0;
+      fNAlloc[i].store(0, std::memory_order_relaxed);
+      fNFreed[i].store(0, std::memory_order_relaxed);
+   }
+   GetObjectPool().Register(this);
+}
+
+/// Give back all the free blocks of the ending thread to the global pool.
+TPoolCache::~TPoolCache()
+{
+   TObjectPool &pool = GetObjectPool();
+   for (Int_t i = 0; i < kPoolNClasses; ++i) {
+      if (fFree[i])
+         pool.PutBatch(i, fFree[i]);
+   }
+   pool.Unregister(this);
+   tPoolCacheDone = true;
+}
+
+void *TPoolCache::Alloc(Int_t cls)
+{
+   if (!fFree[cls]) {
+      fFree[cls] = GetObjectPool().GetBatch(cls);
+      if (!fFree[cls])
+         return nullptr;
+      for (TPoolBlock *b = fFree[cls]; b; b = b->fNext)
+         ++fNFree[cls];
+   }
+   TPoolBlock *block = fFree[cls];
+   fFree[cls] = block->fNext;
+   --fNFree[cls];
+   Increment(fNAlloc[cls]);
+   return block;
+}
+
+void TPoolCache::Free(void *vp, Int_t cls)
+{
+   auto block = static_cast<TPoolBlock *>(vp);
+   block->fNext = fFree[cls];
+   fFree[cls] = block;
+   Increment(fNFreed[cls]);
+   if (++fNFree[cls] >= 2 * kPoolBatch)
+      GetObjectPool().PutBatch(cls, Take(cls));
+}
+
+/// Detach a batch of kPoolBatch blocks from the free list of class cls.
+TPoolBlock *TPoolCache::Take(Int_t cls)
+{
+   TPoolBlock *batch = fFree[cls];
+   TPoolBlock *last = batch;
+   for (Int_t i = 1; i < kPoolBatch; ++i)
+      last = last->fNext;
+   fFree[cls] = last->fNext;
+   last->fNext = nullptr;
+   fNFree[cls] -= kPoolBatch;
+   return batch;
+}
+
+/// Allocate a block of at least sz bytes from the pool, nullptr if it cannot.
+void *PoolAlloc(size_t sz)
+{
+   if (sz == 0 || sz > kPoolMaxSize)
+      return nullptr;
+   TPoolCache *cache = GetPoolCache();
+   return cache ? cache->Alloc((sz - 1) / kPoolGranularity) : nullptr;
+}
+
+/// Give back vp to the pool if it comes from it.
+Bool_t PoolDealloc(void *vp)
+{
+   TObjectPool *pool = gObjectPool.load(std::memory_order_acquire);
+   if (!pool || !vp)
+      return kFALSE;
+   const Int_t cls = pool->ClassOf(vp);
+   if (cls < 0)
+      return kFALSE;
+   if (TPoolCache *cache = GetPoolCache())
+      cache->Free(vp, cls);
+   else
+      pool->Release(vp, cls);
+   return kTRUE;
+}
+
+} // namespace
+
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -327,7 +691,23 @@ Int_t *TStorage::ReAllocInt(Int_t *ovp, size_t size, size_t oldsize)
 
 void *TStorage::ObjectAlloc(size_t sz)
 {
-   void* space =  ::operator new(sz);
+   void* space = gObjectPoolEnabled.load(std::memory_order_relaxed) ? PoolAlloc(sz) : nullptr;
+   if (!space)
+      space = ::operator new(sz);
+   memset(space, kObjectAllocMemValue, sz);
+   return space;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Same as ObjectAlloc(size_t), but the block is taken from the object pool
+/// even if it is not enabled for all TObjects. Used by the classes declared
+/// with R__USE_OBJECT_POOL.
+
+void *TStorage::ObjectPoolAlloc(size_t sz)
+{
+   void* space = PoolAlloc(sz);
+   if (!space)
+      space = ::operator new(sz);
    memset(space, kObjectAllocMemValue, sz);
    return space;
 }
@@ -358,7 +738,8 @@ void *TStorage::ObjectAlloc(size_t , void *vp)
 
 void TStorage::ObjectDealloc(void *vp)
 {
-
+   if (PoolDealloc(vp))
+      return;
    ::operator delete(vp);
 }
 
@@ -377,6 +758,8 @@ void TStorage::ObjectDealloc(void *vp, void *ptr)
 
 void TStorage::ObjectDealloc(void *vp, size_t size)
 {
+   if (PoolDealloc(vp))
+      return;
    ::operator delete(vp, size);
 }
 #endif
@@ -408,6 +791,20 @@ void TStorage::PrintStatistics()
    // Needs to be protected by global mutex
    R__LOCKGUARD(gGlobalMutex);
 
+   if (gObjectPool) {
+      Printf("Object pool statistics");
+      Printf("%12s%12s%12s%12s%12s", "size", "alloc", "free", "diff", "blocks");
+      Printf("============================================================");
+      for (Int_t i = 0; i < GetObjectPoolNClasses(); i++) {
+         TObjectPoolStat stat = GetObjectPoolStat(i);
+         if (stat.fNBlocks)
+            Printf("%12d%12lld%12lld%12lld%12lld", (int)stat.fSize, stat.fNAlloc, stat.fNFree,
+                   stat.fNAlloc - stat.fNFree, stat.fNBlocks);
+      }
+      Printf("============================================================");
+      Printf(" ");
+   }
+
 #if defined(MEM_DEBUG) && defined(MEM_STAT)
 
    if (!gMemStatistics || !HasCustomNewDelete())
@@ -458,6 +855,49 @@ void TStorage::EnableStatistics(int size, int ix)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate all the TObjects of at most 512 bytes from the object pool (see
+/// the class description), or stop doing so. The objects allocated from the
+/// pool before it is disabled are still released to it.
+
+void TStorage::EnableObjectPool(Bool_t enable)
+{
+   if (enable)
+      GetObjectPool();
+   gObjectPoolEnabled = enable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if all the TObjects are allocated from the object pool.
+
+Bool_t TStorage::IsObjectPoolEnabled()
+{
+   return gObjectPoolEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of size classes of the object pool.
+
+Int_t TStorage::GetObjectPoolNClasses()
+{
+   return kPoolNClasses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the usage of the size class sizeClass of the object pool, summed
+/// over all the threads. The counts of the running threads are a snapshot.
+
+TStorage::TObjectPoolStat TStorage::GetObjectPoolStat(Int_t sizeClass)
+{
+   TObjectPoolStat stat = {0, 0, 0, 0};
+   if (sizeClass < 0 || sizeClass >= kPoolNClasses)
+      return stat;
+   if (TObjectPool *pool = gObjectPool)
+      return pool->GetStat(sizeClass);
+   stat.fSize = (sizeClass + 1) * kPoolGranularity;
+   return stat;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ULong_t TStorage::GetHeapBegin()
@@ -0,0 +1,37 @@
+#include "TClass.h"
+#include "TInterpreter.h"
+#include "TNamed.h"
+#include "TROOT.h"
+
+#include "gtest/gtest.h"
+
+#include <typeinfo>
+
+// The interpreter of this test suite is created on first use: this must be set
+// before any use of gROOT.
+static const bool gLazyInterpreterEnabled = (ROOT::EnableLazyInterpreter(), true);
+
+TEST(TROOT, LazyInterpreterCompiledClass)
+{
+   ASSERT_TRUE(gLazyInterpreterEnabled);
+   ASSERT_NE(gROOT, nullptr);
+   ASSERT_TRUE(ROOT::IsLazyInterpreterEnabled());
+   ASSERT_EQ(gCling, nullptr);
+
+   // Classes with a compiled dictionary are found without the interpreter.
+   EXPECT_EQ(TClass::GetClass("TNamed"), TNamed::Class());
+   EXPECT_EQ(TClass::GetClass(typeid(TNamed)), TNamed::Class());
+   EXPECT_EQ(gCling, nullptr);
+   EXPECT_FALSE(ROOT::GetInterpreterInitInfo().fCreated);
+}
+
+TEST(TROOT, InterpreterInitInfo)
+{
+   // Make sure the interpreter exists, even if its creation is deferred.
+   ASSERT_NE(gInterpreter, nullptr);
+
+   auto info = ROOT::GetInterpreterInitInfo();
+   EXPECT_TRUE(info.fCreated);
+   EXPECT_EQ(info.fLazy, ROOT::IsLazyInterpreterEnabled());
+   EXPECT_GT(info.fRealTime, 0.);
+}
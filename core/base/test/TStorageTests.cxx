@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include "TNamed.h"
+#include "TStorage.h"
+
+#include <thread>
+#include <vector>
+
+TEST(TStorage, ObjectPool)
+{
+   TStorage::EnableObjectPool();
+   ASSERT_TRUE(TStorage::IsObjectPoolEnabled());
+
+   const Int_t cls = (sizeof(TNamed) - 1) / 16;
+   const TStorage::TObjectPoolStat before = TStorage::GetObjectPoolStat(cls);
+   EXPECT_GE(before.fSize, sizeof(TNamed));
+
+   auto churn = []() {
+      std::vector<TNamed *> objects;
+      for (int i = 0; i < 1000; ++i) {
+         objects.push_back(new TNamed("name", "title"));
+         // Allocated by TObject::operator new: recognized as being on the heap.
+         EXPECT_TRUE(objects.back()->IsOnHeap());
+      }
+      for (auto obj : objects)
+         delete obj;
+   };
+   churn();
+   std::vector<std::thread> threads;
+   for (int i = 0; i < 4; ++i)
+      threads.emplace_back(churn);
+   for (auto &thr : threads)
+      thr.join();
+
+   const TStorage::TObjectPoolStat after = TStorage::GetObjectPoolStat(cls);
+   EXPECT_EQ(after.fNAlloc - before.fNAlloc, 5000);
+   EXPECT_EQ(after.fNFree - before.fNFree, 5000);
+   EXPECT_GE(after.fNBlocks, 1000);
+
+   // Objects allocated from the pool are released to it once it is disabled.
+   TNamed *named = new TNamed("name", "title");
+   TStorage::EnableObjectPool(kFALSE);
+   delete named;
+   EXPECT_EQ(TStorage::GetObjectPoolStat(cls).fNFree - before.fNFree, 5001);
+}
@@ -38,6 +38,7 @@
 #pragma link C++ class TList-;
 #pragma link C++ class TListIter;
 #pragma link C++ class THashList;
+#pragma link C++ class TConcurrentHashList;
 #pragma link C++ class TMap-;
 #pragma link C++ class TMapIter;
 #pragma link C++ class TPair;
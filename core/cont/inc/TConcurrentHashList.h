@@ -0,0 +1,102 @@
+// @(#)root/cont:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentHashList
+#define ROOT_TConcurrentHashList
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TConcurrentHashList                                                  //
+//                                                                      //
+// THashList shared by many threads: lookups by name or by object do    //
+// not lock, modifications take a lock private to the list. With        //
+// indexed cleanup, deleting an object does not walk the list.          //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "THashList.h"
+
+#include <atomic>
+#include <vector>
+
+namespace ROOT {
+class TVirtualRWMutex;
+}
+
+
+class TConcurrentHashList : public THashList {
+
+public:
+   typedef Bool_t (*PassiveFilter_t)(const TObject *obj);
+
+private:
+   struct TIndex;
+
+   TIndex                                 *fIndex; //! Lookup table read without locking
+   mutable std::atomic<ROOT::TVirtualRWMutex *> fMutex; //! Lock of the modifications, created once thread safety is enabled
+
+   TConcurrentHashList(const TConcurrentHashList&);              // not implemented
+   TConcurrentHashList& operator=(const TConcurrentHashList&);   // not implemented
+
+   ROOT::TVirtualRWMutex *GetMutex() const;
+   void       Register(TObject *obj);
+   void       Unregister(TObject *obj);
+   void       UnregisterAll();
+   Bool_t     Holds(const TObject *obj) const;
+   TObject   *RemoveHeld(TObject *obj);
+
+public:
+   TConcurrentHashList(Int_t capacity=TCollection::kInitHashTableCapacity, Int_t rehash=0);
+   virtual    ~TConcurrentHashList();
+   void       Clear(Option_t *option="");
+   void       Delete(Option_t *option="");
+
+   TObject   *FindObject(const char *name) const;
+   TObject   *FindObject(const TObject *obj) const;
+   Int_t      FindObjects(const char *name, std::vector<TObject *> &objects) const;
+
+   void       AddFirst(TObject *obj);
+   void       AddFirst(TObject *obj, Option_t *opt);
+   void       AddLast(TObject *obj);
+   void       AddLast(TObject *obj, Option_t *opt);
+   void       AddAt(TObject *obj, Int_t idx);
+   void       AddAfter(const TObject *after, TObject *obj);
+   void       AddAfter(TObjLink *after, TObject *obj);
+   void       AddBefore(const TObject *before, TObject *obj);
+   void       AddBefore(TObjLink *before, TObject *obj);
+   void       RecursiveRemove(TObject *obj);
+   void       Rehash(Int_t newCapacity);
+   TObject   *Remove(TObject *obj);
+   TObject   *Remove(TObjLink *lnk);
+   void       RemoveLast();
+   void       Sort(Bool_t order = kSortAscending);
+
+   TObject   *After(const TObject *obj) const;
+   TObject   *At(Int_t idx) const;
+   TObject   *Before(const TObject *obj) const;
+   TObject   *First() const;
+   TObjLink  *FirstLink() const;
+   TObject  **GetObjectRef(const TObject *obj) const;
+   TObject   *Last() const;
+   TObjLink  *LastLink() const;
+
+   bool       UseRWLock();
+
+   Bool_t     IsIndexedCleanup() const;
+   void       SetIndexedCleanup();
+
+   static void AddPassiveFilter(PassiveFilter_t filter);
+   static void RecursiveRemoveIndexed(TObject *obj);
+
+   ClassDef(TConcurrentHashList,0)  //THashList with lookups without locking
+};
+
+#endif
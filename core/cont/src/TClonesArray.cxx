@@ -148,7 +148,8 @@ static inline void R__ReleaseMemory(TClass *cl, TObject *obj)
       if (TObject::GetObjectStat() && gObjectTable) {
          gObjectTable->RemoveQuietly(obj);
       }
-      ::operator delete(obj);
+      // The memory was allocated by TStorage::ObjectAlloc.
+      TStorage::ObjectDealloc(obj);
    }
 }
 
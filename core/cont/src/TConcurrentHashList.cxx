@@ -0,0 +1,1087 @@
+// @(#)root/cont:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TConcurrentHashList
+\ingroup Containers
+THashList for the lists shared by many threads, like the lists of objects
+and of keys of the directories or the lists of files and of cleanups of
+gROOT.
+
+A THashList set to use a RW lock (see UseRWLock()) serializes all the
+accesses of all such collections on ROOT::gCoreMutex. TConcurrentHashList
+instead serves FindObject() and FindObjects() without any lock, from a
+lookup table of its own which is updated by copy and whose memory is only
+released once no reader can still use it, and serializes its modifications and the reads of its list
+on a RW lock private to the list. The lock is created once thread safety is
+enabled (see ROOT::EnableThreadSafety()); before, the list does not lock.
+
+The lookups without lock never use the objects of the list, which another
+thread may be deleting once it has removed them: the table holds a copy of
+the name of each object, taken when the object is added, and looking up an
+object finds the object itself. An object equal to, but other than, the
+object looked up (see TObject::IsEqual()) is searched with the lock.
+
+As for THashList, an object renamed while in the list can only be found
+under its new name after a call to Rehash(); until then it is still found
+under its former name. Iterating over the list while other threads modify
+it is safe, but the iteration may or may not see the objects added or
+removed meanwhile.
+
+The readers do not write to memory shared with other threads: each thread
+publishes in a record of its own the epoch at which its lookup started, and
+the entries retired by a modification are released once all the lookups
+started before it are done.
+
+### Indexed cleanup
+
+Deleting an object with the kMustCleanup bit calls TROOT::RecursiveRemove(),
+which walks all the cleanup collections and, through the directories, all
+their objects. A list set to use indexed cleanup (see SetIndexedCleanup()),
+like the lists of objects of the directories once ROOT::EnableIndexedCleanup()
+has been called, does less work:
+
+  - each object it holds is recorded in a global index of back references,
+    from which RecursiveRemoveIndexed() removes a deleted object from the
+    lists actually holding it, at a cost proportional to their number;
+  - RecursiveRemove() of the list, still reached through the cleanup
+    collections, only calls RecursiveRemove() on the objects it holds which
+    may hold references to other objects, its "listeners". Objects accepted
+    by one of the filters given to AddPassiveFilter() are not listeners.
+
+Only the passive objects gain from it: each deletion still notifies all the
+listeners of the list, so deleting the histograms of a directory one by one
+costs, as without indexed cleanup, a time quadratic in their number. See
+test/cleanupbm.cxx.
+
+The index is sharded and its shards are only locked briefly: deletions in
+different threads proceed concurrently.
+*/
+
+#include "TConcurrentHashList.h"
+#include "TError.h"
+#include "THashTable.h"
+#include "TString.h"
+#include "TVirtualRWMutex.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+ClassImp(TConcurrentHashList);
+
+namespace {
+
+/// The lists with indexed cleanup holding each object, once per occurrence.
+class THolders {
+private:
+   static const Int_t kNShards = 64;
+
+   struct TShard {
+      std::mutex fMutex;
+      std::unordered_multimap<const TObject *, TConcurrentHashList *> fHolders;
+   };
+
+   TShard fShards[kNShards];
+
+   TShard &GetShard(const TObject *obj)
+   {
+      return fShards[(reinterpret_cast<std::uintptr_t>(obj) >> 4) % kNShards];
+   }
+
+public:
+   void Add(const TObject *obj, TConcurrentHashList *list)
+   {
+      TShard &shard = GetShard(obj);
+      std::lock_guard<std::mutex> lock(shard.fMutex);
+      shard.fHolders.emplace(obj, list);
+   }
+
+   /// Remove one occurrence of list among the holders of obj, if any.
+   void Remove(const TObject *obj, TConcurrentHashList *list)
+   {
+      TShard &shard = GetShard(obj);
+      std::lock_guard<std::mutex> lock(shard.fMutex);
+      auto range = shard.fHolders.equal_range(obj);
+      for (auto it = range.first; it != range.second; ++it) {
+         if (it->second == list) {
+            shard.fHolders.erase(it);
+            return;
+         }
+      }
+   }
+
+   /// Move the holders of obj to lists.
+   void Take(const TObject *obj, std::vector<TConcurrentHashList *> &lists)
+   {
+      TShard &shard = GetShard(obj);
+      std::lock_guard<std::mutex> lock(shard.fMutex);
+      auto range = shard.fHolders.equal_range(obj);
+      for (auto it = range.first; it != range.second; ++it)
+         lists.push_back(it->second);
+      shard.fHolders.erase(range.first, range.second);
+   }
+};
+
+// Never deleted: lists are still destroyed at exit.
+THolders &GetHolders()
+{
+   static THolders *holders = new THolders;
+   return *holders;
+}
+
+/// The epoch of the lookups in progress in each thread. A thread writes only
+/// to its own record, on a cache line of its own; the writers advance the
+/// epoch and look at all the records to find the oldest lookup in progress.
+class TReaders {
+public:
+   struct alignas(64) TRecord {
+      std::atomic<ULong64_t> fEpoch; // epoch at the start of the current lookup, 0 if none
+      std::atomic<Bool_t>    fUsed;  // owned by a running thread
+      TRecord() : fEpoch(0), fUsed(kTRUE) {}
+   };
+
+private:
+   std::atomic<ULong64_t> fEpoch;
+   std::mutex             fMutex;   // protects fRecords
+   std::vector<TRecord *> fRecords; // never deleted, reused once their thread exits
+
+public:
+   TReaders() : fEpoch(1) {}
+
+   TRecord *Acquire()
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (auto record : fRecords) {
+         Bool_t used = kFALSE;
+         if (record->fUsed.compare_exchange_strong(used, kTRUE))
+            return record;
+      }
+      fRecords.push_back(new TRecord);
+      return fRecords.back();
+   }
+
+   ULong64_t GetEpoch() const { return fEpoch.load(); }
+
+   /// Close the current epoch and return it.
+   ULong64_t Advance() { return fEpoch.fetch_add(1); }
+
+   /// Return the epoch of the oldest lookup in progress, or the current one if none.
+   ULong64_t GetOldest()
+   {
+      ULong64_t oldest = fEpoch.load();
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (auto record : fRecords) {
+         const ULong64_t epoch = record->fEpoch.load();
+         if (epoch && epoch < oldest)
+            oldest = epoch;
+      }
+      return oldest;
+   }
+};
+
+// Never deleted: lookups may still happen at exit.
+TReaders &GetReaders()
+{
+   static TReaders *readers = new TReaders;
+   return *readers;
+}
+
+/// The record of the current thread, given back when the thread exits.
+struct TThreadReader {
+   TReaders::TRecord *fRecord = nullptr;
+   Int_t              fDepth = 0; // lookups may nest, e.g. through GetName()
+   ~TThreadReader()
+   {
+      if (fRecord)
+         fRecord->fUsed = kFALSE;
+   }
+};
+
+TThreadReader &GetThreadReader()
+{
+   thread_local TThreadReader reader;
+   return reader;
+}
+
+// Constant initialized: filters are added by static initializers of other libraries.
+const Int_t kMaxPassiveFilters = 16;
+std::atomic<Int_t> gNPassiveFilters(0);
+std::atomic<TConcurrentHashList::PassiveFilter_t> gPassiveFilters[kMaxPassiveFilters];
+
+Bool_t IsPassive(const TObject *obj)
+{
+   const Int_t n = std::min(gNPassiveFilters.load(), kMaxPassiveFilters);
+   for (Int_t i = 0; i < n; ++i) {
+      TConcurrentHashList::PassiveFilter_t filter = gPassiveFilters[i].load();
+      if (filter && filter(obj))
+         return kTRUE;
+   }
+   return kFALSE;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hash table of the objects of the list. The writers, serialized by the
+/// lock of the list, publish each change with an atomic store; the nodes they
+/// unlink are kept until no reader can still be visiting them. The objects
+/// themselves are not protected: the lookups only compare what the nodes hold.
+
+struct TConcurrentHashList::TIndex {
+   struct TNode {
+      TObject             *fObject;
+      ULong_t              fHash;
+      std::string          fName;  // name of fObject when it was added or rehashed
+      std::atomic<TNode *> fNext;
+      TNode(TObject *obj, ULong_t hash, const std::string &name)
+         : fObject(obj), fHash(hash), fName(name), fNext(nullptr) {}
+      TNode(TObject *obj, ULong_t hash) : TNode(obj, hash, obj->GetName() ? obj->GetName() : "") {}
+   };
+
+   struct TBuckets {
+      Int_t                 fSize;
+      std::atomic<TNode *> *fSlots;
+      explicit TBuckets(Int_t size) : fSize(size), fSlots(new std::atomic<TNode *>[size])
+      {
+         for (Int_t i = 0; i < size; ++i)
+            fSlots[i].store(nullptr, std::memory_order_relaxed);
+      }
+      ~TBuckets() { delete[] fSlots; }
+   };
+
+   /// Publish the epoch of a lookup in the record of the thread for its
+   /// lifetime. The tables and the nodes are read afterwards.
+   class TReader {
+      TThreadReader &fReader;
+   public:
+      TReader() : fReader(GetThreadReader())
+      {
+         if (fReader.fDepth++) return;
+         if (!fReader.fRecord)
+            fReader.fRecord = GetReaders().Acquire();
+         fReader.fRecord->fEpoch.store(GetReaders().GetEpoch());
+      }
+      ~TReader()
+      {
+         if (!--fReader.fDepth)
+            fReader.fRecord->fEpoch.store(0, std::memory_order_release);
+      }
+   };
+
+   /// Reclaim the retired entries at the end of a modification.
+   class TReclaimGuard {
+      TIndex &fIndex;
+   public:
+      explicit TReclaimGuard(TIndex &index) : fIndex(index) {}
+      ~TReclaimGuard() { fIndex.Reclaim(); }
+   };
+
+   template <typename T>
+   struct TRetired {
+      ULong64_t fEpoch;  // last epoch of the lookups which may use fEntry, 0 until known
+      T        *fEntry;
+   };
+
+   std::atomic<TBuckets *> fBuckets;       // current table
+   std::atomic<Bool_t>     fLocked;        // lookups must go through the locked THashList
+   std::atomic<Bool_t>     fIndexedCleanup; // objects are recorded in the index of holders
+   std::unordered_multiset<TObject *> fListeners; // objects to notify of the deletions, with indexed cleanup
+   Int_t                   fEntries;       // number of objects in the table
+   std::vector<TRetired<TNode>>    fRetiredNodes;  // unlinked nodes, to be deleted
+   std::vector<TRetired<TBuckets>> fRetiredTables; // replaced tables, to be deleted
+
+   explicit TIndex(Int_t capacity)
+      : fBuckets(new TBuckets(capacity > 0 ? capacity : TCollection::kInitHashTableCapacity)), fLocked(kFALSE), fIndexedCleanup(kFALSE), fEntries(0)
+   {
+   }
+
+   ~TIndex()
+   {
+      Retire(fBuckets.load());
+      Reclaim(kTRUE);
+   }
+
+   TNode *Find(const char *name) const
+   {
+      const ULong_t hash = ::Hash(name);
+      TBuckets *buckets = fBuckets.load();
+      for (TNode *node = buckets->fSlots[hash % buckets->fSize].load(); node; node = node->fNext.load()) {
+         if (node->fHash == hash && node->fName == name)
+            return node;
+      }
+      return nullptr;
+   }
+
+   void FindAll(const char *name, std::vector<TObject *> &objects) const
+   {
+      const ULong_t hash = ::Hash(name);
+      TBuckets *buckets = fBuckets.load();
+      for (TNode *node = buckets->fSlots[hash % buckets->fSize].load(); node; node = node->fNext.load()) {
+         if (node->fHash == hash && node->fName == name)
+            objects.push_back(node->fObject);
+      }
+   }
+
+   /// Find the node of obj itself.
+   TNode *Find(const TObject *obj) const
+   {
+      const ULong_t hash = obj->Hash();
+      TBuckets *buckets = fBuckets.load();
+      for (TNode *node = buckets->fSlots[hash % buckets->fSize].load(); node; node = node->fNext.load()) {
+         if (node->fHash == hash && node->fObject == obj)
+            return node;
+      }
+      return nullptr;
+   }
+
+   /// Link node at the end of its slot or, if found there, before the node of `before`.
+   static void Link(TBuckets *buckets, TNode *node, const TObject *before = nullptr)
+   {
+      std::atomic<TNode *> *link = &buckets->fSlots[node->fHash % buckets->fSize];
+      for (TNode *next = link->load(); next; next = link->load()) {
+         if (before && next->fObject == before) {
+            node->fNext.store(next);
+            break;
+         }
+         link = &next->fNext;
+      }
+      link->store(node);
+   }
+
+   void Add(TObject *obj, const TObject *before = nullptr)
+   {
+      TBuckets *buckets = fBuckets.load();
+      if (fEntries >= 2 * buckets->fSize)
+         buckets = Grow(2 * buckets->fSize + 1);
+      Link(buckets, new TNode(obj, obj->Hash()), before);
+      ++fEntries;
+   }
+
+   /// Unlink the node of obj. The slot given by the current hash of obj is
+   /// looked up first, all of them if obj is not found there.
+   void Remove(const TObject *obj, Bool_t checkHash = kTRUE)
+   {
+      TBuckets *buckets = fBuckets.load();
+      const Int_t first = checkHash ? Int_t(obj->Hash() % buckets->fSize) : 0;
+      for (Int_t i = 0; i < buckets->fSize; ++i) {
+         std::atomic<TNode *> *link = &buckets->fSlots[(first + i) % buckets->fSize];
+         for (TNode *node = link->load(); node; node = link->load()) {
+            if (node->fObject == obj) {
+               // Readers standing on node still find their way from its fNext.
+               link->store(node->fNext.load());
+               fRetiredNodes.push_back({0, node});
+               --fEntries;
+               return;
+            }
+            link = &node->fNext;
+         }
+      }
+   }
+
+   /// Replace the table by one with `size` slots, keeping the order of the objects in each slot.
+   TBuckets *Grow(Int_t size)
+   {
+      TBuckets *old = fBuckets.load();
+      TBuckets *buckets = new TBuckets(size);
+      for (Int_t i = 0; i < old->fSize; ++i) {
+         for (TNode *node = old->fSlots[i].load(); node; node = node->fNext.load())
+            Link(buckets, new TNode(node->fObject, node->fHash, node->fName));
+      }
+      fBuckets.store(buckets);
+      Retire(old);
+      return buckets;
+   }
+
+   /// Replace the table by one filled with the objects of the list starting at first, hashed again.
+   void Rebuild(TObjLink *first, Int_t size)
+   {
+      TBuckets *old = fBuckets.load();
+      TBuckets *buckets = new TBuckets(size > 0 ? size : old->fSize);
+      fEntries = 0;
+      for (TObjLink *lnk = first; lnk; lnk = lnk->Next()) {
+         if (TObject *obj = lnk->GetObject()) {
+            Link(buckets, new TNode(obj, obj->Hash()));
+            ++fEntries;
+         }
+      }
+      fBuckets.store(buckets);
+      Retire(old);
+   }
+
+   void Clear()
+   {
+      TBuckets *old = fBuckets.load();
+      fBuckets.store(new TBuckets(old->fSize));
+      fEntries = 0;
+      Retire(old);
+   }
+
+   void Retire(TBuckets *buckets)
+   {
+      for (Int_t i = 0; i < buckets->fSize; ++i) {
+         for (TNode *node = buckets->fSlots[i].load(); node; node = node->fNext.load())
+            fRetiredNodes.push_back({0, node});
+      }
+      fRetiredTables.push_back({0, buckets});
+   }
+
+   /// Set the epoch of the entries retired by the current modification and
+   /// delete the entries which the lookups in progress cannot reach anymore.
+   template <typename T>
+   static void Reclaim(std::vector<TRetired<T>> &retired, ULong64_t epoch, ULong64_t oldest, Bool_t force)
+   {
+      for (auto it = retired.rbegin(); it != retired.rend() && !it->fEpoch; ++it)
+         it->fEpoch = epoch;
+      auto kept = retired.begin();
+      for (auto &entry : retired) {
+         if (force || entry.fEpoch < oldest)
+            delete entry.fEntry;
+         else
+            *kept++ = entry;
+      }
+      retired.erase(kept, retired.end());
+   }
+
+   /// Delete the retired nodes and tables if no reader can reach them anymore.
+   void Reclaim(Bool_t force = kFALSE)
+   {
+      if (fRetiredNodes.empty() && fRetiredTables.empty())
+         return;
+      // The lookups starting from now on only see the current table.
+      const ULong64_t epoch = GetReaders().Advance();
+      const ULong64_t oldest = force ? 0 : GetReaders().GetOldest();
+      Reclaim(fRetiredNodes, epoch, oldest, force);
+      Reclaim(fRetiredTables, epoch, oldest, force);
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a TConcurrentHashList. Capacity and rehash are those of the hash
+/// table of the THashList, see THashList::THashList().
+
+TConcurrentHashList::TConcurrentHashList(Int_t capacity, Int_t rehash)
+   : THashList(capacity, rehash), fIndex(new TIndex(capacity)), fMutex(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the list. Objects are not deleted unless the list is the owner
+/// (set via SetOwner()).
+
+TConcurrentHashList::~TConcurrentHashList()
+{
+   if (IsIndexedCleanup()) {
+      // RecursiveRemoveIndexed() may be using the list, under the read lock of ROOT::gCoreMutex.
+      R__WRITE_LOCKGUARD(ROOT::gCoreMutex);
+      Clear();
+   } else {
+      Clear();
+   }
+   delete fIndex;
+   delete fMutex.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the lock of the list, nullptr as long as thread safety is not enabled.
+
+ROOT::TVirtualRWMutex *TConcurrentHashList::GetMutex() const
+{
+   ROOT::TVirtualRWMutex *mutex = fMutex.load(std::memory_order_acquire);
+   if (mutex || !ROOT::gCoreMutex)
+      return mutex;
+   ROOT::TVirtualRWMutex *created = ROOT::gCoreMutex->Factory(kTRUE);
+   if (fMutex.compare_exchange_strong(mutex, created))
+      return created;
+   delete created;
+   return mutex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record obj, just added to the list, in the index of holders and, unless
+/// it is passive, among the listeners. To be called with the lock of the list.
+
+void TConcurrentHashList::Register(TObject *obj)
+{
+   if (!fIndex->fIndexedCleanup) return;
+
+   GetHolders().Add(obj, this);
+   if (!IsPassive(obj))
+      fIndex->fListeners.insert(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget obj, just removed from the list. To be called with the lock of the list.
+
+void TConcurrentHashList::Unregister(TObject *obj)
+{
+   if (!fIndex->fIndexedCleanup) return;
+
+   GetHolders().Remove(obj, this);
+   auto listener = fIndex->fListeners.find(obj);
+   if (listener != fIndex->fListeners.end())
+      fIndex->fListeners.erase(listener);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget all the objects of the list, before it is emptied. To be called
+/// with the lock of the list.
+
+void TConcurrentHashList::UnregisterAll()
+{
+   if (!fIndex->fIndexedCleanup) return;
+
+   for (TObjLink *lnk = fFirst.get(); lnk; lnk = lnk->Next()) {
+      if (TObject *obj = lnk->GetObject())
+         GetHolders().Remove(obj, this);
+   }
+   fIndex->fListeners.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the beginning of the list.
+
+void TConcurrentHashList::AddFirst(TObject *obj)
+{
+   if (IsArgNull("AddFirst", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddFirst(obj);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the beginning of the list and also store option.
+
+void TConcurrentHashList::AddFirst(TObject *obj, Option_t *opt)
+{
+   if (IsArgNull("AddFirst", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddFirst(obj, opt);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the end of the list.
+
+void TConcurrentHashList::AddLast(TObject *obj)
+{
+   if (IsArgNull("AddLast", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddLast(obj);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the end of the list and also store option.
+
+void TConcurrentHashList::AddLast(TObject *obj, Option_t *opt)
+{
+   if (IsArgNull("AddLast", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddLast(obj, opt);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object at location idx in the list.
+
+void TConcurrentHashList::AddAt(TObject *obj, Int_t idx)
+{
+   if (IsArgNull("AddAt", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddAt(obj, idx);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object after object after in the list.
+
+void TConcurrentHashList::AddAfter(const TObject *after, TObject *obj)
+{
+   if (IsArgNull("AddAfter", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddAfter(after, obj);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object after object after in the list.
+
+void TConcurrentHashList::AddAfter(TObjLink *after, TObject *obj)
+{
+   if (IsArgNull("AddAfter", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddAfter(after, obj);
+   fIndex->Add(obj);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object before object before in the list. Among the objects with
+/// the same name, obj is found before `before`, as in THashList.
+
+void TConcurrentHashList::AddBefore(const TObject *before, TObject *obj)
+{
+   if (IsArgNull("AddBefore", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddBefore(before, obj);
+   fIndex->Add(obj, before);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object before object before in the list.
+
+void TConcurrentHashList::AddBefore(TObjLink *before, TObject *obj)
+{
+   if (IsArgNull("AddBefore", obj)) return;
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::AddBefore(before, obj);
+   fIndex->Add(obj, before ? before->GetObject() : nullptr);
+   Register(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all objects from the list. Does not delete the objects unless
+/// the list is the owner (set via SetOwner()).
+
+void TConcurrentHashList::Clear(Option_t *option)
+{
+   if (IsOwner()) {
+      Delete(option);
+      return;
+   }
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   UnregisterAll();
+   fIndex->Clear();
+   THashList::Clear(option);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all objects from the list AND delete all heap based objects,
+/// see THashList::Delete().
+///
+/// The destructors of the objects may use the list, and may take
+/// ROOT::gCoreMutex: it is taken before the lock of the list, so that both
+/// are always taken in the same order. Meanwhile the lookups use the locked
+/// hash table of THashList, which is kept consistent during the deletion.
+
+void TConcurrentHashList::Delete(Option_t *option)
+{
+   R__WRITE_LOCKGUARD(ROOT::gCoreMutex);
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   fIndex->fLocked = kTRUE;
+   UnregisterAll();
+   fIndex->Clear();
+   THashList::Delete(option);
+   fIndex->fLocked = kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find object using its name, without locking.
+
+TObject *TConcurrentHashList::FindObject(const char *name) const
+{
+   if (!name) return nullptr;
+   if (fIndex->fLocked) {
+      R__READ_LOCKGUARD(GetMutex());
+      return THashList::FindObject(name);
+   }
+   TIndex::TReader reader;
+   TIndex::TNode *node = fIndex->Find(name);
+   return node ? node->fObject : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append to objects all the objects of the list with the given name, like the
+/// cycles of a key, without locking. They come in the order of
+/// THashList::GetListForObject(): an object added with AddBefore() comes before
+/// the object it was added before. Returns the number of objects found.
+
+Int_t TConcurrentHashList::FindObjects(const char *name, std::vector<TObject *> &objects) const
+{
+   if (!name) return 0;
+   const auto n = objects.size();
+   if (fIndex->fLocked) {
+      R__READ_LOCKGUARD(GetMutex());
+      TIter next(THashList::GetListForObject(name));
+      while (TObject *obj = next()) {
+         if (!strcmp(name, obj->GetName()))
+            objects.push_back(obj);
+      }
+   } else {
+      TIndex::TReader reader;
+      fIndex->FindAll(name, objects);
+   }
+   return objects.size() - n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find object using its hash value (returned by its Hash() member). The
+/// object itself is found without locking; an object equal to it (see
+/// TObject::IsEqual()) is looked up with the lock.
+
+TObject *TConcurrentHashList::FindObject(const TObject *obj) const
+{
+   if (!obj) return nullptr;
+   if (!fIndex->fLocked) {
+      TIndex::TReader reader;
+      if (TIndex::TNode *node = fIndex->Find(obj))
+         return node->fObject;
+   }
+   // Under the lock, the objects of the list cannot be deleted meanwhile.
+   R__READ_LOCKGUARD(GetMutex());
+   return THashList::FindObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether obj itself is in the list, without locking.
+
+Bool_t TConcurrentHashList::Holds(const TObject *obj) const
+{
+   if (fIndex->fLocked) {
+      R__READ_LOCKGUARD(GetMutex());
+      TIter next(fTable->GetListForObject(obj));
+      while (TObject *object = next()) {
+         if (object == obj)
+            return kTRUE;
+      }
+      return kFALSE;
+   }
+   TIndex::TReader reader;
+   return fIndex->Find(obj) != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove obj, which may be being deleted, from the list. The lock of the
+/// list is only taken if obj is in the list.
+
+TObject *TConcurrentHashList::RemoveHeld(TObject *obj)
+{
+   const Bool_t inconsistent = obj->HasInconsistentHash();
+   if (!inconsistent && !Holds(obj)) return nullptr;
+
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   TObject *object = TList::Remove(obj);
+   if (object) {
+      if (inconsistent)
+         fTable->RemoveSlow(object);
+      else
+         fTable->Remove(object);
+      fIndex->Remove(object, !inconsistent);
+      Unregister(object);
+   }
+   return object;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object from this collection and recursively remove the object
+/// from all other objects (and collections), see THashList::RecursiveRemove().
+/// The lock of the list is only taken if obj is in the list, and is released
+/// before calling RecursiveRemove() on the objects of the list.
+///
+/// With indexed cleanup, RecursiveRemove() is only called on the listeners
+/// of the list, the objects not declared passive, see AddPassiveFilter().
+
+void TConcurrentHashList::RecursiveRemove(TObject *obj)
+{
+   if (!obj) return;
+
+   RemoveHeld(obj);
+
+   if (IsIndexedCleanup()) {
+      // Collected first: notifying the listeners may modify the list.
+      std::vector<TObject *> listeners;
+      {
+         R__READ_LOCKGUARD(GetMutex());
+         listeners.assign(fIndex->fListeners.begin(), fIndex->fListeners.end());
+      }
+      for (auto ob : listeners) {
+         if (ob != obj && ob->TestBit(kNotDeleted))
+            ob->RecursiveRemove(obj);
+      }
+      return;
+   }
+
+   if (!fFirst.get())
+      return;
+
+   // As in THashList, the shared_ptr links keep our view of the list intact
+   // while other threads modify it.
+   auto lnk = fFirst;
+   decltype(lnk) next;
+   while (lnk.get()) {
+      next = lnk->NextSP();
+      TObject *ob = lnk->GetObject();
+      if (ob && ob->TestBit(kNotDeleted)) {
+         ob->RecursiveRemove(obj);
+      }
+      lnk = next;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Rehash the list, see THashList::Rehash(). To be called after renaming
+/// objects of the list.
+
+void TConcurrentHashList::Rehash(Int_t newCapacity)
+{
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   THashList::Rehash(newCapacity);
+   fIndex->Rebuild(fFirst.get(), newCapacity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object from the list.
+
+TObject *TConcurrentHashList::Remove(TObject *obj)
+{
+   if (!obj || !FindObject(obj)) return nullptr;
+
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   TList::Remove(obj);
+   TObject *object = fTable->Remove(obj);
+   if (object) {
+      fIndex->Remove(object);
+      Unregister(object);
+   }
+   return object;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object via its objlink from the list.
+
+TObject *TConcurrentHashList::Remove(TObjLink *lnk)
+{
+   if (!lnk) return nullptr;
+
+   R__WRITE_LOCKGUARD(GetMutex());
+   TIndex::TReclaimGuard reclaim(*fIndex);
+
+   TObject *obj = lnk->GetObject();
+   TList::Remove(lnk);
+   TObject *object = fTable->Remove(obj);
+   if (object) {
+      fIndex->Remove(object);
+      Unregister(object);
+   }
+   return object;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the last object of the list.
+
+void TConcurrentHashList::RemoveLast()
+{
+   R__WRITE_LOCKGUARD(GetMutex());
+
+   if (TObjLink *lnk = fLast.get())
+      Remove(lnk);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the list, see TList::Sort().
+
+void TConcurrentHashList::Sort(Bool_t order)
+{
+   R__WRITE_LOCKGUARD(GetMutex());
+
+   THashList::Sort(order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the object after object obj, see TList::After().
+
+TObject *TConcurrentHashList::After(const TObject *obj) const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::After(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the object at position idx, see TList::At().
+
+TObject *TConcurrentHashList::At(Int_t idx) const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::At(idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the object before object obj, see TList::Before().
+
+TObject *TConcurrentHashList::Before(const TObject *obj) const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::Before(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first object in the list.
+
+TObject *TConcurrentHashList::First() const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::First();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first link of the list.
+
+TObjLink *TConcurrentHashList::FirstLink() const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::FirstLink();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the address of the pointer obj, see TList::GetObjectRef().
+
+TObject **TConcurrentHashList::GetObjectRef(const TObject *obj) const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::GetObjectRef(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the last object in the list.
+
+TObject *TConcurrentHashList::Last() const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::Last();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the last link of the list.
+
+TObjLink *TConcurrentHashList::LastLink() const
+{
+   R__READ_LOCKGUARD(GetMutex());
+
+   return THashList::LastLink();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// The list always protects itself, with its own lock rather than
+/// ROOT::gCoreMutex: nothing to do. Return true, as for a collection already
+/// set to use a RW lock.
+
+bool TConcurrentHashList::UseRWLock()
+{
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the list uses indexed cleanup, see SetIndexedCleanup().
+
+Bool_t TConcurrentHashList::IsIndexedCleanup() const
+{
+   return fIndex->fIndexedCleanup;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the objects of the list, and the ones added later, in the index
+/// used by RecursiveRemoveIndexed(), which removes a deleted object from the
+/// list without walking it. RecursiveRemove() of the list then only notifies
+/// the objects of the list which are not passive, see AddPassiveFilter().
+
+void TConcurrentHashList::SetIndexedCleanup()
+{
+   R__WRITE_LOCKGUARD(GetMutex());
+
+   if (fIndex->fIndexedCleanup) return;
+   fIndex->fIndexedCleanup = kTRUE;
+   for (TObjLink *lnk = fFirst.get(); lnk; lnk = lnk->Next()) {
+      if (TObject *obj = lnk->GetObject())
+         Register(obj);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add a filter telling whether an object added to a list with indexed
+/// cleanup is passive, i.e. holds no reference to other objects and needs
+/// not be notified of their deletion. The filters are only called when the
+/// object is added.
+
+void TConcurrentHashList::AddPassiveFilter(PassiveFilter_t filter)
+{
+   const Int_t i = gNPassiveFilters++;
+   if (i >= kMaxPassiveFilters) {
+      ::Error("TConcurrentHashList::AddPassiveFilter", "too many filters, at most %d are supported",
+              kMaxPassiveFilters);
+      return;
+   }
+   gPassiveFilters[i] = filter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove obj, which is being deleted, from all the lists with indexed
+/// cleanup holding it. Called by TROOT::RecursiveRemove() with the read lock
+/// of ROOT::gCoreMutex, which the destructor of such a list takes for writing.
+///
+/// The cost is proportional to the number of lists holding obj, not to the
+/// number of objects they hold.
+
+void TConcurrentHashList::RecursiveRemoveIndexed(TObject *obj)
+{
+   if (!obj) return;
+
+   std::vector<TConcurrentHashList *> lists;
+   GetHolders().Take(obj, lists);
+   for (auto list : lists)
+      list->RemoveHeld(obj);
+}
@@ -0,0 +1,201 @@
+#include "gtest/gtest.h"
+
+#include "TConcurrentHashList.h"
+#include "TNamed.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#include "TString.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TConcurrentHashList, Lookup)
+{
+   TConcurrentHashList list;
+   list.SetOwner();
+   for (int i = 0; i < 100; ++i)
+      list.Add(new TNamed(TString::Format("obj%d", i).Data(), ""));
+   EXPECT_EQ(list.GetSize(), 100);
+   auto obj42 = list.FindObject("obj42");
+   ASSERT_NE(obj42, nullptr);
+   EXPECT_STREQ(obj42->GetName(), "obj42");
+   EXPECT_EQ(list.FindObject(obj42), obj42);
+   EXPECT_EQ(list.FindObject("missing"), nullptr);
+
+   // Among objects of the same name, the one added before another is found first.
+   TNamed *cycle2 = new TNamed("obj42", "cycle 2");
+   list.AddBefore(obj42, cycle2);
+   EXPECT_EQ(list.FindObject("obj42"), cycle2);
+   std::vector<TObject *> cycles;
+   EXPECT_EQ(list.FindObjects("obj42", cycles), 2);
+   ASSERT_EQ(cycles.size(), 2u);
+   EXPECT_EQ(cycles[0], cycle2);
+   EXPECT_EQ(cycles[1], obj42);
+   cycles.clear();
+   EXPECT_EQ(list.FindObjects("missing", cycles), 0);
+   EXPECT_EQ(list.Remove(cycle2), cycle2);
+   delete cycle2;
+   EXPECT_EQ(list.FindObject("obj42"), obj42);
+
+   // Renamed objects are found after a rehash.
+   static_cast<TNamed *>(obj42)->SetName("renamed");
+   list.Rehash(list.GetSize());
+   EXPECT_EQ(list.FindObject("renamed"), obj42);
+   EXPECT_EQ(list.FindObject("obj42"), nullptr);
+
+   list.RemoveLast();
+   EXPECT_EQ(list.GetSize(), 99);
+   EXPECT_EQ(list.FindObject("obj99"), nullptr);
+
+   // An object equal to the one looked up is found too, with the lock.
+   TObjString *str = new TObjString("string");
+   list.Add(str);
+   TObjString equal("string");
+   EXPECT_EQ(list.FindObject(&equal), str);
+   EXPECT_EQ(list.FindObject(str), str);
+
+   list.Delete();
+   EXPECT_EQ(list.GetSize(), 0);
+   EXPECT_EQ(list.FindObject("obj1"), nullptr);
+   EXPECT_EQ(list.FindObject(&equal), nullptr);
+}
+
+TEST(TConcurrentHashList, ConcurrentReaders)
+{
+   ROOT::EnableThreadSafety();
+   TConcurrentHashList list;
+   list.SetOwner();
+   std::vector<TNamed *> stable;
+   for (int i = 0; i < 100; ++i) {
+      stable.push_back(new TNamed(TString::Format("stable%d", i).Data(), ""));
+      list.Add(stable.back());
+   }
+
+   std::atomic<bool> done(false);
+   std::atomic<int> errors(0);
+   std::vector<std::thread> readers;
+   for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([&]() {
+         while (!done) {
+            for (int i = 0; i < 100; ++i) {
+               if (list.FindObject(TString::Format("stable%d", i)) != stable[i])
+                  ++errors;
+            }
+         }
+      });
+   }
+   // Insertions, growing the lookup table, and removals while reading.
+   for (int round = 0; round < 20; ++round) {
+      std::vector<TNamed *> transient;
+      for (int i = 0; i < 500; ++i) {
+         transient.push_back(new TNamed(TString::Format("transient%d", i).Data(), ""));
+         list.Add(transient.back());
+      }
+      for (auto obj : transient) {
+         list.Remove(obj);
+         delete obj;
+      }
+   }
+   done = true;
+   for (auto &thr : readers)
+      thr.join();
+   EXPECT_EQ(errors, 0);
+   EXPECT_EQ(list.GetSize(), 100);
+}
+
+// The lookups without lock do not use the objects of the list: other threads
+// may delete the objects they have removed from it meanwhile. The reads of
+// deleted objects, if any, are reported by the address sanitizer.
+TEST(TConcurrentHashList, DeleteWhileFinding)
+{
+   ROOT::EnableThreadSafety();
+   TConcurrentHashList list;
+   list.SetOwner();
+   std::vector<TNamed *> stable;
+   for (int i = 0; i < 50; ++i) {
+      stable.push_back(new TNamed(TString::Format("stable%d", i).Data(), ""));
+      list.Add(stable.back());
+   }
+
+   std::atomic<bool> done(false);
+   std::atomic<int> errors(0);
+   std::vector<std::thread> readers;
+   for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([&]() {
+         std::vector<TObject *> found;
+         while (!done) {
+            for (int i = 0; i < 50; ++i) {
+               const TString name = TString::Format("transient%d", i);
+               list.FindObject(name);
+               found.clear();
+               list.FindObjects(name, found);
+               if (list.FindObject(stable[i]) != stable[i])
+                  ++errors;
+            }
+         }
+      });
+   }
+   for (int round = 0; round < 50; ++round) {
+      std::vector<TNamed *> transient;
+      for (int i = 0; i < 200; ++i) {
+         transient.push_back(new TNamed(TString::Format("transient%d", i % 50).Data(), ""));
+         list.Add(transient.back());
+      }
+      for (auto obj : transient) {
+         list.Remove(obj);
+         // Overwritten before being freed, as the memory may be reused.
+         obj->SetName("deleted");
+         delete obj;
+      }
+   }
+   done = true;
+   for (auto &thr : readers)
+      thr.join();
+   EXPECT_EQ(errors, 0);
+   EXPECT_EQ(list.GetSize(), 50);
+   EXPECT_EQ(list.FindObject("transient0"), nullptr);
+}
+
+TEST(TConcurrentHashList, IndexedCleanup)
+{
+   TConcurrentHashList list;
+   list.SetIndexedCleanup();
+   EXPECT_TRUE(list.IsIndexedCleanup());
+
+   std::vector<TNamed *> objects;
+   for (int i = 0; i < 10; ++i) {
+      objects.push_back(new TNamed(TString::Format("obj%d", i).Data(), ""));
+      objects.back()->SetBit(kMustCleanup);
+      list.Add(objects.back());
+   }
+   // A listener: notified of the deletions when the list is reached from
+   // the cleanup collections, unlike the passive named objects.
+   TList listener;
+   listener.SetName("listener");
+   listener.Add(objects[1]);
+   list.Add(&listener);
+   gROOT->GetListOfCleanups()->Add(&list);
+
+   // Deleting an object removes it from the lists holding it, through gROOT.
+   delete objects[0];
+   EXPECT_EQ(list.GetSize(), 10);
+   EXPECT_EQ(list.FindObject("obj0"), nullptr);
+   delete objects[1];
+   EXPECT_EQ(list.FindObject("obj1"), nullptr);
+   EXPECT_EQ(listener.GetSize(), 0);
+
+   // Objects added before indexed cleanup was set are indexed too.
+   TConcurrentHashList other;
+   other.Add(objects[2]);
+   other.SetIndexedCleanup();
+   delete objects[2];
+   EXPECT_EQ(other.GetSize(), 0);
+   EXPECT_EQ(list.GetSize(), 8);
+
+   gROOT->GetListOfCleanups()->Remove(&list);
+   list.Remove(&listener);
+   for (int i = 3; i < 10; ++i)
+      delete objects[i];
+   EXPECT_EQ(list.GetSize(), 0);
+}
@@ -394,7 +394,7 @@ void TClassEdit::TSplitType::ShortType(std::string &answ, int mode)
          continue;
       }
       fElements[i] = TClassEdit::ShortType(fElements[i].c_str(),mode | TClassEdit::kKeepOuterConst);
-      if (mode&kResolveTypedef) {
+      if ((mode&kResolveTypedef) && gInterpreterHelper) {
          // We 'just' need to check whether the outer type is a typedef or not;
          // this also will add the default template parameter if any needs to
          // be added.
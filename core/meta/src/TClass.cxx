@@ -90,6 +90,7 @@ a 'using namespace std;' has been applied to and with:
 #include <assert.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 #include "TSpinLockGuard.h"
 
@@ -416,6 +417,128 @@ namespace ROOT {
    };
 }
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Concurrent map from a name (class name or type_info name) to a TClass.
+   ///
+   /// It mirrors the list of classes and the IdMap so that the classes which are
+   /// already known can be found without taking any lock. Lookups probe an
+   /// open-addressing table whose slots are only ever filled, never emptied or
+   /// moved; removing a class only resets the TClass pointer of its entry.
+   /// Updates are serialized. When the table is half full, its entries are
+   /// copied to a table twice as large which is then published. The old tables
+   /// and the entries are never deleted, so that a concurrent lookup can always
+   /// complete; their size is bounded by the number of distinct names ever
+   /// registered.
+
+   class TClassLookupTable {
+   private:
+      struct TEntry {
+         TEntry(const char *name, UInt_t hash) : fName(name), fHash(hash) {}
+         const std::string fName;
+         const UInt_t fHash;
+         std::atomic<TClass *> fClass{nullptr};
+      };
+
+      struct TTable {
+         explicit TTable(size_t size) : fMask(size - 1), fSlots(new std::atomic<TEntry *>[size])
+         {
+            for (size_t i = 0; i < size; ++i)
+               fSlots[i].store(nullptr, std::memory_order_relaxed);
+         }
+         const size_t fMask;
+         std::unique_ptr<std::atomic<TEntry *>[]> fSlots;
+         size_t fUsed = 0;
+         TTable *fPrevious = nullptr; // Retired table, possibly still used by a lookup.
+      };
+
+      std::atomic<TTable *> fTable;
+      std::mutex fWriteMutex;
+
+      static UInt_t Hash(const char *name) { return TString::Hash(name, strlen(name)); }
+
+      static TEntry *FindEntry(const TTable &table, const char *name, UInt_t hash)
+      {
+         for (size_t i = hash & table.fMask;; i = (i + 1) & table.fMask) {
+            TEntry *entry = table.fSlots[i].load(std::memory_order_acquire);
+            if (!entry || (entry->fHash == hash && entry->fName == name))
+               return entry;
+         }
+      }
+
+      static void Insert(TTable &table, TEntry *entry)
+      {
+         size_t i = entry->fHash & table.fMask;
+         while (table.fSlots[i].load(std::memory_order_relaxed))
+            i = (i + 1) & table.fMask;
+         table.fSlots[i].store(entry, std::memory_order_release);
+         ++table.fUsed;
+      }
+
+   public:
+      TClassLookupTable() : fTable(new TTable(1024)) {}
+
+      /// Return the TClass registered under name, without locking.
+      TClass *Find(const char *name) const
+      {
+         const TTable *table = fTable.load(std::memory_order_acquire);
+         TEntry *entry = FindEntry(*table, name, Hash(name));
+         return entry ? entry->fClass.load(std::memory_order_acquire) : nullptr;
+      }
+
+      /// Register cl under name. An existing registration is kept unless replace is true.
+      void Add(const char *name, TClass *cl, Bool_t replace)
+      {
+         std::lock_guard<std::mutex> lock(fWriteMutex);
+         TTable *table = fTable.load(std::memory_order_relaxed);
+         const UInt_t hash = Hash(name);
+         TEntry *entry = FindEntry(*table, name, hash);
+         if (entry) {
+            if (replace || !entry->fClass.load(std::memory_order_relaxed))
+               entry->fClass.store(cl, std::memory_order_release);
+            return;
+         }
+         if (2 * (table->fUsed + 1) > table->fMask + 1) {
+            TTable *larger = new TTable(2 * (table->fMask + 1));
+            for (size_t i = 0; i <= table->fMask; ++i) {
+               if (TEntry *moved = table->fSlots[i].load(std::memory_order_relaxed))
+                  Insert(*larger, moved);
+            }
+            larger->fPrevious = table;
+            fTable.store(larger, std::memory_order_release);
+            table = larger;
+         }
+         entry = new TEntry(name, hash);
+         entry->fClass.store(cl, std::memory_order_relaxed);
+         Insert(*table, entry);
+      }
+
+      /// Unregister the class registered under name, if it is cl (or if cl is null).
+      void Remove(const char *name, TClass *cl)
+      {
+         std::lock_guard<std::mutex> lock(fWriteMutex);
+         const TTable *table = fTable.load(std::memory_order_relaxed);
+         TEntry *entry = FindEntry(*table, name, Hash(name));
+         if (entry && (!cl || entry->fClass.load(std::memory_order_relaxed) == cl))
+            entry->fClass.store(nullptr, std::memory_order_release);
+      }
+   };
+
+   /// Lock-free index of the list of classes, by class name.
+   TClassLookupTable &GetClassNameLookup()
+   {
+      static TClassLookupTable *gClassNameLookup = new TClassLookupTable;
+      return *gClassNameLookup;
+   }
+
+   /// Lock-free index of the IdMap, by type_info name.
+   TClassLookupTable &GetTypeInfoLookup()
+   {
+      static TClassLookupTable *gTypeInfoLookup = new TClassLookupTable;
+      return *gTypeInfoLookup;
+   }
+}
+
 IdMap_t *TClass::GetIdMap() {
 
 #ifdef R__COMPLETE_MEM_TERMINATION
@@ -447,8 +570,11 @@ void TClass::AddClass(TClass *cl)
 
    R__LOCKGUARD(gInterpreterMutex);
    gROOT->GetListOfClasses()->Add(cl);
+   // Like THashTable::FindObject, the lookup returns the first class added with a given name.
+   GetClassNameLookup().Add(cl->GetName(), cl, kFALSE);
    if (cl->GetTypeInfo()) {
       GetIdMap()->Add(cl->GetTypeInfo()->name(),cl);
+      GetTypeInfoLookup().Add(cl->GetTypeInfo()->name(), cl, kTRUE);
    }
    if (cl->fClassInfo) {
       GetDeclIdMap()->Add((void*)(cl->fClassInfo), cl);
@@ -473,8 +599,10 @@ void TClass::RemoveClass(TClass *oldcl)
 
    R__LOCKGUARD(gInterpreterMutex);
    gROOT->GetListOfClasses()->Remove(oldcl);
+   GetClassNameLookup().Remove(oldcl->GetName(), oldcl);
    if (oldcl->GetTypeInfo()) {
       GetIdMap()->Remove(oldcl->GetTypeInfo()->name());
+      GetTypeInfoLookup().Remove(oldcl->GetTypeInfo()->name(), nullptr);
    }
    if (oldcl->fClassInfo) {
       //GetDeclIdMap()->Remove((void*)(oldcl->fClassInfo));
@@ -1381,7 +1509,12 @@ void TClass::Init(const char *name, Version_t cversion,
 
    Bool_t isStl = TClassEdit::IsSTLCont(fName);
 
-   if (!gInterpreter)
+   // When the interpreter is created on first use, a class with a compiled
+   // dictionary gets its interpreter information only when it is needed
+   // (see LoadClassInfo()): streaming it may not need the interpreter at all.
+   const Bool_t deferClassInfo = !givenInfo && fState == kHasTClassInit && !gCling && ROOT::IsLazyInterpreterEnabled();
+
+   if (!deferClassInfo && !gInterpreter)
       ::Fatal("TClass::Init", "gInterpreter not initialized");
 
    if (givenInfo) {
@@ -1428,7 +1561,7 @@ void TClass::Init(const char *name, Version_t cversion,
             fHasRootPcmInfo = kTRUE;
          }
       }
-      if (!fHasRootPcmInfo && gInterpreter->CheckClassInfo(fName, /* autoload = */ kTRUE)) {
+      if (!fHasRootPcmInfo && !deferClassInfo && gInterpreter->CheckClassInfo(fName, /* autoload = */ kTRUE)) {
          gInterpreter->SetClassInfo(this);   // sets fClassInfo pointer
          if (fClassInfo) {
             // This should be moved out of GetCheckSum itself however the last time
@@ -2894,14 +3027,25 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
 
    if (!gROOT->GetListOfClasses())  return 0;
 
+   // Classes which are already loaded are found without taking any lock.
+   TClass *cl = GetClassNameLookup().Find(name);
+   if (cl && (cl->IsLoaded() || cl->TestBit(kUnloading))) return cl;
+
    // FindObject will take the read lock before actually getting the
    // TClass pointer so we will need not get a partially initialized
    // object.
-   TClass *cl = (TClass*)gROOT->GetListOfClasses()->FindObject(name);
+   cl = (TClass*)gROOT->GetListOfClasses()->FindObject(name);
 
    // Early return to release the lock without having to execute the
    // long-ish normalization.
-   if (cl && (cl->IsLoaded() || cl->TestBit(kUnloading))) return cl;
+   if (cl && (cl->IsLoaded() || cl->TestBit(kUnloading))) {
+      // The lookup table missed it: this happens when the class shared its name
+      // with another TClass that was removed since. Register it again.
+      R__LOCKGUARD(gInterpreterMutex);
+      if (gROOT->GetListOfClasses()->FindObject(name) == cl)
+         GetClassNameLookup().Add(name, cl, kTRUE);
+      return cl;
+   }
 
    R__WRITE_LOCKGUARD(ROOT::gCoreMutex);
 
@@ -2954,9 +3098,12 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
    Bool_t checkTable = kFALSE;
 
    if (!cl) {
-      int oldAutoloadVal = gCling->SetClassAutoloading(false);
+      // gCling, not gInterpreter: an interpreter created on first use is not
+      // needed to normalize the name.
+      int oldAutoloadVal = gCling ? gCling->SetClassAutoloading(false) : 0;
       TClassEdit::GetNormalizedName(normalizedName, name);
-      gCling->SetClassAutoloading(oldAutoloadVal);
+      if (gCling)
+         gCling->SetClassAutoloading(oldAutoloadVal);
       // Try the normalized name.
       if (normalizedName != name) {
          cl = (TClass*)gROOT->GetListOfClasses()->FindObject(normalizedName.c_str());
@@ -3107,10 +3254,14 @@ TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /*
    if (!gROOT->GetListOfClasses())
       return 0;
 
+   // Classes which are already loaded are found without taking any lock.
+   TClass* cl = GetTypeInfoLookup().Find(typeinfo.name());
+   if (cl && cl->IsLoaded()) return cl;
+
    //protect access to TROOT::GetIdMap
    R__READ_LOCKGUARD(ROOT::gCoreMutex);
 
-   TClass* cl = GetIdMap()->Find(typeinfo.name());
+   cl = GetIdMap()->Find(typeinfo.name());
 
    if (cl && cl->IsLoaded()) return cl;
 
@@ -3158,8 +3309,9 @@ TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /*
       }
    }
 
-   // try autoloading the typeinfo
-   int autoload_old = gCling->SetClassAutoloading(1);
+   // try autoloading the typeinfo. An interpreter created on first use is
+   // only created by the autoloading itself.
+   int autoload_old = gCling ? gCling->SetClassAutoloading(1) : 1;
    if (!autoload_old) {
       // Re-disable, we just meant to test
       gCling->SetClassAutoloading(0);
@@ -45,6 +45,9 @@ TInterpreter *TInterpreter::Instance()
       if (!getROOT) {
          ::Fatal("TInterpreter::Instance","TROOT object is required before accessing a TInterpreter");
       }
+      // With ROOT::EnableLazyInterpreter(), this is its first use.
+      if (gInterpreterLocal == 0)
+         ROOT::Internal::InitDeferredInterpreter();
    }
    if (gPtr2Interpreter) return gPtr2Interpreter();
    return gInterpreterLocal;
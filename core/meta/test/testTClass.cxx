@@ -1,9 +1,14 @@
 #include "TClass.h"
 #include "THashTable.h"
 #include "TInterpreter.h"
+#include "TNamed.h"
+#include "TROOT.h"
 
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
 TEST(TClass, DictCheck)
 {
    gInterpreter->ProcessLine(".L stlDictCheck.h+");
@@ -22,3 +27,40 @@ TEST(TClass, DictCheck)
 
    EXPECT_STREQ(errMsg.c_str(), "Missing dictionary for C, ") << errMsg;
 }
+
+TEST(TClass, ConcurrentLookup)
+{
+   ROOT::EnableThreadSafety();
+   TClass *named = TClass::GetClass("TNamed");
+   ASSERT_NE(named, nullptr);
+   EXPECT_EQ(TClass::GetClass(typeid(TNamed)), named);
+
+   std::vector<std::thread> threads;
+   std::vector<int> failures(8, 0);
+   for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&failures, named, t]() {
+         for (int i = 0; i < 10000; ++i) {
+            if (TClass::GetClass("TNamed") != named || TClass::GetClass(typeid(TNamed)) != named)
+               ++failures[t];
+         }
+      });
+   }
+   for (auto &thr : threads)
+      thr.join();
+   for (int t = 0; t < 8; ++t)
+      EXPECT_EQ(failures[t], 0);
+}
+
+TEST(TClass, LookupAfterRemoval)
+{
+   TClass *named = TClass::GetClass("TNamed");
+   auto clone = static_cast<TClass *>(named->Clone("TNamedLookupClone"));
+   ASSERT_NE(clone, nullptr);
+   EXPECT_EQ(TClass::GetClass("TNamedLookupClone", kFALSE), clone);
+   EXPECT_EQ(TClass::GetClass("TNamed"), named);
+   EXPECT_EQ(TClass::GetClass(typeid(TNamed)), named);
+
+   delete clone;
+   EXPECT_EQ(TClass::GetClass("TNamedLookupClone", kFALSE), nullptr);
+   EXPECT_EQ(TClass::GetClass("TNamed"), named);
+}
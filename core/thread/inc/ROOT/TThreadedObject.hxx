@@ -85,6 +85,23 @@ namespace ROOT {
             }
          };
 
+         /// Prepare an object to be shared by all the slots, if its class supports it:
+         /// histograms are filled concurrently (see TH1::SetConcurrentFill).
+         template<class T, bool ISHISTO = std::is_base_of<TH1,T>::value>
+         struct Sharer{
+            static bool Share(T *) {
+               return false;
+            }
+         };
+
+         template<class T>
+         struct Sharer<T, true>{
+            static bool Share(T *obj) {
+               obj->SetConcurrentFill();
+               return obj->IsConcurrentFill();
+            }
+         };
+
          template<class T, bool ISHISTO = std::is_base_of<TH1,T>::value>
          struct DirCreator{
             static std::vector<TDirectory*> Create(unsigned maxSlots) {
@@ -147,6 +164,10 @@ namespace ROOT {
     * manually via the fgMaxSlots parameter. The size of individual instances
     * is automatically extended if the size of the implicit MT pool is bigger
     * than 64.
+    * For the classes which can be used by several threads at once, e.g. the
+    * histograms which can be filled concurrently, SetShared() replaces the
+    * thread private objects by a single one shared by all the slots: the memory
+    * used does not grow with the number of threads.
     *
     */
    template<class T>
@@ -186,6 +207,30 @@ namespace ROOT {
          return objPointer;
       }
 
+      /// Let all the slots share a single object, a copy of the model, instead of
+      /// creating one object per slot. Only the objects which can be used by
+      /// several threads at once can be shared: histograms are filled concurrently
+      /// (see TH1::SetConcurrentFill). Must be called before any slot is accessed.
+      /// Returns false if the objects cannot be shared.
+      bool SetShared()
+      {
+         if (fShared) return true;
+         for (auto &objPointer : fObjPointers) {
+            if (objPointer) {
+               Warning("TThreadedObject::SetShared", "The objects of some slots were already created.");
+               return false;
+            }
+         }
+         std::shared_ptr<T> shared(Internal::TThreadedObjectUtils::Cloner<T>::Clone(fModel.get(), fDirectories[0]));
+         if (!Internal::TThreadedObjectUtils::Sharer<T>::Share(shared.get())) {
+            Warning("TThreadedObject::SetShared", "The objects cannot be shared between threads.");
+            return false;
+         }
+         fShared = shared;
+         for (auto &objPointer : fObjPointers) objPointer = fShared;
+         return true;
+      }
+
       /// Set the value of a particular slot.
       void SetAtSlot(unsigned i, std::shared_ptr<T> v)
       {
@@ -247,6 +292,11 @@ namespace ROOT {
             Warning("TThreadedObject::Merge", "This object was already merged. Returning the previous result.");
             return fObjPointers[0];
          }
+         // A shared object holds the contributions of all the slots already.
+         if (fShared) {
+            fIsMerged = true;
+            return fShared;
+         }
          mergeFunction(fObjPointers[0], fObjPointers);
          fIsMerged = true;
          return fObjPointers[0];
@@ -262,6 +312,8 @@ namespace ROOT {
             Warning("TThreadedObject::SnapshotMerge", "This object was already merged. Returning the previous result.");
             return std::unique_ptr<T>(Internal::TThreadedObjectUtils::Cloner<T>::Clone(fObjPointers[0].get()));
          }
+         if (fShared)
+            return std::unique_ptr<T>(Internal::TThreadedObjectUtils::Cloner<T>::Clone(fShared.get()));
          auto targetPtr = Internal::TThreadedObjectUtils::Cloner<T>::Clone(fModel.get());
          std::shared_ptr<T> targetPtrShared(targetPtr, [](T *) {});
          mergeFunction(targetPtrShared, fObjPointers);
@@ -272,6 +324,7 @@ namespace ROOT {
       unsigned fMaxSlots;                                ///< The size of the instance
       std::unique_ptr<T> fModel;                         ///< Use to store a "model" of the object
       std::vector<std::shared_ptr<T>> fObjPointers;      ///< A pointer per thread is kept.
+      std::shared_ptr<T> fShared;                        ///< The object shared by all the slots, if any
       std::vector<TDirectory*> fDirectories;             ///< A TDirectory per thread is kept.
       std::map<std::thread::id, unsigned> fThrIDSlotMap; ///< A mapping between the thread IDs and the slots
       unsigned fCurrMaxSlotIndex = 0;                    ///< The maximum slot index
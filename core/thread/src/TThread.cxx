@@ -337,9 +337,10 @@ void TThread::Init()
 
    // Create the single global mutex
    gGlobalMutex = new TMutex(kTRUE);
-   // We need to make sure that gCling is initialized.
-   TInterpreter::Instance()->SetAlloclockfunc(CINT_alloc_lock);
-   gCling->SetAllocunlockfunc(CINT_alloc_unlock);
+   // We need to make sure that gCling is initialized. If it is created on
+   // first use (see ROOT::EnableLazyInterpreter()), the functions are
+   // installed when it is.
+   ROOT::Internal::SetInterpreterAllocLock(CINT_alloc_lock, CINT_alloc_unlock);
 
    // To avoid deadlocks, gInterpreterMutex and gROOTMutex need
    // to point at the same instance.
@@ -126,3 +126,25 @@ TEST(TThreadedObject, SnapshotMerge)
    IsSameHist(*hsum1, *hsum0);
    EXPECT_TRUE(hsum1 != hsum0);
 }
+
+TEST(TThreadedObject, SetShared)
+{
+   TH1::AddDirectory(false);
+
+   TH1F m0("h", "h", 64, -4, 4);
+   gRandom->SetSeed(1);
+   m0.FillRandom("gaus", 100);
+   m0.FillRandom("gaus", 100);
+
+   ROOT::TThreadedObject<TH1F> tto("h", "h", 64, -4, 4);
+   EXPECT_TRUE(tto.SetShared());
+   EXPECT_EQ(tto.GetAtSlot(0), tto.GetAtSlot(1));
+   EXPECT_TRUE(tto.GetAtSlot(0)->IsConcurrentFill());
+   gRandom->SetSeed(1);
+   tto.GetAtSlot(0)->FillRandom("gaus", 100);
+   tto.GetAtSlot(1)->FillRandom("gaus", 100);
+   IsSameHist(*tto.SnapshotMerge(), m0);
+   auto hsum = tto.Merge();
+   IsSameHist(*hsum, m0);
+   EXPECT_DOUBLE_EQ(hsum->GetEntries(), m0.GetEntries());
+}
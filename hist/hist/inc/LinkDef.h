@@ -157,6 +157,7 @@
 #pragma link C++ class TProfile-;
 #pragma link C++ class TProfile2D-;
 #pragma link C++ class TProfile3D+;
+#pragma link C++ class TQuantileSketch+;
 #pragma link C++ class TSpline-;
 #pragma link C++ class TSpline5-;
 #pragma link C++ class TSpline3-;
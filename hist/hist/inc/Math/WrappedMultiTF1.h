@@ -122,6 +122,9 @@ namespace ROOT {
          // evaluate the derivative of the function with respect to the parameters
          void ParameterGradient(const T *x, const double *par, T *grad) const;
 
+         /// evaluate the function at n points, whose coordinates are stored by dimension
+         void EvalBatch(const T *x, T *out, std::size_t n, const double *p) const;
+
          /// precision value used for calculating the derivative step-size
          /// h = eps * |x|. The default is 0.001, give a smaller in case function changes rapidly
          static void SetDerivPrecision(double eps);
@@ -175,6 +178,24 @@ namespace ROOT {
 
       };
 
+      template<class T>
+      void WrappedMultiTF1Templ<T>::EvalBatch(const T *x, T *out, std::size_t n, const double *p) const
+      {
+         // TF1 evaluates batches of points of type double only
+         ROOT::Math::IParametricFunctionMultiDimTempl<T>::EvalBatch(x, out, n, p);
+      }
+
+      template<>
+      inline void WrappedMultiTF1Templ<double>::EvalBatch(const double *x, double *out, std::size_t n, const double *p) const
+      {
+         // the TF1 reads the coordinates of its own dimension
+         if (fDim != (unsigned int)fFunc->GetNdim()) {
+            ROOT::Math::IParametricFunctionMultiDimTempl<double>::EvalBatch(x, out, n, p);
+            return;
+         }
+         fFunc->EvalBatch(x, out, n, p);
+      }
+
       /**
        * Auxiliar class to bypass the (provisional) lack of vectorization in TFormula::EvalPar.
        *
@@ -2,6 +2,7 @@
 #define ROOT_TEfficiency
 
 //standard header
+#include <memory>
 #include <vector>
 #include <utility>
 
@@ -26,6 +27,9 @@ class TList;
 
 class TEfficiency: public TNamed, public TAttLine, public TAttFill, public TAttMarker
 {
+private:
+      struct TIntervalCache;
+
 public:
       //enumaration type for different statistic options for calculating confidence intervals
       //kF* ... frequentist methods; kB* ... bayesian methods
@@ -51,6 +55,7 @@ protected:
       Double_t      fConfLevel;              //confidence level (default = 0.683, 1 sigma)
       TDirectory*   fDirectory;              //!pointer to directory holding this TEfficiency object
       TList*        fFunctions;              //->pointer to list of functions
+      mutable std::shared_ptr<const TIntervalCache> fIntervalCache; //!errors of all the bins computed by ComputeIntervals, accessed atomically
       TGraphAsymmErrors* fPaintGraph;        //!temporary graph for painting
       TH2*          fPaintHisto;             //!temporary histogram for painting
       TH1*          fPassedHistogram;        //histogram for events which passed certain criteria
@@ -67,6 +72,8 @@ protected:
       };
 
       void          Build(const char* name,const char* title);
+      void          ComputeErrors(Int_t bin,Double_t& low,Double_t& up) const;
+      Bool_t        FindCachedErrors(Int_t bin,Double_t& low,Double_t& up) const;
       void          FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const;
       void          FillHistogram(TH2 * h2) const;
 
@@ -93,6 +100,7 @@ public:
 
       void          Add(const TEfficiency& rEff) {*this += rEff;}
       void          Browse(TBrowser*){Draw();}
+      void          ComputeIntervals() const;
       TGraphAsymmErrors*   CreateGraph(Option_t * opt = "") const;
       TH2*          CreateHistogram(Option_t * opt = "") const;
       virtual Int_t DistancetoPrimitive(Int_t px, Int_t py);
@@ -18,6 +18,7 @@
 #include "TObjArray.h"
 #include "TMethodCall.h"
 #include "TInterpreter.h"
+#include <atomic>
 #include <vector>
 #include <list>
 #include <map>
@@ -102,6 +103,8 @@ private:
    std::string       fGradGenerationInput; //! input query to clad to generate a gradient
    CallFuncSignature fFuncPtr; //!  function pointer, owned by the JIT.
    CallFuncSignature fGradFuncPtr; //!  function pointer, owned by the JIT.
+   mutable std::atomic<CallFuncSignature> fBatchFuncPtr{nullptr}; //! pointer to the loop over points, owned by the JIT
+   mutable std::atomic<Bool_t> fBatchFailed{kFALSE}; //! flag set when the loop over points cannot be compiled
    static bool       fIsCladRuntimeIncluded;
    void *   fLambdaPtr;                                    //!  pointer to the lambda function
 
@@ -127,6 +130,7 @@ private:
    bool HasGradientGenerationFailed() const {
       return !fGradMethod && !fGradGenerationInput.empty();
    }
+   CallFuncSignature GetBatchFuncPtr() const;
 
 protected:
 
@@ -192,6 +196,7 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalBatch(const Double_t *x, Double_t *out, size_t n, const Double_t *params=0) const;
 
    /// Generate gradient computation routine with respect to the parameters.
    /// \returns true if a gradient was generated and GradientPar can be called.
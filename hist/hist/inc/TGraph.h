@@ -38,8 +38,18 @@ class TSpline;
 
 #include "TFitResultPtr.h"
 
+#include <atomic>
+
 class TGraph : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
+private:
+   struct TEvalIndex;
+
+   Bool_t             fIndexedEval = kFALSE;                 ///<!Eval looks up the points in fEvalIndex
+   mutable std::atomic<TEvalIndex *> fEvalIndex{nullptr};    ///<!Points sorted in X for Eval, built at the first Eval
+
+   const TEvalIndex  *GetEvalIndex() const;
+
 protected:
 
    Int_t              fMaxSize;   ///<!Current dimension of arrays fX and fY
@@ -63,6 +73,7 @@ protected:
    virtual void       FillZero(Int_t begin, Int_t end, Bool_t from_ctor = kTRUE);
    Double_t         **ShrinkAndCopy(Int_t size, Int_t iend);
    virtual Bool_t     DoMerge(const TGraph * g);
+   void               ResetEvalIndex();
 
 public:
    // TGraph status bits
@@ -103,6 +114,7 @@ public:
    virtual void          DrawGraph(Int_t n, const Double_t *x=0, const Double_t *y=0, Option_t *option="");
    virtual void          DrawPanel(); // *MENU*
    virtual Double_t      Eval(Double_t x, TSpline *spline=0, Option_t *option="") const;
+   virtual void          Eval(Int_t n, const Double_t *x, Double_t *y, TSpline *spline=0, Option_t *option="") const;
    virtual void          ExecuteEvent(Int_t event, Int_t px, Int_t py);
    virtual void          Expand(Int_t newsize);
    virtual void          Expand(Int_t newsize, Int_t step);
@@ -153,6 +165,7 @@ public:
    virtual Double_t      Integral(Int_t first=0, Int_t last=-1) const;
    virtual Bool_t        IsEditable() const {return !TestBit(kNotEditable);}
    virtual Bool_t        IsHighlight() const { return TestBit(kIsHighlight); }
+   Bool_t                IsIndexedEval() const { return fIndexedEval; }
    virtual Int_t         IsInside(Double_t x, Double_t y) const;
    virtual void          LeastSquareFit(Int_t m, Double_t *a, Double_t xmin=0, Double_t xmax=0);
    virtual void          LeastSquareLinearFit(Int_t n, Double_t &a0, Double_t &a1, Int_t &ifail, Double_t xmin=0, Double_t xmax=0);
@@ -169,6 +182,7 @@ public:
    virtual void          SetEditable(Bool_t editable=kTRUE); // *TOGGLE* *GETTER=GetEditable
    virtual void          SetHighlight(Bool_t set = kTRUE); // *TOGGLE* *GETTER=IsHighlight
    virtual void          SetHistogram(TH1F *h) {fHistogram = h;}
+   void                  SetIndexedEval(Bool_t on = kTRUE);
    virtual void          SetMaximum(Double_t maximum=-1111); // *MENU*
    virtual void          SetMinimum(Double_t minimum=-1111); // *MENU*
    virtual void          Set(Int_t n);
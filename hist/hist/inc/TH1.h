@@ -118,6 +118,10 @@ public:
    static Int_t FitOptionsMake(Option_t *option, Foption_t &Foption);
 
 private:
+   struct TConcurrentFill;
+
+   TConcurrentFill *fConcurrentFill; ///<!State of the concurrent filling, see SetConcurrentFill
+
    Int_t   AxisChoice(Option_t *axis) const;
    void    Build();
 
@@ -145,6 +149,23 @@ protected:
                                Option_t * opt, Bool_t doerr = kFALSE) const;
 
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+   Int_t            FindBatchBin(TAxis &axis, Int_t i, Int_t n, const Double_t *x, Int_t *bins, Int_t stride);
+   virtual void     AddConcurrentStats(const Double_t *stats);
+   void             ConcurrentAddBinContent(Int_t bin, Double_t w);
+   void             ConcurrentAddStats(Double_t entries, const Double_t *stats, Int_t nstat);
+   void             FoldConcurrentFill();
+
+   // Folds the partial sums of a concurrent filling and keeps the statistics
+   // from being folded again while they are read, until destruction
+   class TConcurrentFillLock {
+      TConcurrentFill *fFill;
+   public:
+      TConcurrentFillLock(const TH1 *h);
+      ~TConcurrentFillLock();
+      TConcurrentFillLock(const TConcurrentFillLock &) = delete;
+      TConcurrentFillLock &operator=(const TConcurrentFillLock &) = delete;
+   };
+
    Bool_t    GetStatOverflowsBehaviour() const { return EStatOverflows::kNeutral == fStatOverflows ? fgStatOverflows : EStatOverflows::kConsider == fStatOverflows; }
 
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
@@ -176,7 +197,8 @@ public:
    // s[7]  = sumwz      s[8]  = sumwz2   s[9]  = sumwxz   s[10]  = sumwyz
    // s[11] = sumwt      s[12] = sumwt2                 (11 and 12 used only by TProfile3D)
    enum {
-      kNstat       = 13  // size of statistics data (up to TProfile3D)
+      kNstat       = 13, // size of statistics data (up to TProfile3D)
+      kNFillBatch  = 256 // number of entries whose bins are computed at once by FillN
    };
 
 
@@ -327,6 +349,7 @@ public:
    virtual Double_t Interpolate(Double_t x, Double_t y, Double_t z);
            Bool_t   IsBinOverflow(Int_t bin, Int_t axis = 0) const;
            Bool_t   IsBinUnderflow(Int_t bin, Int_t axis = 0) const;
+           Bool_t   IsConcurrentFill() const { return fConcurrentFill != 0; }
    virtual Bool_t   IsHighlight() const { return TestBit(kIsHighlight); }
    virtual Double_t AndersonDarlingTest(const TH1 *h2, Option_t *option="") const;
    virtual Double_t AndersonDarlingTest(const TH1 *h2, Double_t &advalue) const;
@@ -372,6 +395,7 @@ public:
    virtual void     SetBinErrorOption(EBinErrorOpt type) { fBinStatErrOpt = type; }
    virtual void     SetBuffer(Int_t buffersize, Option_t *option="");
    virtual UInt_t   SetCanExtend(UInt_t extendBitMask);
+           void     SetConcurrentFill(Bool_t on = kTRUE);
    virtual void     SetContent(const Double_t *content);
    virtual void     SetContour(Int_t nlevels, const Double_t *levels=0);
    virtual void     SetContourLevel(Int_t level, Double_t value);
@@ -22,6 +22,8 @@
 
 #include "TH2.h"
 
+#include <atomic>
+
 class TH2PolyBin: public TObject{
 
 public:
@@ -65,6 +67,14 @@ class TPad;
 
 class TH2Poly : public TH2 {
 
+private:
+   struct TBinIndex;
+
+   std::atomic<TBinIndex*> fBinIndex; //!Lookup structure of the bins, built on demand
+
+   TBinIndex *GetBinIndex();
+   void       ResetBinIndex();
+
 public:
    TH2Poly();
    TH2Poly(const char *name,const char *title, Double_t xlow, Double_t xup, Double_t ylow, Double_t yup);
@@ -35,11 +35,12 @@ class THnSparseCompactBinCoord;
 
 class THnSparse: public THnBase {
  private:
+   struct TBinTable;
+
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   TBinTable *fBins;         //! filled bins, by hash of their compact coordinates
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
@@ -60,6 +61,9 @@ class THnSparse: public THnBase {
    void FillExMap();
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
+   Long64_t GetBinIndexForBuffer(ULong64_t hash, const Char_t* buf, Bool_t allocate);
+   Long64_t FindBinIndexForBuffer(ULong64_t hash, const Char_t* buf) const;
+   void AddInternal(const THnBase* h, Double_t c, Bool_t rebinned);
 
    /// Increment the bin content of "bin" by "w",
    /// return the bin index.
@@ -126,6 +130,9 @@ class THnSparse: public THnBase {
 
    Double_t GetSparseFractionBins() const;
    Double_t GetSparseFractionMem() const;
+   Long64_t GetMemoryUsage() const;
+
+   void FillN(Int_t nevents, const Double_t* x, const Double_t* w = 0);
 
    /// Forwards to THnBase::Projection().
    /// Non-virtual, as a CINT-compatible replacement of a using
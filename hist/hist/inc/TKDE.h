@@ -94,6 +94,7 @@ public:
    void SetUseBinsNEvents(UInt_t nEvents);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
+   void SetEvaluationGrid(UInt_t npoints); // Interpolate the density on a grid of npoints over the range, 0 to evaluate it exactly
 
    virtual void Draw(const Option_t* option = "");
 
@@ -101,6 +102,7 @@ public:
    Double_t operator()(const Double_t* x, const Double_t* p=0) const;  // Needed for creating TF1
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
+   void GetValues(UInt_t n, const Double_t* x, Double_t* values) const;
    Double_t GetError(Double_t x) const;
 
    Double_t GetBias(Double_t x) const;
@@ -163,6 +165,7 @@ private:
    UInt_t fNEvents;        // Data's number of events
    Double_t fSumOfCounts; // Data sum of weights
    UInt_t fUseBinsNEvents; // If the algorithm is allowed to use binning this is the minimum number of events to do so
+   UInt_t fGridSize;       //! Number of points of the evaluation grid, 0 if the density is evaluated exactly
 
    Double_t fMean;  // Data mean
    Double_t fSigma; // Data std deviation
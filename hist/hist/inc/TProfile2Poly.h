@@ -69,6 +69,8 @@ public:
    using TH2Poly::Fill;
    virtual Int_t Fill(Double_t xcoord, Double_t ycoord, Double_t value) override;
    virtual Int_t Fill(Double_t xcoord, Double_t ycoord, Double_t value, Double_t weight);
+   virtual void FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *value,
+                      Int_t stride = 1) override;
 
    Long64_t Merge(const std::vector<TProfile2Poly *> &list);
    Long64_t Merge(TCollection *in) override;
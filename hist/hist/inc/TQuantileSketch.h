@@ -0,0 +1,75 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TQuantileSketch
+#define ROOT_TQuantileSketch
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TQuantileSketch                                                      //
+//                                                                      //
+// Streaming estimate of the quantiles of a set of values, in a memory  //
+// that does not depend on the number of values. Sketches filled        //
+// separately, for instance by different threads, can be merged.        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TObject.h"
+
+#include <utility>
+#include <vector>
+
+class TCollection;
+
+
+class TQuantileSketch : public TObject {
+
+private:
+   Int_t                               fK;       ///< Number of values kept at the top level, sets the accuracy
+   Long64_t                            fEntries; ///< Number of values filled
+   Double_t                            fMin;     ///< Smallest value filled
+   Double_t                            fMax;     ///< Largest value filled
+   std::vector<std::vector<Double_t> > fLevels;  ///< Values kept at each level, each one stands for 2^level values
+   Int_t                               fSize;    ///<! Number of values kept
+   Int_t                               fMaxSize; ///<! Number of values kept above which the sketch is compacted
+   ULong64_t                           fCoin;    ///<! State of the generator choosing the values promoted by a compaction
+
+   Int_t      GetCapacity(Int_t level) const;
+   void       Compact(Int_t level);
+   void       Compress();
+   void       GetCumulative(std::vector<std::pair<Double_t, Double_t> > &values) const;
+
+public:
+   TQuantileSketch(Int_t k = 200);
+   virtual    ~TQuantileSketch();
+
+   virtual void Clear(Option_t *option="");
+   void       Fill(Double_t x);
+   void       FillN(Long64_t n, const Double_t *x);
+   void       Merge(const TQuantileSketch &other);
+   virtual Long64_t Merge(TCollection *list);
+
+   Long64_t   GetEntries() const { return fEntries; }
+   Int_t      GetK() const { return fK; }
+   Double_t   GetMaximum() const { return fEntries ? fMax : 0; }
+   Double_t   GetMedian() const { return GetQuantile(0.5); }
+   Double_t   GetMinimum() const { return fEntries ? fMin : 0; }
+   Double_t   GetQuantile(Double_t prob) const;
+   Int_t      GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum=0) const;
+   void       GetRange(Double_t &xmin, Double_t &xmax, Double_t tail=0) const;
+   Double_t   GetRank(Double_t x) const;
+   Int_t      GetSize() const;
+   virtual void Print(Option_t *option="") const;
+
+   ClassDef(TQuantileSketch,1)  //Mergeable streaming estimate of quantiles
+};
+
+#endif
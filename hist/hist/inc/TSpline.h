@@ -14,6 +14,8 @@
 
 #include "TGraph.h"
 
+#include <vector>
+
 class TH1;
 class TF1;
 
@@ -196,13 +198,16 @@ protected:
    Double_t       fValEnd;     // End value of first or second derivative
    Int_t          fBegCond;    // 0=no beg cond, 1=first derivative, 2=second derivative
    Int_t          fEndCond;    // 0=no end cond, 1=first derivative, 2=second derivative
+   std::vector<Int_t> fKnotIndex; //! First knot of each cell of a uniform grid between fXmin and fXmax, empty if not indexed
+   Double_t       fKnotScale;  //! Number of cells of the grid per unit of abscissa
 
    void   BuildCoeff();
+   void   BuildKnotIndex();
    void   SetCond(const char *opt);
 
 public:
    TSpline3() : TSpline() , fPoly(0), fValBeg(0), fValEnd(0),
-      fBegCond(-1), fEndCond(-1) {}
+      fBegCond(-1), fEndCond(-1), fKnotScale(0) {}
    TSpline3(const char *title,
             Double_t x[], Double_t y[], Int_t n, const char *opt=0,
             Double_t valbeg=0, Double_t valend=0);
@@ -226,6 +231,7 @@ public:
    TSpline3& operator=(const TSpline3&);
    Int_t    FindX(Double_t x) const;
    Double_t Eval(Double_t x) const;
+   void     Eval(Int_t n, const Double_t *x, Double_t *y) const;
    Double_t Derivative(Double_t x) const;
    virtual ~TSpline3() {if (fPoly) delete [] fPoly;}
    void GetCoeff(Int_t i, Double_t &x, Double_t &y, Double_t &b,
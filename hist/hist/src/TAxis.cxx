@@ -420,6 +420,47 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bins of the n values x[0], x[stride], ... x[(n-1)*stride], as
+/// FindFixBin would, and store them in bins[0] ... bins[n-1].
+///
+/// The loops have no branch: for fix bins the compiler vectorizes the
+/// computation, for variable bins the bin edges are searched with the same
+/// number of steps for all the values.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   const Int_t nbins = fNbins;
+   if (!fXbins.fN) {        //*-* fix bins
+      const Double_t width = xmax - xmin;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t v = x[i*stride];
+         const Bool_t inside = v >= xmin && v < xmax;   // false for NaN
+         // out of range values are not converted to int
+         const Double_t vin = inside ? v : xmin;
+         const Int_t bin = 1 + int (nbins*(vin-xmin)/width);
+         bins[i] = inside ? bin : (v < xmin ? 0 : nbins+1);
+      }
+   } else {                  //*-* variable bin sizes
+      const Double_t *edges = fXbins.fArray;
+      const Int_t nedges = fXbins.fN;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t v = x[i*stride];
+         const Bool_t inside = v >= xmin && v < xmax;
+         // last edge lower or equal to v, as TMath::BinarySearch
+         const Double_t *low = edges;
+         for (Int_t len = nedges; len > 1; ) {
+            const Int_t half = len/2;
+            low = (low[half] <= v) ? low + half : low;
+            len -= half;
+         }
+         bins[i] = inside ? 1 + Int_t(low - edges) : (v < xmin ? 0 : nbins+1);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
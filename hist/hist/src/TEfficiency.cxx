@@ -6,7 +6,10 @@
 #include <string>
 #include <cmath>
 #include <stdlib.h>
+#include <string.h>
 #include <cassert>
+#include <algorithm>
+#include <memory>
 
 //ROOT headers
 #include "Math/DistFuncMathCore.h"
@@ -32,6 +35,11 @@
 // file with extra class for FC method
 #include "TEfficiencyHelper.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#endif
+
 //default values
 const Double_t kDefBetaAlpha = 1;
 const Double_t kDefBetaBeta = 1;
@@ -394,6 +402,18 @@ The average (over all possible true efficiencies) coverage probability for
 different number of total events is shown in the next picture.
 \image html av_cov.png "Average Coverage"
 
+## IV.2 Computing the intervals of all the bins
+The Clopper-Pearson, Feldman-Cousins, mid-P and Bayesian intervals need a root
+finding or a minimisation in each bin. TEfficiency::ComputeIntervals computes
+the lower and upper errors of all the bins at once: the bins with the same
+contents (and the same prior) share their interval, which is computed only
+once, and the computations are spread over the threads of the implicit
+multi-threading pool when it is enabled (ROOT::EnableImplicitMT). The errors are
+kept and returned by TEfficiency::GetEfficiencyErrorLow and
+TEfficiency::GetEfficiencyErrorUp for the bins whose contents did not change,
+as long as the statistic option, the confidence level and the prior are the
+same. Painting a 1-dimensional TEfficiency computes the intervals this way.
+
 ## V. Merging and combining TEfficiency objects
 In many applications, the efficiency should be calculated for an inhomogeneous
 sample in the sense that it contains events with different weights. In order
@@ -623,6 +643,7 @@ fBoundary(0),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fPassedHistogram(0),
@@ -661,6 +682,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -728,6 +750,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -767,6 +790,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -810,6 +834,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -853,6 +878,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -900,6 +926,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -947,6 +974,7 @@ fBeta_beta(kDefBetaBeta),
 fConfLevel(kDefConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(kDefWeight)
@@ -988,6 +1016,7 @@ fBeta_bin_params(rEff.fBeta_bin_params),
 fConfLevel(rEff.fConfLevel),
 fDirectory(0),
 fFunctions(0),
+fIntervalCache(),
 fPaintGraph(0),
 fPaintHisto(0),
 fWeight(rEff.fWeight)
@@ -1585,6 +1614,228 @@ Bool_t TEfficiency::CheckWeights(const TH1& pass,const TH1& total)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Errors of all the bins computed by TEfficiency::ComputeIntervals, with what
+/// they were computed from: the options and, for each bin, the contents of the
+/// bin in the total and passed histograms and its prior.
+
+struct TEfficiency::TIntervalCache {
+   enum { kNInputs = 6 };
+
+   EStatOption           fStatisticOption;  ///< Statistic option used
+   Double_t              fConfLevel;        ///< Confidence level used
+   UInt_t                fBits;             ///< Statistic bits used, see Bits()
+   std::vector<Double_t> fInputs;           ///< Total, passed, sums of squares of the weights and prior of each bin
+   std::vector<Double_t> fErrors;           ///< Lower and upper error of each bin
+
+   /// Bits of the efficiency changing its errors.
+   static UInt_t Bits(const TEfficiency &eff)
+   {
+      return eff.TestBits(kIsBayesian | kPosteriorMode | kShortestInterval | kUseBinPrior | kUseWeights);
+   }
+
+   /// Fill inputs with what the errors of bin depend on.
+   static void GetInputs(const TEfficiency &eff, Int_t bin, Double_t *inputs)
+   {
+      inputs[0] = eff.fTotalHistogram->GetBinContent(bin);
+      inputs[1] = eff.fPassedHistogram->GetBinContent(bin);
+      const Bool_t weights = eff.TestBit(kUseWeights);
+      inputs[2] = weights ? eff.fTotalHistogram->GetSumw2()->At(bin) : 0.;
+      inputs[3] = weights ? eff.fPassedHistogram->GetSumw2()->At(bin) : 0.;
+      const Bool_t binPrior = eff.TestBit(kUseBinPrior);
+      inputs[4] = binPrior ? eff.GetBetaAlpha(bin) : eff.GetBetaAlpha();
+      inputs[5] = binPrior ? eff.GetBetaBeta(bin) : eff.GetBetaBeta();
+   }
+
+   /// Whether the errors were computed with the current options of eff.
+   Bool_t IsValid(const TEfficiency &eff) const
+   {
+      return fStatisticOption == eff.fStatisticOption && fConfLevel == eff.fConfLevel && fBits == Bits(eff);
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the lower and upper errors on the efficiency in the given global
+/// bin, as GetEfficiencyErrorLow and GetEfficiencyErrorUp do, with a single
+/// search of the interval when both boundaries come from it.
+///
+/// With weights, the caller has to switch to the normal approximation first
+/// if a frequentist method is used.
+
+void TEfficiency::ComputeErrors(Int_t bin,Double_t& low,Double_t& up) const
+{
+   Double_t total = fTotalHistogram->GetBinContent(bin);
+   Double_t passed = fPassedHistogram->GetBinContent(bin);
+
+   Double_t eff = GetEfficiency(bin);
+
+   // parameters for the beta prior distribution
+   Double_t alpha = TestBit(kUseBinPrior) ? GetBetaAlpha(bin) : GetBetaAlpha();
+   Double_t beta  = TestBit(kUseBinPrior) ? GetBetaBeta(bin)  : GetBetaBeta();
+
+   Double_t lower = 0;
+   Double_t upper = 1;
+   if(TestBit(kUseWeights))
+   {
+      Double_t tw2 = fTotalHistogram->GetSumw2()->At(bin);
+      Double_t pw2 = fPassedHistogram->GetSumw2()->At(bin);
+
+      if(TestBit(kIsBayesian))
+      {
+         if (tw2 <= 0) {
+            low = up = 0;
+            return;
+         }
+
+         // tw/tw2 renormalize the weights
+         Double_t norm = total/tw2;
+         Double_t aa =  passed * norm + alpha;
+         Double_t bb =  (total - passed) * norm + beta;
+         if(TestBit(kShortestInterval)) {
+            TEfficiency::BetaShortestInterval(fConfLevel,aa,bb,lower,upper);
+         }
+         else {
+            lower = TEfficiency::BetaCentralInterval(fConfLevel,aa,bb,false);
+            upper = TEfficiency::BetaCentralInterval(fConfLevel,aa,bb,true);
+         }
+      }
+      else
+      {
+         // normal approximation
+         Double_t variance = ( pw2 * (1. - 2 * eff) + tw2 * eff *eff ) / ( total * total) ;
+         Double_t sigma = sqrt(variance);
+
+         Double_t prob = 0.5 * (1.- fConfLevel);
+         Double_t delta = ROOT::Math::normal_quantile_c(prob, sigma);
+
+         // avoid to return errors which makes eff-err < 0 or eff+err > 1
+         low = (eff - delta < 0) ? eff : delta;
+         up = (eff + delta > 1) ? 1.-eff : delta;
+         return;
+      }
+   }
+   else if(TestBit(kIsBayesian))
+   {
+      if(TestBit(kShortestInterval)) {
+         BetaShortestInterval(fConfLevel,passed+alpha,total-passed+beta,lower,upper);
+      }
+      else {
+         lower = Bayesian(total,passed,fConfLevel,alpha,beta,false,false);
+         upper = Bayesian(total,passed,fConfLevel,alpha,beta,true,false);
+      }
+   }
+   else if(fBoundary == &FeldmanCousins)
+   {
+      // both boundaries come from the same Neyman construction
+      if (!FeldmanCousinsInterval(total,passed,fConfLevel,lower,upper))
+         ::Error("FeldmanCousins","Error running FC method - return 0 or 1");
+   }
+   else
+   {
+      lower = fBoundary(total,passed,fConfLevel,false);
+      upper = fBoundary(total,passed,fConfLevel,true);
+   }
+   low = eff - lower;
+   up = upper - eff;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the lower and upper errors on the efficiency in all the bins,
+/// including the under- and overflow bins.
+///
+/// The bins having the same contents and the same prior share their interval,
+/// which is computed only once. The intervals are computed in parallel when
+/// the implicit multi-threading is enabled. The errors are kept:
+/// GetEfficiencyErrorLow(bin) and GetEfficiencyErrorUp(bin) return them as long
+/// as the contents of the bin, its prior, the statistic option and the
+/// confidence level are unchanged, and compute the errors again otherwise.
+///
+/// The errors are published at once when they are all computed: other threads
+/// may use this object meanwhile, e.g. call CreateGraph, which calls this
+/// method, as long as they do not modify it.
+
+void TEfficiency::ComputeIntervals() const
+{
+   if (!fTotalHistogram || !fPassedHistogram) return;
+
+   // as GetEfficiencyErrorLow/Up do for each bin
+   if(TestBit(kUseWeights) && !TestBit(kIsBayesian) && fStatisticOption != kFNormal)
+   {
+      Warning("ComputeIntervals","frequentist confidence intervals for weights are only supported by the normal approximation");
+      Info("ComputeIntervals","setting statistic option to kFNormal");
+      const_cast<TEfficiency*>(this)->SetStatisticOption(kFNormal);
+   }
+
+   const Int_t kNInputs = TIntervalCache::kNInputs;
+   const Int_t ncells = fTotalHistogram->GetNcells();
+   auto cache = std::make_shared<TIntervalCache>();
+   cache->fStatisticOption = fStatisticOption;
+   cache->fConfLevel = fConfLevel;
+   cache->fBits = TIntervalCache::Bits(*this);
+   cache->fInputs.resize(ncells * kNInputs);
+   cache->fErrors.resize(2 * ncells);
+   Double_t *inputs = cache->fInputs.data();
+   for (Int_t bin = 0; bin < ncells; ++bin)
+      TIntervalCache::GetInputs(*this, bin, inputs + bin * kNInputs);
+
+   // group the bins with identical inputs (compared bitwise, to order them
+   // totally), the first bin of each group being its representative
+   std::vector<Int_t> order(ncells);
+   for (Int_t bin = 0; bin < ncells; ++bin) order[bin] = bin;
+   auto same = [inputs](Int_t i, Int_t j) {
+      return memcmp(inputs + i * kNInputs, inputs + j * kNInputs, kNInputs * sizeof(Double_t)) == 0;
+   };
+   std::sort(order.begin(), order.end(), [inputs](Int_t i, Int_t j) {
+      return memcmp(inputs + i * kNInputs, inputs + j * kNInputs, kNInputs * sizeof(Double_t)) < 0;
+   });
+   std::vector<Int_t> groups;
+   for (Int_t k = 0; k < ncells; ++k)
+      if (k == 0 || !same(order[k], order[k-1])) groups.push_back(order[k]);
+   const Int_t ngroups = groups.size();
+   std::vector<Double_t> errors(2 * ngroups);
+
+   auto computeGroups = [&](Int_t first, Int_t last) {
+      for (Int_t g = first; g < last; ++g)
+         ComputeErrors(groups[g], errors[2*g], errors[2*g+1]);
+   };
+#ifdef R__USE_IMT
+   const Int_t kGroupsPerTask = 16;
+   const Int_t ntasks = (ngroups + kGroupsPerTask - 1) / kGroupsPerTask;
+   if (ROOT::IsImplicitMTEnabled() && ntasks > 1) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t task) {
+         computeGroups(task * kGroupsPerTask, std::min<Int_t>((task + 1) * kGroupsPerTask, ngroups));
+      }, ROOT::TSeqU(ntasks));
+   } else
+#endif
+      computeGroups(0, ngroups);
+
+   for (Int_t k = 0, g = -1; k < ncells; ++k) {
+      if (k == 0 || !same(order[k], order[k-1])) ++g;
+      cache->fErrors[2*order[k]] = errors[2*g];
+      cache->fErrors[2*order[k]+1] = errors[2*g+1];
+   }
+   std::atomic_store(&fIntervalCache, std::shared_ptr<const TIntervalCache>(cache));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set low and up to the errors of the given global bin computed by
+/// ComputeIntervals, if they are still valid.
+
+Bool_t TEfficiency::FindCachedErrors(Int_t bin,Double_t& low,Double_t& up) const
+{
+   const auto cache = std::atomic_load(&fIntervalCache);
+   if (!cache || bin < 0 || 2 * bin + 1 >= (Int_t)cache->fErrors.size() || !cache->IsValid(*this))
+      return kFALSE;
+   Double_t inputs[TIntervalCache::kNInputs];
+   TIntervalCache::GetInputs(*this, bin, inputs);
+   if (memcmp(inputs, &cache->fInputs[bin * TIntervalCache::kNInputs], sizeof(inputs)) != 0)
+      return kFALSE;
+   low = cache->fErrors[2*bin];
+   up = cache->fErrors[2*bin+1];
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create the graph used be painted (for dim=1 TEfficiency)
 /// The return object is managed by the caller
@@ -1618,6 +1869,9 @@ void TEfficiency::FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const
    Bool_t plot0Bins = false;
    if (option.Contains("e0") ) plot0Bins = true;
 
+   // the errors of all the bins at once, GetEfficiencyErrorLow/Up return them
+   ComputeIntervals();
+
    Double_t x,y,xlow,xup,ylow,yup;
    //point i corresponds to bin i+1 in histogram
    // point j is point graph index
@@ -1982,7 +2236,8 @@ Double_t TEfficiency::Combine(Double_t& up,Double_t& low,Int_t n,
 ///           pList (w[0] correspond to pList->First ... w[n-1] -> pList->Last)
 ///           The weights do not have to be normalised.
 ///
-/// For each bin the calculation is done by the Combine(double&, double& ...) method.
+/// For each bin the calculation is done by the Combine(double&, double& ...) method,
+/// in parallel for different bins when the implicit multi-threading is enabled.
 
 TGraphAsymmErrors* TEfficiency::Combine(TCollection* pList,Option_t* option,
                                         Int_t n,const Double_t* w)
@@ -2127,34 +2382,50 @@ TGraphAsymmErrors* TEfficiency::Combine(TCollection* pList,Option_t* option,
    //parameters for combining:
    //number of objects
    Int_t num = vTotal.size();
-   std::vector<Int_t> pass(num);
-   std::vector<Int_t> total(num);
-
-   //loop over all bins
-   Double_t low = 0;
-   Double_t up = 0;
-   for(Int_t i=1; i <= nbins_max; ++i) {
-      //the binning of the x-axis is taken from the first total histogram
-      x[i-1] = vTotal.at(0)->GetBinCenter(i);
-      xlow[i-1] = x[i-1] - vTotal.at(0)->GetBinLowEdge(i);
-      xhigh[i-1] = vTotal.at(0)->GetBinWidth(i) - xlow[i-1];
-
-      for(Int_t j = 0; j < num; ++j) {
-         pass[j] = (Int_t)(vPassed.at(j)->GetBinContent(i) + 0.5);
-         total[j] = (Int_t)(vTotal.at(j)->GetBinContent(i) + 0.5);
-      }
 
-      //fill efficiency and errors
-      eff[i-1] = Combine(up,low,num,&pass[0],&total[0],alpha,beta,level,&vWeights[0],opt.Data());
-      //did an error occurred ?
-      if(eff[i-1] == -1) {
-         gROOT->Error("TEfficiency::Combine","error occurred during combining");
-         gROOT->Info("TEfficiency::Combine","stop combining");
-         return 0;
+   //combine the bins first to last, the bins are independent
+   auto combineBins = [&](Int_t first, Int_t last) {
+      std::vector<Int_t> pass(num);
+      std::vector<Int_t> total(num);
+      Double_t low = 0;
+      Double_t up = 0;
+      for(Int_t i=first; i <= last; ++i) {
+         //the binning of the x-axis is taken from the first total histogram
+         x[i-1] = vTotal.at(0)->GetBinCenter(i);
+         xlow[i-1] = x[i-1] - vTotal.at(0)->GetBinLowEdge(i);
+         xhigh[i-1] = vTotal.at(0)->GetBinWidth(i) - xlow[i-1];
+
+         for(Int_t j = 0; j < num; ++j) {
+            pass[j] = (Int_t)(vPassed.at(j)->GetBinContent(i) + 0.5);
+            total[j] = (Int_t)(vTotal.at(j)->GetBinContent(i) + 0.5);
+         }
+
+         //fill efficiency and errors
+         eff[i-1] = Combine(up,low,num,&pass[0],&total[0],alpha,beta,level,&vWeights[0],opt.Data());
+         efflow[i-1]= eff[i-1] - low;
+         effhigh[i-1]= up - eff[i-1];
       }
-      efflow[i-1]= eff[i-1] - low;
-      effhigh[i-1]= up - eff[i-1];
-   }//loop over all bins
+   };
+
+   //loop over all bins, in parallel when implicit multi-threading is enabled
+#ifdef R__USE_IMT
+   const Int_t kBinsPerTask = 16;
+   const Int_t ntasks = (nbins_max + kBinsPerTask - 1) / kBinsPerTask;
+   if (ROOT::IsImplicitMTEnabled() && ntasks > 1) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t task) {
+         combineBins(task * kBinsPerTask + 1, std::min<Int_t>((task + 1) * kBinsPerTask, nbins_max));
+      }, ROOT::TSeqU(ntasks));
+   } else
+#endif
+      combineBins(1, nbins_max);
+
+   //did an error occurred ?
+   if(std::find(eff.begin(), eff.end(), -1.) != eff.end()) {
+      gROOT->Error("TEfficiency::Combine","error occurred during combining");
+      gROOT->Info("TEfficiency::Combine","stop combining");
+      return 0;
+   }
 
    TGraphAsymmErrors* gr = new TGraphAsymmErrors(nbins_max,&x[0],&eff[0],&xlow[0],&xhigh[0],&efflow[0],&effhigh[0]);
 
@@ -2509,9 +2780,16 @@ Double_t TEfficiency::GetEfficiency(Int_t bin) const
 ///
 /// Note: If the histograms are filled with weights, only bayesian methods and the
 ///       normal approximation are supported.
+///
+/// The error computed for all the bins by ComputeIntervals is returned if the
+/// bin and the options did not change since.
 
 Double_t TEfficiency::GetEfficiencyErrorLow(Int_t bin) const
 {
+   Double_t cachedLow, cachedUp;
+   if (FindCachedErrors(bin, cachedLow, cachedUp))
+      return cachedLow;
+
    Double_t total = fTotalHistogram->GetBinContent(bin);
    Double_t passed = fPassedHistogram->GetBinContent(bin);
 
@@ -2589,9 +2867,16 @@ Double_t TEfficiency::GetEfficiencyErrorLow(Int_t bin) const
 ///
 /// Note: If the histograms are filled with weights, only bayesian methods and the
 ///       normal approximation are supported.
+///
+/// The error computed for all the bins by ComputeIntervals is returned if the
+/// bin and the options did not change since.
 
 Double_t TEfficiency::GetEfficiencyErrorUp(Int_t bin) const
 {
+   Double_t cachedLow, cachedUp;
+   if (FindCachedErrors(bin, cachedLow, cachedUp))
+      return cachedUp;
+
    Double_t total = fTotalHistogram->GetBinContent(bin);
    Double_t passed = fPassedHistogram->GetBinContent(bin);
 
@@ -2829,6 +3114,7 @@ TEfficiency& TEfficiency::operator=(const TEfficiency& rhs)
       delete fPaintGraph;
       fPaintHisto = 0;
       fPaintGraph = 0;
+      std::atomic_store(&fIntervalCache, std::shared_ptr<const TIntervalCache>());
 
       //copy style
       rhs.TAttLine::Copy(*this);
@@ -51,6 +51,9 @@
 
 #include "AnalyticalIntegrals.h"
 
+#include <algorithm>
+#include <vector>
+
 std::atomic<Bool_t> TF1::fgAbsValue(kFALSE);
 Bool_t TF1::fgRejectPoint = kFALSE;
 std::atomic<Bool_t> TF1::fgAddToGlobList(kTRUE);
@@ -1425,6 +1428,38 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points, for the parameters params or, if params
+/// is null, for the current parameters of the function.
+///
+/// The coordinates of the points are stored by dimension: the coordinate j of
+/// the point i is x[j * n + i]. The values are stored in out. A function defined
+/// by a formula is evaluated by a loop over the points compiled for the formula,
+/// see TFormula::EvalBatch, which is faster than calling EvalPar for each point.
+/// The other functions are evaluated with EvalPar, one point at a time.
+/// Classes reimplementing EvalPar must reimplement this function as well.
+
+void TF1::EvalBatch(const Double_t *x, Double_t *out, size_t n, const Double_t *params)
+{
+   if (fType == EFType::kFormula) {
+      assert(fFormula);
+      fFormula->EvalBatch(x, out, n, params);
+      if (fNormalized && fNormIntegral != 0) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] = out[i] / fNormIntegral;
+      }
+      return;
+   }
+
+   std::vector<Double_t> xi(std::max(fNdim, 1));
+   InitArgs(xi.data(), params);
+   for (size_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < fNdim; ++j)
+         xi[j] = x[j * n + i];
+      out[i] = EvalPar(xi.data(), params);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -2929,7 +2964,6 @@ void TF1::Paint(Option_t *choptin)
 TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
 {
    Int_t i;
-   Double_t xv[1];
 
    TH1 *histogram = 0;
 
@@ -2998,11 +3032,13 @@ TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
-   InitArgs(xv, parameters);
-   for (i = 1; i <= fNpx; i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i, EvalPar(xv, parameters));
-   }
+   // evaluate the function at all the bin centers at once
+   std::vector<Double_t> xv(fNpx), values(fNpx);
+   for (i = 1; i <= fNpx; i++)
+      xv[i - 1] = histogram->GetBinCenter(i);
+   EvalBatch(xv.data(), values.data(), fNpx, parameters);
+   for (i = 1; i <= fNpx; i++)
+      histogram->SetBinContent(i, values[i - 1]);
 
    // Copy Function attributes to histogram attributes.
    histogram->SetBit(TH1::kNoStats);
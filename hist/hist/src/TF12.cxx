@@ -13,6 +13,9 @@
 #include "TH1.h"
 #include "TVirtualPad.h"
 
+#include <algorithm>
+#include <vector>
+
 ClassImp(TF12);
 
 /** \class TF12
@@ -167,6 +170,20 @@ Double_t TF12::EvalPar(const Double_t *x, const Double_t *params)
    return fF2->EvalPar(xx,params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate this function at the n points x, see EvalPar
+
+void TF12::EvalBatch(const Double_t *x, Double_t *out, size_t n, const Double_t *params)
+{
+   if (!fF2) {
+      std::fill(out, out + n, 0.);
+      return;
+   }
+   std::vector<Double_t> xx(2 * n, fXY);
+   std::copy(x, x + n, xx.begin() + (fCase == 0 ? 0 : n));
+   fF2->EvalBatch(xx.data(), out, n, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
@@ -25,11 +25,13 @@
 #include "TInterpreterValue.h"
 #include "TFormula.h"
 #include "TRegexp.h"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <iostream>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 using namespace std;
 
@@ -179,6 +181,17 @@ ClassImp(TFormula);
     tf.EvalPar(nullptr, params);
     ```
 
+    Many points can be evaluated at once with `TFormula::EvalBatch`, which takes
+    the coordinates stored by dimension, first the x of all the points, then
+    their y, etc. The expression is then compiled in a loop over the points, that
+    the compiler can vectorize, and it is much faster than a call per point.
+
+    ```
+    TFormula tf("", "[0]*exp(-[1]*x)*cos(y)");
+    std::vector<double> xy(2 * n), values(n);  // x[0..n-1], then y[0..n-1]
+    tf.EvalBatch(xy.data(), values.data(), n);
+    ```
+
     ### A note on operators
 
     All operators of C/C++ are allowed in a TFormula with a few caveats.
@@ -699,6 +712,8 @@ void TFormula::Copy(TObject &obj) const
    fnew.fFuncPtr = fFuncPtr;
    fnew.fGradGenerationInput = fGradGenerationInput;
    fnew.fGradFuncPtr = fGradFuncPtr;
+   fnew.fBatchFuncPtr = fBatchFuncPtr.load();
+   fnew.fBatchFailed = fBatchFailed.load();
 
 }
 
@@ -713,6 +728,8 @@ void TFormula::Clear(Option_t * )
    fNumber = 0;
    fFormula = "";
    fClingName = "";
+   fBatchFuncPtr = nullptr;
+   fBatchFailed = false;
 
 
    if(fMethod) fMethod->Delete();
@@ -2281,6 +2298,8 @@ void TFormula::ProcessFormula(TString &formula)
          // set the cling name using hash of the static formulae map
          auto hasher = gClingFunctions.hash_function();
          fClingName = TString::Format("%s__id%zu", gNamePrefix.Data(), hasher(inputFormulaVecFlag));
+         fBatchFuncPtr = nullptr;
+         fBatchFailed = false;
 
          fClingInput = TString::Format("%s %s(%s){ return %s ; }", argType.Data(), fClingName.Data(),
                                        argumentsPrototype.Data(), inputFormula.c_str());
@@ -3057,6 +3076,8 @@ void TFormula::SetVectorized(Bool_t vectorized)
       fClingInitialized = false;
       fReadyToExecute = false;
       fClingName = "";
+      fBatchFuncPtr = nullptr;
+      fBatchFailed = false;
       fClingInput = fFormula;
 
       if (fMethod)
@@ -3224,6 +3245,100 @@ void TFormula::GradientPar(const Double_t *x, Double_t *result)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the pointer to a function evaluating the formula expression in a loop
+/// over points, compiling it the first time. The function is shared by all the
+/// formulae with the same expression. Return null if the formula is not compiled
+/// by Cling as an expression (lambda or vectorized formula) or if the loop
+/// cannot be compiled.
+
+TFormula::CallFuncSignature TFormula::GetBatchFuncPtr() const
+{
+   if (CallFuncSignature func = fBatchFuncPtr)
+      return func;
+   if (fBatchFailed || !fReadyToExecute || fVectorized || TestBit(TFormula::kLambda))
+      return nullptr;
+
+   R__LOCKGUARD(gROOTMutex);
+   if (CallFuncSignature func = fBatchFuncPtr)
+      return func;
+   if (!fClingInitialized && fLazyInitialization)
+      const_cast<TFormula *>(this)->ReInitializeEvalMethod();
+   if (!fClingInitialized || fClingName.IsNull() || fNdim <= 0) {
+      fBatchFailed = true;
+      return nullptr;
+   }
+
+   // the body of the loop is the expression compiled for a single point, for
+   // which x is the array of the coordinates of the point
+   TString funcName = fClingName + "_batch";
+   if (!functionExists(funcName.Data())) {
+      TString coords;
+      for (Int_t j = 0; j < fNdim; ++j)
+         coords += TString::Format("%sxs[%d * n + i]", (j ? ", " : ""), j);
+      TString input = TString::Format("#pragma cling optimize(2)\n"
+                                      "void %s(Double_t *xs, Double_t *p, Double_t *out, Long64_t n) {\n"
+                                      "   for (Long64_t i = 0; i < n; ++i) {\n"
+                                      "      Double_t x[] = {%s};\n"
+                                      "      out[i] = %s;\n"
+                                      "   }\n"
+                                      "}",
+                                      funcName.Data(), coords.Data(), GetExpFormula("CLING").Data());
+      if (!gInterpreter->Declare(input)) {
+         Error("GetBatchFuncPtr", "Cannot compile the loop over points of the formula %s", GetName());
+         fBatchFailed = true;
+         return nullptr;
+      }
+   }
+
+   TMethodCall method;
+   method.InitWithPrototype(funcName, "Double_t*,Double_t*,Double_t*,Long64_t");
+   CallFuncSignature func = method.IsValid() ? prepareFuncPtr(&method) : nullptr;
+   if (!func) {
+      fBatchFailed = true;
+      return nullptr;
+   }
+   fBatchFuncPtr = func;
+   return func;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points, for the parameters params or, if params is
+/// null, for the current parameters of the formula.
+///
+/// The coordinates of the points are stored by dimension: the coordinate j of
+/// the point i is x[j * n + i]. The values are stored in out. The expression of
+/// the formula is compiled, the first time, in a loop over the points that the
+/// compiler can vectorize, without the need of the Vc library. A lambda or a
+/// vectorized formula is evaluated with EvalPar, one point at a time.
+
+void TFormula::EvalBatch(const Double_t *x, Double_t *out, size_t n, const Double_t *params) const
+{
+   if (n == 0)
+      return;
+   if (CallFuncSignature func = GetBatchFuncPtr()) {
+      // __attribute__((used)) extern "C" void __cf_0(void* obj, int nargs, void** args, void* ret)
+      // {
+      //    ((void (&)(double*, double*, double*, long long))TFormula____id_batch)(*(double**)args[0],
+      //       *(double**)args[1], *(double**)args[2], *(long long*)args[3]);
+      //    return;
+      // }
+      Double_t *xs = const_cast<Double_t *>(x);
+      Double_t *pars = const_cast<Double_t *>(params ? params : fClingParameters.data());
+      Long64_t nn = n;
+      void *args[4] = {&xs, &pars, &out, &nn};
+      (*func)(0, 4, args, /*ret*/ nullptr);
+      return;
+   }
+
+   std::vector<Double_t> xi(std::max(fNdim, 1));
+   for (size_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < fNdim; ++j)
+         xi[j] = x[j * n + i];
+      out[i] = EvalPar(xi.data(), params);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 #ifdef R__HAS_VECCORE
 // ROOT::Double_v TFormula::Eval(ROOT::Double_v x, ROOT::Double_v y, ROOT::Double_v z, ROOT::Double_v t) const
@@ -35,6 +35,10 @@
 #include <stdlib.h>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -168,6 +172,7 @@ TGraph::TGraph(const TGraph &gr)
    else fHistogram = 0;
    fMinimum = gr.fMinimum;
    fMaximum = gr.fMaximum;
+   fIndexedEval = gr.fIndexedEval;
    if (!fMaxSize) {
       fX = fY = 0;
       return;
@@ -192,6 +197,8 @@ TGraph& TGraph::operator=(const TGraph &gr)
       TAttFill::operator=(gr);
       TAttMarker::operator=(gr);
 
+      ResetEvalIndex();
+      fIndexedEval = gr.fIndexedEval;
       fNpoints = gr.fNpoints;
       fMaxSize = gr.fMaxSize;
 
@@ -504,6 +511,7 @@ TGraph::TGraph(const char *filename, const char *format, Option_t *option)
 
 TGraph::~TGraph()
 {
+   ResetEvalIndex();
    delete [] fX;
    delete [] fY;
    if (fFunctions) {
@@ -552,6 +560,7 @@ Double_t** TGraph::AllocateArrays(Int_t Narrays, Int_t arraySize)
 void TGraph::Apply(TF1 *f)
 {
    if (fHistogram) SetBit(kResetHisto);
+   ResetEvalIndex();
 
    for (Int_t i = 0; i < fNpoints; i++) {
       fY[i] = f->Eval(fX[i], fY[i]);
@@ -845,6 +854,97 @@ void TGraph::DrawPanel()
    if (painter) painter->DrawPanelHelper(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Points of a graph sorted in X, with a uniform grid over their range giving
+/// the first point of each cell, to look up the interval of an abscissa
+/// without a search over all the points.
+
+struct TGraph::TEvalIndex {
+   std::vector<Double_t> fX, fY;    ///< Points sorted in X, empty if an X is not a number
+   std::vector<Int_t>    fFirst;    ///< First point of cell c, fFirst[ncells] = number of points
+   Double_t              fXmin;     ///< Lower edge of the grid
+   Double_t              fScale;    ///< Number of cells per unit of X, 0 for a single cell
+
+   TEvalIndex(Int_t n, const Double_t *x, const Double_t *y);
+
+   Bool_t IsValid() const { return !fX.empty(); }
+
+   /// Cell of abscissa x, non decreasing with x.
+   Int_t Cell(Double_t x) const
+   {
+      const Int_t ncells = fFirst.size() - 1;
+      const Double_t pos = (x - fXmin)*fScale;
+      if (pos < 0) return -1;
+      return pos < ncells ? Int_t(pos) : ncells - 1;
+   }
+
+   Int_t    FindLow(Double_t x) const;
+   Double_t Eval(Double_t x, Int_t &hint) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the n points (x,y) and index them, about one point per cell.
+
+TGraph::TEvalIndex::TEvalIndex(Int_t n, const Double_t *x, const Double_t *y)
+   : fXmin(0), fScale(0)
+{
+   for (Int_t i = 0; i < n; ++i)
+      if (std::isnan(x[i])) return;
+   std::vector<Int_t> order(n);
+   for (Int_t i = 0; i < n; ++i) order[i] = i;
+   std::stable_sort(order.begin(), order.end(), [x](Int_t i, Int_t j) { return x[i] < x[j]; });
+   fX.resize(n);
+   fY.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      fX[i] = x[order[i]];
+      fY[i] = y[order[i]];
+   }
+
+   fXmin = fX.front();
+   const Double_t range = fX.back() - fXmin;
+   const Int_t ncells = (range > 0 && std::isfinite(range)) ? n : 1;
+   if (ncells > 1) fScale = ncells/range;
+   if (!std::isfinite(fScale)) fScale = 0;
+   fFirst.assign(ncells + 1, n);
+   Int_t c = 0;
+   for (Int_t i = 0; i < n; ++i) {
+      const Int_t cell = Cell(fX[i]);
+      while (c <= cell) fFirst[c++] = i;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the last point with X <= x, -1 if there is none, as TMath::BinarySearch.
+
+Int_t TGraph::TEvalIndex::FindLow(Double_t x) const
+{
+   const Int_t cell = Cell(x);
+   if (cell < 0) return -1;
+   // the points before the cell are below x, the ones after it above x
+   auto begin = fX.begin();
+   return std::upper_bound(begin + fFirst[cell], begin + fFirst[cell+1], x) - begin - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Linear interpolation at x, as TGraph::Eval for a graph sorted in X. hint is
+/// the lower point of the interval of the previous abscissa, it is updated.
+
+Double_t TGraph::TEvalIndex::Eval(Double_t x, Int_t &hint) const
+{
+   const Int_t n = fX.size();
+   Int_t low = hint;
+   if (low < 0 || low >= n - 1 || !(fX[low] < x && x < fX[low+1])) {
+      low = FindLow(x);
+      hint = low;
+   }
+   if (low == -1) low = 0;
+   if (fX[low] == x) return fY[low];
+   if (low == n - 1) low--;
+   const Int_t up = low + 1;
+   if (fX[low] == fX[up]) return fY[low];
+   return fY[up] + (x - fX[up])*(fY[low] - fY[up])/(fX[low] - fX[up]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interpolate points in this graph at x using a TSpline.
 ///
@@ -859,6 +959,10 @@ void TGraph::DrawPanel()
 ///   If the points are sorted in X a binary search is used (significantly faster)
 ///   One needs to set the bit  TGraph::SetBit(TGraph::kIsSortedX) before calling
 ///   TGraph::Eval to indicate that the graph is sorted in X.
+///
+///   With SetIndexedEval(), the linear interpolation looks up the points in a
+///   copy sorted in X, indexed by a uniform grid over their range: the points
+///   need not be sorted and the cost of a call hardly depends on their number.
 
 Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
 {
@@ -896,6 +1000,14 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    //linear interpolation
    //In case x is < fX[0] or > fX[fNpoints-1] return the extrapolated point
 
+   if (fIndexedEval) {
+      const TEvalIndex *index = GetEvalIndex();
+      if (index->IsValid()) {
+         Int_t hint = -1;
+         return index->Eval(x, hint);
+      }
+   }
+
    //find points in graph around x assuming points are not sorted
    // (if point are sorted use a binary search)
    Int_t low  = -1;
@@ -952,6 +1064,91 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    return yn;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Interpolate points in this graph at the n abscissas x, the results are
+/// stored in y. spline and option are used as in Eval(Double_t, TSpline*, Option_t*).
+///
+/// With option "S" the spline is created once for all the abscissas. With
+/// SetIndexedEval(), the interval found for an abscissa is tried first for the
+/// next one, which makes sorted or close abscissas cheap to evaluate.
+
+void TGraph::Eval(Int_t n, const Double_t *x, Double_t *y, TSpline *spline, Option_t *option) const
+{
+   if (n <= 0) return;
+
+   if (spline) {
+      if (TSpline3 *spline3 = dynamic_cast<TSpline3 *>(spline)) {
+         spline3->Eval(n, x, y);
+      } else {
+         for (Int_t i = 0; i < n; ++i) y[i] = spline->Eval(x[i]);
+      }
+      return;
+   }
+
+   if (fNpoints <= 1) {
+      std::fill(y, y + n, fNpoints == 1 ? fY[0] : 0.);
+      return;
+   }
+
+   if (option && *option) {
+      TString opt = option;
+      opt.ToLower();
+      if (opt.Contains("s")) {
+         // points must be sorted before using a TSpline
+         std::vector<Double_t> xsort(fNpoints);
+         std::vector<Double_t> ysort(fNpoints);
+         std::vector<Int_t> indxsort(fNpoints);
+         TMath::Sort(fNpoints, fX, &indxsort[0], false);
+         for (Int_t i = 0; i < fNpoints; ++i) {
+            xsort[i] = fX[ indxsort[i] ];
+            ysort[i] = fY[ indxsort[i] ];
+         }
+         TSpline3 s("", &xsort[0], &ysort[0], fNpoints);
+         s.Eval(n, x, y);
+         return;
+      }
+   }
+
+   if (fIndexedEval) {
+      const TEvalIndex *index = GetEvalIndex();
+      if (index->IsValid()) {
+         Int_t hint = -1;
+         for (Int_t i = 0; i < n; ++i) y[i] = index->Eval(x[i], hint);
+         return;
+      }
+   }
+
+   for (Int_t i = 0; i < n; ++i) y[i] = Eval(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the points sorted in X looked up by Eval in indexed mode, built at
+/// the first call after the points changed. Several threads can call it at the
+/// same time, as long as none of them modifies the graph.
+
+const TGraph::TEvalIndex *TGraph::GetEvalIndex() const
+{
+   TEvalIndex *index = fEvalIndex.load(std::memory_order_acquire);
+   if (index) return index;
+
+   static std::mutex buildMutex;
+   std::lock_guard<std::mutex> lock(buildMutex);
+   index = fEvalIndex.load(std::memory_order_acquire);
+   if (index) return index;
+   index = new TEvalIndex(fNpoints, fX, fY);
+   fEvalIndex.store(index, std::memory_order_release);
+   return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the points sorted for Eval, they are sorted again when needed.
+/// To be called when the points are modified.
+
+void TGraph::ResetEvalIndex()
+{
+   delete fEvalIndex.exchange(nullptr);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -1753,6 +1950,7 @@ void TGraph::InsertPointBefore(Int_t ipoint, Double_t x, Double_t y)
 
    fX[ipoint] = x;
    fY[ipoint] = y;
+   ResetEvalIndex();
 }
 
 
@@ -2043,6 +2241,7 @@ Int_t TGraph::RemovePoint(Int_t ipoint)
 
    Double_t **ps = ShrinkAndCopy(fNpoints - 1, ipoint);
    CopyAndRelease(ps, ipoint + 1, fNpoints--, ipoint);
+   ResetEvalIndex();
    if (gPad) gPad->Modified();
    return ipoint;
 }
@@ -2140,6 +2339,7 @@ void TGraph::Set(Int_t n)
       FillZero(fNpoints, n, kFALSE);
    }
    fNpoints = n;
+   ResetEvalIndex();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2174,6 +2374,19 @@ void TGraph::SetHighlight(Bool_t set)
    painter->SetHighlight(this);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (on=kTRUE) or disable the indexed mode of Eval: the linear
+/// interpolation looks up the points in a copy sorted in X, as if the graph
+/// were sorted with kIsSortedX set. The copy is made at the first Eval and
+/// again after the points are changed by the setters of TGraph; call
+/// SetIndexedEval() again after modifying the arrays returned by GetX() or GetY().
+
+void TGraph::SetIndexedEval(Bool_t on)
+{
+   fIndexedEval = on;
+   ResetEvalIndex();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the maximum of the graph.
 
@@ -2213,6 +2426,7 @@ void TGraph::SetPoint(Int_t i, Double_t x, Double_t y)
    }
    fX[i] = x;
    fY[i] = y;
+   ResetEvalIndex();
    if (gPad) gPad->Modified();
 }
 
@@ -2288,6 +2502,8 @@ void TGraph::Sort(Bool_t (*greaterfunc)(const TGraph*, Int_t, Int_t) /*=TGraph::
    // set the bit in case of an ascending =sort in X
    if (greaterfunc == TGraph::CompareX && ascending  && low == 0 && high == -1111)
       SetBit(TGraph::kIsSortedX);
+   if (low == 0 && high == -1111)
+      ResetEvalIndex();
 
    if (high == -1111) high = GetN() - 1;
    //  Termination condition
@@ -2319,6 +2535,7 @@ void TGraph::Sort(Bool_t (*greaterfunc)(const TGraph*, Int_t, Int_t) /*=TGraph::
 void TGraph::Streamer(TBuffer &b)
 {
    if (b.IsReading()) {
+      ResetEvalIndex();
       UInt_t R__s, R__c;
       Version_t R__v = b.ReadVersion(&R__s, &R__c);
       if (R__v > 2) {
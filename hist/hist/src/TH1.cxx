@@ -15,6 +15,8 @@
 #include <ctype.h>
 #include <sstream>
 #include <cmath>
+#include <atomic>
+#include <mutex>
 
 #include "Riostream.h"
 #include "TROOT.h"
@@ -42,6 +44,7 @@
 #include "TVirtualHistPainter.h"
 #include "TVirtualFFT.h"
 #include "TSystem.h"
+#include "ThreadLocalStorage.h"
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -544,6 +547,97 @@ class DifferentLabels: public std::exception {};
 
 ClassImp(TH1);
 
+namespace {
+
+/// Atomically add `w` to `value`.
+template <typename T>
+void AtomicAdd(std::atomic<T> &value, T w)
+{
+   T old = value.load(std::memory_order_relaxed);
+   while (!value.compare_exchange_weak(old, old + w, std::memory_order_relaxed)) {}
+}
+
+/// Atomically add `w` to the bin content at `address`, as the AddBinContent
+/// of the histograms storing floating point contents does.
+template <typename T>
+void AtomicAddContent(T *address, Double_t w)
+{
+   static_assert(sizeof(std::atomic<T>) == sizeof(T), "atomic bin contents must have the size of the contents");
+   AtomicAdd(*reinterpret_cast<std::atomic<T> *>(address), T(w));
+}
+
+/// Atomically add `w` to the bin content at `address`, as the AddBinContent
+/// of the histograms storing integer contents does: the content saturates at +-max.
+template <typename T>
+void AtomicAddContent(T *address, Double_t w, Long64_t max)
+{
+   static_assert(sizeof(std::atomic<T>) == sizeof(T), "atomic bin contents must have the size of the contents");
+   std::atomic<T> &value = *reinterpret_cast<std::atomic<T> *>(address);
+   T old = value.load(std::memory_order_relaxed);
+   T sum;
+   do {
+      const Long64_t newval = old + Long64_t(w);
+      sum = T(newval < -max ? -max : (newval > max ? max : newval));
+   } while (!value.compare_exchange_weak(old, sum, std::memory_order_relaxed));
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// State of a histogram filled concurrently, see TH1::SetConcurrentFill.
+///
+/// The bin contents and the sums of squares of weights are updated in place
+/// with atomic operations. The number of entries and the sums of the statistics
+/// are added to one of kNstripes stripes of partial sums, chosen per thread to
+/// spread the contention, and folded into the histogram when they are read.
+
+struct TH1::TConcurrentFill {
+   enum EStorage { kChar, kShort, kInt, kFloat, kDouble };
+   enum {
+      kNvalues    = TH1::kNstat + 1, // number of entries, then the statistics in the order of GetStats
+      kStripeSize = 16,              // values per stripe: a stripe spans whole cache lines
+      kNstripes   = 32
+   };
+
+   EStorage              fStorage;                           ///< type of the bin contents
+   TArray               *fArray;                             ///< bin contents, the TArray the histogram inherits from
+   std::atomic<Double_t> fStripes[kNstripes * kStripeSize];  ///< partial sums of the entries and statistics
+   std::mutex            fFoldMutex;                         ///< serializes the folds of the partial sums
+
+   TConcurrentFill(EStorage storage, TArray *array) : fStorage(storage), fArray(array)
+   {
+      static_assert(kNvalues <= kStripeSize, "the entries and statistics must fit in a stripe");
+      for (auto &value : fStripes) value.store(0., std::memory_order_relaxed);
+   }
+
+   /// Return the stripe of the calling thread: threads are assigned stripes in turn.
+   static std::atomic<Double_t> *GetStripe(std::atomic<Double_t> *stripes)
+   {
+      static std::atomic<Int_t> gNextStripe(0);
+      TTHREAD_TLS(Int_t) stripe = -1;
+      if (stripe < 0) stripe = gNextStripe++ % kNstripes;
+      return &stripes[stripe * kStripeSize];
+   }
+
+   /// Move the partial sums of all the stripes to `values`.
+   void Drain(Double_t *values)
+   {
+      for (Int_t s = 0; s < kNstripes; ++s) {
+         for (Int_t i = 0; i < kNvalues; ++i)
+            values[i] += fStripes[s * kStripeSize + i].exchange(0., std::memory_order_relaxed);
+      }
+   }
+
+   /// Add the partial sums to the statistics of h. fFoldMutex must be held.
+   void Fold(TH1 *h)
+   {
+      Double_t values[kNvalues] = {0};
+      Drain(values);
+      h->fEntries += values[0];
+      h->AddConcurrentStats(&values[1]);
+   }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Histogram default constructor.
 
@@ -561,6 +655,7 @@ TH1::TH1(): TNamed(), TAttLine(), TAttFill(), TAttMarker()
    fMinimum       = -1111;
    fBufferSize    = 0;
    fBuffer        = 0;
+   fConcurrentFill = 0;
    fBinStatErrOpt = kNormal;
    fStatOverflows = EStatOverflows::kNeutral;
    fXaxis.SetName("xaxis");
@@ -584,6 +679,8 @@ TH1::~TH1()
    fIntegral = 0;
    delete[] fBuffer;
    fBuffer = 0;
+   delete fConcurrentFill;
+   fConcurrentFill = 0;
    if (fFunctions) {
       R__WRITE_LOCKGUARD(ROOT::gCoreMutex);
 
@@ -731,6 +828,7 @@ void TH1::Build()
    fMinimum       = -1111;
    fBufferSize    = 0;
    fBuffer        = 0;
+   fConcurrentFill = 0;
    fBinStatErrOpt = kNormal;
    fStatOverflows = EStatOverflows::kNeutral;
    fXaxis.SetName("xaxis");
@@ -2581,6 +2679,10 @@ TH1 *TH1::GetCumulative(Bool_t forward, const char* suffix) const
 
 void TH1::Copy(TObject &obj) const
 {
+   // the statistics are copied with their partial sums, the content of obj is replaced
+   TConcurrentFillLock lock(this);
+   delete ((TH1&)obj).fConcurrentFill;
+   ((TH1&)obj).fConcurrentFill = 0;
    if (((TH1&)obj).fDirectory) {
       // We are likely to change the hash value of this object
       // with TNamed::Copy, to keep things correct, we need to
@@ -2638,6 +2740,7 @@ void TH1::Copy(TObject &obj) const
    ((TH1&)obj).fZaxis.SetParent(&obj);
    fContour.Copy(((TH1&)obj).fContour);
    fSumw2.Copy(((TH1&)obj).fSumw2);
+   if (fConcurrentFill) ((TH1&)obj).SetConcurrentFill();
    //   fFunctions->Copy(((TH1&)obj).fFunctions);
    // when copying an histogram if the AddDirectoryStatus() is true it
    // will be added to gDirectory independently of the fDirectory stored.
@@ -3252,6 +3355,7 @@ TH1* TH1::FFT(TH1* h_output, Option_t *option)
 
 Int_t TH1::Fill(Double_t x)
 {
+   if (fConcurrentFill) return TH1::Fill(x, 1.);
    if (fBuffer)  return BufferFill(x,1);
 
    Int_t bin;
@@ -3284,10 +3388,22 @@ Int_t TH1::Fill(Double_t x)
 
 Int_t TH1::Fill(Double_t x, Double_t w)
 {
+   Int_t bin;
+   if (fConcurrentFill) {
+      // the axis cannot be extended: finding the bin does not change the histogram
+      bin = fXaxis.FindFixBin(x);
+      ConcurrentAddBinContent(bin, w);
+      if ((bin == 0 || bin > fXaxis.GetNbins()) && !GetStatOverflowsBehaviour()) {
+         ConcurrentAddStats(1, 0, 0);
+         return -1;
+      }
+      const Double_t stats[4] = {w, w*w, w*x, w*x*x};
+      ConcurrentAddStats(1, stats, 4);
+      return bin;
+   }
 
    if (fBuffer) return BufferFill(x,w);
 
-   Int_t bin;
    fEntries++;
    bin =fXaxis.FindBin(x);
    if (bin <0) return -1;
@@ -3378,33 +3494,81 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// The entries are filled by batches of kNFillBatch: the bins of a batch are
+/// computed at once with TAxis::FindFixBins, and its statistics are summed
+/// in a loop without branches before being added to the histogram ones.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
-   Int_t bin,i;
+   const Bool_t concurrent = fConcurrentFill != 0;
+   if (!concurrent) fEntries += ntimes;
+   // a weight not equal to 1 triggers the storage of the sum of squares of weights
+   // (when filling concurrently, it is stored from the start)
+   if (w && !concurrent && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (Int_t i = 0; i < ntimes; ++i) {
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
 
-   fEntries += ntimes;
-   Double_t ww = 1;
-   Int_t nbins   = fXaxis.GetNbins();
-   ntimes *= stride;
-   for (i=0;i<ntimes;i+=stride) {
-      bin =fXaxis.FindBin(x[i]);
-      if (bin <0) continue;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin, ww);
-      if (bin == 0 || bin > nbins) {
-         if (!GetStatOverflowsBehaviour()) continue;
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t bins[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, bins, stride);
+      for (Int_t i = 0; i < n; ++i) {
+         const Int_t bin = FindBatchBin(fXaxis, i, n, xb, bins, stride);
+         const Double_t ww = wb ? wb[i*stride] : 1.;
+         if (concurrent) {
+            ConcurrentAddBinContent(bin, ww);
+            continue;
+         }
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin, ww);
+      }
+      const Int_t nbins = fXaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0;
+      for (Int_t i = 0; i < n; ++i) {
+         const Bool_t stat = statOverflows || (bins[i] > 0 && bins[i] <= nbins);
+         const Double_t z = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         sumw   += z;
+         sumw2  += z*z;
+         sumwx  += z*xx;
+         sumwx2 += z*xx*xx;
       }
-      Double_t z= ww;
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
+      if (concurrent) {
+         const Double_t stats[4] = {sumw, sumw2, sumwx, sumwx2};
+         ConcurrentAddStats(n, stats, 4);
+         continue;
+      }
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the bin on axis of the value x[i*stride] of a batch of n values
+/// filled by FillN, whose bins were computed by TAxis::FindFixBins.
+///
+/// As in Fill, a value outside of an axis which can be extended extends it:
+/// the bins of the next values of the batch are then computed again.
+
+Int_t TH1::FindBatchBin(TAxis &axis, Int_t i, Int_t n, const Double_t *x, Int_t *bins, Int_t stride)
+{
+   Int_t bin = bins[i];
+   if ((bin == 0 || bin > axis.GetNbins()) && axis.CanExtend() && !axis.IsAlphanumeric()) {
+      bin = axis.FindBin(x[i*stride]);
+      bins[i] = bin;
+      if (i+1 < n) axis.FindFixBins(n-i-1, &x[(i+1)*stride], &bins[i+1], stride);
+   }
+   return bin;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
@@ -4186,6 +4350,7 @@ Bool_t TH1::GetDefaultSumw2()
 
 Double_t TH1::GetEntries() const
 {
+   TConcurrentFillLock lock(this);
    if (fBuffer) {
       Int_t nentries = (Int_t) fBuffer[0];
       if (nentries > 0) return nentries;
@@ -6185,6 +6350,61 @@ UInt_t TH1::SetCanExtend(UInt_t extendBitMask)
    return oldExtendBitMask;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable) the concurrent filling of the histogram.
+///
+/// In this mode Fill and FillN, with numeric coordinates, can be called on
+/// the histogram from several threads at the same time: the bin contents and
+/// the sums of squares of weights are updated with atomic operations, and the
+/// number of entries and the statistics are accumulated per thread in partial
+/// sums, added to the histogram when they are read (GetEntries, GetStats,
+/// GetMean, Copy, Write...). All the threads of a job can thus share a single
+/// histogram instead of filling a copy each: the memory does not grow with the
+/// number of threads. See also ROOT::TThreadedObject::SetShared.
+///
+/// While the histogram is filled concurrently, its other methods must not be
+/// called from other threads than the reading ones listed above. In this mode:
+///  - the axes cannot be extended,
+///  - the entries are not buffered (see SetBuffer),
+///  - the sum of squares of weights is stored from the start, unless the bit
+///    TH1::kIsNotW is set to declare that all the weights are 1.
+///
+/// The profiles, TH1K and TH2Poly histograms cannot be filled concurrently.
+/// A copy of a histogram filled concurrently is filled concurrently too.
+
+void TH1::SetConcurrentFill(Bool_t on)
+{
+   if (!on) {
+      if (fConcurrentFill) {
+         FoldConcurrentFill();
+         delete fConcurrentFill;
+         fConcurrentFill = 0;
+      }
+      return;
+   }
+   if (fConcurrentFill) return;
+
+   TArray *array = 0;
+   TConcurrentFill::EStorage storage = TConcurrentFill::kDouble;
+   if      ((array = dynamic_cast<TArrayD*>(this))) storage = TConcurrentFill::kDouble;
+   else if ((array = dynamic_cast<TArrayF*>(this))) storage = TConcurrentFill::kFloat;
+   else if ((array = dynamic_cast<TArrayI*>(this))) storage = TConcurrentFill::kInt;
+   else if ((array = dynamic_cast<TArrayS*>(this))) storage = TConcurrentFill::kShort;
+   else if ((array = dynamic_cast<TArrayC*>(this))) storage = TConcurrentFill::kChar;
+   // the profiles and TH1K fill more than the bin contents
+   if (!array || InheritsFrom(TProfile::Class()) || InheritsFrom("TProfile2D") || InheritsFrom("TProfile3D") ||
+       InheritsFrom("TH1K")) {
+      Error("SetConcurrentFill", "histograms of class %s cannot be filled concurrently", ClassName());
+      return;
+   }
+
+   if (fBuffer) BufferEmpty(1);
+   if (SetCanExtend(kNoAxis) != kNoAxis)
+      Warning("SetConcurrentFill", "the axes of %s cannot be extended when it is filled concurrently", GetName());
+   if (!fSumw2.fN && !TestBit(kIsNotW)) Sumw2();
+   fConcurrentFill = new TConcurrentFill(storage, array);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function to set the default buffer size for automatic histograms.
 /// When an histogram is created with one of its axis lower limit greater
@@ -6500,6 +6720,7 @@ void TH1::Streamer(TBuffer &b)
       b.CheckByteCount(R__s, R__c, TH1::IsA());
 
    } else {
+      TConcurrentFillLock lock(this);
       b.WriteClassBuffer(TH1::Class(),this);
    }
 }
@@ -6630,6 +6851,8 @@ void TH1::Reset(Option_t *option)
    // reset in calling TH1D::Reset. For this we need to reset the stats afterwards
    // It may be needed for computing the axis limits....
    if (fBuffer) {BufferEmpty(); fBuffer[0] = 0;}
+   // the partial sums of a concurrent filling are reset with the statistics
+   if (fConcurrentFill) FoldConcurrentFill();
 
    // need to reset also the statistics
    // (needs to be done after calling BufferEmpty() )
@@ -7217,6 +7440,7 @@ Double_t TH1::GetKurtosis(Int_t axis) const
 
 void TH1::GetStats(Double_t *stats) const
 {
+   TConcurrentFillLock lock(this);
    if (fBuffer) ((TH1*)this)->BufferEmpty();
 
    // Loop on bins (possibly including underflows/overflows)
@@ -7274,6 +7498,81 @@ void TH1::PutStats(Double_t *stats)
    fTsumwx2 = stats[3];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add to the current statistics the values in array stats, in the order of
+/// GetStats. Used to fold the statistics of a concurrent filling.
+
+void TH1::AddConcurrentStats(const Double_t *stats)
+{
+   fTsumw   += stats[0];
+   fTsumw2  += stats[1];
+   fTsumwx  += stats[2];
+   fTsumwx2 += stats[3];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add w to the content of bin, and w*w to its sum of squares of weights if
+/// it is stored, with atomic operations. Can only be called when filling
+/// concurrently, see SetConcurrentFill.
+
+void TH1::ConcurrentAddBinContent(Int_t bin, Double_t w)
+{
+   TArray *array = fConcurrentFill->fArray;
+   switch (fConcurrentFill->fStorage) {
+      case TConcurrentFill::kChar:   AtomicAddContent(&static_cast<TArrayC*>(array)->fArray[bin], w, 127); break;
+      case TConcurrentFill::kShort:  AtomicAddContent(&static_cast<TArrayS*>(array)->fArray[bin], w, 32767); break;
+      case TConcurrentFill::kInt:    AtomicAddContent(&static_cast<TArrayI*>(array)->fArray[bin], w, 2147483647); break;
+      case TConcurrentFill::kFloat:  AtomicAddContent(&static_cast<TArrayF*>(array)->fArray[bin], w); break;
+      case TConcurrentFill::kDouble: AtomicAddContent(&static_cast<TArrayD*>(array)->fArray[bin], w); break;
+   }
+   if (fSumw2.fN) AtomicAddContent(&fSumw2.fArray[bin], w*w);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add entries to the number of entries and the nstat values of stats (in the
+/// order of GetStats, possibly none) to the statistics of a histogram filled
+/// concurrently. They are accumulated in partial sums of the calling thread,
+/// until FoldConcurrentFill adds them to the statistics of the histogram.
+
+void TH1::ConcurrentAddStats(Double_t entries, const Double_t *stats, Int_t nstat)
+{
+   std::atomic<Double_t> *stripe = TConcurrentFill::GetStripe(fConcurrentFill->fStripes);
+   AtomicAdd(stripe[0], entries);
+   for (Int_t i = 0; i < nstat; ++i) AtomicAdd(stripe[i+1], stats[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the partial sums of the entries and statistics of a concurrent filling
+/// to the statistics of the histogram. The statistics are exact once the
+/// threads filling the histogram are done.
+
+void TH1::FoldConcurrentFill()
+{
+   if (!fConcurrentFill) return;
+   std::lock_guard<std::mutex> lock(fConcurrentFill->fFoldMutex);
+   fConcurrentFill->Fold(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fold the partial sums of the concurrent filling of h, if any, and hold the
+/// lock of the folds until destruction, so that the statistics of h can be
+/// read while other threads fill it and read them.
+
+TH1::TConcurrentFillLock::TConcurrentFillLock(const TH1 *h) : fFill(h->fConcurrentFill)
+{
+   if (!fFill) return;
+   fFill->fFoldMutex.lock();
+   fFill->Fold(const_cast<TH1*>(h));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the lock of the folds.
+
+TH1::TConcurrentFillLock::~TConcurrentFillLock()
+{
+   if (fFill) fFill->fFoldMutex.unlock();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset the statistics including the number of entries
 /// and replace with values calculates from bin content
@@ -7284,6 +7583,7 @@ void TH1::PutStats(Double_t *stats)
 void TH1::ResetStats()
 {
    Double_t stats[kNstat] = {0};
+   if (fConcurrentFill) FoldConcurrentFill();
    fTsumw = 0;
    fEntries = 1; // to force re-calculation of the statistics in TH1::GetStats
    GetStats(stats);
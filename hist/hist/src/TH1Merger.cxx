@@ -8,9 +8,17 @@
 #include "TError.h"
 #include "THashList.h"
 #include "TClass.h"
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <utility>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
 
 #define PRINTRANGE(a, b, bn)                                                                                          \
    Printf(" base: %f %f %d, %s: %f %f %d", a->GetXmin(), a->GetXmax(), a->GetNbins(), bn, b->GetXmin(), b->GetXmax(), \
@@ -750,7 +758,11 @@ Bool_t TH1Merger::SameAxesMerge() {
    }
    fH0->GetStats(totstats);
    Double_t nentries = fH0->GetEntries();
-   
+
+   // histograms to add, in the order of the list
+   std::vector<TH1 *> hists;
+   hists.reserve(fInputList.GetSize());
+
    TIter next(&fInputList); 
    while (TH1* hist=(TH1*)next()) {
       // process only if the histogram has limits; otherwise it was processed before
@@ -768,19 +780,45 @@ Bool_t TH1Merger::SameAxesMerge() {
          totstats[i] += stats[i];
       nentries += hist->GetEntries();
 
-         //Int_t nx = hist->GetXaxis()->GetNbins();
-         // loop on bins of the histogram and do the merge
-      for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
+      hists.push_back(hist);
+   }
 
-         Double_t cu = hist->RetrieveBinContent(ibin);
-         Double_t e1sq = TMath::Abs(cu);
-         if (fH0->fSumw2.fN) e1sq= hist->GetBinErrorSqUnchecked(ibin);
+   // loop on the bins [first, last) of the histograms and do the merge.
+   // Each bin receives the contents in the order of the list, whatever the range.
+   const Bool_t hasSumw2 = fH0->fSumw2.fN != 0;
+   auto mergeBins = [&](Int_t first, Int_t last) {
+      for (TH1 *hist : hists) {
+         for (Int_t ibin = first; ibin < last; ibin++) {
+
+            Double_t cu = hist->RetrieveBinContent(ibin);
+            Double_t e1sq = TMath::Abs(cu);
+            if (hasSumw2) e1sq= hist->GetBinErrorSqUnchecked(ibin);
 
-         fH0->AddBinContent(ibin,cu);
-         if (fH0->fSumw2.fN) fH0->fSumw2.fArray[ibin] += e1sq;
+            fH0->AddBinContent(ibin,cu);
+            if (hasSumw2) fH0->fSumw2.fArray[ibin] += e1sq;
 
+         }
       }
-   }
+   };
+
+   const Int_t ncells = fH0->fNcells;
+#ifdef R__USE_IMT
+   // Large histograms: the bin range is split among the threads, each one
+   // adding all the histograms in its slice of the merged histogram.
+   const Int_t kNBinsPerTask = 16384;
+   const Long64_t kMinCells = 1 << 20;
+   const Int_t ntasks = (ncells + kNBinsPerTask - 1) / kNBinsPerTask;
+   if (ROOT::IsImplicitMTEnabled() && ntasks > 1 && Long64_t(ncells) * hists.size() >= kMinCells) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t task) {
+                      const Int_t first = task * kNBinsPerTask;
+                      mergeBins(first, std::min(first + kNBinsPerTask, ncells));
+                   },
+                   ROOT::TSeqU(ntasks));
+   } else
+#endif
+      mergeBins(0, ncells);
+
    //copy merged stats
    fH0->PutStats(totstats);
    fH0->SetEntries(nentries);
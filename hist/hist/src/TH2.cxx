@@ -313,6 +313,7 @@ Int_t TH2::Fill(Double_t )
 
 Int_t TH2::Fill(Double_t x,Double_t y)
 {
+   if (IsConcurrentFill()) return TH2::Fill(x, y, 1.);
    if (fBuffer) return BufferFill(x,y,1);
 
    Int_t binx, biny, bin;
@@ -357,9 +358,25 @@ Int_t TH2::Fill(Double_t x,Double_t y)
 
 Int_t TH2::Fill(Double_t x, Double_t y, Double_t w)
 {
+   Int_t binx, biny, bin;
+   if (IsConcurrentFill()) {
+      // the axes cannot be extended: finding the bin does not change the histogram
+      binx = fXaxis.FindFixBin(x);
+      biny = fYaxis.FindFixBin(y);
+      bin  = biny*(fXaxis.GetNbins()+2) + binx;
+      ConcurrentAddBinContent(bin, w);
+      if ((binx == 0 || binx > fXaxis.GetNbins() || biny == 0 || biny > fYaxis.GetNbins()) &&
+          !GetStatOverflowsBehaviour()) {
+         ConcurrentAddStats(1, 0, 0);
+         return -1;
+      }
+      const Double_t stats[7] = {w, w*w, w*x, w*x*x, w*y, w*y*y, w*x*y};
+      ConcurrentAddStats(1, stats, 7);
+      return bin;
+   }
+
    if (fBuffer) return BufferFill(x,y,w);
 
-   Int_t binx, biny, bin;
    fEntries++;
    binx = fXaxis.FindBin(x);
    biny = fYaxis.FindBin(y);
@@ -532,7 +549,7 @@ Int_t TH2::Fill(Double_t x, const char *namey, Double_t w)
 
 void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
-   Int_t binx, biny, bin, i;
+   Int_t i;
    ntimes *= stride;
    Int_t ifirst = 0;
 
@@ -551,31 +568,69 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
          return;
    }
 
-   Double_t ww = 1;
-   for (i=ifirst;i<ntimes;i+=stride) {
-      fEntries++;
-      binx = fXaxis.FindBin(x[i]);
-      biny = fYaxis.FindBin(y[i]);
-      if (binx <0 || biny <0) continue;
-      bin  = biny*(fXaxis.GetNbins()+2) + binx;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin,ww);
-      if (binx == 0 || binx > fXaxis.GetNbins()) {
-         if (!GetStatOverflowsBehaviour()) continue;
+   // fill by batches, see TH1::DoFillN
+   x += ifirst;
+   y += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst)/stride;
+   const Bool_t concurrent = IsConcurrentFill();
+   if (!concurrent) fEntries += ntimes;
+   if (w && !concurrent && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i = 0; i < ntimes; ++i) {
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kNFillBatch], binsy[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, binsx, stride);
+      fYaxis.FindFixBins(n, yb, binsy, stride);
+      for (i = 0; i < n; ++i) {
+         const Int_t binx = FindBatchBin(fXaxis, i, n, xb, binsx, stride);
+         const Int_t biny = FindBatchBin(fYaxis, i, n, yb, binsy, stride);
+         const Int_t bin  = biny*(fXaxis.GetNbins()+2) + binx;
+         const Double_t ww = wb ? wb[i*stride] : 1.;
+         if (concurrent) {
+            ConcurrentAddBinContent(bin, ww);
+            continue;
+         }
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+      }
+      const Int_t nbinsx = fXaxis.GetNbins();
+      const Int_t nbinsy = fYaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+      for (i = 0; i < n; ++i) {
+         const Bool_t stat = statOverflows ||
+            (binsx[i] > 0 && binsx[i] <= nbinsx && binsy[i] > 0 && binsy[i] <= nbinsy);
+         const Double_t z  = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         const Double_t yy = stat ? yb[i*stride] : 0.;
+         sumw   += z;
+         sumw2  += z*z;
+         sumwx  += z*xx;
+         sumwx2 += z*xx*xx;
+         sumwy  += z*yy;
+         sumwy2 += z*yy*yy;
+         sumwxy += z*xx*yy;
       }
-      if (biny == 0 || biny > fYaxis.GetNbins()) {
-         if (!GetStatOverflowsBehaviour()) continue;
+      if (concurrent) {
+         const Double_t stats[7] = {sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy};
+         ConcurrentAddStats(n, stats, 7);
+         continue;
       }
-      Double_t z= ww; //(ww > 0 ? ww : -ww);
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
-      fTsumwy  += z*y[i];
-      fTsumwy2 += z*y[i]*y[i];
-      fTsumwxy += z*x[i]*y[i];
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      fTsumwy  += sumwy;
+      fTsumwy2 += sumwy2;
+      fTsumwxy += sumwxy;
    }
 }
 
@@ -1142,6 +1197,7 @@ void TH2::GetRandom2(Double_t &x, Double_t &y)
 
 void TH2::GetStats(Double_t *stats) const
 {
+   TConcurrentFillLock lock(this);
    if (fBuffer) ((TH2*)this)->BufferEmpty();
 
    if ((fTsumw == 0 && fEntries > 0) || fXaxis.TestBit(TAxis::kAxisRange) || fYaxis.TestBit(TAxis::kAxisRange)) {
@@ -2372,6 +2428,19 @@ void TH2::PutStats(Double_t *stats)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add to the current statistics the values in array stats, in the order of
+/// GetStats. Used to fold the statistics of a concurrent filling.
+
+void TH2::AddConcurrentStats(const Double_t *stats)
+{
+   TH1::AddConcurrentStats(stats);
+   fTsumwy  += stats[4];
+   fTsumwy2 += stats[5];
+   fTsumwxy += stats[6];
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Compute the X distribution of quantiles in the other variable Y
 /// name is the name of the returned histogram
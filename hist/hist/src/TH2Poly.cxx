@@ -17,6 +17,15 @@
 #include "TList.h"
 #include "TMath.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
+#include <mutex>
+#include <vector>
+
 ClassImp(TH2Poly);
 
 /** \class TH2Poly
@@ -138,12 +147,227 @@ filling, it also adds a constant time delay into the code. When `Fill()`
 is to be called many times, it is more efficient to divide the histogram into
 a large number cells. However, if the histogram is to be filled only a few
 times, it is better to divide into a small number of cells.
+
+## Bin Index
+`Fill()`, `FillN()` and `FindBin()` do not walk the partition cells: they use
+an index of the bins built the first time one of them is called. Its grid has
+about one cell per bin, the bins of each cell and their vertices being stored
+in contiguous arrays, and the bounding box of each bin is checked before its
+polygon. With many bins (e.g. the cells of a detector), the filling is then
+much faster, whatever the partition chosen. The index is rebuilt when bins are
+added or when the partition is changed; `ChangePartition()` must be called if
+the polygons of the bins are modified.
+
+Several threads can look up bins with `FindBin()` at the same time. `FillN()`
+looks up the bins of large arrays of entries in parallel when the implicit
+multi-threading is enabled.
 */
 
+////////////////////////////////////////////////////////////////////////////////
+/// Lookup structure of the bins of a TH2Poly, see GetBinIndex.
+///
+/// A grid following the mean size of the bins stores for each of its cells the
+/// positions of the bins whose bounding box overlaps it. The candidates of a
+/// point are checked against their bounding box, then against their polygons,
+/// whose vertices are copied in contiguous arrays and tested as in
+/// TMath::IsInside, without branches. The lookup does not change the index.
+
+struct TH2Poly::TBinIndex {
+   enum { kCellsPerBin = 4, kMaxCells = 4096 };
+
+   const TList *fBinList;          ///< List of the bins indexed
+   Int_t        fNbins;            ///< Number of bins indexed
+   Double_t     fXmin, fXmax;      ///< X limits of the histogram
+   Double_t     fYmin, fYmax;      ///< Y limits of the histogram
+   Int_t        fNx, fNy;          ///< Number of cells of the grid along x and y
+   Double_t     fStepX, fStepY;    ///< Size of a cell
+   std::vector<TH2PolyBin *> fBins;     ///< Bins, in the order of the list of bins
+   std::vector<Double_t>     fBoxes;    ///< Bounding box of each bin: xmin, xmax, ymin, ymax
+   std::vector<char>         fGeneric;  ///< Whether a bin is tested with TH2PolyBin::IsInside
+   std::vector<Int_t>        fBinRings; ///< Polygons of bin i: fBinRings[i] to fBinRings[i+1]
+   std::vector<Int_t>        fRings;    ///< Vertices of polygon r: fRings[r] to fRings[r+1], last vertex first
+   std::vector<Double_t>     fX, fY;    ///< Vertices of the polygons
+   std::vector<Int_t>        fCellStart; ///< Bins of cell c: fCellBins[fCellStart[c]] to fCellBins[fCellStart[c+1]]
+   std::vector<Int_t>        fCellBins;  ///< Positions of the bins overlapping each cell
+
+   TBinIndex(TH2Poly &h);
+
+   /// Whether the index still describes the bins of h.
+   Bool_t IsValid(const TH2Poly &h) const
+   {
+      return fBinList == h.fBins && fNbins == h.fBins->GetSize() &&
+             (!fNbins || (fBins.front() == h.fBins->First() && fBins.back() == h.fBins->Last())) &&
+             fXmin == h.fXaxis.GetXmin() && fXmax == h.fXaxis.GetXmax() &&
+             fYmin == h.fYaxis.GetXmin() && fYmax == h.fYaxis.GetXmax();
+   }
+
+   /// Cell of the grid of coordinate v, origin min and size step along an axis of n cells.
+   static Int_t Cell(Double_t v, Double_t min, Double_t step, Int_t n)
+   {
+      const Double_t c = step > 0 ? floor((v - min)/step) : 0;
+      if (!(c >= 0)) return 0;
+      return c >= n ? n - 1 : (Int_t)c;
+   }
+
+   void           AddPolygon(const TGraph *g);
+   Bool_t         IsInside(Int_t pos, Double_t x, Double_t y) const;
+   TH2PolyBin    *Find(Double_t x, Double_t y) const;
+   Int_t          FindBin(Double_t x, Double_t y, TH2PolyBin *&bin) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index the bins of histogram h.
+
+TH2Poly::TBinIndex::TBinIndex(TH2Poly &h)
+   : fBinList(h.fBins), fNbins(h.fBins->GetSize()),
+     fXmin(h.fXaxis.GetXmin()), fXmax(h.fXaxis.GetXmax()), fYmin(h.fYaxis.GetXmin()), fYmax(h.fYaxis.GetXmax())
+{
+   fBins.reserve(fNbins);
+   fBoxes.reserve(4*fNbins);
+   fBinRings.push_back(0);
+   fRings.push_back(0);
+   Double_t sumWidth = 0, sumHeight = 0;
+   TIter next(h.fBins);
+   while (TH2PolyBin *bin = (TH2PolyBin*)next()) {
+      fBins.push_back(bin);
+      fBoxes.push_back(bin->GetXMin());
+      fBoxes.push_back(bin->GetXMax());
+      fBoxes.push_back(bin->GetYMin());
+      fBoxes.push_back(bin->GetYMax());
+      sumWidth  += bin->GetXMax() - bin->GetXMin();
+      sumHeight += bin->GetYMax() - bin->GetYMin();
+
+      // only the polygons of class TGraph are tested by TH2PolyBin::IsInside with TMath::IsInside
+      Bool_t generic = kFALSE;
+      TObject *poly = bin->GetPolygon();
+      if (poly && poly->IsA() == TGraph::Class()) {
+         AddPolygon((TGraph*)poly);
+      } else if (poly && poly->IsA() == TMultiGraph::Class() && ((TMultiGraph*)poly)->GetListOfGraphs()) {
+         TIter nextGraph(((TMultiGraph*)poly)->GetListOfGraphs());
+         while (TObject *g = nextGraph()) {
+            if (g->IsA() == TGraph::Class()) AddPolygon((TGraph*)g);
+            else generic = kTRUE;
+         }
+      }
+      fGeneric.push_back(generic);
+      fBinRings.push_back(fRings.size() - 1);
+   }
+
+   // about one cell per bin of mean size, at most kCellsPerBin cells per bin
+   Double_t nx = 1, ny = 1;
+   const Double_t width = fXmax - fXmin, height = fYmax - fYmin;
+   if (fNbins > 0 && width > 0 && height > 0) {
+      nx = sumWidth > 0 ? width*fNbins/sumWidth : 1;
+      ny = sumHeight > 0 ? height*fNbins/sumHeight : 1;
+      const Double_t scale = TMath::Sqrt(Double_t(kCellsPerBin)*fNbins/(nx*ny));
+      if (scale < 1) { nx *= scale; ny *= scale; }
+   }
+   fNx = (Int_t)TMath::Max(1., TMath::Min(nx, Double_t(kMaxCells)));
+   fNy = (Int_t)TMath::Max(1., TMath::Min(ny, Double_t(kMaxCells)));
+   fStepX = width/fNx;
+   fStepY = height/fNy;
+
+   // the cells overlapped by the bounding boxes, computed as the cells of the points
+   std::vector<Int_t> first(4*fNbins);
+   fCellStart.assign(fNx*fNy + 1, 0);
+   for (Int_t pos = 0; pos < fNbins; ++pos) {
+      const Double_t *box = &fBoxes[4*pos];
+      Int_t *cells = &first[4*pos];
+      cells[0] = Cell(box[0], fXmin, fStepX, fNx);
+      cells[1] = Cell(box[1], fXmin, fStepX, fNx);
+      cells[2] = Cell(box[2], fYmin, fStepY, fNy);
+      cells[3] = Cell(box[3], fYmin, fStepY, fNy);
+      for (Int_t j = cells[2]; j <= cells[3]; ++j)
+         for (Int_t i = cells[0]; i <= cells[1]; ++i)
+            ++fCellStart[i + fNx*j + 1];
+   }
+   for (Int_t c = 0; c < fNx*fNy; ++c) fCellStart[c+1] += fCellStart[c];
+   fCellBins.resize(fCellStart.back());
+   std::vector<Int_t> fill(fCellStart.begin(), fCellStart.end() - 1);
+   for (Int_t pos = 0; pos < fNbins; ++pos) {
+      const Int_t *cells = &first[4*pos];
+      for (Int_t j = cells[2]; j <= cells[3]; ++j)
+         for (Int_t i = cells[0]; i <= cells[1]; ++i)
+            fCellBins[fill[i + fNx*j]++] = pos;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the vertices of g as a polygon of the last bin.
+
+void TH2Poly::TBinIndex::AddPolygon(const TGraph *g)
+{
+   const Int_t n = g->GetN();
+   if (n > 0) {
+      fX.push_back(g->GetX()[n-1]);
+      fY.push_back(g->GetY()[n-1]);
+      fX.insert(fX.end(), g->GetX(), g->GetX() + n);
+      fY.insert(fY.end(), g->GetY(), g->GetY() + n);
+   }
+   fRings.push_back(fX.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Whether (x,y) is inside the bin at position pos, as TH2PolyBin::IsInside.
+
+Bool_t TH2Poly::TBinIndex::IsInside(Int_t pos, Double_t x, Double_t y) const
+{
+   if (fGeneric[pos]) return fBins[pos]->IsInside(x, y);
+   for (Int_t r = fBinRings[pos]; r < fBinRings[pos+1]; ++r) {
+      const Int_t n = fRings[r+1] - fRings[r] - 1;
+      const Double_t *vx = &fX[fRings[r]];
+      const Double_t *vy = &fY[fRings[r]];
+      // TMath::IsInside, the vertex i+1 following the vertex i
+      Bool_t odd = kFALSE;
+      for (Int_t i = 0; i < n; ++i) {
+         const Bool_t crosses = (vy[i+1] < y && vy[i] >= y) || (vy[i] < y && vy[i+1] >= y);
+         const Double_t dy = crosses ? vy[i] - vy[i+1] : 1.;
+         const Double_t xcross = vx[i+1] + (y - vy[i+1])/dy*(vx[i] - vx[i+1]);
+         odd ^= crosses && xcross < x;
+      }
+      if (odd) return kTRUE;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first bin containing (x,y), 0 if there is none.
+
+TH2PolyBin *TH2Poly::TBinIndex::Find(Double_t x, Double_t y) const
+{
+   const Int_t cell = Cell(x, fXmin, fStepX, fNx) + fNx*Cell(y, fYmin, fStepY, fNy);
+   for (Int_t k = fCellStart[cell]; k < fCellStart[cell+1]; ++k) {
+      const Int_t pos = fCellBins[k];
+      const Double_t *box = &fBoxes[4*pos];
+      if (x < box[0] || x > box[1] || y < box[2] || y > box[3]) continue;
+      if (IsInside(pos, x, y)) return fBins[pos];
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of the bin containing (x,y), as TH2Poly::FindBin, and set
+/// bin to it, or to 0 for the overflow bins and the sea.
+
+Int_t TH2Poly::TBinIndex::FindBin(Double_t x, Double_t y, TH2PolyBin *&bin) const
+{
+   bin = 0;
+   Int_t overflow = 0;
+   if      (y > fYmax) overflow += -1;
+   else if (y > fYmin) overflow += -4;
+   else                overflow += -7;
+   if      (x > fXmax) overflow += -2;
+   else if (x > fXmin) overflow += -1;
+   if (overflow != -5) return overflow;
+
+   bin = Find(x, y);
+   return bin ? bin->GetBinNumber() : -5;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor. No boundaries specified.
 
-TH2Poly::TH2Poly()
+TH2Poly::TH2Poly() : fBinIndex(nullptr)
 {
    Initialize(0., 0., 0., 0., 25, 25);
    SetName("NoName");
@@ -157,6 +381,7 @@ TH2Poly::TH2Poly()
 
 TH2Poly::TH2Poly(const char *name,const char *title, Double_t xlow,Double_t xup
                                              , Double_t ylow,Double_t yup)
+   : fBinIndex(nullptr)
 {
    Initialize(xlow, xup, ylow, yup, 25, 25);
    SetName(name);
@@ -170,6 +395,7 @@ TH2Poly::TH2Poly(const char *name,const char *title, Double_t xlow,Double_t xup
 TH2Poly::TH2Poly(const char *name,const char *title,
            Int_t nX, Double_t xlow, Double_t xup,
            Int_t nY, Double_t ylow, Double_t yup)
+   : fBinIndex(nullptr)
 {
    Initialize(xlow, xup, ylow, yup, nX, nY);
    SetName(name);
@@ -182,6 +408,7 @@ TH2Poly::TH2Poly(const char *name,const char *title,
 
 TH2Poly::~TH2Poly()
 {
+   ResetBinIndex();
    delete[] fCells;
    delete[] fIsEmpty;
    delete[] fCompletelyInside;
@@ -189,6 +416,34 @@ TH2Poly::~TH2Poly()
    delete fBins;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bins, built if the bins, the partition or the
+/// limits of the histogram changed since the last call. Several threads can
+/// call it at the same time, as long as none of them modifies the histogram.
+
+TH2Poly::TBinIndex *TH2Poly::GetBinIndex()
+{
+   TBinIndex *index = fBinIndex.load(std::memory_order_acquire);
+   if (index && index->IsValid(*this)) return index;
+
+   static std::mutex buildMutex;
+   std::lock_guard<std::mutex> lock(buildMutex);
+   index = fBinIndex.load(std::memory_order_acquire);
+   if (index && index->IsValid(*this)) return index;
+   delete index;
+   index = new TBinIndex(*this);
+   fBinIndex.store(index, std::memory_order_release);
+   return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the index of the bins, it is built again when needed.
+
+void TH2Poly::ResetBinIndex()
+{
+   delete fBinIndex.exchange(nullptr);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create appropriate histogram bin.
 ///  e.g. TH2Poly        creates TH2PolyBin,
@@ -249,6 +504,7 @@ Int_t TH2Poly::AddBin(TObject *poly)
 
    fBins->Add((TObject*) bin);
    SetNewBinAdded(kTRUE);
+   ResetBinIndex();
 
    // Adds the bin to the partition matrix
    AddBinToPartition(bin);
@@ -462,6 +718,7 @@ void TH2Poly::ChangePartition(Int_t n, Int_t m)
 {
    fCellX = n;                          // Set the number of cells
    fCellY = m;                          // Set the number of cells
+   ResetBinIndex();                     // The bin index is rebuilt on demand
 
    delete [] fCells;                    // Deletes the old partition
 
@@ -565,41 +822,8 @@ void TH2Poly::Reset(Option_t *opt)
 
 Int_t TH2Poly::FindBin(Double_t x, Double_t y, Double_t)
 {
-
-   // Checks for overflow/underflow
-   Int_t overflow = 0;
-   if      (y > fYaxis.GetXmax()) overflow += -1;
-   else if (y > fYaxis.GetXmin()) overflow += -4;
-   else                           overflow += -7;
-   if      (x > fXaxis.GetXmax()) overflow += -2;
-   else if (x > fXaxis.GetXmin()) overflow += -1;
-   if (overflow != -5) return overflow;
-
-   // Finds the cell (x,y) coordinates belong to
-   Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
-   Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
-
-   // Make sure the array indices are correct.
-   if (n>=fCellX) n = fCellX-1;
-   if (m>=fCellY) m = fCellY-1;
-   if (n<0)       n = 0;
-   if (m<0)       m = 0;
-
-   if (fIsEmpty[n+fCellX*m]) return -5;
-
    TH2PolyBin *bin;
-
-   TIter next(&fCells[n+fCellX*m]);
-   TObject *obj;
-
-   // Search for the bin in the cell
-   while ((obj=next())) {
-      bin  = (TH2PolyBin*)obj;
-      if (bin->IsInside(x,y)) return bin->GetBinNumber();
-   }
-
-   // If the search has not returned a bin, the point must be on "the sea"
-   return -5;
+   return GetBinIndex()->FindBin(x, y, bin);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -618,65 +842,31 @@ Int_t TH2Poly::Fill(Double_t x, Double_t y)
 Int_t TH2Poly::Fill(Double_t x, Double_t y, Double_t w)
 {
    if (fNcells <= kNOverflow) return 0;
-   Int_t overflow = 0;
-   if      (y > fYaxis.GetXmax()) overflow += -1;
-   else if (y > fYaxis.GetXmin()) overflow += -4;
-   else                           overflow += -7;
-   if      (x > fXaxis.GetXmax()) overflow += -2;
-   else if(x > fXaxis.GetXmin())  overflow += -1;
-   if (overflow != -5) {
-      fOverflow[-overflow - 1]+= w;
-      if (fSumw2.fN) fSumw2.fArray[-overflow - 1] += w*w;
-      return overflow;
-   }
-
-   // Finds the cell (x,y) coordinates belong to
-   Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
-   Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
-
-   // Make sure the array indices are correct.
-   if (n>=fCellX) n = fCellX-1;
-   if (m>=fCellY) m = fCellY-1;
-   if (n<0)       n = 0;
-   if (m<0)       m = 0;
-
-   if (fIsEmpty[n+fCellX*m]) {
-      fOverflow[4]+= w;
-      if (fSumw2.fN) fSumw2.fArray[4] += w*w;
-      return -5;
-   }
 
    TH2PolyBin *bin;
-   Int_t bi;
-
-   TIter next(&fCells[n+fCellX*m]);
-   TObject *obj;
-
-   while ((obj=next())) {
-      bin  = (TH2PolyBin*)obj;
-      // needs to account offset in array for overflow bins
-      bi = bin->GetBinNumber()-1+kNOverflow;
-      if (bin->IsInside(x,y)) {
-         bin->Fill(w);
+   Int_t binNumber = GetBinIndex()->FindBin(x, y, bin);
+   if (!bin) {
+      // overflow bins or the sea
+      fOverflow[-binNumber - 1]+= w;
+      if (fSumw2.fN) fSumw2.fArray[-binNumber - 1] += w*w;
+      return binNumber;
+   }
 
-         // Statistics
-         fTsumw   = fTsumw + w;
-         fTsumwx  = fTsumwx + w*x;
-         fTsumwx2 = fTsumwx2 + w*x*x;
-         fTsumwy  = fTsumwy + w*y;
-         fTsumwy2 = fTsumwy2 + w*y*y;
-         if (fSumw2.fN) fSumw2.fArray[bi] += w*w;
-         fEntries++;
+   bin->Fill(w);
 
-         SetBinContentChanged(kTRUE);
+   // Statistics
+   fTsumw   = fTsumw + w;
+   fTsumwx  = fTsumwx + w*x;
+   fTsumwx2 = fTsumwx2 + w*x*x;
+   fTsumwy  = fTsumwy + w*y;
+   fTsumwy2 = fTsumwy2 + w*y*y;
+   // needs to account offset in array for overflow bins
+   if (fSumw2.fN) fSumw2.fArray[binNumber-1+kNOverflow] += w*w;
+   fEntries++;
 
-         return bin->GetBinNumber();
-      }
-   }
+   SetBinContentChanged(kTRUE);
 
-   fOverflow[4]+= w;
-   if (fSumw2.fN) fSumw2.fArray[4] += w*w;
-   return -5;
+   return binNumber;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -710,15 +900,80 @@ Int_t TH2Poly::Fill(const char* name, Double_t w)
 ///                      (array size must be ntimes*stride)
 /// \param [in] x:       array of x values to be histogrammed
 /// \param [in] y:       array of y values to be histogrammed
-/// \param [in] w:       array of weights
+/// \param [in] w:       array of weights, all weights are 1 if w is null
 /// \param [in] stride:  step size through arrays x, y and w
+///
+/// The result is the one of calling Fill(x,y,w) for each entry. The bins of
+/// the entries are looked up by blocks, in parallel if the implicit
+/// multi-threading is enabled. For a derived class, which may reimplement
+/// Fill(x,y,w), Fill is called for each entry.
 
 void TH2Poly::FillN(Int_t ntimes, const Double_t* x, const Double_t* y,
                                const Double_t* w, Int_t stride)
 {
-   for (int i = 0; i < ntimes; i += stride) {
-      Fill(x[i], y[i], w[i]);
+   if (IsA() != TH2Poly::Class()) {
+      for (Int_t i = 0; i < ntimes; ++i)
+         Fill(x[i*stride], y[i*stride], w ? w[i*stride] : 1.);
+      return;
+   }
+   if (fNcells <= kNOverflow || ntimes <= 0) return;
+
+   const Int_t kNBlock = 65536;  // entries looked up before filling
+   const Int_t kNChunk = 4096;   // entries looked up by a task
+   const TBinIndex *index = GetBinIndex();
+   const Int_t nblock = TMath::Min(ntimes, kNBlock);
+   std::vector<Int_t> binNumbers(nblock);
+   std::vector<TH2PolyBin*> bins(nblock);
+
+   Double_t tsumw = 0, tsumwx = 0, tsumwx2 = 0, tsumwy = 0, tsumwy2 = 0;
+   Int_t nentries = 0;
+   for (Int_t first = 0; first < ntimes; first += kNBlock) {
+      const Int_t n = TMath::Min(kNBlock, ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+
+      auto findBins = [&](Int_t begin, Int_t end) {
+         for (Int_t i = begin; i < end; ++i)
+            binNumbers[i] = index->FindBin(xb[i*stride], yb[i*stride], bins[i]);
+      };
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && n > kNChunk) {
+         ROOT::TThreadExecutor pool;
+         const UInt_t nchunks = (n + kNChunk - 1)/kNChunk;
+         pool.Foreach([&](UInt_t chunk) {
+            findBins(chunk*kNChunk, TMath::Min(n, Int_t(chunk + 1)*kNChunk));
+         }, ROOT::TSeqU(nchunks));
+      } else
+#endif
+         findBins(0, n);
+
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t wi = wb ? wb[i*stride] : 1.;
+         if (!bins[i]) {
+            fOverflow[-binNumbers[i] - 1] += wi;
+            if (fSumw2.fN) fSumw2.fArray[-binNumbers[i] - 1] += wi*wi;
+            continue;
+         }
+         const Double_t xi = xb[i*stride], yi = yb[i*stride];
+         bins[i]->Fill(wi);
+         tsumw   += wi;
+         tsumwx  += wi*xi;
+         tsumwx2 += wi*xi*xi;
+         tsumwy  += wi*yi;
+         tsumwy2 += wi*yi*yi;
+         if (fSumw2.fN) fSumw2.fArray[binNumbers[i]-1+kNOverflow] += wi*wi;
+         ++nentries;
+      }
    }
+
+   fTsumw   += tsumw;
+   fTsumwx  += tsumwx;
+   fTsumwx2 += tsumwx2;
+   fTsumwy  += tsumwy;
+   fTsumwy2 += tsumwy2;
+   fEntries += nentries;
+   if (nentries) SetBinContentChanged(kTRUE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
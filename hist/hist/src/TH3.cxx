@@ -298,6 +298,7 @@ Int_t TH3::Fill(Double_t )
 
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 {
+   if (IsConcurrentFill()) return TH3::Fill(x, y, z, 1.);
    if (fBuffer) return BufferFill(x,y,z,1);
 
    Int_t binx, biny, binz, bin;
@@ -346,9 +347,26 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 {
+   Int_t binx, biny, binz, bin;
+   if (IsConcurrentFill()) {
+      // the axes cannot be extended: finding the bin does not change the histogram
+      binx = fXaxis.FindFixBin(x);
+      biny = fYaxis.FindFixBin(y);
+      binz = fZaxis.FindFixBin(z);
+      bin  =  binx + (fXaxis.GetNbins()+2)*(biny + (fYaxis.GetNbins()+2)*binz);
+      ConcurrentAddBinContent(bin, w);
+      if ((binx == 0 || binx > fXaxis.GetNbins() || biny == 0 || biny > fYaxis.GetNbins() ||
+           binz == 0 || binz > fZaxis.GetNbins()) && !GetStatOverflowsBehaviour()) {
+         ConcurrentAddStats(1, 0, 0);
+         return -1;
+      }
+      const Double_t stats[11] = {w, w*w, w*x, w*x*x, w*y, w*y*y, w*x*y, w*z, w*z*z, w*x*z, w*y*z};
+      ConcurrentAddStats(1, stats, 11);
+      return bin;
+   }
+
    if (fBuffer) return BufferFill(x,y,z,w);
 
-   Int_t binx, biny, binz, bin;
    fEntries++;
    binx = fXaxis.FindBin(x);
    biny = fYaxis.FindBin(y);
@@ -381,6 +399,121 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+/// The result is the one of calling Fill(x[i],y[i],z[i],w[i]) for each entry,
+/// but the entries are filled by batches as in TH1::FillN.
+/// If w is NULL each entry is assumed a weight=1
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],w[i]);
+         else BufferFill(x[i], y[i], z[i], 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst)/stride;
+   const Bool_t concurrent = IsConcurrentFill();
+   if (!concurrent) fEntries += ntimes;
+   if (w && !concurrent && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i = 0; i < ntimes; ++i) {
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kNFillBatch], binsy[kNFillBatch], binsz[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *zb = &z[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, binsx, stride);
+      fYaxis.FindFixBins(n, yb, binsy, stride);
+      fZaxis.FindFixBins(n, zb, binsz, stride);
+      for (i = 0; i < n; ++i) {
+         const Int_t binx = FindBatchBin(fXaxis, i, n, xb, binsx, stride);
+         const Int_t biny = FindBatchBin(fYaxis, i, n, yb, binsy, stride);
+         const Int_t binz = FindBatchBin(fZaxis, i, n, zb, binsz, stride);
+         const Int_t bin  = binx + (fXaxis.GetNbins()+2)*(biny + (fYaxis.GetNbins()+2)*binz);
+         const Double_t ww = wb ? wb[i*stride] : 1.;
+         if (concurrent) {
+            ConcurrentAddBinContent(bin, ww);
+            continue;
+         }
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+      }
+      const Int_t nbinsx = fXaxis.GetNbins();
+      const Int_t nbinsy = fYaxis.GetNbins();
+      const Int_t nbinsz = fZaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+      Double_t sumwz = 0, sumwz2 = 0, sumwxz = 0, sumwyz = 0;
+      for (i = 0; i < n; ++i) {
+         const Bool_t stat = statOverflows ||
+            (binsx[i] > 0 && binsx[i] <= nbinsx && binsy[i] > 0 && binsy[i] <= nbinsy &&
+             binsz[i] > 0 && binsz[i] <= nbinsz);
+         const Double_t u  = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         const Double_t yy = stat ? yb[i*stride] : 0.;
+         const Double_t zz = stat ? zb[i*stride] : 0.;
+         sumw   += u;
+         sumw2  += u*u;
+         sumwx  += u*xx;
+         sumwx2 += u*xx*xx;
+         sumwy  += u*yy;
+         sumwy2 += u*yy*yy;
+         sumwxy += u*xx*yy;
+         sumwz  += u*zz;
+         sumwz2 += u*zz*zz;
+         sumwxz += u*xx*zz;
+         sumwyz += u*yy*zz;
+      }
+      if (concurrent) {
+         const Double_t stats[11] = {sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy, sumwz, sumwz2, sumwxz, sumwyz};
+         ConcurrentAddStats(n, stats, 11);
+         continue;
+      }
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      fTsumwy  += sumwy;
+      fTsumwy2 += sumwy2;
+      fTsumwxy += sumwxy;
+      fTsumwz  += sumwz;
+      fTsumwz2 += sumwz2;
+      fTsumwxz += sumwxz;
+      fTsumwyz += sumwyz;
+   }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
@@ -1167,6 +1300,7 @@ void TH3::GetRandom3(Double_t &x, Double_t &y, Double_t &z)
 
 void TH3::GetStats(Double_t *stats) const
 {
+   TConcurrentFillLock lock(this);
    if (fBuffer) ((TH3*)this)->BufferEmpty();
 
    Int_t bin, binx, biny, binz;
@@ -2690,6 +2824,23 @@ void TH3::PutStats(Double_t *stats)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add to the current statistics the values in array stats, in the order of
+/// GetStats. Used to fold the statistics of a concurrent filling.
+
+void TH3::AddConcurrentStats(const Double_t *stats)
+{
+   TH1::AddConcurrentStats(stats);
+   fTsumwy  += stats[4];
+   fTsumwy2 += stats[5];
+   fTsumwxy += stats[6];
+   fTsumwz  += stats[7];
+   fTsumwz2 += stats[8];
+   fTsumwxz += stats[9];
+   fTsumwyz += stats[10];
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Rebin only the X axis
 /// see Rebin3D
@@ -32,6 +32,14 @@
 #include "Math/MinimizerOptions.h"
 #include "Math/WrappedMultiTF1.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
+#include <vector>
+
 
 /** \class THnBase
     \ingroup Hist
@@ -521,61 +529,56 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    Bool_t haveErrors = GetCalculateErrors();
    Bool_t wantErrors = haveErrors || (option && (strchr(option, 'E') || strchr(option, 'e')));
 
-   Int_t* bins  = new Int_t[ndim];
-   Long64_t myLinBin = 0;
+   Int_t* binOffset = new Int_t[ndim];
+   for (Int_t d = 0; d < ndim; ++d) {
+      binOffset[d] = 0;
+      if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+         binOffset[d] = GetAxis(dim[d])->GetFirst();
+         // Don't subtract even more if underflow is alreday included:
+         if (binOffset[d] > 0) --binOffset[d];
+      }
+   }
 
-   THnIter iter(this, kTRUE /*use axis range*/);
+   Bool_t haveSkippedBin = kFALSE;
+   if (wantNDim) {
+      Int_t* bins  = new Int_t[ndim];
+      Long64_t myLinBin = 0;
 
-   while ((myLinBin = iter.Next()) >= 0) {
-      Double_t v = GetBinContent(myLinBin);
+      THnIter iter(this, kTRUE /*use axis range*/);
 
-      for (Int_t d = 0; d < ndim; ++d) {
-         bins[d] = iter.GetCoord(dim[d]);
-         if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
-            Int_t binOffset = GetAxis(dim[d])->GetFirst();
-            // Don't subtract even more if underflow is alreday included:
-            if (binOffset > 0) --binOffset;
-            bins[d] -= binOffset;
-         }
-      }
+      while ((myLinBin = iter.Next()) >= 0) {
+         Double_t v = GetBinContent(myLinBin);
 
-      Long64_t targetLinBin = -1;
-      if (!wantNDim) {
-         if (ndim == 1) targetLinBin = bins[0];
-         else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
-         else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
-      } else {
-         targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
-      }
+         for (Int_t d = 0; d < ndim; ++d)
+            bins[d] = iter.GetCoord(dim[d]) - binOffset[d];
 
-      if (wantErrors) {
-         Double_t err2 = 0.;
-         if (haveErrors) {
-            err2 = GetBinError2(myLinBin);
-         } else {
-            err2 = v;
-         }
-         if (wantNDim) {
+         Long64_t targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
+
+         if (wantErrors) {
+            Double_t err2 = 0.;
+            if (haveErrors) {
+               err2 = GetBinError2(myLinBin);
+            } else {
+               err2 = v;
+            }
             hn->AddBinError2(targetLinBin, err2);
-         } else {
-            Double_t preverr = hist->GetBinError(targetLinBin);
-            hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
          }
-      }
 
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      if (wantNDim)
+         // only _after_ error calculation, or sqrt(v) is taken into account!
          hn->AddBinContent(targetLinBin, v);
-      else
-         hist->AddBinContent(targetLinBin, v);
+      }
+
+      delete [] bins;
+   } else {
+      haveSkippedBin = ProjectionToHist(hist, ndim, dim, binOffset, wantErrors);
    }
 
-   delete [] bins;
+   delete [] binOffset;
 
    if (wantNDim) {
       hn->SetEntries(fEntries);
    } else {
-      if (!iter.HaveSkippedBin()) {
+      if (!haveSkippedBin) {
          hist->SetEntries(fEntries);
       } else {
          // re-compute the entries
@@ -603,6 +606,100 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bins in range of this histogram to the bins of hist, a TH1D, TH2D
+/// or TH3D whose axes are the dimensions dim of this histogram, shifted by
+/// binOffset. Return whether bins out of range were skipped.
+///
+/// The contents and errors are accumulated in the arrays of hist. The bins of
+/// a THnSparse are read in parallel if the implicit multi-threading is
+/// enabled, each task adding them to its own copy of the arrays.
+
+Bool_t THnBase::ProjectionToHist(TH1* hist, Int_t ndim, const Int_t* dim,
+                                 const Int_t* binOffset, Bool_t wantErrors) const
+{
+   const Bool_t haveErrors = GetCalculateErrors();
+   if (wantErrors && !hist->GetSumw2N())
+      hist->Sumw2();
+   Double_t* content = dynamic_cast<TArrayD*>(hist)->GetArray();
+   Double_t* sumw2 = wantErrors ? hist->GetSumw2()->GetArray() : 0;
+
+   // Add the content of the bin linbin at coordinates coord to c and s
+   auto addBin = [&](Long64_t linbin, Double_t v, const Int_t* coord, Double_t* c, Double_t* s) {
+      Int_t bins[3] = {0, 0, 0};
+      for (Int_t d = 0; d < ndim; ++d)
+         bins[d] = coord[dim[d]] - binOffset[d];
+      Int_t targetLinBin = bins[0];
+      if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
+      else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
+      if (s)
+         s[targetLinBin] += haveErrors ? GetBinError2(linbin) : v;
+      c[targetLinBin] += v;
+   };
+
+#ifdef R__USE_IMT
+   // bins read by a task, and size of the arrays of all tasks
+   const Long64_t kNBinsPerTask = 1 << 20;
+   const Long64_t kMaxArraySize = 1 << 26;
+   const Long64_t nbins = GetNbins();
+   const Long64_t ncells = hist->GetNcells();
+   const THnSparse* sparse = dynamic_cast<const THnSparse*>(this);
+   if (sparse && ROOT::IsImplicitMTEnabled() && nbins > kNBinsPerTask) {
+      const Int_t narrays = wantErrors ? 2 : 1;
+      const Long64_t ntasks = TMath::Min(TMath::Min(nbins / kNBinsPerTask, (Long64_t)ROOT::GetImplicitMTPoolSize()),
+                                         kMaxArraySize / (narrays * ncells));
+      if (ntasks > 1) {
+         std::vector<Int_t> first(fNdimensions);
+         sparse->GetBinContent(0, first.data()); // creates the decoder of the coordinates
+         std::vector<std::vector<Double_t>> partial(ntasks * narrays);
+         std::vector<char> skipped(ntasks);
+         ROOT::TThreadExecutor pool;
+         pool.Foreach([&](UInt_t task) {
+            std::vector<Double_t>& c = partial[task * narrays];
+            c.assign(ncells, 0.);
+            Double_t* s = 0;
+            if (wantErrors) {
+               partial[task * narrays + 1].assign(ncells, 0.);
+               s = partial[task * narrays + 1].data();
+            }
+            std::vector<Int_t> coord(fNdimensions);
+            const Long64_t last = nbins * (task + 1) / ntasks;
+            for (Long64_t i = nbins * task / ntasks; i < last; ++i) {
+               Double_t v = GetBinContent(i, coord.data());
+               if (!IsInRange(coord.data())) {
+                  skipped[task] = 1;
+                  continue;
+               }
+               addBin(i, v, coord.data(), c.data(), s);
+            }
+         }, ROOT::TSeqU(ntasks));
+
+         Bool_t haveSkippedBin = kFALSE;
+         for (Long64_t task = 0; task < ntasks; ++task) {
+            haveSkippedBin |= skipped[task];
+            const Double_t* c = partial[task * narrays].data();
+            for (Long64_t bin = 0; bin < ncells; ++bin)
+               content[bin] += c[bin];
+            if (wantErrors) {
+               const Double_t* s = partial[task * narrays + 1].data();
+               for (Long64_t bin = 0; bin < ncells; ++bin)
+                  sumw2[bin] += s[bin];
+            }
+         }
+         return haveSkippedBin;
+      }
+   }
+#endif
+
+   Int_t* coord = new Int_t[fNdimensions];
+   Long64_t myLinBin = 0;
+   THnIter iter(this, kTRUE /*use axis range*/);
+   while ((myLinBin = iter.Next(coord)) >= 0)
+      addBin(myLinBin, GetBinContent(myLinBin), coord, content, sumw2);
+   delete [] coord;
+   return iter.HaveSkippedBin();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Scale contents and errors of this histogram by c:
 /// this = this * c
@@ -628,6 +725,17 @@ void THnBase::Scale(Double_t c)
    SetEntries(nEntries);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill nevents entries. x holds their coordinates one after the other, i.e.
+/// GetNdimensions() values per entry; w holds their weights, or is 0 if all
+/// weights are 1.
+
+void THnBase::FillN(Int_t nevents, const Double_t *x, const Double_t *w /*= 0*/)
+{
+   for (Int_t i = 0; i < nevents; ++i)
+      Fill(x + i * fNdimensions, w ? w[i] : 1.);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add() implementation for both rebinned histograms and those with identical
 /// binning. See THnBase::Add().
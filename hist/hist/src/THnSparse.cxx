@@ -17,6 +17,14 @@
 #include "TDataMember.h"
 #include "TDataType.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
+#include <vector>
+
 namespace {
 //______________________________________________________________________________
 //
@@ -206,6 +214,19 @@ THnSparseCoordCompression::~THnSparseCoordCompression()
 void THnSparseCoordCompression::SetCoordFromBuffer(const Char_t* buf_in,
                                                   Int_t* coord_out) const
 {
+#ifdef R__BYTESWAP
+   if (fCoordBufferSize <= 8) {
+      // little endian: the buffer holds the Long64_t built by SetBufferFromCoord()
+      ULong64_t l64buf = 0;
+      memcpy(&l64buf, buf_in, fCoordBufferSize);
+      for (Int_t i = 0; i < fNdimensions; ++i) {
+         const Int_t nbits = fBitOffsets[i + 1] - fBitOffsets[i];
+         coord_out[i] = (Int_t)((l64buf >> fBitOffsets[i]) & ((1ULL << nbits) - 1));
+      }
+      return;
+   }
+#endif
+
    for (Int_t i = 0; i < fNdimensions; ++i) {
       const Int_t offset = fBitOffsets[i] / 8;
       Int_t shift = fBitOffsets[i] % 8;
@@ -571,16 +592,111 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in fBins, an open addressing
+hash table storing the hashes and linear indexes of the filled bins in two
+contiguous arrays; a lookup usually reads a single slot of each. If the
+compact bin coordinates are larger than 8 bytes, two coordinates can have
+the same hash: the coordinates of the bins with the hash passed to GetBin()
+are then compared to the ones passed to GetBin() until the matching bin is
+found.
+
+## Batch Operations
+FillN() fills many entries at once, computing their bins in parallel when
+the implicit multi-threading is enabled (see ROOT::EnableImplicitMT()).
+Add() and Merge() of THnSparse with the same binning reuse the compact
+coordinates of the added bins, and look them up in parallel. Projections
+to TH1D, TH2D and TH3D read the bins in parallel. The memory used by a
+THnSparse is returned by GetMemoryUsage().
 */
 
+////////////////////////////////////////////////////////////////////////////////
+/// Hash table of the filled bins of a THnSparse, with open addressing and
+/// linear probing. Slot i holds the hash of the compact coordinates of a bin
+/// and its linear index + 1, 0 for an empty slot. The number of slots is a
+/// power of two, at least twice the number of bins.
+
+struct THnSparse::TBinTable {
+   std::vector<ULong64_t> fHashes; ///< Hash of the bin of each slot
+   std::vector<Long64_t>  fBins;   ///< Linear index + 1 of the bin of each slot, 0 if the slot is empty
+   Long64_t               fNbins;  ///< Number of bins in the table
+
+   TBinTable(): fNbins(0) { Resize(16); }
+
+   /// Mix the bits of hash: the compact coordinates of neighbouring bins only
+   /// differ in a few bits.
+   static ULong64_t Mix(ULong64_t hash)
+   {
+      hash ^= hash >> 33;
+      hash *= 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 33;
+      hash *= 0xc4ceb9fe1a85ec53ULL;
+      hash ^= hash >> 33;
+      return hash;
+   }
+
+   ULong64_t GetMask() const { return fBins.size() - 1; }
+   ULong64_t GetFirstSlot(ULong64_t hash) const { return Mix(hash) & GetMask(); }
+
+   /// Memory used by the table, in bytes.
+   Long64_t GetMemoryUsage() const
+   {
+      return sizeof(*this) + fHashes.capacity() * sizeof(ULong64_t) + fBins.capacity() * sizeof(Long64_t);
+   }
+
+   /// Store the bin of linear index bin and hash hash in an empty slot.
+   void Insert(ULong64_t hash, Long64_t bin)
+   {
+      const ULong64_t mask = GetMask();
+      ULong64_t slot = GetFirstSlot(hash);
+      while (fBins[slot])
+         slot = (slot + 1) & mask;
+      fHashes[slot] = hash;
+      fBins[slot] = bin + 1;
+   }
+
+   /// Add the bin of linear index bin and hash hash.
+   void Add(ULong64_t hash, Long64_t bin)
+   {
+      if (2 * (fNbins + 1) > (Long64_t)fBins.size())
+         Resize(2 * fBins.size());
+      Insert(hash, bin);
+      ++fNbins;
+   }
+
+   /// Make room for nbins bins.
+   void Reserve(Long64_t nbins)
+   {
+      ULong64_t nslots = fBins.size();
+      while ((Long64_t)nslots < 2 * nbins)
+         nslots *= 2;
+      if (nslots != fBins.size())
+         Resize(nslots);
+   }
+
+   /// Use nslots slots, a power of two.
+   void Resize(ULong64_t nslots)
+   {
+      std::vector<ULong64_t> hashes(nslots);
+      std::vector<Long64_t> bins(nslots);
+      fHashes.swap(hashes);
+      fBins.swap(bins);
+      for (size_t slot = 0; slot < bins.size(); ++slot) {
+         if (bins[slot])
+            Insert(hashes[slot], bins[slot] - 1);
+      }
+   }
+};
+
+namespace {
+   /// Size of the elements of the TArray cont, 0 if it cannot be determined.
+   Int_t GetArrayElementSize(const TArray* cont)
+   {
+      TClass* clArray = cont ? cont->IsA() : 0;
+      TDataMember* dm = clArray ? clArray->GetDataMember("fArray") : 0;
+      return dm ? dm->GetDataType()->Size() : 0;
+   }
+}
+
 
 ClassImp(THnSparse);
 
@@ -588,7 +704,7 @@ ClassImp(THnSparse);
 /// Construct an empty THnSparse.
 
 THnSparse::THnSparse():
-   fChunkSize(1024), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(1024), fFilledBins(0), fBins(0), fCompactCoord(0)
 {
    fBinContent.SetOwner();
 }
@@ -605,7 +721,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
                      const Int_t* nbins, const Double_t* xmin, const Double_t* xmax,
                      Int_t chunksize):
    THnBase(name, title, dim, nbins, xmin, xmax),
-   fChunkSize(chunksize), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(chunksize), fFilledBins(0), fBins(0), fCompactCoord(0)
 {
    fCompactCoord = new THnSparseCompactBinCoord(dim, nbins);
    fBinContent.SetOwner();
@@ -615,6 +731,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
 /// Destruct a THnSparse
 
 THnSparse::~THnSparse() {
+   delete fBins;
    delete fCompactCoord;
 }
 
@@ -655,32 +772,24 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 
 void THnSparse::FillExMap()
 {
+   delete fBins;
+   fBins = new TBinTable;
+   const Int_t nchunks = GetNChunks();
+   if (!nchunks)
+      return;
+   fBins->Reserve((Long64_t)(nchunks - 1) * fChunkSize + GetChunk(nchunks - 1)->GetEntries());
+
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
-   THnSparseCoordCompression compactCoord(*GetCompactCoord());
+   const THnSparseCoordCompression* compactCoord = GetCompactCoord();
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
-      }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         fBins->Add(compactCoord->GetHashFromBuffer(buf), idx);
    }
 }
 
@@ -688,12 +797,9 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
+   if (!fBins)
       FillExMap();
-   }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
-   }
+   fBins->Reserve(nbins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -790,49 +896,54 @@ Double_t THnSparse::GetBinError2(Long64_t linidx) const {
 Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
-   ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
+   return GetBinIndexForBuffer(cc->GetHash(), cc->GetBuffer(), allocate);
+}
 
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bin with compact coordinates buf of hash hash.
+/// If it doesn't exist then return -1, or allocate a new bin if allocate is set
 
-      linidx = nextlinidx;
-   }
-   if (!allocate) return -1;
+Long64_t THnSparse::GetBinIndexForBuffer(ULong64_t hash, const Char_t* buf, Bool_t allocate)
+{
+   if (!fBins)
+      FillExMap();
+   Long64_t newidx = FindBinIndexForBuffer(hash, buf);
+   if (newidx >= 0 || !allocate) return newidx;
 
    ++fFilledBins;
 
    // allocate bin in chunk
    THnSparseArrayChunk *chunk = (THnSparseArrayChunk*) fBinContent.Last();
-   Long64_t newidx = chunk ? ((Long64_t) chunk->GetEntries()) : -1;
+   newidx = chunk ? ((Long64_t) chunk->GetEntries()) : -1;
    if (!chunk || newidx == (Long64_t)fChunkSize) {
       chunk = AddChunk();
       newidx = 0;
    }
-   chunk->AddBin(newidx, cc->GetBuffer());
+   chunk->AddBin(newidx, buf);
 
    // store translation between hash and bin
-   newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   newidx += (fBinContent.GetEntriesFast() - 1) * (Long64_t)fChunkSize;
+   fBins->Add(hash, newidx);
    return newidx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bin with compact coordinates buf of hash hash,
+/// -1 if it doesn't exist. fBins must have been set up. Several threads
+/// can look up bins at the same time, as long as none of them adds bins.
+
+Long64_t THnSparse::FindBinIndexForBuffer(ULong64_t hash, const Char_t* buf) const
+{
+   const ULong64_t mask = fBins->GetMask();
+   for (ULong64_t slot = fBins->GetFirstSlot(hash); fBins->fBins[slot]; slot = (slot + 1) & mask) {
+      if (fBins->fHashes[slot] != hash) continue;
+      const Long64_t linidx = fBins->fBins[slot] - 1; // 0 is "empty slot"
+      if (GetChunk(linidx / fChunkSize)->Matches(linidx % fChunkSize, buf))
+         return linidx;
+   }
+   return -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return THnSparseCompactBinCoord object.
 
@@ -865,29 +976,44 @@ Double_t THnSparse::GetSparseFractionBins() const {
 
 Double_t THnSparse::GetSparseFractionMem() const {
    Int_t arrayElementSize = 0;
-   if (fFilledBins) {
-      TClass* clArray = GetChunk(0)->fContent->IsA();
-      TDataMember* dm = clArray ? clArray->GetDataMember("fArray") : 0;
-      arrayElementSize = dm ? dm->GetDataType()->Size() : 0;
-   }
+   if (fFilledBins)
+      arrayElementSize = GetArrayElementSize(GetChunk(0)->fContent);
    if (!arrayElementSize) {
       Warning("GetSparseFractionMem", "Cannot determine type of elements!");
       return -1.;
    }
 
-   Double_t sizePerChunkElement = arrayElementSize + GetCompactCoord()->GetBufferSize();
-   if (fFilledBins && GetChunk(0)->fSumw2)
-      sizePerChunkElement += sizeof(Double_t); /* fSumw2 */
-
-   Double_t size = 0.;
-   size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
-
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
       nbinsTotal *= GetAxis(d)->GetNbins() + 2;
 
-   return size / nbinsTotal / arrayElementSize;
+   return GetMemoryUsage() / nbinsTotal / arrayElementSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory used by the bins of this histogram in bytes: the
+/// chunks with their contents, errors and compact coordinates, and the table
+/// of the filled bins. The value is approximate.
+
+Long64_t THnSparse::GetMemoryUsage() const {
+   Long64_t size = sizeof(THnSparse);
+   TIter iChunk(&fBinContent);
+   THnSparseArrayChunk* chunk = 0;
+   Int_t arrayElementSize = 0;
+   while ((chunk = (THnSparseArrayChunk*) iChunk())) {
+      size += sizeof(THnSparseArrayChunk);
+      size += TMath::Max(chunk->fCoordinateAllocationSize, chunk->fCoordinatesSize);
+      if (chunk->fContent) {
+         if (!arrayElementSize)
+            arrayElementSize = GetArrayElementSize(chunk->fContent);
+         size += chunk->fContent->IsA()->Size() + (Long64_t)chunk->fContent->GetSize() * arrayElementSize;
+      }
+      if (chunk->fSumw2)
+         size += sizeof(TArrayD) + (Long64_t)chunk->fSumw2->GetSize() * sizeof(Double_t);
+   }
+   if (fBins)
+      size += fBins->GetMemoryUsage();
+   return size;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -963,9 +1089,140 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   delete fBins;
+   fBins = 0;
    fBinContent.Delete();
    ResetBase(option);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill nevents entries, see THnBase::FillN(). The compact coordinates of the
+/// entries are computed by blocks, in parallel if the implicit multi-threading
+/// is enabled, before their bins are looked up and filled.
+
+void THnSparse::FillN(Int_t nevents, const Double_t* x, const Double_t* w /*= 0*/)
+{
+   // Extending axes must see the entries in order.
+   for (Int_t d = 0; d < fNdimensions; ++d) {
+      if (GetAxis(d)->CanExtend()) {
+         THnBase::FillN(nevents, x, w);
+         return;
+      }
+   }
+   if (nevents <= 0) return;
+
+   const Int_t kNBlock = 65536; // entries whose coordinates are computed before filling
+   const Int_t kNChunk = 4096;  // entries whose coordinates are computed by a task
+   const THnSparseCoordCompression* compactCoord = GetCompactCoord();
+   // SetBufferFromCoord() writes at least a Long64_t
+   const Int_t bufSize = TMath::Max(compactCoord->GetBufferSize(), (Int_t)sizeof(Long64_t));
+   const Int_t nblock = TMath::Min(nevents, kNBlock);
+   std::vector<Char_t> buffers((size_t)nblock * bufSize);
+   std::vector<ULong64_t> hashes(nblock);
+
+   for (Int_t first = 0; first < nevents; first += kNBlock) {
+      const Int_t n = TMath::Min(kNBlock, nevents - first);
+      const Double_t* xb = x + (Long64_t)first * fNdimensions;
+
+      auto compact = [&](Int_t begin, Int_t end) {
+         std::vector<Int_t> coord(fNdimensions);
+         for (Int_t i = begin; i < end; ++i) {
+            for (Int_t d = 0; d < fNdimensions; ++d)
+               coord[d] = GetAxis(d)->FindFixBin(xb[(Long64_t)i * fNdimensions + d]);
+            hashes[i] = compactCoord->SetBufferFromCoord(coord.data(), &buffers[(size_t)i * bufSize]);
+         }
+      };
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && n > kNChunk) {
+         ROOT::TThreadExecutor pool;
+         const UInt_t nchunks = (n + kNChunk - 1) / kNChunk;
+         pool.Foreach([&](UInt_t chunk) {
+            compact(chunk * kNChunk, TMath::Min(n, Int_t(chunk + 1) * kNChunk));
+         }, ROOT::TSeqU(nchunks));
+      } else
+#endif
+         compact(0, n);
+
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xb + (Long64_t)i * fNdimensions, wi);
+         FillBin(GetBinIndexForBuffer(hashes[i], &buffers[(size_t)i * bufSize], kTRUE), wi);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add() implementation, see THnBase::AddInternal(). A THnSparse with the
+/// same binning is added without decoding the coordinates of its bins: its
+/// compact coordinates are looked up directly, by blocks, in parallel if the
+/// implicit multi-threading is enabled; only the missing bins are then
+/// allocated one after the other.
+
+void THnSparse::AddInternal(const THnBase* h, Double_t c, Bool_t rebinned)
+{
+   const THnSparse* hs = dynamic_cast<const THnSparse*>(h);
+   if (rebinned || !hs || fNdimensions != h->GetNdimensions()
+       || hs->GetCompactCoord()->GetBufferSize() != GetCompactCoord()->GetBufferSize()) {
+      THnBase::AddInternal(h, c, rebinned);
+      return;
+   }
+
+   // Trigger error calculation if h has it
+   if (!GetCalculateErrors() && h->GetCalculateErrors())
+      Sumw2();
+   Bool_t haveErrors = GetCalculateErrors();
+
+   // Expand the table if needed; this also sets it up
+   const Long64_t nbins = hs->GetNbins();
+   Reserve(GetNbins() + nbins);
+
+   const Long64_t kNBlock = 65536; // bins looked up before adding them
+   const Long64_t kNChunk = 4096;  // bins looked up by a task
+   const THnSparseCoordCompression* compactCoord = GetCompactCoord();
+   const Int_t bufSize = compactCoord->GetBufferSize();
+   const Int_t chunkSize = hs->GetChunkSize();
+   const Long64_t nblock = TMath::Min(nbins, kNBlock);
+   std::vector<ULong64_t> hashes(nblock);
+   std::vector<Long64_t> targets(nblock);
+
+   for (Long64_t first = 0; first < nbins; first += kNBlock) {
+      const Long64_t n = TMath::Min(kNBlock, nbins - first);
+      auto getBuffer = [&](Long64_t i) {
+         const Long64_t bin = first + i;
+         return hs->GetChunk(bin / chunkSize)->fCoordinates + (bin % chunkSize) * bufSize;
+      };
+      auto find = [&](Long64_t begin, Long64_t end) {
+         for (Long64_t i = begin; i < end; ++i) {
+            const Char_t* buf = getBuffer(i);
+            hashes[i] = compactCoord->GetHashFromBuffer(buf);
+            targets[i] = FindBinIndexForBuffer(hashes[i], buf);
+         }
+      };
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && n > kNChunk) {
+         ROOT::TThreadExecutor pool;
+         const UInt_t nchunks = (n + kNChunk - 1) / kNChunk;
+         pool.Foreach([&](UInt_t chunk) {
+            find(chunk * kNChunk, TMath::Min(n, Long64_t(chunk + 1) * kNChunk));
+         }, ROOT::TSeqU(nchunks));
+      } else
+#endif
+         find(0, n);
+
+      for (Long64_t i = 0; i < n; ++i) {
+         Long64_t mybinidx = targets[i];
+         if (mybinidx < 0)
+            mybinidx = GetBinIndexForBuffer(hashes[i], getBuffer(i), kTRUE /*allocate*/);
+         if (haveErrors) {
+            Double_t err2 = hs->GetBinError2(first + i) * c * c;
+            AddBinError2(mybinidx, err2);
+         }
+         // only _after_ error calculation, or sqrt(v) is taken into account!
+         AddBinContent(mybinidx, c * hs->GetBinContent(first + i));
+      }
+   }
+
+   Double_t nEntries = GetEntries() + c * h->GetEntries();
+   SetEntries(nEntries);
+}
+
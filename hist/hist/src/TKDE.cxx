@@ -22,6 +22,20 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ With the built-in kernels, which vanish beyond a few bandwidths, the density at a point only
+ sums the events whose kernel reaches it: the events are kept sorted, with the extent of their
+ kernels, and the density is evaluated in a time proportional to the number of events near the
+ point. The result is the same as summing over all the events. GetValues() evaluates the density
+ at many points, in parallel when implicit multi-threading is enabled.
+
+ SetEvaluationGrid() trades accuracy for speed: the density is computed once on a grid of points
+ over the range and linearly interpolated in between, so that drawing, integrating or
+ sampling the density (for instance through GetFunction()) do not depend on the number of events
+ anymore. With a fixed bandwidth and no asymmetric mirroring, the grid values are computed by
+ binning the events linearly on the grid and convolving them with the sampled kernel. The
+ approximation error is of the order of (d/h)^2, for a grid spacing d and a bandwidth h. For the
+ adaptive iteration, the first estimate of the density, at each event, is interpolated as well.
  */
 
 
@@ -30,6 +44,7 @@
 #include <numeric>
 #include <limits>
 #include <cassert>
+#include <cmath>
 
 #include "Math/Error.h"
 #include "TMath.h"
@@ -43,6 +58,12 @@
 #include "TCanvas.h"
 #include "TKDE.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
 
 ClassImp(TKDE);
 
@@ -50,9 +71,29 @@ class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   // Events sorted by position, for the built-in kernels
+   Double_t fSupport; // Half width of the kernel support in bandwidth units, 0 if not indexed
+   std::vector<Double_t> fX; // Positions
+   std::vector<Double_t> fCount; // Counts (bin contents or event weights)
+   std::vector<Double_t> fH; // Bandwidths
+   std::vector<Double_t> fMaxUpper; // Highest upper bound of the kernel supports up to each event
+   std::vector<Double_t> fMinLower; // Lowest lower bound of the kernel supports from each event
+   // Density on the evaluation grid
+   std::vector<Double_t> fGrid;
+   Double_t fGridMin;
+   Double_t fGridStep;
+
+   template <Double_t (TKDE::*kernel)(Double_t) const>
+   Double_t SumRange(Double_t x, UInt_t first, UInt_t last) const;
+   Double_t Sum(Double_t x) const;
+   Double_t Exact(Double_t x) const;
+   Bool_t ConvolveOnGrid(std::vector<Double_t>& grid) const;
+   void BuildIndex();
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void ComputeGrid(UInt_t npoints, Double_t xMin, Double_t xMax);
+   void Evaluate(UInt_t n, const Double_t* x, Double_t* values, Bool_t useGrid) const;
    Double_t operator()(Double_t x) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
@@ -130,6 +171,7 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fNBins = events < 10000 ? 100 : events / 10;
    fNEvents = events;
    fUseBinsNEvents = 10000;
+   fGridSize = 0;
    fMean = 0.0;
    fSigma = 0.0;
    fXMin = xMin;
@@ -413,6 +455,17 @@ void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    SetKernel();
 }
 
+void TKDE::SetEvaluationGrid(UInt_t npoints) {
+   // Sets the number of points of the grid on which the density is computed once and then
+   // linearly interpolated, over the range. With 0 (default) the density is evaluated exactly.
+   if (npoints == 1) {
+      Error("SetEvaluationGrid", "The evaluation grid needs at least two points.");
+      return;
+   }
+   fGridSize = npoints;
+   SetKernel();
+}
+
 // private methods
 
 void TKDE::SetUseBins() {
@@ -553,6 +606,9 @@ void TKDE::SetKernel() {
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
    }
+   if (fGridSize) {
+      fKernel->ComputeGrid(fGridSize, fXMin, fXMax);
+   }
 }
 
 void TKDE::SetKernelFunction(KernelFunction_Ptr kernfunc) {
@@ -674,6 +730,13 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValues(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Returns in values the kernel density estimates at the n points x,
+   // computed in parallel when implicit multi-threading is enabled
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   fKernel->Evaluate(n, x, values, kTRUE);
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -696,8 +759,86 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
-{}
+fWeights(fNWeights, weight),
+fSupport(0),
+fGridMin(0),
+fGridStep(0)
+{
+   BuildIndex();
+}
+
+void TKDE::TKernel::BuildIndex() {
+   // Sorts the events by position, with the bounds of their kernel supports, for the
+   // built-in kernels which vanish beyond fSupport bandwidths
+   fX.clear(); fCount.clear(); fH.clear(); fMaxUpper.clear(); fMinLower.clear();
+   switch (fKDE->fKernelType) {
+      case kGaussian:     fSupport = 9.; break;
+      case kEpanechnikov:
+      case kBiweight:
+      case kCosineArch:   fSupport = 1.; break;
+      default:            fSupport = 0.; return;
+   }
+   const std::vector<Double_t>& data = fKDE->fData;
+   UInt_t n = data.size();
+   if (n != fWeights.size()) {
+      fSupport = 0.;
+      return;
+   }
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
+   std::vector<UInt_t> order;
+   order.reserve(n);
+   for (UInt_t i = 0; i < n; ++i) {
+      if (!std::isfinite(data[i]) || !std::isfinite(fWeights[i]) || fWeights[i] <= 0 ||
+          (useBins && !std::isfinite(fKDE->fBinCount[i]))) {
+         // summed over all the events, to get the same non finite result
+         fSupport = 0.;
+         return;
+      }
+      if (!useBins || fKDE->fBinCount[i] != 0) order.push_back(i);
+   }
+   std::sort(order.begin(), order.end(), [&data](UInt_t i, UInt_t j) { return data[i] < data[j]; });
+   UInt_t nIndexed = order.size();
+   fX.resize(nIndexed); fCount.resize(nIndexed); fH.resize(nIndexed);
+   fMaxUpper.resize(nIndexed); fMinLower.resize(nIndexed);
+   // supports slightly widened, not to depend on the rounding at their bounds
+   Double_t reach = fSupport * (1. + 1.E-9);
+   for (UInt_t k = 0; k < nIndexed; ++k) {
+      UInt_t i = order[k];
+      fX[k] = data[i];
+      fCount[k] = useBins ? fKDE->fBinCount[i] : 1.0;
+      fH[k] = fWeights[i];
+      fMaxUpper[k] = fX[k] + reach * fH[k];
+      if (k > 0) fMaxUpper[k] = std::max(fMaxUpper[k], fMaxUpper[k - 1]);
+   }
+   for (UInt_t k = nIndexed; k-- > 0;) {
+      fMinLower[k] = fX[k] - reach * fH[k];
+      if (k + 1 < nIndexed) fMinLower[k] = std::min(fMinLower[k], fMinLower[k + 1]);
+   }
+}
+
+template <Double_t (TKDE::*kernel)(Double_t) const>
+Double_t TKDE::TKernel::SumRange(Double_t x, UInt_t first, UInt_t last) const {
+   // Sums the kernels of the sorted events [first, last) at x
+   Double_t result(0.0);
+   for (UInt_t k = first; k < last; ++k) {
+      result += fCount[k] / fH[k] * (fKDE->*kernel)((x - fX[k]) / fH[k]);
+   }
+   return result;
+}
+
+Double_t TKDE::TKernel::Sum(Double_t x) const {
+   // Sums the kernels reaching x: the events before first end below x, the ones from last start above it
+   UInt_t first = std::upper_bound(fMaxUpper.begin(), fMaxUpper.end(), x) - fMaxUpper.begin();
+   UInt_t last = std::lower_bound(fMinLower.begin(), fMinLower.end(), x) - fMinLower.begin();
+   if (first >= last) return 0.0;
+   switch (fKDE->fKernelType) {
+      case kGaussian:     return SumRange<&TKDE::GaussianKernel>(x, first, last);
+      case kEpanechnikov: return SumRange<&TKDE::EpanechnikovKernel>(x, first, last);
+      case kBiweight:     return SumRange<&TKDE::BiweightKernel>(x, first, last);
+      case kCosineArch:   return SumRange<&TKDE::CosineArchKernel>(x, first, last);
+      default:            return 0.0;
+   }
+}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
    // Gets the adaptive weights (bandwidths) for TKernel internal computation
@@ -706,11 +847,15 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    unsigned int n = fKDE->fData.size();
    assert( n == weights.size() );
    bool useDataWeights = (fKDE->fBinCount.size() == n); 
+   // first estimate of the density at the events, with the fixed bandwidth
+   if (fKDE->fGridSize) ComputeGrid(fKDE->fGridSize, fKDE->fXMin, fKDE->fXMax);
+   std::vector<Double_t> density(n);
+   Evaluate(n, fKDE->fData.data(), density.data(), kTRUE);
    Double_t f = 0.0;
    for (unsigned int i = 0; i < n; ++i) { 
 //   for (; weight != weights.end(); ++weight, ++data, ++dataW) {
       if (useDataWeights && fKDE->fBinCount[i] <= 0) continue;  // skip negative or null weights
-      f = (*fKDE->fKernel)(fKDE->fData[i]);
+      f = density[i];
       if (f <= 0)
          fKDE->Warning("ComputeAdativeWeights","function value is zero or negative for x = %f w = %f",
                        fKDE->fData[i],(useDataWeights) ? fKDE->fBinCount[i] : 1.);
@@ -722,6 +867,8 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    fKDE->fAdaptiveBandwidthFactor = fKDE->fUseMirroring ? kAPPROX_GEO_MEAN / fKDE->fSigmaRob : std::sqrt(std::exp(fKDE->fAdaptiveBandwidthFactor / fKDE->fData.size()));
    transform(weights.begin(), weights.end(), fWeights.begin(),
              std::bind(std::multiplies<Double_t>(), std::placeholders::_1, fKDE->fAdaptiveBandwidthFactor));
+   fGrid.clear();
+   BuildIndex();
    //printf("adaptive bandwidth factor % f weight 0 %f , %f \n",fKDE->fAdaptiveBandwidthFactor, weights[0],fWeights[0] );
 }
 
@@ -845,9 +992,13 @@ TGraphErrors* TKDE::GetGraphWithErrors(UInt_t npx, double xmin, double xmax) {
    Double_t* ey = new Double_t[n + 1];
    for (UInt_t i = 0; i <= n; ++i) {
       x[i] = xmin + i * (xmax - xmin) / n;
-      y[i] = (*this)(x[i]);
+   }
+   GetValues(n + 1, x, y);
+   // as GetError(), with the kernel norm computed once
+   Double_t kernelL2Norm = ComputeKernelL2Norm();
+   for (UInt_t i = 0; i <= n; ++i) {
       ex[i] = 0;
-      ey[i] = this->GetError(x[i]);
+      ey[i] = std::sqrt(y[i] * kernelL2Norm / (fNEvents * fKernel->GetWeight(x[i])));
    }
    TGraphErrors* ge = new TGraphErrors(n, &x[0], &y[0], &ex[0], &ey[0]);
    ge->SetName("kde_graph_error");
@@ -907,11 +1058,39 @@ const std::vector<Double_t> & TKDE::TKernel::GetAdaptiveWeights() const {
 
 Double_t TKDE::TKernel::operator()(Double_t x) const {
    // The internal class's unary function: returns the kernel density estimate
+   if (!fGrid.empty()) {
+      // interpolated on the evaluation grid
+      Double_t pos = (x - fGridMin) / fGridStep;
+      if (pos >= 0 && pos <= fGrid.size() - 1) {
+         UInt_t i = std::min(UInt_t(pos), UInt_t(fGrid.size() - 2));
+         Double_t t = pos - i;
+         return (1. - t) * fGrid[i] + t * fGrid[i + 1];
+      }
+   }
+   return Exact(x);
+}
+
+Double_t TKDE::TKernel::Exact(Double_t x) const {
+   // Returns the kernel density estimate summed over the events
    Double_t result(0.0);
    UInt_t n = fKDE->fData.size();
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
    Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+   if (fSupport > 0) {
+      // symmetric kernels: the mirrored kernels at x are the kernels at the mirrored point
+      result = Sum(x);
+      if (fKDE->fAsymLeft) {
+         result -= Sum(2. * fKDE->fXMin - x);
+      }
+      if (fKDE->fAsymRight) {
+         result -= Sum(2. * fKDE->fXMax - x);
+      }
+      if ( TMath::IsNaN(result) ) {
+         fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
+      }
+      return result / nSum;
+   }
    // double dmin = 1.E10;
    // double xmin,bmin,wmin; 
    for (UInt_t i = 0; i < n; ++i) {
@@ -944,6 +1123,88 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
    return result / nSum;
 }
 
+void TKDE::TKernel::Evaluate(UInt_t n, const Double_t* x, Double_t* values, Bool_t useGrid) const {
+   // Returns in values the kernel density estimates at the n points x, interpolated on
+   // the evaluation grid if useGrid. With implicit multi-threading, the points are evaluated in parallel
+   // for the built-in kernels: a user defined kernel, which may not be thread safe, is evaluated serially.
+   auto evaluate = [&](UInt_t first, UInt_t last) {
+      for (UInt_t i = first; i < last; ++i) {
+         values[i] = useGrid ? (*this)(x[i]) : Exact(x[i]);
+      }
+   };
+#ifdef R__USE_IMT
+   const UInt_t kNPointsPerTask = 64;
+   if (ROOT::IsImplicitMTEnabled() && n > kNPointsPerTask && fKDE->fKernelType != kUserDefined) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t task) {
+                      UInt_t first = task * kNPointsPerTask;
+                      evaluate(first, std::min(first + kNPointsPerTask, n));
+                   },
+                   ROOT::TSeqU((n + kNPointsPerTask - 1) / kNPointsPerTask));
+   } else
+#endif
+      evaluate(0, n);
+}
+
+void TKDE::TKernel::ComputeGrid(UInt_t npoints, Double_t xMin, Double_t xMax) {
+   // Computes the density on npoints equidistant points between xMin and xMax, to be interpolated
+   fGrid.clear();
+   if (npoints < 2 || !(xMin < xMax)) return;
+   fGridMin = xMin;
+   fGridStep = (xMax - xMin) / (npoints - 1);
+   std::vector<Double_t> grid(npoints);
+   if (!ConvolveOnGrid(grid)) {
+      std::vector<Double_t> x(npoints);
+      for (UInt_t i = 0; i < npoints; ++i) {
+         x[i] = xMin + i * fGridStep;
+      }
+      Evaluate(npoints, x.data(), grid.data(), kFALSE);
+   }
+   fGrid.swap(grid);
+}
+
+Bool_t TKDE::TKernel::ConvolveOnGrid(std::vector<Double_t>& grid) const {
+   // Computes the density on the grid points by binning the events linearly on the grid
+   // and convolving the bins with the sampled kernel. Returns kFALSE if it cannot be done, or
+   // if it would not be faster than summing the kernels: the bandwidth must be fixed and there
+   // must be no asymmetric mirroring.
+   if (fSupport <= 0 || fX.empty() || fKDE->fAsymLeft || fKDE->fAsymRight) return kFALSE;
+   for (UInt_t k = 1; k < fH.size(); ++k) {
+      if (fH[k] != fH[0]) return kFALSE;
+   }
+   Double_t h = fH[0];
+   Double_t halfWidth = std::ceil(fSupport * h / fGridStep);
+   if (halfWidth >= fX.size()) return kFALSE;
+   Int_t nhalf = Int_t(halfWidth);
+   Int_t npoints = grid.size();
+   // bin i + nhalf is centred on the grid point i; the bins beyond the grid hold the events
+   // reaching its ends
+   Int_t nbins = npoints + 2 * nhalf;
+   std::vector<Double_t> bins(nbins, 0.0);
+   for (UInt_t k = 0; k < fX.size(); ++k) {
+      Double_t pos = (fX[k] - fGridMin) / fGridStep + nhalf;
+      if (pos < 0 || pos >= nbins - 1) continue;
+      Int_t bin = Int_t(pos);
+      Double_t t = pos - bin;
+      bins[bin] += (1. - t) * fCount[k];
+      bins[bin + 1] += t * fCount[k];
+   }
+   std::vector<Double_t> kernel(2 * nhalf + 1);
+   for (Int_t d = -nhalf; d <= nhalf; ++d) {
+      kernel[d + nhalf] = (*fKDE->fKernelFunction)(d * fGridStep / h) / h;
+   }
+   Bool_t useBins = (fKDE->fBinCount.size() == fKDE->fData.size());
+   Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+   for (Int_t i = 0; i < npoints; ++i) {
+      Double_t result(0.0);
+      for (Int_t b = i; b <= i + 2 * nhalf; ++b) {
+         result += bins[b] * kernel[i - b + 2 * nhalf];
+      }
+      grid[i] = result / nSum;
+   }
+   return kTRUE;
+}
+
 UInt_t TKDE::Index(Double_t x) const {
    // Returns the indices (bins) for the binned weights
    Int_t bin = Int_t((x - fXMin) * fWeightSize);
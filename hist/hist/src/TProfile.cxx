@@ -749,10 +749,13 @@ Int_t TProfile::Fill(const char *namex, Double_t y, Double_t w)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill a Profile histogram with weights.
+///
+/// The result is the one of calling Fill(x[i],y[i],w[i]) for each entry, but
+/// the entries are filled by batches as in TH1::FillN.
 
 void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
-   Int_t bin,i;
+   Int_t i;
    ntimes *= stride;
    Int_t ifirst = 0;
    //If a buffer is activated, fill buffer
@@ -770,28 +773,60 @@ void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const D
          return;
    }
 
-   for (i=ifirst;i<ntimes;i+=stride) {
-      if (fYmin != fYmax) {
-         if (y[i] <fYmin || y[i]> fYmax || TMath::IsNaN(y[i])) continue;
+   x += ifirst;
+   y += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst)/stride;
+   const Bool_t yrange = fYmin != fYmax;
+   // must be called before accumulating the entries
+   if (w && !fBinSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i = 0; i < ntimes; ++i) {
+         const Double_t yy = y[i*stride];
+         if (w[i*stride] != 1.0 && (!yrange || (yy >= fYmin && yy <= fYmax))) { Sumw2(); break; }
       }
+   }
 
-      Double_t u = (w) ? w[i] : 1; // (w[i] > 0 ? w[i] : -w[i]);
-      fEntries++;
-      bin =fXaxis.FindBin(x[i]);
-      AddBinContent(bin, u*y[i]);
-      fSumw2.fArray[bin] += u*y[i]*y[i];
-      if (!fBinSumw2.fN && u != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();  // must be called before accumulating the entries
-      if (fBinSumw2.fN)  fBinSumw2.fArray[bin] += u*u;
-      fBinEntries.fArray[bin] += u;
-      if (bin == 0 || bin > fXaxis.GetNbins()) {
-         if (!GetStatOverflowsBehaviour()) continue;
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t bins[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, bins, stride);
+      for (i = 0; i < n; ++i) {
+         const Double_t yy = yb[i*stride];
+         if (yrange && !(yy >= fYmin && yy <= fYmax)) continue;   // also skips NaN
+         const Int_t bin = FindBatchBin(fXaxis, i, n, xb, bins, stride);
+         const Double_t u = wb ? wb[i*stride] : 1.;
+         fEntries++;
+         AddBinContent(bin, u*yy);
+         fSumw2.fArray[bin] += u*yy*yy;
+         if (fBinSumw2.fN)  fBinSumw2.fArray[bin] += u*u;
+         fBinEntries.fArray[bin] += u;
+      }
+      const Int_t nbins = fXaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0;
+      for (i = 0; i < n; ++i) {
+         const Double_t yv = yb[i*stride];
+         const Bool_t stat = (!yrange || (yv >= fYmin && yv <= fYmax)) &&
+                             (statOverflows || (bins[i] > 0 && bins[i] <= nbins));
+         const Double_t u  = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         const Double_t yy = stat ? yv : 0.;
+         sumw   += u;
+         sumw2  += u*u;
+         sumwx  += u*xx;
+         sumwx2 += u*xx*xx;
+         sumwy  += u*yy;
+         sumwy2 += u*yy*yy;
       }
-      fTsumw   += u;
-      fTsumw2  += u*u;
-      fTsumwx  += u*x[i];
-      fTsumwx2 += u*x[i]*x[i];
-      fTsumwy  += u*y[i];
-      fTsumwy2 += u*y[i]*y[i];
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      fTsumwy  += sumwy;
+      fTsumwy2 += sumwy2;
    }
 }
 
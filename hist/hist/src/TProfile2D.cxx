@@ -771,6 +771,103 @@ Int_t TProfile2D::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a Profile2D histogram with an array of values and weights.
+///
+/// The result is the one of calling Fill(x[i],y[i],z[i],w[i]) for each entry,
+/// but the entries are filled by batches as in TH1::FillN.
+/// If w is NULL each entry is assumed a weight=1
+
+void TProfile2D::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],w[i]);
+         else BufferFill(x[i], y[i], z[i], 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst)/stride;
+   const Bool_t zrange = fZmin != fZmax;
+   // must be called before accumulating the entries
+   if (w && !fBinSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i = 0; i < ntimes; ++i) {
+         const Double_t zz = z[i*stride];
+         if (w[i*stride] != 1.0 && (!zrange || (zz >= fZmin && zz <= fZmax))) { Sumw2(); break; }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kNFillBatch], binsy[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *zb = &z[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, binsx, stride);
+      fYaxis.FindFixBins(n, yb, binsy, stride);
+      for (i = 0; i < n; ++i) {
+         const Double_t zz = zb[i*stride];
+         if (zrange && !(zz >= fZmin && zz <= fZmax)) continue;   // also skips NaN
+         const Int_t binx = FindBatchBin(fXaxis, i, n, xb, binsx, stride);
+         const Int_t biny = FindBatchBin(fYaxis, i, n, yb, binsy, stride);
+         const Int_t bin  = biny*(fXaxis.GetNbins()+2) + binx;
+         const Double_t u = wb ? wb[i*stride] : 1.;
+         fEntries++;
+         AddBinContent(bin, u*zz);
+         fSumw2.fArray[bin] += u*zz*zz;
+         if (fBinSumw2.fN)  fBinSumw2.fArray[bin] += u*u;
+         fBinEntries.fArray[bin] += u;
+      }
+      const Int_t nbinsx = fXaxis.GetNbins();
+      const Int_t nbinsy = fYaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+      Double_t sumwz = 0, sumwz2 = 0;
+      for (i = 0; i < n; ++i) {
+         const Double_t zv = zb[i*stride];
+         const Bool_t stat = (!zrange || (zv >= fZmin && zv <= fZmax)) &&
+                             (statOverflows || (binsx[i] > 0 && binsx[i] <= nbinsx && binsy[i] > 0 && binsy[i] <= nbinsy));
+         const Double_t u  = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         const Double_t yy = stat ? yb[i*stride] : 0.;
+         const Double_t zz = stat ? zv : 0.;
+         sumw   += u;
+         sumw2  += u*u;
+         sumwx  += u*xx;
+         sumwx2 += u*xx*xx;
+         sumwy  += u*yy;
+         sumwy2 += u*yy*yy;
+         sumwxy += u*xx*yy;
+         sumwz  += u*zz;
+         sumwz2 += u*zz*zz;
+      }
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      fTsumwy  += sumwy;
+      fTsumwy2 += sumwy2;
+      fTsumwxy += sumwxy;
+      fTsumwz  += sumwz;
+      fTsumwz2 += sumwz2;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return bin content of a Profile2D histogram.
 
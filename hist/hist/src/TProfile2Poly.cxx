@@ -167,6 +167,27 @@ TProfile2PolyBin *TProfile2Poly::CreateBin(TObject *poly)
    return new TProfile2PolyBin(poly, ibin);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the profile with an array of values, each of weight 1: the result is
+/// the one of calling Fill(x,y,value) for each entry.
+///
+/// \param [in] ntimes:  number of entries in arrays x, y and value
+///                      (array size must be ntimes*stride)
+/// \param [in] x:       array of x values
+/// \param [in] y:       array of y values
+/// \param [in] value:   array of the values to profile
+/// \param [in] stride:  step size through arrays x, y and value
+
+void TProfile2Poly::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *value, Int_t stride)
+{
+   if (!value) {
+      Error("FillN", "the values to profile are required");
+      return;
+   }
+   for (Int_t i = 0; i < ntimes; ++i)
+      Fill(x[i * stride], y[i * stride], value[i * stride], 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill
 
@@ -679,6 +679,118 @@ Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a Profile3D histogram with an array of values and weights.
+///
+/// The result is the one of calling Fill(x[i],y[i],z[i],t[i],w[i]) for each
+/// entry, but the entries are filled by batches as in TH1::FillN.
+/// If w is NULL each entry is assumed a weight=1
+
+void TProfile3D::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *t, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],t[i],w[i]);
+         else BufferFill(x[i], y[i], z[i], t[i], 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   t += ifirst;
+   if (w) w += ifirst;
+   ntimes = (ntimes - ifirst)/stride;
+   const Bool_t trange = fTmin != fTmax;
+   // must be called before accumulating the entries
+   if (w && !fBinSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i = 0; i < ntimes; ++i) {
+         const Double_t tt = t[i*stride];
+         if (w[i*stride] != 1.0 && (!trange || (tt >= fTmin && tt <= fTmax))) { Sumw2(); break; }
+      }
+   }
+
+   const Bool_t statOverflows = GetStatOverflowsBehaviour();
+   Int_t binsx[kNFillBatch], binsy[kNFillBatch], binsz[kNFillBatch];
+   for (Int_t first = 0; first < ntimes; first += kNFillBatch) {
+      const Int_t n = TMath::Min(Int_t(kNFillBatch), ntimes - first);
+      const Double_t *xb = &x[first*stride];
+      const Double_t *yb = &y[first*stride];
+      const Double_t *zb = &z[first*stride];
+      const Double_t *tb = &t[first*stride];
+      const Double_t *wb = w ? &w[first*stride] : 0;
+      fXaxis.FindFixBins(n, xb, binsx, stride);
+      fYaxis.FindFixBins(n, yb, binsy, stride);
+      fZaxis.FindFixBins(n, zb, binsz, stride);
+      for (i = 0; i < n; ++i) {
+         const Double_t tt = tb[i*stride];
+         if (trange && !(tt >= fTmin && tt <= fTmax)) continue;   // also skips NaN
+         const Int_t binx = FindBatchBin(fXaxis, i, n, xb, binsx, stride);
+         const Int_t biny = FindBatchBin(fYaxis, i, n, yb, binsy, stride);
+         const Int_t binz = FindBatchBin(fZaxis, i, n, zb, binsz, stride);
+         const Int_t bin  = GetBin(binx,biny,binz);
+         const Double_t u = wb ? wb[i*stride] : 1.;
+         fEntries++;
+         AddBinContent(bin, u*tt);
+         fSumw2.fArray[bin] += u*tt*tt;
+         if (fBinSumw2.fN)  fBinSumw2.fArray[bin] += u*u;
+         fBinEntries.fArray[bin] += u;
+      }
+      const Int_t nbinsx = fXaxis.GetNbins();
+      const Int_t nbinsy = fYaxis.GetNbins();
+      const Int_t nbinsz = fZaxis.GetNbins();
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+      Double_t sumwz = 0, sumwz2 = 0, sumwxz = 0, sumwyz = 0, sumwt = 0, sumwt2 = 0;
+      for (i = 0; i < n; ++i) {
+         const Double_t tv = tb[i*stride];
+         const Bool_t stat = (!trange || (tv >= fTmin && tv <= fTmax)) &&
+                             (statOverflows || (binsx[i] > 0 && binsx[i] <= nbinsx && binsy[i] > 0 &&
+                                                binsy[i] <= nbinsy && binsz[i] > 0 && binsz[i] <= nbinsz));
+         const Double_t u  = stat ? (wb ? wb[i*stride] : 1.) : 0.;
+         const Double_t xx = stat ? xb[i*stride] : 0.;
+         const Double_t yy = stat ? yb[i*stride] : 0.;
+         const Double_t zz = stat ? zb[i*stride] : 0.;
+         const Double_t tt = stat ? tv : 0.;
+         sumw   += u;
+         sumw2  += u*u;
+         sumwx  += u*xx;
+         sumwx2 += u*xx*xx;
+         sumwy  += u*yy;
+         sumwy2 += u*yy*yy;
+         sumwxy += u*xx*yy;
+         sumwz  += u*zz;
+         sumwz2 += u*zz*zz;
+         sumwxz += u*xx*zz;
+         sumwyz += u*yy*zz;
+         sumwt  += u*tt;
+         sumwt2 += u*tt*tt;
+      }
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      fTsumwy  += sumwy;
+      fTsumwy2 += sumwy2;
+      fTsumwxy += sumwxy;
+      fTsumwz  += sumwz;
+      fTsumwz2 += sumwz2;
+      fTsumwxz += sumwxz;
+      fTsumwyz += sumwyz;
+      fTsumwt  += sumwt;
+      fTsumwt2 += sumwt2;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return bin content of a Profile3D histogram.
 
@@ -0,0 +1,338 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TQuantileSketch
+    \ingroup Hist
+Streaming estimate of the quantiles of a set of values.
+
+The values are not stored: the sketch keeps a few hundred of them, whatever
+the number of values filled, and estimates from them the quantiles, the median
+or the fraction of the values below a given one. The smallest and the largest
+values, and the number of values, are exact. The sketch is the one of Karnin,
+Lang and Liberty (KLL, "Optimal Quantile Approximation in Streams", 2016):
+the kept values are organized in levels, a value at level h standing for 2^h
+filled values. When a level is full, it is sorted and every other value, from
+a randomly chosen first one, is moved to the level above. The capacities of
+the levels decrease geometrically from the top level, which keeps k values.
+
+The error on the fraction of the values below an estimated quantile is of the
+order of 1/k, it is about 1.5% for the default k of 200, for which the sketch
+keeps about 500 values. It does not depend on the number of values filled, nor
+on their distribution.
+
+Sketches filled separately can be merged, with Merge(), and keep the same
+accuracy: to estimate the quantiles of values processed by several threads,
+each thread fills its own sketch and the sketches are merged at the end. For
+instance, the range of the values found with GetRange() can be used to book a
+histogram without storing the values or reading them twice:
+
+~~~ {.cpp}
+   TQuantileSketch sketch;
+   for (auto x : values)
+      sketch.Fill(x);
+   Double_t xmin, xmax;
+   sketch.GetRange(xmin, xmax, 0.001); // leave 0.1% of the values on each side out
+   TH1D h("h", "values", 100, xmin, xmax);
+~~~
+
+NaN values are ignored.
+*/
+
+#include "TQuantileSketch.h"
+
+#include "TCollection.h"
+#include "TString.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ClassImp(TQuantileSketch);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor. The accuracy of the sketch, and its size, grow with k, which
+/// must be at least 8.
+
+TQuantileSketch::TQuantileSketch(Int_t k)
+   : fK(k), fEntries(0), fMin(std::numeric_limits<Double_t>::infinity()),
+     fMax(-std::numeric_limits<Double_t>::infinity()), fLevels(1), fSize(0), fMaxSize(0), fCoin(0)
+{
+   if (fK < 8) {
+      Warning("TQuantileSketch", "k=%d is too small, it is set to 8", k);
+      fK = 8;
+   }
+   Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TQuantileSketch::~TQuantileSketch()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget all the values filled.
+
+void TQuantileSketch::Clear(Option_t *)
+{
+   fEntries = 0;
+   fMin = std::numeric_limits<Double_t>::infinity();
+   fMax = -std::numeric_limits<Double_t>::infinity();
+   fLevels.assign(1, std::vector<Double_t>());
+   Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of values the given level can keep before being compacted.
+
+Int_t TQuantileSketch::GetCapacity(Int_t level) const
+{
+   const Int_t depth = fLevels.size() - 1 - level;
+   return std::max(2, (Int_t)std::ceil(fK * std::pow(2. / 3., depth)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the values of the level and move every other one to the level above.
+/// With an odd number of values, the largest one stays.
+
+void TQuantileSketch::Compact(Int_t level)
+{
+   if (level + 1 == (Int_t)fLevels.size())
+      fLevels.emplace_back();
+   std::vector<Double_t> &values = fLevels[level];
+   std::vector<Double_t> &above = fLevels[level + 1];
+   std::sort(values.begin(), values.end());
+
+   // a xorshift generator, started again after the sketch is read
+   if (!fCoin)
+      fCoin = 0x9E3779B97F4A7C15ULL;
+   fCoin ^= fCoin << 13;
+   fCoin ^= fCoin >> 7;
+   fCoin ^= fCoin << 17;
+
+   const size_t n = values.size() & ~size_t(1);
+   for (size_t i = fCoin & 1; i < n; i += 2)
+      above.push_back(values[i]);
+   values.erase(values.begin(), values.begin() + n);
+   fSize -= n / 2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compact levels until the number of values kept is below the capacity of the
+/// sketch. The first full level, from the bottom, is compacted first.
+
+void TQuantileSketch::Compress()
+{
+   fSize = GetSize();
+   while (true) {
+      fMaxSize = 0;
+      for (Int_t level = 0; level < (Int_t)fLevels.size(); ++level)
+         fMaxSize += GetCapacity(level);
+      if (fSize < fMaxSize)
+         break;
+      for (Int_t level = 0; level < (Int_t)fLevels.size(); ++level) {
+         if ((Int_t)fLevels[level].size() >= GetCapacity(level)) {
+            Compact(level);
+            break;
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill one value.
+
+void TQuantileSketch::Fill(Double_t x)
+{
+   if (std::isnan(x))
+      return;
+   if (x < fMin)
+      fMin = x;
+   if (x > fMax)
+      fMax = x;
+   ++fEntries;
+   fLevels[0].push_back(x);
+   if (++fSize >= fMaxSize)
+      Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill n values.
+
+void TQuantileSketch::FillN(Long64_t n, const Double_t *x)
+{
+   for (Long64_t i = 0; i < n; ++i)
+      Fill(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values of another sketch to this one. The accuracy of the result
+/// is the one of this sketch.
+
+void TQuantileSketch::Merge(const TQuantileSketch &other)
+{
+   if (&other == this || !other.fEntries)
+      return;
+   fEntries += other.fEntries;
+   fMin = std::min(fMin, other.fMin);
+   fMax = std::max(fMax, other.fMax);
+   if (fLevels.size() < other.fLevels.size())
+      fLevels.resize(other.fLevels.size());
+   for (size_t level = 0; level < other.fLevels.size(); ++level)
+      fLevels[level].insert(fLevels[level].end(), other.fLevels[level].begin(), other.fLevels[level].end());
+   Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values of the sketches of the list to this one.
+/// Return the number of values of the result, or -1 if an object of the
+/// list is not a TQuantileSketch.
+
+Long64_t TQuantileSketch::Merge(TCollection *list)
+{
+   if (!list)
+      return fEntries;
+   TIter next(list);
+   while (TObject *obj = next()) {
+      TQuantileSketch *sketch = dynamic_cast<TQuantileSketch *>(obj);
+      if (!sketch) {
+         Error("Merge", "Cannot merge an object of class %s", obj->ClassName());
+         return -1;
+      }
+      Merge(*sketch);
+   }
+   return fEntries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of values kept by the sketch.
+
+Int_t TQuantileSketch::GetSize() const
+{
+   Int_t size = 0;
+   for (auto &values : fLevels)
+      size += values.size();
+   return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// The values kept, sorted, with the number of filled values they stand for
+/// up to each of them.
+
+void TQuantileSketch::GetCumulative(std::vector<std::pair<Double_t, Double_t> > &values) const
+{
+   values.clear();
+   values.reserve(GetSize());
+   Double_t weight = 1;
+   for (auto &level : fLevels) {
+      for (auto x : level)
+         values.emplace_back(x, weight);
+      weight *= 2;
+   }
+   std::sort(values.begin(), values.end());
+   Double_t sum = 0;
+   for (auto &value : values) {
+      sum += value.second;
+      value.second = sum;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Estimate of the quantile of probability prob: the smallest value x such
+/// that a fraction prob of the values is lower or equal to x. The quantiles of
+/// probability 0 and 1 are the exact minimum and maximum.
+
+Double_t TQuantileSketch::GetQuantile(Double_t prob) const
+{
+   Double_t q = 0;
+   GetQuantiles(1, &q, &prob);
+   return q;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Estimate the quantiles of the values, see GetQuantile().
+///
+/// \param[in] nprobSum size of the array q and of the array probSum (if given)
+/// \param[out] q array filled with the nprobSum quantiles
+/// \param[in] probSum array of the probabilities of the quantiles. If it is
+///   null, the quantiles are computed for nprobSum probabilities evenly spaced
+///   from 0 to 1.
+/// \return number of quantiles computed, 0 if the sketch is empty
+
+Int_t TQuantileSketch::GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum) const
+{
+   if (nprobSum <= 0 || !fEntries)
+      return 0;
+
+   std::vector<std::pair<Double_t, Double_t> > values;
+   GetCumulative(values);
+   const Double_t total = values.back().second;
+   for (Int_t i = 0; i < nprobSum; ++i) {
+      Double_t prob = probSum ? probSum[i] : (nprobSum > 1 ? Double_t(i) / (nprobSum - 1) : 0.5);
+      if (prob <= 0) {
+         q[i] = fMin;
+      } else if (prob >= 1) {
+         q[i] = fMax;
+      } else {
+         const Double_t rank = prob * total;
+         auto it = std::lower_bound(values.begin(), values.end(), rank,
+                                    [](const std::pair<Double_t, Double_t> &v, Double_t r) { return v.second < r; });
+         q[i] = it == values.end() ? fMax : std::min(std::max(it->first, fMin), fMax);
+      }
+   }
+   return nprobSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Range of the values, to book a histogram: with tail=0, the exact minimum and
+/// maximum, otherwise the quantiles of probability tail and 1-tail.
+
+void TQuantileSketch::GetRange(Double_t &xmin, Double_t &xmax, Double_t tail) const
+{
+   const Double_t prob[2] = {tail, 1 - tail};
+   Double_t q[2] = {0, 0};
+   GetQuantiles(2, q, prob);
+   xmin = q[0];
+   xmax = q[1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Estimate of the fraction of the values lower or equal to x.
+
+Double_t TQuantileSketch::GetRank(Double_t x) const
+{
+   if (!fEntries || x < fMin)
+      return 0;
+   if (x >= fMax)
+      return 1;
+   Double_t below = 0, total = 0, weight = 1;
+   for (auto &level : fLevels) {
+      for (auto v : level) {
+         if (v <= x)
+            below += weight;
+      }
+      total += weight * level.size();
+      weight *= 2;
+   }
+   return below / total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the number of values, the extrema and the quartiles.
+
+void TQuantileSketch::Print(Option_t *) const
+{
+   const Double_t prob[3] = {0.25, 0.5, 0.75};
+   Double_t q[3] = {0, 0, 0};
+   GetQuantiles(3, q, prob);
+   Printf("TQuantileSketch: %lld entries, %d values kept (k=%d)", fEntries, GetSize(), fK);
+   Printf("   min=%g, q1=%g, median=%g, q3=%g, max=%g", GetMinimum(), q[0], q[1], q[2], GetMaximum());
+}
@@ -345,6 +345,13 @@ void TSplinePoly5::CopyPoly(TSplinePoly5 const &other)
  Class to create third splines to interpolate knots
  Arbitrary conditions can be introduced for first and second
  derivatives at beginning and ending points
+
+ When the knots are not equidistant, the interval of a point is looked up
+ in a uniform grid over the knots, each cell holding the first knot it
+ contains, instead of a binary search over all the knots. A spline whose
+ knots were moved with SetPoint() falls back to the binary search.
+ Eval(n, x, y) evaluates the spline at many points, reusing the interval
+ of the previous point when the points are close to each other.
  */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -355,7 +362,7 @@ TSpline3::TSpline3(const char *title,
                    Double_t x[], Double_t y[], Int_t n, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1,x[0],x[n-1],n,kFALSE),
-  fValBeg(valbeg), fValEnd(valend), fBegCond(0), fEndCond(0)
+  fValBeg(valbeg), fValEnd(valend), fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName="Spline3";
 
@@ -385,7 +392,7 @@ TSpline3::TSpline3(const char *title,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,(xmax-xmin)/(n-1), xmin, xmax, n, kTRUE),
   fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName="Spline3";
 
@@ -414,7 +421,7 @@ TSpline3::TSpline3(const char *title,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1, x[0], x[n-1], n, kFALSE),
   fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName="Spline3";
 
@@ -444,7 +451,7 @@ TSpline3::TSpline3(const char *title,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,(xmax-xmin)/(n-1), xmin, xmax, n, kTRUE),
   fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName="Spline3";
 
@@ -477,7 +484,7 @@ TSpline3::TSpline3(const char *title,
                    Double_t valbeg, Double_t valend) :
   TSpline(title,-1,0,0,g->GetN(),kFALSE),
   fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName="Spline3";
 
@@ -507,7 +514,7 @@ TSpline3::TSpline3(const TH1 *h, const char *opt,
                    Double_t valbeg, Double_t valend) :
   TSpline(h->GetTitle(),-1,0,0,h->GetNbinsX(),kFALSE),
   fValBeg(valbeg), fValEnd(valend),
-  fBegCond(0), fEndCond(0)
+  fBegCond(0), fEndCond(0), fKnotScale(0)
 {
    fName=h->GetName();
 
@@ -537,7 +544,9 @@ TSpline3::TSpline3(const TSpline3& sp3) :
   fValBeg(sp3.fValBeg),
   fValEnd(sp3.fValEnd),
   fBegCond(sp3.fBegCond),
-  fEndCond(sp3.fEndCond)
+  fEndCond(sp3.fEndCond),
+  fKnotIndex(sp3.fKnotIndex),
+  fKnotScale(sp3.fKnotScale)
 {
    if (fNp > 0) fPoly = new TSplinePoly3[fNp];
    for (Int_t i=0; i<fNp; ++i)
@@ -560,6 +569,8 @@ TSpline3& TSpline3::operator=(const TSpline3& sp3)
       fValEnd=sp3.fValEnd;
       fBegCond=sp3.fBegCond;
       fEndCond=sp3.fEndCond;
+      fKnotIndex=sp3.fKnotIndex;
+      fKnotScale=sp3.fKnotScale;
    }
    return *this;
 }
@@ -756,6 +767,23 @@ Int_t TSpline3::FindX(Double_t x) const
          else if (klow < khig) {
             if (x > fPoly[klow+1].X()) ++klow;
          }
+      } else if (!fKnotIndex.empty()) {
+         //
+         // Non equidistant knots, search the knots of the cell of x:
+         // those of the cells before are below x, those of the cells after above it
+         Int_t ncells = fKnotIndex.size()-1;
+         Double_t pos = (x-fXmin)*fKnotScale;
+         Int_t cell = pos < ncells ? Int_t(pos) : ncells-1;
+         Int_t first = fKnotIndex[cell], last = fKnotIndex[cell+1];
+         // first knot not below x, in the cell or the first one of the next cells
+         while (last-first>0) {
+            Int_t khalf = (first+last)/2;
+            if (x>fPoly[khalf].X())
+               first = khalf+1;
+            else
+               last = khalf;
+         }
+         klow = TMath::Min(TMath::Max(first-1, 0), khig-1);
       } else {
          Int_t khalf;
          //
@@ -786,6 +814,37 @@ Double_t TSpline3::Eval(Double_t x) const
    return fPoly[klow].Eval(x);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Eval this spline at the n points x, into y. The result is the same as
+/// evaluating the points one by one. The interval of a point is looked up
+/// only if it is not the one of the previous point; the points are processed
+/// by blocks, their intervals being found before the polynomials are evaluated.
+
+void TSpline3::Eval(Int_t n, const Double_t *x, Double_t *y) const
+{
+   const Int_t kBlockSize = 256;
+   Int_t knots[kBlockSize];
+   Int_t klow = -1;
+   for (Int_t begin = 0; begin < n; begin += kBlockSize) {
+      const Int_t size = TMath::Min(kBlockSize, n - begin);
+      const Double_t *xb = x + begin;
+      for (Int_t i = 0; i < size; ++i) {
+         // with indexed knots, FindX returns the last knot below x when x is inside the range
+         if (!(klow >= 0 && xb[i] > fPoly[klow].X() && xb[i] <= fPoly[klow+1].X() &&
+               xb[i] > fXmin && xb[i] < fXmax)) {
+            Int_t k = FindX(xb[i]);
+            if (k >= fNp-1 && fNp > 1) k = fNp-2; //see: https://savannah.cern.ch/bugs/?71651
+            knots[i] = k;
+            klow = fKnotIndex.empty() ? -1 : k;
+         } else {
+            knots[i] = klow;
+         }
+      }
+      for (Int_t i = 0; i < size; ++i)
+         y[begin + i] = fPoly[knots[i]].Eval(xb[i]);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Derivative.
 
@@ -993,6 +1052,8 @@ void TSpline3::SetPoint(Int_t i, Double_t x, Double_t y)
    if (i < 0 || i >= fNp) return;
    fPoly[i].X()= x;
    fPoly[i].Y()= y;
+   // the knots may not be ordered anymore
+   fKnotIndex.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1161,6 +1222,37 @@ L30: j = l-1;
       fPoly[i-1].C() = (divdf1 - fPoly[i-1].B() - divdf3)/dtau;
       fPoly[i-1].D() = (divdf3/dtau)/dtau;
    }
+   BuildKnotIndex();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the lookup grid of the knots used by FindX when they are not
+/// equidistant: cell i of the grid covers [fXmin+i/fKnotScale, fXmin+(i+1)/fKnotScale[
+/// and fKnotIndex[i] is the first knot in a cell not before i. The grid is not
+/// built if the knots are not in increasing order.
+
+void TSpline3::BuildKnotIndex()
+{
+   fKnotIndex.clear();
+   if (fKstep || fNp < 2 || !(fXmin < fXmax)) return;
+   for (Int_t i = 1; i < fNp; ++i) {
+      if (!(fPoly[i-1].X() <= fPoly[i].X())) return;
+   }
+   const Int_t ncells = fNp;
+   fKnotScale = ncells/(fXmax-fXmin);
+   fKnotIndex.resize(ncells+1);
+   // cell of each knot, computed as in FindX
+   Int_t k = 0;
+   for (Int_t cell = 0; cell < ncells; ++cell) {
+      while (k < fNp) {
+         Double_t pos = (fPoly[k].X()-fXmin)*fKnotScale;
+         Int_t kcell = pos < 0 ? -1 : (pos < ncells ? Int_t(pos) : ncells-1);
+         if (kcell >= cell) break;
+         ++k;
+      }
+      fKnotIndex[cell] = k;
+   }
+   fKnotIndex[ncells] = fNp;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1173,6 +1265,7 @@ void TSpline3::Streamer(TBuffer &R__b)
       Version_t R__v = R__b.ReadVersion(&R__s, &R__c);
       if (R__v > 1) {
          R__b.ReadClassBuffer(TSpline3::Class(), this, R__v, R__s, R__c);
+         BuildKnotIndex();
          return;
       }
       //====process old versions before automatic schema evolution
@@ -1188,6 +1281,7 @@ void TSpline3::Streamer(TBuffer &R__b)
       R__b >> fValEnd;
       R__b >> fBegCond;
       R__b >> fEndCond;
+      BuildKnotIndex();
    } else {
       R__b.WriteClassBuffer(TSpline3::Class(),this);
    }
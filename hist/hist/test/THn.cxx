@@ -1,8 +1,12 @@
 #include "gtest/gtest.h"
 
 #include "THn.h"
+#include "THnSparse.h"
 #include "TH1.h"
 #include "TH2.h"
+#include "TRandom3.h"
+
+#include <vector>
 
 // Filling THn
 TEST(THn, Fill) {
@@ -108,3 +112,96 @@ TEST(THn, Projection) {
 
 
 }
+
+// Filling THnSparse by batches, adding and projecting them
+TEST(THnSparse, FillNAddProjection) {
+   const Int_t ndim = 5;
+   Int_t bins[ndim] = {10, 20, 5, 8, 10};
+   Double_t xmin[ndim] = {0., -3., 0., 0., -1.};
+   Double_t xmax[ndim] = {10., 3., 1., 4., 1.};
+   THnSparseD hs("hs", "hs", ndim, bins, xmin, xmax, 256);
+   THnSparseD hsN("hsN", "hsN", ndim, bins, xmin, xmax, 256);
+   THnD hn("hn", "hn", ndim, bins, xmin, xmax);
+   hs.Sumw2();
+   hsN.Sumw2();
+   hn.Sumw2();
+
+   TRandom3 r(7);
+   const Int_t n = 20000;
+   std::vector<Double_t> x(n * ndim), w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t d = 0; d < ndim; ++d)
+         x[i * ndim + d] = r.Gaus((xmin[d] + xmax[d]) / 2, (xmax[d] - xmin[d]) / 3);
+      w[i] = r.Uniform(0.5, 1.5);
+      hs.Fill(&x[i * ndim], w[i]);
+      hn.Fill(&x[i * ndim], w[i]);
+   }
+   hsN.FillN(n, x.data(), w.data());
+
+   EXPECT_EQ(hs.GetNbins(), hsN.GetNbins());
+   EXPECT_DOUBLE_EQ(hs.GetEntries(), hsN.GetEntries());
+   Int_t coord[ndim];
+   for (Long64_t bin = 0; bin < hs.GetNbins(); ++bin) {
+      Double_t v = hs.GetBinContent(bin, coord);
+      Long64_t binN = hsN.GetBin(coord, kFALSE);
+      ASSERT_GE(binN, 0);
+      EXPECT_NEAR(v, hsN.GetBinContent(binN), 1e-12);
+      EXPECT_NEAR(v, hn.GetBinContent(coord), 1e-12);
+   }
+
+   // Adding THnSparse with the same binning, to one with only some of their bins
+   THnSparseD hsSum("hsSum", "hsSum", ndim, bins, xmin, xmax, 256);
+   THnSparseD hsHalf("hsHalf", "hsHalf", ndim, bins, xmin, xmax, 256);
+   for (Int_t i = 0; i < n / 2; ++i) {
+      hsSum.Fill(&x[i * ndim], w[i]);
+      hsHalf.Fill(&x[i * ndim], w[i]);
+   }
+   hsSum.Add(&hsN, 2.);
+   hsSum.Add(&hs, -1.);
+   EXPECT_EQ(hsSum.GetNbins(), hs.GetNbins());
+   for (Long64_t bin = 0; bin < hs.GetNbins(); ++bin) {
+      Double_t v = hs.GetBinContent(bin, coord);
+      EXPECT_NEAR(hsSum.GetBinContent(coord), v + hsHalf.GetBinContent(coord), 1e-9);
+   }
+
+   // Projections of the sparse and dense histograms, with a range
+   hs.GetAxis(2)->SetRange(2, 4);
+   hn.GetAxis(2)->SetRange(2, 4);
+   TH2D* projS = hs.Projection(1, 0);
+   TH2D* projN = hn.Projection(1, 0);
+   EXPECT_DOUBLE_EQ(projS->GetEntries(), projN->GetEntries());
+   for (Int_t bin = 0; bin < projS->GetNcells(); ++bin) {
+      EXPECT_NEAR(projS->GetBinContent(bin), projN->GetBinContent(bin), 1e-9);
+      EXPECT_NEAR(projS->GetBinError(bin), projN->GetBinError(bin), 1e-9);
+   }
+   delete projS;
+   delete projN;
+}
+
+// Bins whose compact coordinates do not fit in a Long64_t
+TEST(THnSparse, LargeCoordinates) {
+   const Int_t ndim = 8;
+   Int_t bins[ndim];
+   Double_t xmin[ndim], xmax[ndim];
+   for (Int_t d = 0; d < ndim; ++d) {
+      bins[d] = 1000;
+      xmin[d] = 0.;
+      xmax[d] = 1.;
+   }
+   THnSparseF hs("hs", "hs", ndim, bins, xmin, xmax, 128);
+   TRandom3 r(3);
+   std::vector<Double_t> x(1000 * ndim);
+   for (auto &xi : x)
+      xi = r.Uniform(-0.01, 1.01);
+   for (Int_t i = 0; i < 1000; ++i) {
+      hs.Fill(&x[i * ndim]);
+      hs.Fill(&x[i * ndim], 2.);
+   }
+   EXPECT_EQ(1000, hs.GetNbins());
+   for (Int_t i = 0; i < 1000; ++i) {
+      Long64_t bin = hs.GetBin(&x[i * ndim], kFALSE);
+      ASSERT_GE(bin, 0);
+      EXPECT_FLOAT_EQ(3., hs.GetBinContent(bin));
+   }
+   EXPECT_GT(hs.GetMemoryUsage(), 1000 * (Long64_t)sizeof(Float_t));
+}
@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+
+#include "TEfficiency.h"
+#include "TH2D.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static TEfficiency *CreateEfficiency(Bool_t weights)
+{
+   TRandom3 rnd(1);
+   TEfficiency *eff = new TEfficiency("eff", "eff", 20, 0, 1, 20, 0, 1);
+   eff->SetDirectory(nullptr);
+   if (weights)
+      eff->SetUseWeightedEvents();
+   for (Int_t i = 0; i < 2000; ++i) {
+      const Double_t x = rnd.Rndm(), y = rnd.Rndm();
+      const Bool_t passed = rnd.Rndm() < x;
+      if (weights)
+         eff->FillWeighted(passed, 0.5 + rnd.Rndm(), x, y);
+      else
+         eff->Fill(passed, x, y);
+   }
+   return eff;
+}
+
+// the errors of the empty bins may be undefined
+static void ExpectSame(Double_t value, Double_t expected, Int_t bin)
+{
+   if (std::isnan(expected))
+      EXPECT_TRUE(std::isnan(value)) << "bin " << bin;
+   else
+      EXPECT_DOUBLE_EQ(value, expected) << "bin " << bin;
+}
+
+static void ExpectSameErrors(const TEfficiency &eff, const std::vector<Double_t> &low, const std::vector<Double_t> &up)
+{
+   for (Int_t bin = 0; bin < (Int_t)low.size(); ++bin) {
+      ExpectSame(eff.GetEfficiencyErrorLow(bin), low[bin], bin);
+      ExpectSame(eff.GetEfficiencyErrorUp(bin), up[bin], bin);
+   }
+}
+
+// The errors computed for all the bins are the ones computed bin by bin
+TEST(TEfficiency, ComputeIntervals)
+{
+   for (Bool_t weights : {kFALSE, kTRUE}) {
+      std::unique_ptr<TEfficiency> eff(CreateEfficiency(weights));
+      const Int_t ncells = eff->GetTotalHistogram()->GetNcells();
+      std::vector<TEfficiency::EStatOption> options = {TEfficiency::kBJeffrey, TEfficiency::kBBayesian};
+      if (!weights)
+         options.insert(options.end(), {TEfficiency::kFCP, TEfficiency::kFFC, TEfficiency::kMidP});
+      for (auto option : options) {
+         for (Bool_t shortest : {kFALSE, kTRUE}) {
+            eff->SetStatisticOption(option);
+            if (option == TEfficiency::kBBayesian) {
+               eff->SetBetaAlpha(2);
+               eff->SetBetaBeta(3);
+            }
+            eff->SetShortestInterval(shortest);
+            std::vector<Double_t> low(ncells), up(ncells);
+            for (Int_t bin = 0; bin < ncells; ++bin) {
+               low[bin] = eff->GetEfficiencyErrorLow(bin);
+               up[bin] = eff->GetEfficiencyErrorUp(bin);
+            }
+            eff->ComputeIntervals();
+            ExpectSameErrors(*eff, low, up);
+#ifdef R__USE_IMT
+            ROOT::EnableImplicitMT(4);
+            eff->ComputeIntervals();
+            ExpectSameErrors(*eff, low, up);
+            ROOT::DisableImplicitMT();
+#endif
+         }
+      }
+   }
+}
+
+// The errors kept are not used once the bin or the options changed
+TEST(TEfficiency, IntervalsChanged)
+{
+   std::unique_ptr<TEfficiency> eff(CreateEfficiency(kFALSE));
+   eff->SetStatisticOption(TEfficiency::kFCP);
+   eff->ComputeIntervals();
+   const Int_t bin = eff->GetGlobalBin(3, 4);
+   const Double_t low = eff->GetEfficiencyErrorLow(bin);
+
+   eff->SetTotalEvents(bin, 50);
+   eff->SetPassedEvents(bin, 10);
+   EXPECT_DOUBLE_EQ(eff->GetEfficiencyErrorLow(bin), 0.2 - TEfficiency::ClopperPearson(50, 10, eff->GetConfidenceLevel(), kFALSE));
+   EXPECT_NE(eff->GetEfficiencyErrorLow(bin), low);
+
+   const Int_t other = eff->GetGlobalBin(5, 6);
+   const Double_t total = eff->GetTotalHistogram()->GetBinContent(other);
+   const Double_t passed = eff->GetPassedHistogram()->GetBinContent(other);
+   eff->SetConfidenceLevel(0.95);
+   EXPECT_DOUBLE_EQ(eff->GetEfficiencyErrorUp(other),
+                    TEfficiency::ClopperPearson(total, passed, 0.95, kTRUE) - eff->GetEfficiency(other));
+}
+
+// The errors may be computed again by a thread while other threads read them
+TEST(TEfficiency, ConcurrentIntervals)
+{
+   ROOT::EnableThreadSafety();
+   std::unique_ptr<TEfficiency> eff(CreateEfficiency(kFALSE));
+   eff->SetStatisticOption(TEfficiency::kFCP);
+   const Int_t ncells = eff->GetTotalHistogram()->GetNcells();
+   std::vector<Double_t> low(ncells), up(ncells);
+   for (Int_t bin = 0; bin < ncells; ++bin) {
+      low[bin] = eff->GetEfficiencyErrorLow(bin);
+      up[bin] = eff->GetEfficiencyErrorUp(bin);
+   }
+
+   const TEfficiency &shared = *eff;
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < 4; ++t) {
+      threads.emplace_back([&]() {
+         for (Int_t round = 0; round < 5; ++round) {
+            shared.ComputeIntervals();
+            ExpectSameErrors(shared, low, up);
+         }
+      });
+   }
+   for (auto &thr : threads)
+      thr.join();
+}
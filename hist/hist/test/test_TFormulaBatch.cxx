@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+
+#include "Fit/BinData.h"
+#include "Fit/Chi2FCN.h"
+#include "Fit/Fitter.h"
+#include "Fit/LogLikelihoodFCN.h"
+#include "Fit/UnBinData.h"
+#include "HFitInterface.h"
+#include "Math/WrappedMultiTF1.h"
+#include "TF1.h"
+#include "TF12.h"
+#include "TF2.h"
+#include "TFormula.h"
+#include "TH1D.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <vector>
+
+// Coordinates of n random points in [-2, 2]^ndim, stored by dimension
+static std::vector<Double_t> RandomPoints(size_t n, Int_t ndim)
+{
+   TRandom3 rnd(1);
+   std::vector<Double_t> x(n * ndim);
+   for (auto &xi : x)
+      xi = rnd.Uniform(-2, 2);
+   return x;
+}
+
+// The values computed by batch are the ones computed point by point
+TEST(TFormulaBatch, Formula)
+{
+   const size_t n = 1001;
+   std::vector<Double_t> x = RandomPoints(n, 2), values(n);
+
+   TFormula formula("batch_formula", "[0]*exp(-x*x)*cos([1]*y) + y");
+   formula.SetParameters(2., 3.);
+   formula.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i) {
+      Double_t xi[2] = {x[i], x[n + i]};
+      EXPECT_DOUBLE_EQ(values[i], formula.EvalPar(xi)) << "point " << i;
+   }
+
+   const Double_t params[2] = {-1., 0.5};
+   formula.EvalBatch(x.data(), values.data(), n, params);
+   for (size_t i = 0; i < n; ++i) {
+      Double_t xi[2] = {x[i], x[n + i]};
+      EXPECT_DOUBLE_EQ(values[i], formula.EvalPar(xi, params)) << "point " << i;
+   }
+
+   // a copy uses the same compiled loop
+   TFormula copy(formula);
+   std::vector<Double_t> copyValues(n);
+   copy.EvalBatch(x.data(), copyValues.data(), n, params);
+   EXPECT_EQ(copyValues, values);
+}
+
+TEST(TFormulaBatch, TF1)
+{
+   const size_t n = 257;
+   std::vector<Double_t> x = RandomPoints(n, 1), values(n);
+
+   TF1 f1("batch_gaus", "gaus(0) + [3]", -2, 2);
+   f1.SetParameters(1., 0.2, 0.7, 0.1);
+   f1.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(values[i], f1.Eval(x[i])) << "point " << i;
+
+   f1.SetNormalized(true);
+   f1.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(values[i], f1.Eval(x[i])) << "point " << i;
+
+   // functions which are not formulae are evaluated one point at a time
+   TF1 lambda("batch_lambda", [](Double_t *xx, Double_t *p) { return p[0] * xx[0] * xx[0]; }, -2, 2, 1);
+   lambda.SetParameter(0, 3.);
+   lambda.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(values[i], lambda.Eval(x[i])) << "point " << i;
+}
+
+TEST(TFormulaBatch, TF12)
+{
+   const size_t n = 100;
+   std::vector<Double_t> x = RandomPoints(n, 1), values(n);
+
+   TF2 f2("batch_f2", "x*x + [0]*y", -2, 2, -2, 2);
+   f2.SetParameter(0, 2.);
+   TF12 fx("batch_fx", &f2, 0.5, "x");
+   fx.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(values[i], f2.Eval(x[i], 0.5)) << "point " << i;
+
+   TF12 fy("batch_fy", &f2, 0.5, "y");
+   fy.EvalBatch(x.data(), values.data(), n);
+   for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(values[i], f2.Eval(0.5, x[i])) << "point " << i;
+}
+
+// Fit f to the data with a chi2 or, for unbinned data, a likelihood fit
+template <class Data>
+static ROOT::Fit::FitResult FitModel(const Data &data, TF1 &f, const std::vector<Double_t> &init)
+{
+   ROOT::Fit::Fitter fitter;
+   fitter.SetFunction(ROOT::Math::WrappedMultiTF1(f, 1), false);
+   for (size_t i = 0; i < init.size(); ++i)
+      fitter.Config().ParSettings(i).SetValue(init[i]);
+   EXPECT_TRUE(fitter.Fit(data));
+   return fitter.Result();
+}
+
+static void ExpectSameFit(const ROOT::Fit::FitResult &batch, const ROOT::Fit::FitResult &point)
+{
+   EXPECT_TRUE(batch.IsValid());
+   EXPECT_NEAR(batch.MinFcnValue(), point.MinFcnValue(), 1e-10 * std::abs(point.MinFcnValue()));
+   for (unsigned int i = 0; i < point.NPar(); ++i)
+      EXPECT_NEAR(batch.Parameter(i), point.Parameter(i), 1e-4 * point.ParError(i)) << "parameter " << i;
+}
+
+// The fits of a formula, whose model values are computed by batches of
+// points, give the results of the fits of the same formula evaluated one
+// point at a time
+TEST(TFormulaBatch, Fit)
+{
+   TRandom3 rnd(1);
+   const Double_t params[3] = {60., 0.5, 1.2};
+
+   TF1 batch("batch_fit", "[0]*exp(-0.5*((x-[1])/[2])^2)", -5, 5);
+   TF1 point("point_fit", [&](Double_t *xx, Double_t *p) { return batch.EvalPar(xx, p); }, -5, 5, 3);
+
+   // more bins and points than in a batch
+   TH1D h("batch_fit_hist", "", 1200, -5, 5);
+   h.SetDirectory(nullptr);
+   for (int i = 0; i < 200000; ++i)
+      h.Fill(rnd.Gaus(params[1], params[2]));
+   ROOT::Fit::BinData binData;
+   ROOT::Fit::FillData(binData, &h);
+   ASSERT_GT(binData.Size(), 1024u);
+
+   ROOT::Fit::Chi2Function batchChi2(binData, ROOT::Math::WrappedMultiTF1(batch, 1));
+   ROOT::Fit::Chi2Function pointChi2(binData, ROOT::Math::WrappedMultiTF1(point, 1));
+   EXPECT_NEAR(batchChi2(params), pointChi2(params), 1e-12 * pointChi2(params));
+   ExpectSameFit(FitModel(binData, batch, {50., 0., 1.}), FitModel(binData, point, {50., 0., 1.}));
+
+   TF1 batchPdf("batch_pdf", "exp(-0.5*((x-[0])/[1])^2)/(sqrt(2*pi)*[1])", -5, 5);
+   TF1 pointPdf("point_pdf", [&](Double_t *xx, Double_t *p) { return batchPdf.EvalPar(xx, p); }, -5, 5, 2);
+
+   std::vector<Double_t> x(5000);
+   for (auto &xi : x)
+      xi = rnd.Gaus(params[1], params[2]);
+   ROOT::Fit::UnBinData unbinData(x.size(), x.data());
+
+   ROOT::Fit::LogLikelihoodFunction batchLogL(unbinData, ROOT::Math::WrappedMultiTF1(batchPdf, 1));
+   ROOT::Fit::LogLikelihoodFunction pointLogL(unbinData, ROOT::Math::WrappedMultiTF1(pointPdf, 1));
+   EXPECT_NEAR(batchLogL(params + 1), pointLogL(params + 1), 1e-12 * std::abs(pointLogL(params + 1)));
+   ExpectSameFit(FitModel(unbinData, batchPdf, {0., 1.}), FitModel(unbinData, pointPdf, {0., 1.}));
+
+#ifdef R__USE_IMT
+   // the batches are evaluated in the chunks of the parallel reduction
+   ROOT::Fit::Chi2Function parallelChi2(binData, ROOT::Math::WrappedMultiTF1(batch, 1),
+                                        ROOT::Fit::ExecutionPolicy::kMultithread);
+   EXPECT_NEAR(parallelChi2(params), batchChi2(params), 1e-12 * batchChi2(params));
+   ROOT::Fit::LogLikelihoodFunction parallelLogL(unbinData, ROOT::Math::WrappedMultiTF1(batchPdf, 1), 0, false,
+                                                 ROOT::Fit::ExecutionPolicy::kMultithread);
+   EXPECT_NEAR(parallelLogL(params + 1), batchLogL(params + 1), 1e-12 * std::abs(batchLogL(params + 1)));
+#endif
+}
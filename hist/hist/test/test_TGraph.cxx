@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include "TGraph.h"
+#include "TRandom3.h"
+#include "TSpline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Eval in indexed mode gives the interpolation of the graph sorted in x
+TEST(TGraph, IndexedEval)
+{
+   const Int_t n = 500;
+   TRandom3 rnd(1);
+   std::vector<Double_t> x(n), y(n);
+   for (Int_t i = 0; i < n; ++i) {
+      // a few duplicated abscissas
+      x[i] = i % 50 == 0 ? 1. : 10 * rnd.Rndm() * rnd.Rndm();
+      y[i] = std::sin(x[i]);
+   }
+   TGraph indexed(n, x.data(), y.data());
+   indexed.SetIndexedEval();
+   EXPECT_TRUE(indexed.IsIndexedEval());
+   TGraph sorted(indexed);
+   sorted.SetIndexedEval(kFALSE);
+   sorted.Sort();
+
+   std::vector<Double_t> xe;
+   for (Double_t xx = -1; xx <= 11; xx += 0.0137)
+      xe.push_back(xx);
+   for (Int_t i = 0; i < n; i += 7)
+      xe.push_back(x[i]);
+   std::vector<Double_t> ye(xe.size());
+   indexed.Eval(xe.size(), xe.data(), ye.data());
+   for (UInt_t i = 0; i < xe.size(); ++i) {
+      EXPECT_EQ(indexed.Eval(xe[i]), sorted.Eval(xe[i])) << "x = " << xe[i];
+      EXPECT_EQ(ye[i], sorted.Eval(xe[i])) << "x = " << xe[i];
+   }
+
+   // the index follows the changes of the points
+   indexed.SetPoint(3, 20., 5.);
+   EXPECT_EQ(indexed.Eval(20.), 5.);
+   indexed.SetPoint(3, x[3], y[3]);
+   EXPECT_EQ(indexed.Eval(20.), sorted.Eval(20.));
+}
+
+// The batch evaluation of a spline gives the evaluation point by point
+TEST(TGraph, SplineEval)
+{
+   const Int_t n = 200;
+   TRandom3 rnd(2);
+   std::vector<Double_t> x(n), y(n);
+   for (Int_t i = 0; i < n; ++i)
+      x[i] = 10 * rnd.Rndm() * rnd.Rndm();
+   std::sort(x.begin(), x.end());
+   for (Int_t i = 0; i < n; ++i)
+      y[i] = std::cos(x[i]);
+   TGraph g(n, x.data(), y.data());
+   TSpline3 spline("spline", &g);
+
+   std::vector<Double_t> xe;
+   for (Int_t i = 0; i < 2000; ++i)
+      xe.push_back(-1 + 12 * rnd.Rndm());
+   std::vector<Double_t> ye(xe.size()), yg(xe.size());
+   spline.Eval(xe.size(), xe.data(), ye.data());
+   g.Eval(xe.size(), xe.data(), yg.data(), nullptr, "S");
+   for (UInt_t i = 0; i < xe.size(); ++i) {
+      EXPECT_EQ(ye[i], spline.Eval(xe[i])) << "x = " << xe[i];
+      EXPECT_EQ(yg[i], g.Eval(xe[i], nullptr, "S")) << "x = " << xe[i];
+   }
+}
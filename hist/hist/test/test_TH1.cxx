@@ -2,6 +2,20 @@
 
 #include "TH1.h"
 #include "TH1F.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TH3F.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
 
 // StatOverflows TH1
 TEST(TH1, StatOverflows)
@@ -30,3 +44,184 @@ TEST(TH1, StatOverflows)
    EXPECT_EQ(TH1::EStatOverflows::kConsider, h1.GetStatOverflows());
    EXPECT_EQ(TH1::EStatOverflows::kNeutral,  h2.GetStatOverflows());
 }
+
+static void ExpectSameFill(const TH1 &h1, const TH1 &h2)
+{
+   ASSERT_EQ(h1.GetNcells(), h2.GetNcells());
+   EXPECT_DOUBLE_EQ(h1.GetXaxis()->GetXmin(), h2.GetXaxis()->GetXmin());
+   EXPECT_DOUBLE_EQ(h1.GetXaxis()->GetXmax(), h2.GetXaxis()->GetXmax());
+   for (Int_t bin = 0; bin < h1.GetNcells(); ++bin) {
+      EXPECT_DOUBLE_EQ(h1.GetBinContent(bin), h2.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_DOUBLE_EQ(h1.GetBinError(bin), h2.GetBinError(bin)) << "bin " << bin;
+   }
+   EXPECT_DOUBLE_EQ(h1.GetEntries(), h2.GetEntries());
+   Double_t stats1[TH1::kNstat] = {0}, stats2[TH1::kNstat] = {0};
+   h1.GetStats(stats1);
+   h2.GetStats(stats2);
+   for (Int_t i = 0; i < TH1::kNstat; ++i)
+      EXPECT_NEAR(stats1[i], stats2[i], 1e-9 * (1 + std::abs(stats1[i]))) << "stat " << i;
+}
+
+static std::vector<Double_t> FillValues(Int_t n, Double_t min, Double_t max, UInt_t seed)
+{
+   TRandom3 rnd(seed);
+   std::vector<Double_t> values(n);
+   for (auto &v : values)
+      v = rnd.Uniform(min, max);
+   values[n / 2] = std::numeric_limits<Double_t>::quiet_NaN();
+   return values;
+}
+
+// FillN gives the same result as Fill
+TEST(TH1, FillN)
+{
+   const Int_t n = 1000;
+   auto x = FillValues(n, -1, 11, 1);
+   auto w = FillValues(n, 0.5, 2, 2);
+   w[n / 2] = 1;
+   const Double_t edges[] = {0, 1, 1.5, 2, 4, 7, 10};
+
+   TH1D fix1("fix1", "", 20, 0, 10), fix2("fix2", "", 20, 0, 10);
+   TH1D var1("var1", "", 6, edges), var2("var2", "", 6, edges);
+   for (Int_t i = 0; i < n; ++i) {
+      fix1.Fill(x[i], w[i]);
+      var1.Fill(x[i]);
+   }
+   fix2.FillN(n, x.data(), w.data());
+   var2.FillN(n, x.data(), nullptr);
+   ExpectSameFill(fix1, fix2);
+   ExpectSameFill(var1, var2);
+
+   // Extendable axis: extended by the entries of a batch
+   TH1D ext1("ext1", "", 10, 0, 1), ext2("ext2", "", 10, 0, 1);
+   ext1.SetCanExtend(TH1::kAllAxes);
+   ext2.SetCanExtend(TH1::kAllAxes);
+   for (Int_t i = 0; i < n; ++i)
+      ext1.Fill(x[i]);
+   ext2.FillN(n, x.data(), nullptr);
+   ExpectSameFill(ext1, ext2);
+}
+
+TEST(TH1, FillN2D3D)
+{
+   const Int_t n = 1000;
+   auto x = FillValues(n, -1, 11, 3);
+   auto y = FillValues(n, -1, 11, 4);
+   auto z = FillValues(n, -1, 11, 5);
+   auto w = FillValues(n, 0.5, 2, 6);
+
+   TH2D h2a("h2a", "", 10, 0, 10, 5, 0, 10), h2b("h2b", "", 10, 0, 10, 5, 0, 10);
+   TH3D h3a("h3a", "", 10, 0, 10, 5, 0, 10, 4, 0, 10), h3b("h3b", "", 10, 0, 10, 5, 0, 10, 4, 0, 10);
+   TProfile pa("pa", "", 10, 0, 10, 2, 8), pb("pb", "", 10, 0, 10, 2, 8);
+   TProfile2D p2a("p2a", "", 10, 0, 10, 5, 0, 10), p2b("p2b", "", 10, 0, 10, 5, 0, 10);
+   for (Int_t i = 0; i < n; ++i) {
+      h2a.Fill(x[i], y[i], w[i]);
+      h3a.Fill(x[i], y[i], z[i], w[i]);
+      pa.Fill(x[i], y[i], w[i]);
+      p2a.Fill(x[i], y[i], z[i]);
+   }
+   h2b.FillN(n, x.data(), y.data(), w.data());
+   h3b.FillN(n, x.data(), y.data(), z.data(), w.data());
+   pb.FillN(n, x.data(), y.data(), w.data());
+   p2b.FillN(n, x.data(), y.data(), z.data(), nullptr);
+   ExpectSameFill(h2a, h2b);
+   ExpectSameFill(h3a, h3b);
+   ExpectSameFill(pa, pb);
+   ExpectSameFill(p2a, p2b);
+}
+
+// Threads filling a histogram concurrently give the result of a serial filling
+TEST(TH1, ConcurrentFill)
+{
+   const Int_t n = 4000;
+   const Int_t nthreads = 4;
+   auto x = FillValues(n, -1, 11, 7);
+   auto y = FillValues(n, -1, 11, 8);
+   auto z = FillValues(n, -1, 11, 9);
+   x[n / 2] = y[n / 2] = z[n / 2] = 5;
+   // weights summed exactly in any order
+   TRandom3 rnd(10);
+   std::vector<Double_t> w(n);
+   for (auto &ww : w)
+      ww = 0.5 * (1 + rnd.Integer(4));
+
+   TH1D h1a("h1a", "", 20, 0, 10), h1b("h1b", "", 20, 0, 10);
+   TH3F h3a("h3a", "", 10, 0, 10, 5, 0, 10, 4, 0, 10), h3b("h3b", "", 10, 0, 10, 5, 0, 10, 4, 0, 10);
+   h1b.SetConcurrentFill();
+   h3b.SetConcurrentFill();
+   EXPECT_TRUE(h1b.IsConcurrentFill());
+   EXPECT_TRUE(h3b.IsConcurrentFill());
+   for (Int_t i = 0; i < n; ++i) {
+      h1a.Fill(x[i], w[i]);
+      h3a.Fill(x[i], y[i], z[i], w[i]);
+   }
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < nthreads; ++t) {
+      threads.emplace_back([&, t]() {
+         // half of the entries of a thread one by one, the other half with FillN
+         const Int_t first = t * n / nthreads, last = (t + 1) * n / nthreads;
+         const Int_t middle = (first + last) / 2;
+         Double_t stats[TH1::kNstat];
+         for (Int_t i = first; i < middle; ++i) {
+            h1b.Fill(x[i], w[i]);
+            h3b.Fill(x[i], y[i], z[i], w[i]);
+            // the statistics are read while the other threads fill and fold them
+            if (i % 100 == 0) {
+               EXPECT_LE(h1b.GetEntries(), n);
+               h3b.GetStats(stats);
+            }
+         }
+         h1b.FillN(last - middle, &x[middle], &w[middle]);
+         h3b.FillN(last - middle, &x[middle], &y[middle], &z[middle], &w[middle]);
+      });
+   }
+   for (auto &thr : threads)
+      thr.join();
+   ExpectSameFill(h1a, h1b);
+   ExpectSameFill(h3a, h3b);
+
+   // A copy is filled concurrently too
+   TH1D copy(h1b);
+   EXPECT_TRUE(copy.IsConcurrentFill());
+   copy.Fill(1.);
+   EXPECT_DOUBLE_EQ(copy.GetEntries(), n + 1);
+
+   h1b.SetConcurrentFill(kFALSE);
+   EXPECT_FALSE(h1b.IsConcurrentFill());
+   ExpectSameFill(h1a, h1b);
+}
+
+// Merging large histograms with implicit multi-threading gives the result of a serial merge
+TEST(TH1, MergeLarge)
+{
+   const Int_t n = 20000;
+   const Int_t ninputs = 8;
+   std::vector<TH2D *> inputs;
+   TList list;
+   for (Int_t i = 0; i < ninputs; ++i) {
+      auto x = FillValues(n, -1, 11, 20 + i);
+      auto y = FillValues(n, -1, 11, 40 + i);
+      inputs.push_back(new TH2D(TString::Format("in%d", i), "", 400, 0, 10, 400, 0, 10));
+      inputs.back()->SetDirectory(nullptr);
+      inputs.back()->Sumw2();
+      inputs.back()->FillN(n, x.data(), y.data(), nullptr);
+      list.Add(inputs.back());
+   }
+
+   TH2D serial("serial", "", 400, 0, 10, 400, 0, 10);
+   serial.Sumw2();
+   EXPECT_GT(serial.Merge(&list), 0);
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT(4);
+#endif
+   TH2D parallel("parallel", "", 400, 0, 10, 400, 0, 10);
+   parallel.Sumw2();
+   EXPECT_GT(parallel.Merge(&list), 0);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   ExpectSameFill(serial, parallel);
+
+   for (auto h : inputs)
+      delete h;
+}
@@ -0,0 +1,93 @@
+#include "TGraph.h"
+#include "TH2Poly.h"
+#include "TList.h"
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+// The bin containing (x,y) found by testing all the bins, as FindBin.
+static Int_t FindBinBruteForce(TH2Poly &h, Double_t x, Double_t y)
+{
+   Int_t overflow = 0;
+   if (y > h.GetYaxis()->GetXmax())      overflow += -1;
+   else if (y > h.GetYaxis()->GetXmin()) overflow += -4;
+   else                                  overflow += -7;
+   if (x > h.GetXaxis()->GetXmax())      overflow += -2;
+   else if (x > h.GetXaxis()->GetXmin()) overflow += -1;
+   if (overflow != -5) return overflow;
+   TIter next(h.GetBins());
+   while (TH2PolyBin *bin = (TH2PolyBin *)next()) {
+      if (bin->IsInside(x, y)) return bin->GetBinNumber();
+   }
+   return -5;
+}
+
+TEST(TH2Poly, FindBin)
+{
+   TH2Poly h("h", "honeycomb", 0, 10, 0, 10);
+   h.Honeycomb(0, 0, .1, 50, 50);
+   // triangles overlapping the honeycomb, found after the hexagons
+   for (Int_t i = 0; i < 20; ++i) {
+      Double_t x[] = {0.5 * i, 0.5 * i + 2, 0.5 * i};
+      Double_t y[] = {1., 1., 4.};
+      h.AddBin(3, x, y);
+   }
+
+   TRandom3 r(42);
+   for (Int_t i = 0; i < 20000; ++i) {
+      Double_t x = r.Uniform(-1, 11), y = r.Uniform(-1, 11);
+      ASSERT_EQ(h.FindBin(x, y), FindBinBruteForce(h, x, y)) << x << " " << y;
+   }
+
+   // the index follows the new bins and partitions
+   Double_t x[] = {-0.5, 10.5, 10.5, -0.5};
+   Double_t y[] = {-0.5, -0.5, 10.5, 10.5};
+   Int_t last = h.AddBin(4, x, y);
+   EXPECT_EQ(h.FindBin(10.2, 10.2), last);
+   h.ChangePartition(3, 7);
+   for (Int_t i = 0; i < 20000; ++i) {
+      Double_t px = r.Uniform(-1, 11), py = r.Uniform(-1, 11);
+      ASSERT_EQ(h.FindBin(px, py), FindBinBruteForce(h, px, py)) << px << " " << py;
+   }
+}
+
+TEST(TH2Poly, FillN)
+{
+   TH2Poly h1("h1", "", 0, 10, 0, 10);
+   h1.Honeycomb(0, 0, .2, 25, 25);
+   h1.Sumw2();
+   TH2Poly *h2 = (TH2Poly *)h1.Clone("h2");
+   TH2Poly *h3 = (TH2Poly *)h1.Clone("h3");
+   TH2Poly *h4 = (TH2Poly *)h1.Clone("h4");
+
+   const Int_t n = 100000;
+   TRandom3 r(1);
+   std::vector<Double_t> x(2 * n), y(2 * n), w(2 * n);
+   for (Int_t i = 0; i < 2 * n; ++i) {
+      x[i] = r.Gaus(5, 3);
+      y[i] = r.Gaus(5, 3);
+      w[i] = r.Uniform(0, 2);
+   }
+   for (Int_t i = 0; i < n; ++i) {
+      h1.Fill(x[2 * i], y[2 * i], w[2 * i]);
+      h3->Fill(x[i], y[i]);
+   }
+   h2->FillN(n, x.data(), y.data(), w.data(), 2);
+   h4->FillN(n, x.data(), y.data(), nullptr);
+
+   EXPECT_EQ(h1.GetEntries(), h2->GetEntries());
+   EXPECT_NEAR(h1.GetMean(1), h2->GetMean(1), 1e-10);
+   EXPECT_NEAR(h1.GetStdDev(2), h2->GetStdDev(2), 1e-10);
+   for (Int_t bin = -9; bin <= h1.GetNumberOfBins(); ++bin) {
+      if (bin == 0) continue;
+      ASSERT_NEAR(h1.GetBinContent(bin), h2->GetBinContent(bin), 1e-8) << bin;
+      ASSERT_NEAR(h1.GetBinError(bin), h2->GetBinError(bin), 1e-8) << bin;
+      ASSERT_EQ(h3->GetBinContent(bin), h4->GetBinContent(bin)) << bin;
+   }
+   EXPECT_EQ(h3->GetEntries(), h4->GetEntries());
+   delete h2;
+   delete h3;
+   delete h4;
+}
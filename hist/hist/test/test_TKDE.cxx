@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+
+#include "TKDE.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static std::vector<Double_t> GenerateData(Int_t n, UInt_t seed)
+{
+   TRandom3 rnd(seed);
+   std::vector<Double_t> data(n);
+   for (auto &x : data)
+      x = rnd.Gaus(0, 1);
+   return data;
+}
+
+static Double_t Epanechnikov(Double_t u)
+{
+   return (u > -1. && u < 1.) ? 3. / 4. * (1. - u * u) : 0.0;
+}
+
+// The sums over the events near a point give the sum over all the events
+TEST(TKDE, Evaluation)
+{
+   const Int_t n = 2000;
+   auto data = GenerateData(n, 1);
+
+   TKDE fixed(n, data.data(), -5, 5, "KernelType:Gaussian;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned");
+   TKDE adaptive(n, data.data(), -5, 5, "KernelType:Epanechnikov;Iteration:Adaptive;Mirror:noMirror;Binning:Unbinned");
+   const Double_t h = fixed.GetFixedWeight();
+   const Double_t *weights = adaptive.GetAdaptiveWeights();
+   ASSERT_NE(weights, nullptr);
+
+   std::vector<Double_t> x;
+   for (Double_t xx = -4.5; xx <= 4.5; xx += 0.05)
+      x.push_back(xx);
+   std::vector<Double_t> values(x.size());
+   fixed.GetValues(x.size(), x.data(), values.data());
+   for (UInt_t i = 0; i < x.size(); ++i) {
+      Double_t fixedSum = 0, adaptiveSum = 0;
+      for (Int_t k = 0; k < n; ++k) {
+         fixedSum += TMath::Gaus(x[i], data[k], h, kTRUE);
+         adaptiveSum += Epanechnikov((x[i] - data[k]) / weights[k]) / weights[k];
+      }
+      EXPECT_NEAR(fixed(x[i]), fixedSum / n, 1e-12) << "x = " << x[i];
+      EXPECT_DOUBLE_EQ(values[i], fixed(x[i]));
+      EXPECT_NEAR(adaptive(x[i]), adaptiveSum / n, 1e-12) << "x = " << x[i];
+   }
+}
+
+// The density interpolated on a grid approximates the exact one
+TEST(TKDE, EvaluationGrid)
+{
+   const Int_t n = 20000;
+   auto data = GenerateData(n, 2);
+
+   for (auto option : {"KernelType:Gaussian;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned",
+                       "KernelType:Gaussian;Iteration:Fixed;Mirror:MirrorAsymBoth;Binning:Unbinned",
+                       "KernelType:Biweight;Iteration:Adaptive;Mirror:noMirror;Binning:RelaxedBinning"}) {
+      TKDE exact(n, data.data(), -3, 3, option);
+      TKDE grid(n, data.data(), -3, 3, option);
+      grid.SetEvaluationGrid(2001);
+      for (Double_t x = -2.5; x <= 2.5; x += 0.0123)
+         EXPECT_NEAR(grid(x), exact(x), 2e-3 * exact(1.)) << option << ", x = " << x;
+   }
+}
+
+// A user defined kernel, which may not be thread safe, is not evaluated by several threads
+TEST(TKDE, UserDefinedKernelSerial)
+{
+   const Int_t n = 500;
+   auto data = GenerateData(n, 3);
+   const auto thisThread = std::this_thread::get_id();
+   std::atomic<Int_t> otherThreadCalls(0);
+   auto kernel = [&](Double_t u) {
+      if (std::this_thread::get_id() != thisThread)
+         ++otherThreadCalls;
+      return Epanechnikov(u);
+   };
+   TKDE kde("user", kernel, n, data.data(), -5, 5, "KernelType:UserDefined;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned");
+
+   std::vector<Double_t> x(1000), values(x.size());
+   for (UInt_t i = 0; i < x.size(); ++i)
+      x[i] = -4. + 8. * i / x.size();
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT(4);
+#endif
+   kde.GetValues(x.size(), x.data(), values.data());
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   EXPECT_EQ(otherThreadCalls, 0);
+   for (UInt_t i = 0; i < x.size(); i += 97)
+      EXPECT_DOUBLE_EQ(values[i], kde(x[i]));
+}
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include "TList.h"
+#include "TQuantileSketch.h"
+#include "TRandom3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Fraction of the sorted values lower or equal to x
+static Double_t Rank(const std::vector<Double_t> &sorted, Double_t x)
+{
+   return Double_t(std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) / sorted.size();
+}
+
+// The quantiles of a sketch are exact as long as it did not compact any value
+TEST(TQuantileSketch, Exact)
+{
+   TQuantileSketch sketch;
+   EXPECT_EQ(sketch.GetQuantiles(1, nullptr), 0);
+   for (Int_t i = 100; i >= 1; --i)
+      sketch.Fill(i);
+   sketch.Fill(std::nan(""));
+   EXPECT_EQ(sketch.GetEntries(), 100);
+   EXPECT_EQ(sketch.GetMinimum(), 1);
+   EXPECT_EQ(sketch.GetMaximum(), 100);
+   EXPECT_EQ(sketch.GetMedian(), 50);
+   EXPECT_EQ(sketch.GetQuantile(0.255), 26);
+   EXPECT_EQ(sketch.GetRank(10.5), 0.1);
+
+   Double_t q[5];
+   EXPECT_EQ(sketch.GetQuantiles(5, q), 5);
+   EXPECT_EQ(q[0], 1);
+   EXPECT_EQ(q[2], 50);
+   EXPECT_EQ(q[4], 100);
+
+   sketch.Clear();
+   EXPECT_EQ(sketch.GetEntries(), 0);
+   EXPECT_EQ(sketch.GetSize(), 0);
+}
+
+// Sketches filled by parts and merged estimate the quantiles of all the values
+// in a bounded size
+TEST(TQuantileSketch, Merge)
+{
+   const Int_t n = 1000000;
+   TRandom3 rnd(1);
+   std::vector<Double_t> values(n);
+   TQuantileSketch parts[4];
+   for (Int_t i = 0; i < n; ++i) {
+      values[i] = rnd.Exp(1);
+      parts[i % 4].Fill(values[i]);
+   }
+   TQuantileSketch sketch;
+   TList list;
+   for (auto &part : parts)
+      list.Add(&part);
+   EXPECT_EQ(sketch.Merge(&list), n);
+   EXPECT_LT(sketch.GetSize(), 4 * sketch.GetK());
+
+   std::sort(values.begin(), values.end());
+   EXPECT_EQ(sketch.GetMinimum(), values.front());
+   EXPECT_EQ(sketch.GetMaximum(), values.back());
+   for (Double_t prob = 0.01; prob < 1; prob += 0.01) {
+      const Double_t q = sketch.GetQuantile(prob);
+      EXPECT_NEAR(Rank(values, q), prob, 0.015) << "prob = " << prob;
+      EXPECT_NEAR(sketch.GetRank(q), Rank(values, q), 0.015) << "prob = " << prob;
+   }
+
+   Double_t xmin, xmax;
+   sketch.GetRange(xmin, xmax, 0.05);
+   EXPECT_NEAR(Rank(values, xmin), 0.05, 0.015);
+   EXPECT_NEAR(Rank(values, xmax), 0.95, 0.015);
+}
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -296,3 +297,29 @@ TEST(TProfile2Poly, BinErrorSpreadCompare) {
 TEST(TProfile2Poly, BinErrorMeanCompare) {
    test_binErrorMeanStats();
 }
+
+// FillN profiles the values as Fill(x, y, value) does, entry by entry
+TEST(TProfile2Poly, FillN) {
+   TProfile2Poly filled("filled", "filled", 10, -5, 5, 10, -5, 5);
+   TProfile2Poly filledN("filledN", "filledN", 10, -5, 5, 10, -5, 5);
+
+   TRandom3 ran(7);
+   const Int_t n = 10000;
+   std::vector<Double_t> x(n), y(n), value(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = ran.Gaus(0, 3);
+      y[i] = ran.Gaus(0, 3);
+      value[i] = ran.Gaus(20, 5);
+      filled.Fill(x[i], y[i], value[i]);
+   }
+   filledN.FillN(n, x.data(), y.data(), value.data());
+
+   EXPECT_EQ(filledN.GetEntries(), filled.GetEntries());
+   for (Int_t c = 1; c <= 3; ++c)
+      EXPECT_NEAR(filledN.GetMean(c), filled.GetMean(c), delta);
+   for (Int_t bin = 1; bin <= filled.GetNumberOfBins(); ++bin) {
+      EXPECT_NEAR(filledN.GetBinContent(bin), filled.GetBinContent(bin), delta) << "bin " << bin;
+      EXPECT_NEAR(filledN.GetBinError(bin), filled.GetBinError(bin), delta) << "bin " << bin;
+      EXPECT_NEAR(filledN.GetBinEffectiveEntries(bin), filled.GetBinEffectiveEntries(bin), delta) << "bin " << bin;
+   }
+}
@@ -54,5 +54,7 @@
 #pragma link C++ class TStreamerInfoActions::TConfiguration-;
 #pragma link C++ class ROOT::Experimental::TBufferMerger;
 #pragma link C++ class ROOT::Experimental::TBufferMergerFile;
+#pragma link C++ class ROOT::Experimental::TStreamingFile;
+#pragma link C++ class ROOT::Experimental::TStreamerInfoSnapshot;
 
 #endif
@@ -15,6 +15,7 @@
 #include "TFileMerger.h"
 #include "TMemFile.h"
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -36,10 +37,29 @@ class TBufferMergerFile;
  * socket, TBufferMerger uses threads that each write to a
  * TBufferMergerFile, which in turn push data into a queue
  * managed by the TBufferMerger.
+ *
+ * The memory held by buffers waiting to be merged can be bounded with
+ * SetMaxBufferedBytes(): once the limit is reached, TBufferMergerFile::Write()
+ * blocks until the merge in progress has released its buffers, or performs
+ * the merge itself if nobody else is merging. GetStatistics() reports the
+ * queue depth, the merge times and the number of bytes merged.
  */
 
 class TBufferMerger {
 public:
+   /** Counters describing the activity of a TBufferMerger. */
+   struct TStatistics {
+      size_t fNBuffers{0};         ///< Number of buffers pushed to the queue
+      size_t fBytesPushed{0};      ///< Number of bytes pushed to the queue
+      size_t fBytesMerged{0};      ///< Number of bytes merged into the output file
+      size_t fNMerges{0};          ///< Number of partial merges performed
+      size_t fMaxQueueSize{0};     ///< Largest number of buffers waiting in the queue
+      size_t fMaxBufferedBytes{0}; ///< Largest number of bytes held by queued or merging buffers
+      double fMergeTime{0.};       ///< Total time spent merging, in seconds
+      double fMaxMergeTime{0.};    ///< Longest partial merge, in seconds
+      double fWaitTime{0.};        ///< Total time producers were blocked by the byte limit, in seconds
+   };
+
    /** Constructor
     * @param name Output file name
     * @param option Output file creation options
@@ -70,6 +90,23 @@ public:
    /** Returns the number of buffers currently in the queue. */
    size_t GetQueueSize() const;
 
+   /** Returns the number of bytes held by buffers that are queued or being merged. */
+   size_t GetBufferedBytes() const;
+
+   /** Returns the limit on the number of buffered bytes (0, the default, means no limit). */
+   size_t GetMaxBufferedBytes() const;
+
+   /** Limit the memory held by buffers waiting to be merged to @param size bytes.
+    *  When pushing a new buffer would exceed this limit, the producer blocks
+    *  until enough memory has been released by merging (a single buffer larger
+    *  than the limit is accepted when nothing else is buffered). A value of 0
+    *  disables the limit.
+    */
+   void SetMaxBufferedBytes(size_t size);
+
+   /** Returns a snapshot of the merging statistics. */
+   TStatistics GetStatistics() const;
+
    /** Returns the current value of the auto save setting in bytes (default = 0). */
    size_t GetAutoSave() const;
 
@@ -98,14 +135,19 @@ private:
    void Init(std::unique_ptr<TFile>);
 
    void Merge();
-   void Push(TBufferFile *buffer);
+   void Push(TMemFile::ExternalDataPtr_t data);
 
    size_t fAutoSave{0};                                          //< AutoSave only every fAutoSave bytes
    size_t fBuffered{0};                                          //< Number of bytes currently buffered
+   size_t fMaxBuffered{0};                                       //< Limit on fBuffered + fMergingBytes (0 = none)
+   size_t fMergingBytes{0};                                      //< Number of bytes being merged
+   bool fMergeActive{false};                                     //< Whether a merge is in progress
+   TStatistics fStats;                                           //< Merging statistics
    TFileMerger fMerger{false, false};                            //< TFileMerger used to merge all buffers
    std::mutex fMergeMutex;                                       //< Mutex used to lock fMerger
-   std::mutex fQueueMutex;                                       //< Mutex used to lock fQueue
-   std::queue<TBufferFile *> fQueue;                             //< Queue to which data is pushed and merged
+   mutable std::mutex fQueueMutex;                               //< Mutex used to lock fQueue
+   std::condition_variable fQueueCV;                             //< Signals the end of a merge to blocked producers
+   std::queue<TMemFile::ExternalDataPtr_t> fQueue;               //< Queue to which data is pushed and merged
    std::vector<std::weak_ptr<TBufferMergerFile>> fAttachedFiles; //< Attached files
 };
 
@@ -143,7 +185,7 @@ public:
 
    using TMemFile::Write;
 
-   /** Write data into a TBufferFile and append it to TBufferMerger.
+   /** Write data into a memory buffer and append it to TBufferMerger.
     * @param name Name
     * @param opt  Options
     * @param bufsize Buffer size
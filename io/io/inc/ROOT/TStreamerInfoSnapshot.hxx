@@ -0,0 +1,61 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TStreamerInfoSnapshot
+#define ROOT_TStreamerInfoSnapshot
+
+#include "RtypesCore.h"
+
+#include <string>
+#include <vector>
+
+class TStreamerInfo;
+
+namespace ROOT {
+namespace Experimental {
+
+/**
+ * \class TStreamerInfoSnapshot TStreamerInfoSnapshot.hxx
+ * \ingroup IO
+ *
+ * Binary snapshot of the built TStreamerInfos of a set of classes, to speed up
+ * the start of short jobs.
+ *
+ * Building the TStreamerInfo of the current version of a class queries the
+ * interpreter for its bases, data members, offsets and checksum. Write() saves
+ * the result of that work, for the given classes and all the classes they
+ * stream (bases, members, collection contents), in a compact file. Load() maps
+ * the file and installs the TStreamerInfos as the current ones of their
+ * classes, compiling their streaming actions directly: neither TClass::GetStreamerInfo()
+ * nor TFile::ReadStreamerInfo() has to build them anymore.
+ *
+ * The snapshot is only valid for the libraries it was written with: a class is
+ * skipped at load time if its version, size or checksum changed, or if it
+ * already has a TStreamerInfo for its current version. Classes whose
+ * TStreamerInfo depends on schema evolution rules or on custom member streamers
+ * are not snapshotted.
+ *
+ * The snapshot named by the rootrc variable `TFile.StreamerInfoSnapshot` is
+ * loaded before the first file is opened.
+ */
+
+class TStreamerInfoSnapshot {
+private:
+   static Bool_t Install(TStreamerInfo *info, Int_t size, UInt_t checksum, const std::vector<Int_t> &elements);
+
+public:
+   static Int_t Write(const char *filename, const std::vector<std::string> &classes);
+   static Int_t Load(const char *filename);
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
@@ -0,0 +1,108 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TStreamingFile
+#define ROOT_TStreamingFile
+
+#include "TFile.h"
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+namespace ROOT {
+namespace Experimental {
+
+/**
+ * \class TStreamingFile TStreamingFile.hxx
+ * \ingroup IO
+ *
+ * A TFile for files holding a very large number of objects in their top
+ * directory, e.g. hundreds of thousands of histograms.
+ *
+ * When created (options "NEW", "CREATE" or "RECREATE"), the file is append-only:
+ * each object written is streamed to disk together with its key, and only the
+ * serialized key header (a few tens of bytes) is kept, instead of a TKey in the
+ * list of keys. Beyond SetMaxIndexMemory() bytes the headers are spilled to a
+ * temporary file. The index block (the standard list of keys) is written once,
+ * at Close(), instead of at each Write() or SaveSelf(). Since no key is kept in
+ * memory, objects can not be overwritten or deleted: writing an object twice
+ * adds a new cycle, and subdirectories are not supported. The cycles are only
+ * numbered at Close(), from the complete list of keys; until then all the keys
+ * stored with the objects have cycle 1.
+ *
+ * When opened for reading (option "READ"), the list of keys is read into a
+ * compact sorted index, and a TKey is only created when the corresponding
+ * object is requested with Get() or GetKey(). GetListOfKeys() creates all of
+ * them.
+ *
+ * The files are normal ROOT files: they can be read with TFile, and files
+ * written with TFile can be read with TStreamingFile.
+ */
+
+class TStreamingFile : public TFile {
+private:
+   /// Location of one key of the index, sorted by name and decreasing cycle.
+   struct TIndexEntry {
+      UInt_t fHeader;   ///< Offset of the key header in fIndex
+      UInt_t fName;     ///< Offset of the key name in fIndex
+      UInt_t fNameLen;  ///< Length of the key name
+      Short_t fCycle;   ///< Cycle number of the key
+   };
+
+   std::vector<char> fIndex;                        ///<! Serialized key headers
+   std::vector<TIndexEntry> fEntries;               ///<! Reading: sorted index of fIndex
+   std::unordered_map<UInt_t, TKey *> fKeyCache;    ///<! Reading: keys created from the index, by entry
+   std::FILE *fSpill{nullptr};                      ///<! Writing: key headers beyond fMaxIndexMemory
+   Long64_t fSpilledBytes{0};                       ///<! Writing: number of bytes in fSpill
+   Long64_t fNIndexedKeys{0};                       ///<! Number of keys in fIndex and fSpill
+   size_t fMaxIndexMemory{64 * 1024 * 1024};        ///<! Writing: memory limit for the key headers
+   Bool_t fWriteIndex{kFALSE};                      ///<! Writing: set while closing, when the index block is written
+   Bool_t fAllKeysRead{kFALSE};                     ///<! Reading: whether all the keys have been created
+
+   TStreamingFile(const TStreamingFile &) = delete;
+   TStreamingFile &operator=(const TStreamingFile &) = delete;
+
+   void RetireKeys();
+   void SpillIndex();
+   TKey *MakeKey(UInt_t entry);
+
+public:
+   TStreamingFile(const char *name, Option_t *option = "READ", const char *title = "",
+                  Int_t compress = ROOT::kUseGeneralPurposeCompressionSetting);
+   virtual ~TStreamingFile();
+
+   virtual Int_t AppendKey(TKey *key) override;
+   virtual void Close(Option_t *option = "") override;
+   virtual TKey *GetKey(const char *name, Short_t cycle = 9999) const override;
+   virtual TList *GetListOfKeys() const override;
+   virtual Int_t GetNkeys() const override;
+   virtual TDirectory *mkdir(const char *name, const char *title = "") override;
+   virtual Int_t ReadKeys(Bool_t forceRead = kTRUE) override;
+   virtual Int_t WriteTObject(const TObject *obj, const char *name = nullptr, Option_t *option = "",
+                              Int_t bufsize = 0) override;
+   virtual Int_t WriteObjectAny(const void *obj, const TClass *cl, const char *name, Option_t *option = "",
+                                Int_t bufsize = 0) override;
+   using TFile::WriteObjectAny;
+   virtual void WriteKeys() override;
+
+   /// Returns the number of bytes of key headers held in memory.
+   size_t GetIndexMemory() const { return fIndex.capacity() + fEntries.capacity() * sizeof(TIndexEntry); }
+   size_t GetMaxIndexMemory() const { return fMaxIndexMemory; }
+   /// Set the memory above which the key headers of a file being written are spilled to a temporary file.
+   void SetMaxIndexMemory(size_t bytes) { fMaxIndexMemory = bytes; }
+
+   ClassDefOverride(TStreamingFile, 0);
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
@@ -16,6 +16,8 @@
 #include "TString.h"
 
 #include <deque>
+#include <iosfwd>
+#include <vector>
 
 class TVirtualStreamerInfo;
 class TStreamerInfo;
@@ -40,6 +42,15 @@ public:
    static Int_t ExportToFile(const char *filename, const TObject *obj, const char *option = nullptr);
    static Int_t ExportToFile(const char *filename, const void *obj, const TClass *cl, const char *option = nullptr);
 
+   static Long64_t ExportToStream(std::ostream &out, const TObject *obj, Int_t compact = 0);
+   static Long64_t ExportToStream(std::ostream &out, const void *obj, const TClass *cl, Int_t compact = 0);
+
+   static std::vector<UChar_t> ConvertToCBOR(const TObject *obj, Int_t compact = 0);
+   static std::vector<UChar_t> ConvertToCBOR(const void *obj, const TClass *cl, Int_t compact = 0);
+
+   static TObject *ConvertFromCBOR(const std::vector<UChar_t> &data);
+   static void *ConvertFromCBORAny(const std::vector<UChar_t> &data, TClass **cl = nullptr);
+
    static TObject *ConvertFromJSON(const char *str);
    static void *ConvertFromJSONAny(const char *str, TClass **cl = nullptr);
 
@@ -215,6 +226,10 @@ protected:
 
    static void *ConvertFromJSONChecked(const char *str, const TClass *expectedClass);
 
+   static void *JsonReadDocument(void *node, TClass **cl);
+
+   Long64_t FlushOutput(Bool_t final = kFALSE);
+
    TString JsonWriteMember(const void *ptr, TDataMember *member, TClass *memberClass, Int_t arraylen);
 
    TJSONStackObj *PushStack(Int_t inclevel = 0, void *readnode = nullptr);
@@ -286,6 +301,9 @@ protected:
    TString fSemicolon; ///<!  depending from compression level, " : " or ":"
    TString fArraySepar;    ///<!  depending from compression level, ", " or ","
    TString fNumericLocale; ///<!  stored value of setlocale(LC_NUMERIC), which should be recovered at the end
+   Bool_t fRoundTrip;      ///<!  floating-point values are written in the shortest form restoring them exactly
+   std::ostream *fOutStream; ///<!  stream receiving the main output buffer as it fills, if any
+   Long64_t fOutStreamed;    ///<!  number of characters already written to fOutStream
 
    ClassDef(TBufferJSON, 1) // a specialized TBuffer to only write objects into JSON format
 };
@@ -132,6 +132,10 @@ public:
    static void CompactFloatString(char *buf, unsigned len);
    static const char *ConvertFloat(Float_t v, char *buf, unsigned len, Bool_t not_optimize = kFALSE);
    static const char *ConvertDouble(Double_t v, char *buf, unsigned len, Bool_t not_optimize = kFALSE);
+   static const char *ConvertFloatRoundTrip(Float_t v, char *buf, unsigned len);
+   static const char *ConvertDoubleRoundTrip(Double_t v, char *buf, unsigned len);
+   static const char *ConvertInteger(Long64_t v, char *buf, unsigned len);
+   static const char *ConvertUnsigned(ULong64_t v, char *buf, unsigned len);
 
 protected:
    static const char *fgFloatFmt;  ///<!  printf argument for floats, either "%f" or "%e" or "%10f" and so on
@@ -24,6 +24,8 @@
 #include "Compression.h"
 #include "TDirectory.h"
 
+#include <vector>
+
 class TList;
 class TBrowser;
 class TKey;
@@ -104,6 +106,7 @@ public:
    virtual void        Purge(Short_t nkeep=1);
    virtual void        ReadAll(Option_t *option="");
    virtual Int_t       ReadKeys(Bool_t forceRead=kTRUE);
+   std::vector<TObject *> ReadObjects(const std::vector<TKey *> &keys, Bool_t replace = kFALSE);
    virtual Int_t       ReadTObject(TObject *obj, const char *keyname);
    virtual void        ResetAfterMerge(TFileMergeInfo *);
    virtual void        rmdir(const char *name);
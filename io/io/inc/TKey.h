@@ -92,6 +92,7 @@ protected:
    virtual Int_t       Read(TObject *obj);
    virtual TObject    *ReadObj();
    virtual TObject    *ReadObjWithBuffer(char *bufferRead);
+   virtual TObject    *ReadObjWithUnzippedBuffer(char *unzipped);
    /// To read an object (non deriving from TObject) from the file.
    /// This is more user friendly version of TKey::ReadObjectAny.
    /// See TKey::ReadObjectAny for more details.
@@ -106,6 +107,7 @@ protected:
    virtual void        SetParent(const TObject *parent);
            void        SetMotherDir(TDirectory* dir) { fMotherDir = dir; }
    virtual Int_t       Sizeof() const;
+           Bool_t      UnzipRecord(const char *record, char *target) const;
    virtual Int_t       WriteFile(Int_t cycle=1, TFile* f = 0);
 
    ClassDef(TKey,4); //Header description of a logical record on file.
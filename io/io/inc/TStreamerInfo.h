@@ -39,6 +39,7 @@ namespace ROOT { namespace Detail { class TCollectionProxyInfo; } }
 namespace ROOT { class TSchemaRule; }
 
 namespace TStreamerInfoActions { class TActionSequence; }
+namespace ROOT { namespace Experimental { class TStreamerInfoSnapshot; } }
 
 class TStreamerInfo : public TVirtualStreamerInfo {
 
@@ -64,6 +65,7 @@ class TStreamerInfo : public TVirtualStreamerInfo {
       void Update(const TClass *oldcl, TClass *newcl);
    };
    friend class TStreamerInfoActions::TActionSequence;
+   friend class ROOT::Experimental::TStreamerInfoSnapshot;
 
 public:
    // make the opaque pointer public.
@@ -195,6 +195,7 @@ namespace TStreamerInfoActions {
 
       void AddToOffset(Int_t delta);
       void SetMissing();
+      void FuseBasicTypeActions(Bool_t read);
 
       TActionSequence *CreateCopy();
       static TActionSequence *CreateReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
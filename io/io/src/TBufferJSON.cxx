@@ -40,15 +40,29 @@ JSON data does not include stored class version, therefore schema evolution
 (reading of older class versions) is not supported. JSON should not be used as
 persistent storage for object data - only for live applications.
 
+Large objects can be written to a std::ostream with TBufferJSON::ExportToStream,
+which passes the output on as it is produced instead of building it in memory:
+~~~{.cpp}
+   std::ofstream out("h2.json");
+   TBufferJSON::ExportToStream(out, h2, 23);
+~~~
+
+The same representation can also be produced in the binary CBOR format
+(RFC 7049), more compact and faster to decode than text, with
+TBufferJSON::ConvertToCBOR and read back with TBufferJSON::ConvertFromCBOR.
+The CBOR is encoded as the object is streamed, without building its JSON.
+
 */
 
 #include "TBufferJSON.h"
 
 #include <typeinfo>
 #include <string>
+#include <streambuf>
 #include <string.h>
 #include <locale.h>
 #include <cmath>
+#include <fstream>
 
 #include "Compression.h"
 
@@ -80,6 +94,9 @@ ClassImp(TBufferJSON);
 
 enum { json_TArray = 100, json_TCollection = -130, json_TString = 110, json_stdstring = 120 };
 
+/// Size from which the main output buffer is passed on to the output stream
+const Int_t kOutStreamChunk = 256 * 1024;
+
 ///////////////////////////////////////////////////////////////
 // TArrayIndexProducer is used to correctly create
 /// JSON array separators for multi-dimensional JSON arrays
@@ -367,7 +384,7 @@ public:
 
 TBufferJSON::TBufferJSON(TBuffer::EMode mode)
    : TBufferText(mode), fOutBuffer(), fOutput(nullptr), fValue(), fJsonrCnt(0), fStack(), fCompact(0),
-     fSemicolon(" : "), fArraySepar(", "), fNumericLocale()
+     fSemicolon(" : "), fArraySepar(", "), fNumericLocale(), fRoundTrip(kFALSE), fOutStream(nullptr), fOutStreamed(0)
 {
    fOutBuffer.Capacity(10000);
    fValue.Capacity(1000);
@@ -408,6 +425,10 @@ TBufferJSON::~TBufferJSON()
 ///  - 1 - exclude leading, trailing zeros, required JSROOT v5
 ///  - 2 - check values repetition and empty gaps, required JSROOT v5
 ///
+/// Third digit of compact parameter defines the writing of floating-point values
+///  - 0 - with the format set by TBufferText::SetFloatFormat()
+///  - 1 - in the shortest form which reads back to the same value
+///
 /// Maximal compression achieved when compact parameter equal to 23
 /// When member_name specified, converts only this data member
 
@@ -439,12 +460,17 @@ TString TBufferJSON::ConvertToJSON(const TObject *obj, Int_t compact, const char
 //  - 0 - no compression, standard JSON array
 //  - 1 - exclude leading, trailing zeros, required JSROOT v5
 //  - 2 - check values repetition and empty gaps, required JSROOT v5
+//
+// Third digit of compact parameter defines the writing of floating-point values
+//  - 0 - with the format set by TBufferText::SetFloatFormat()
+//  - 1 - in the shortest form which reads back to the same value
 
 void TBufferJSON::SetCompact(int level)
 {
    fCompact = level;
    fSemicolon = (fCompact % 10 > 2) ? ":" : " : ";
    fArraySepar = (fCompact % 10 > 2) ? "," : ", ";
+   fRoundTrip = (fCompact / 100) % 10 == 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -461,6 +487,10 @@ void TBufferJSON::SetCompact(int level)
 ///  - 1 - exclude leading, trailing zeros, required JSROOT v5
 ///  - 2 - check values repetition and empty gaps, required JSROOT v5
 ///
+/// Third digit of compact parameter defines the writing of floating-point values
+///  - 0 - with the format set by TBufferText::SetFloatFormat()
+///  - 1 - in the shortest form which reads back to the same value
+///
 /// Maximal compression achieved when compact parameter equal to 23
 /// When member_name specified, converts only this data member
 
@@ -563,67 +593,68 @@ Int_t TBufferJSON::ExportToFile(const char *filename, const TObject *obj, const
    if (option && (*option >= '0') && (*option <= '3'))
       compact = TString(option).Atoi();
 
+   if (!strstr(filename, ".json.gz")) {
+      std::ofstream ofs(filename);
+      return ExportToStream(ofs, obj, compact);
+   }
+
    TString json = TBufferJSON::ConvertToJSON(obj, compact);
 
    std::ofstream ofs(filename);
 
-   if (strstr(filename, ".json.gz")) {
-      const char *objbuf = json.Data();
-      Long_t objlen = json.Length();
+   const char *objbuf = json.Data();
+   Long_t objlen = json.Length();
 
-      unsigned long objcrc = R__crc32(0, NULL, 0);
-      objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
+   unsigned long objcrc = R__crc32(0, NULL, 0);
+   objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
 
-      // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
-      Int_t buflen = 10 + objlen + 8;
-      if (buflen < 512)
-         buflen = 512;
+   // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
+   Int_t buflen = 10 + objlen + 8;
+   if (buflen < 512)
+      buflen = 512;
 
-      char *buffer = (char *)malloc(buflen);
-      if (!buffer)
-         return 0; // failure
+   char *buffer = (char *)malloc(buflen);
+   if (!buffer)
+      return 0; // failure
 
-      char *bufcur = buffer;
+   char *bufcur = buffer;
 
-      *bufcur++ = 0x1f; // first byte of ZIP identifier
-      *bufcur++ = 0x8b; // second byte of ZIP identifier
-      *bufcur++ = 0x08; // compression method
-      *bufcur++ = 0x00; // FLAG - empty, no any file names
-      *bufcur++ = 0;    // empty timestamp
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    // XFL (eXtra FLags)
-      *bufcur++ = 3;    // OS   3 means Unix
-      // strcpy(bufcur, "item.json");
-      // bufcur += strlen("item.json")+1;
+   *bufcur++ = 0x1f; // first byte of ZIP identifier
+   *bufcur++ = 0x8b; // second byte of ZIP identifier
+   *bufcur++ = 0x08; // compression method
+   *bufcur++ = 0x00; // FLAG - empty, no any file names
+   *bufcur++ = 0;    // empty timestamp
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    // XFL (eXtra FLags)
+   *bufcur++ = 3;    // OS   3 means Unix
+   // strcpy(bufcur, "item.json");
+   // bufcur += strlen("item.json")+1;
 
-      char dummy[8];
-      memcpy(dummy, bufcur - 6, 6);
+   char dummy[8];
+   memcpy(dummy, bufcur - 6, 6);
 
-      // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
-      unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
+   // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
+   unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
 
-      memcpy(bufcur - 6, dummy, 6);
+   memcpy(bufcur - 6, dummy, 6);
 
-      bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
+   bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
 
-      *bufcur++ = objcrc & 0xff; // CRC32
-      *bufcur++ = (objcrc >> 8) & 0xff;
-      *bufcur++ = (objcrc >> 16) & 0xff;
-      *bufcur++ = (objcrc >> 24) & 0xff;
+   *bufcur++ = objcrc & 0xff; // CRC32
+   *bufcur++ = (objcrc >> 8) & 0xff;
+   *bufcur++ = (objcrc >> 16) & 0xff;
+   *bufcur++ = (objcrc >> 24) & 0xff;
 
-      *bufcur++ = objlen & 0xff;         // original data length
-      *bufcur++ = (objlen >> 8) & 0xff;  // original data length
-      *bufcur++ = (objlen >> 16) & 0xff; // original data length
-      *bufcur++ = (objlen >> 24) & 0xff; // original data length
+   *bufcur++ = objlen & 0xff;         // original data length
+   *bufcur++ = (objlen >> 8) & 0xff;  // original data length
+   *bufcur++ = (objlen >> 16) & 0xff; // original data length
+   *bufcur++ = (objlen >> 24) & 0xff; // original data length
 
-      ofs.write(buffer, bufcur - buffer);
+   ofs.write(buffer, bufcur - buffer);
 
-      free(buffer);
-   } else {
-      ofs << json.Data();
-   }
+   free(buffer);
 
    ofs.close();
 
@@ -643,73 +674,438 @@ Int_t TBufferJSON::ExportToFile(const char *filename, const void *obj, const TCl
    if (option && (*option >= '0') && (*option <= '3'))
       compact = TString(option).Atoi();
 
+   if (!strstr(filename, ".json.gz")) {
+      std::ofstream ofs(filename);
+      return ExportToStream(ofs, obj, cl, compact);
+   }
+
    TString json = TBufferJSON::ConvertToJSON(obj, cl, compact);
 
    std::ofstream ofs(filename);
 
-   if (strstr(filename, ".json.gz")) {
-      const char *objbuf = json.Data();
-      Long_t objlen = json.Length();
+   const char *objbuf = json.Data();
+   Long_t objlen = json.Length();
 
-      unsigned long objcrc = R__crc32(0, NULL, 0);
-      objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
+   unsigned long objcrc = R__crc32(0, NULL, 0);
+   objcrc = R__crc32(objcrc, (const unsigned char *)objbuf, objlen);
 
-      // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
-      Int_t buflen = 10 + objlen + 8;
-      if (buflen < 512)
-         buflen = 512;
+   // 10 bytes (ZIP header), compressed data, 8 bytes (CRC and original length)
+   Int_t buflen = 10 + objlen + 8;
+   if (buflen < 512)
+      buflen = 512;
 
-      char *buffer = (char *)malloc(buflen);
-      if (!buffer)
-         return 0; // failure
+   char *buffer = (char *)malloc(buflen);
+   if (!buffer)
+      return 0; // failure
 
-      char *bufcur = buffer;
+   char *bufcur = buffer;
 
-      *bufcur++ = 0x1f; // first byte of ZIP identifier
-      *bufcur++ = 0x8b; // second byte of ZIP identifier
-      *bufcur++ = 0x08; // compression method
-      *bufcur++ = 0x00; // FLAG - empty, no any file names
-      *bufcur++ = 0;    // empty timestamp
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    //
-      *bufcur++ = 0;    // XFL (eXtra FLags)
-      *bufcur++ = 3;    // OS   3 means Unix
-      // strcpy(bufcur, "item.json");
-      // bufcur += strlen("item.json")+1;
+   *bufcur++ = 0x1f; // first byte of ZIP identifier
+   *bufcur++ = 0x8b; // second byte of ZIP identifier
+   *bufcur++ = 0x08; // compression method
+   *bufcur++ = 0x00; // FLAG - empty, no any file names
+   *bufcur++ = 0;    // empty timestamp
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    //
+   *bufcur++ = 0;    // XFL (eXtra FLags)
+   *bufcur++ = 3;    // OS   3 means Unix
+   // strcpy(bufcur, "item.json");
+   // bufcur += strlen("item.json")+1;
 
-      char dummy[8];
-      memcpy(dummy, bufcur - 6, 6);
+   char dummy[8];
+   memcpy(dummy, bufcur - 6, 6);
 
-      // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
-      unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
+   // R__memcompress fills first 6 bytes with own header, therefore just overwrite them
+   unsigned long ziplen = R__memcompress(bufcur - 6, objlen + 6, (char *)objbuf, objlen);
 
-      memcpy(bufcur - 6, dummy, 6);
+   memcpy(bufcur - 6, dummy, 6);
 
-      bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
+   bufcur += (ziplen - 6); // jump over compressed data (6 byte is extra ROOT header)
 
-      *bufcur++ = objcrc & 0xff; // CRC32
-      *bufcur++ = (objcrc >> 8) & 0xff;
-      *bufcur++ = (objcrc >> 16) & 0xff;
-      *bufcur++ = (objcrc >> 24) & 0xff;
+   *bufcur++ = objcrc & 0xff; // CRC32
+   *bufcur++ = (objcrc >> 8) & 0xff;
+   *bufcur++ = (objcrc >> 16) & 0xff;
+   *bufcur++ = (objcrc >> 24) & 0xff;
 
-      *bufcur++ = objlen & 0xff;         // original data length
-      *bufcur++ = (objlen >> 8) & 0xff;  // original data length
-      *bufcur++ = (objlen >> 16) & 0xff; // original data length
-      *bufcur++ = (objlen >> 24) & 0xff; // original data length
+   *bufcur++ = objlen & 0xff;         // original data length
+   *bufcur++ = (objlen >> 8) & 0xff;  // original data length
+   *bufcur++ = (objlen >> 16) & 0xff; // original data length
+   *bufcur++ = (objlen >> 24) & 0xff; // original data length
 
-      ofs.write(buffer, bufcur - buffer);
+   ofs.write(buffer, bufcur - buffer);
 
-      free(buffer);
-   } else {
-      ofs << json.Data();
-   }
+   free(buffer);
 
    ofs.close();
 
    return json.Length();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert object, inherited from TObject class, into JSON and write it to out
+/// as it is produced, without keeping the complete JSON in memory.
+/// Compact parameter is as for ConvertToJSON().
+/// Returns the number of characters written
+
+Long64_t TBufferJSON::ExportToStream(std::ostream &out, const TObject *obj, Int_t compact)
+{
+   if (!obj)
+      return 0;
+
+   return ExportToStream(out, obj, TObject::Class(), compact);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Convert any type of object into JSON and write it to out as it is produced,
+/// without keeping the complete JSON in memory.
+/// Compact parameter is as for ConvertToJSON().
+/// Returns the number of characters written
+
+Long64_t TBufferJSON::ExportToStream(std::ostream &out, const void *obj, const TClass *cl, Int_t compact)
+{
+   if (!obj || !cl)
+      return 0;
+
+   TClass *clActual = cl->GetActualClass(obj);
+   const void *actualStart = obj;
+   if (clActual && (clActual != cl))
+      actualStart = (char *)obj - clActual->GetBaseClassOffset(cl);
+   else
+      clActual = const_cast<TClass *>(cl);
+
+   TBufferJSON buf;
+
+   buf.SetCompact(compact);
+
+   buf.fOutStream = &out;
+
+   buf.InitMap();
+
+   buf.PushStack(0); // dummy stack entry to avoid extra checks in the beginning
+
+   buf.JsonWriteObject(actualStart, clActual);
+
+   buf.PopStack();
+
+   return buf.FlushOutput(kTRUE);
+}
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream buffer encoding in CBOR (RFC 7049) the JSON written to it by
+/// TBufferJSON, as it is written. Objects and arrays are encoded with
+/// indefinite lengths, so that only the current string or number is kept.
+
+class TCBORStreamBuf : public std::streambuf {
+private:
+   enum EState { kValue, kString, kEscape, kUnicode, kLiteral };
+
+   std::vector<UChar_t> &fOut; ///< encoded data
+   EState fState = kValue;     ///< what the next character belongs to
+   std::string fToken;         ///< content of the current string, number or literal
+   UInt_t fCode = 0;           ///< code point of the current unicode escape
+   Int_t fCodeDigits = 0;      ///< number of hexadecimal digits of fCode read
+   UInt_t fHighSurrogate = 0;  ///< first half of a surrogate pair, if the last escape was one
+   Int_t fDepth = 0;           ///< number of open objects and arrays
+   Bool_t fError = kFALSE;     ///< the JSON is not valid
+
+   void PutBigEndian(ULong64_t value, Int_t nbytes)
+   {
+      for (Int_t i = nbytes - 1; i >= 0; --i)
+         fOut.push_back((value >> (8 * i)) & 0xff);
+   }
+
+   /// Initial byte(s) of a data item of the given major type and argument.
+   void PutHead(UChar_t major, ULong64_t value)
+   {
+      major <<= 5;
+      if (value < 24) {
+         fOut.push_back(major | value);
+      } else if (value <= 0xff) {
+         fOut.push_back(major | 24);
+         PutBigEndian(value, 1);
+      } else if (value <= 0xffff) {
+         fOut.push_back(major | 25);
+         PutBigEndian(value, 2);
+      } else if (value <= 0xffffffff) {
+         fOut.push_back(major | 26);
+         PutBigEndian(value, 4);
+      } else {
+         fOut.push_back(major | 27);
+         PutBigEndian(value, 8);
+      }
+   }
+
+   void AppendUTF8(UInt_t code)
+   {
+      if (code >= 0xd800 && code < 0xdc00) {
+         fHighSurrogate = code;
+         return;
+      }
+      if (code >= 0xdc00 && code < 0xe000 && fHighSurrogate)
+         code = 0x10000 + ((fHighSurrogate - 0xd800) << 10) + (code - 0xdc00);
+      fHighSurrogate = 0;
+      if (code < 0x80) {
+         fToken += (char)code;
+      } else if (code < 0x800) {
+         fToken += (char)(0xc0 | (code >> 6));
+         fToken += (char)(0x80 | (code & 0x3f));
+      } else if (code < 0x10000) {
+         fToken += (char)(0xe0 | (code >> 12));
+         fToken += (char)(0x80 | ((code >> 6) & 0x3f));
+         fToken += (char)(0x80 | (code & 0x3f));
+      } else {
+         fToken += (char)(0xf0 | (code >> 18));
+         fToken += (char)(0x80 | ((code >> 12) & 0x3f));
+         fToken += (char)(0x80 | ((code >> 6) & 0x3f));
+         fToken += (char)(0x80 | (code & 0x3f));
+      }
+   }
+
+   /// Encode the number, true, false or null just read. Integers are encoded as
+   /// integers when they fit in a Long64_t or a ULong64_t, as JSON parsers do.
+   void EndLiteral()
+   {
+      fState = kValue;
+      if (fToken == "null") {
+         fOut.push_back(0xf6);
+      } else if (fToken == "true") {
+         fOut.push_back(0xf5);
+      } else if (fToken == "false") {
+         fOut.push_back(0xf4);
+      } else {
+         const char *digits = fToken.c_str();
+         const Bool_t negative = (*digits == '-');
+         if (negative)
+            ++digits;
+         const ULong64_t maxValue = negative ? (1ULL << 63) : ~0ULL;
+         ULong64_t value = 0;
+         Bool_t integer = (*digits != 0);
+         for (const char *c = digits; *c && integer; ++c) {
+            const Int_t digit = *c - '0';
+            if (digit < 0 || digit > 9 || value > (maxValue - digit) / 10)
+               integer = kFALSE;
+            else
+               value = value * 10 + digit;
+         }
+         if (integer && negative && value) {
+            PutHead(1, value - 1);
+         } else if (integer) {
+            PutHead(0, value);
+         } else {
+            char *end = nullptr;
+            const Double_t number = strtod(fToken.c_str(), &end);
+            if (end == fToken.c_str() || *end)
+               fError = kTRUE;
+            ULong64_t bits;
+            memcpy(&bits, &number, sizeof(bits));
+            fOut.push_back(0xfb);
+            PutBigEndian(bits, 8);
+         }
+      }
+      fToken.clear();
+   }
+
+   void Consume(char c)
+   {
+      switch (fState) {
+      case kString:
+         if (c == '"') {
+            PutHead(3, fToken.size());
+            fOut.insert(fOut.end(), fToken.begin(), fToken.end());
+            fToken.clear();
+            fState = kValue;
+         } else if (c == '\\') {
+            fState = kEscape;
+         } else {
+            fToken += c;
+         }
+         return;
+      case kEscape:
+         fState = kString;
+         switch (c) {
+         case 'b': fToken += '\b'; break;
+         case 'f': fToken += '\f'; break;
+         case 'n': fToken += '\n'; break;
+         case 'r': fToken += '\r'; break;
+         case 't': fToken += '\t'; break;
+         case 'u':
+            fState = kUnicode;
+            fCode = 0;
+            fCodeDigits = 0;
+            break;
+         default: fToken += c; // quote, backslash and slash
+         }
+         return;
+      case kUnicode: {
+         const Int_t digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                                                              : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+         if (digit < 0) {
+            fError = kTRUE;
+            return;
+         }
+         fCode = fCode * 16 + digit;
+         if (++fCodeDigits == 4) {
+            AppendUTF8(fCode);
+            fState = kString;
+         }
+         return;
+      }
+      case kLiteral:
+         if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '.' || c == '+' ||
+             c == '-') {
+            fToken += c;
+            return;
+         }
+         EndLiteral();
+         break;
+      case kValue: break;
+      }
+
+      switch (c) {
+      case '{':
+         fOut.push_back(0xbf);
+         ++fDepth;
+         break;
+      case '[':
+         fOut.push_back(0x9f);
+         ++fDepth;
+         break;
+      case '}':
+      case ']':
+         fOut.push_back(0xff);
+         if (--fDepth < 0)
+            fError = kTRUE;
+         break;
+      case '"': fState = kString; break;
+      case ',':
+      case ':':
+      case ' ':
+      case '\n':
+      case '\r':
+      case '\t': break;
+      default:
+         if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-') {
+            fState = kLiteral;
+            fToken = c;
+         } else {
+            fError = kTRUE;
+         }
+      }
+   }
+
+protected:
+   int_type overflow(int_type c) override
+   {
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+         Consume(traits_type::to_char_type(c));
+      return traits_type::not_eof(c);
+   }
+
+   std::streamsize xsputn(const char *s, std::streamsize n) override
+   {
+      for (std::streamsize i = 0; i < n; ++i)
+         Consume(s[i]);
+      return n;
+   }
+
+public:
+   explicit TCBORStreamBuf(std::vector<UChar_t> &out) : fOut(out) {}
+
+   /// Encode the last value. Returns false if the JSON written was not complete and valid.
+   Bool_t Finish()
+   {
+      if (fState == kLiteral)
+         EndLiteral();
+      return !fError && fState == kValue && fDepth == 0 && !fOut.empty();
+   }
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Converts object, inherited from TObject class, to the CBOR binary encoding
+/// (RFC 7049) of its JSON representation. Second and third digits of compact
+/// parameter are as for ConvertToJSON().
+
+std::vector<UChar_t> TBufferJSON::ConvertToCBOR(const TObject *obj, Int_t compact)
+{
+   if (!obj)
+      return std::vector<UChar_t>(1, 0xf6); // null
+
+   return ConvertToCBOR(obj, TObject::Class(), compact);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Converts any type of object to the CBOR binary encoding (RFC 7049) of its
+/// JSON representation. Second and third digits of compact parameter are as
+/// for ConvertToJSON().
+///
+/// The JSON written by the streamer is encoded as it is produced, in pieces of
+/// the size of the output buffer (see ExportToStream()): neither the JSON of
+/// the whole object nor a document tree are built.
+
+std::vector<UChar_t> TBufferJSON::ConvertToCBOR(const void *obj, const TClass *cl, Int_t compact)
+{
+   std::vector<UChar_t> cbor;
+   if (!obj || !cl)
+      return std::vector<UChar_t>(1, 0xf6); // null
+
+   TCBORStreamBuf encoder(cbor);
+   std::ostream out(&encoder);
+   ExportToStream(out, obj, cl, compact - compact % 10 + 3);
+   if (!encoder.Finish()) {
+      ::Error("TBufferJSON::ConvertToCBOR", "cannot encode the JSON of class %s", cl->GetName());
+      cbor.clear();
+   }
+
+   return cbor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read TObject-based class from CBOR, produced by ConvertToCBOR() method.
+/// If object does not inherit from TObject class, return 0.
+
+TObject *TBufferJSON::ConvertFromCBOR(const std::vector<UChar_t> &data)
+{
+   TClass *cl = nullptr;
+   void *obj = ConvertFromCBORAny(data, &cl);
+
+   if (!cl || !obj)
+      return nullptr;
+
+   Int_t delta = cl->GetBaseClassOffset(TObject::Class());
+
+   if (delta < 0) {
+      cl->Destructor(obj);
+      return nullptr;
+   }
+
+   return (TObject *)(((char *)obj) + delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read object from CBOR, produced by ConvertToCBOR() method.
+/// In class pointer (if specified) read class is returned
+/// One must specify expected object class, if it is TArray or STL container
+
+void *TBufferJSON::ConvertFromCBORAny(const std::vector<UChar_t> &data, TClass **cl)
+{
+   nlohmann::json docu;
+   try {
+      docu = nlohmann::json::from_cbor(data);
+   } catch (const std::exception &e) {
+      ::Error("TBufferJSON::ConvertFromCBORAny", "cannot decode CBOR data: %s", e.what());
+      if (cl)
+         *cl = nullptr;
+      return nullptr;
+   }
+
+   return JsonReadDocument(&docu, cl);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read TObject-based class from JSON, produced by ConvertToJSON() method.
 /// If object does not inherit from TObject class, return 0.
@@ -738,6 +1134,17 @@ TObject *TBufferJSON::ConvertFromJSON(const char *str)
 /// One must specify expected object class, if it is TArray or STL container
 
 void *TBufferJSON::ConvertFromJSONAny(const char *str, TClass **cl)
+{
+   nlohmann::json docu = nlohmann::json::parse(str);
+
+   return JsonReadDocument(&docu, cl);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read object from parsed JSON document, either text or binary.
+/// In class pointer (if specified) read class is returned
+
+void *TBufferJSON::JsonReadDocument(void *node, TClass **cl)
 {
    TClass *objClass = nullptr;
 
@@ -746,16 +1153,16 @@ void *TBufferJSON::ConvertFromJSONAny(const char *str, TClass **cl)
       *cl = nullptr;
    }
 
-   nlohmann::json docu = nlohmann::json::parse(str);
+   nlohmann::json *docu = (nlohmann::json *)node;
 
-   if (docu.is_null() || (!docu.is_object() && !docu.is_array()))
+   if (docu->is_null() || (!docu->is_object() && !docu->is_array()))
       return nullptr;
 
    TBufferJSON buf(TBuffer::kRead);
 
    buf.InitMap();
 
-   buf.PushStack(0, &docu);
+   buf.PushStack(0, docu);
 
    void *obj = buf.JsonReadObject(nullptr, objClass, cl);
 
@@ -961,6 +1368,26 @@ void TBufferJSON::AppendOutput(const char *line0, const char *line1)
          fOutput->Append(line1);
       }
    }
+
+   if (fOutStream && (fOutput == &fOutBuffer) && (fOutBuffer.Length() >= kOutStreamChunk))
+      FlushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Pass the main output buffer on to the output stream and clear it.
+/// When final, also write the value if the output is a single value.
+/// Returns the total number of characters written to the stream.
+
+Long64_t TBufferJSON::FlushOutput(Bool_t final)
+{
+   if (final && (fOutStreamed == 0) && (fOutBuffer.Length() == 0))
+      fOutBuffer = fValue;
+   if (fOutBuffer.Length() > 0) {
+      fOutStream->write(fOutBuffer.Data(), fOutBuffer.Length());
+      fOutStreamed += fOutBuffer.Length();
+      fOutBuffer.Clear();
+   }
+   return fOutStreamed;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2673,7 +3100,7 @@ void TBufferJSON::ReadFastArray(void **start, const TClass *cl, Int_t n, Bool_t
 template <typename T>
 R__ALWAYS_INLINE void TBufferJSON::JsonWriteArrayCompress(const T *vname, Int_t arrsize, const char *typname)
 {
-   if ((fCompact < 10) || (arrsize < 6)) {
+   if ((fCompact % 100 < 10) || (arrsize < 6)) {
       fValue.Append("[");
       for (Int_t indx = 0; indx < arrsize; indx++) {
          if (indx > 0)
@@ -2698,7 +3125,7 @@ R__ALWAYS_INLINE void TBufferJSON::JsonWriteArrayCompress(const T *vname, Int_t
                continue;
             }
             Int_t p0(p++), pp(0), nsame(1);
-            if (fCompact < 20) {
+            if (fCompact % 100 < 20) {
                pp = bindx;
                p = bindx + 1;
                nsame = 0;
@@ -3483,8 +3910,7 @@ void TBufferJSON::WriteCharStar(char *s)
 void TBufferJSON::JsonWriteBasic(Char_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%d", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertInteger(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3493,8 +3919,7 @@ void TBufferJSON::JsonWriteBasic(Char_t value)
 void TBufferJSON::JsonWriteBasic(Short_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%hd", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertInteger(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3503,8 +3928,7 @@ void TBufferJSON::JsonWriteBasic(Short_t value)
 void TBufferJSON::JsonWriteBasic(Int_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%d", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertInteger(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3513,8 +3937,7 @@ void TBufferJSON::JsonWriteBasic(Int_t value)
 void TBufferJSON::JsonWriteBasic(Long_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%ld", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertInteger(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3522,7 +3945,8 @@ void TBufferJSON::JsonWriteBasic(Long_t value)
 
 void TBufferJSON::JsonWriteBasic(Long64_t value)
 {
-   fValue.Append(std::to_string(value).c_str());
+   char buf[50];
+   fValue.Append(ConvertInteger(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3533,6 +3957,8 @@ void TBufferJSON::JsonWriteBasic(Float_t value)
    char buf[200];
    if (std::isnan(value) || std::isinf(value))
       strcpy(buf, "null");
+   else if (fRoundTrip)
+      ConvertFloatRoundTrip(value, buf, sizeof(buf));
    else
       ConvertFloat(value, buf, sizeof(buf));
    fValue.Append(buf);
@@ -3546,6 +3972,8 @@ void TBufferJSON::JsonWriteBasic(Double_t value)
    char buf[200];
    if (std::isnan(value) || std::isinf(value))
       strcpy(buf, "null");
+   else if (fRoundTrip)
+      ConvertDoubleRoundTrip(value, buf, sizeof(buf));
    else
       ConvertDouble(value, buf, sizeof(buf));
    fValue.Append(buf);
@@ -3565,8 +3993,7 @@ void TBufferJSON::JsonWriteBasic(Bool_t value)
 void TBufferJSON::JsonWriteBasic(UChar_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%u", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertUnsigned(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3575,8 +4002,7 @@ void TBufferJSON::JsonWriteBasic(UChar_t value)
 void TBufferJSON::JsonWriteBasic(UShort_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%hu", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertUnsigned(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3585,8 +4011,7 @@ void TBufferJSON::JsonWriteBasic(UShort_t value)
 void TBufferJSON::JsonWriteBasic(UInt_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%u", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertUnsigned(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3595,8 +4020,7 @@ void TBufferJSON::JsonWriteBasic(UInt_t value)
 void TBufferJSON::JsonWriteBasic(ULong_t value)
 {
    char buf[50];
-   snprintf(buf, sizeof(buf), "%lu", value);
-   fValue.Append(buf);
+   fValue.Append(ConvertUnsigned(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3604,7 +4028,8 @@ void TBufferJSON::JsonWriteBasic(ULong_t value)
 
 void TBufferJSON::JsonWriteBasic(ULong64_t value)
 {
-   fValue.Append(std::to_string(value).c_str());
+   char buf[50];
+   fValue.Append(ConvertUnsigned(value, buf, sizeof(buf)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -11,11 +11,13 @@
 
 #include "ROOT/TBufferMerger.hxx"
 
-#include "TBufferFile.h"
 #include "TError.h"
 #include "TROOT.h"
 #include "TVirtualMutex.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <utility>
 
 namespace ROOT {
@@ -62,18 +64,74 @@ std::shared_ptr<TBufferMergerFile> TBufferMerger::GetFile()
 
 size_t TBufferMerger::GetQueueSize() const
 {
+   std::lock_guard<std::mutex> lock(fQueueMutex);
    return fQueue.size();
 }
 
-void TBufferMerger::Push(TBufferFile *buffer)
+size_t TBufferMerger::GetBufferedBytes() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fBuffered + fMergingBytes;
+}
+
+size_t TBufferMerger::GetMaxBufferedBytes() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fMaxBuffered;
+}
+
+void TBufferMerger::SetMaxBufferedBytes(size_t size)
 {
    {
       std::lock_guard<std::mutex> lock(fQueueMutex);
-      fBuffered += buffer->BufferSize();
-      fQueue.push(buffer);
+      fMaxBuffered = size;
    }
+   fQueueCV.notify_all();
+}
 
-   if (fBuffered > fAutoSave)
+TBufferMerger::TStatistics TBufferMerger::GetStatistics() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fStats;
+}
+
+void TBufferMerger::Push(TMemFile::ExternalDataPtr_t data)
+{
+   const size_t size = data->size();
+   bool merge;
+   {
+      std::unique_lock<std::mutex> lock(fQueueMutex);
+
+      // Back pressure: while the buffered data would exceed the limit, either
+      // wait for the merge in progress to release its buffers or merge the
+      // queue in this thread. A buffer is always accepted if nothing is held.
+      if (fMaxBuffered && fBuffered + fMergingBytes && fBuffered + fMergingBytes + size > fMaxBuffered) {
+         const auto start = std::chrono::steady_clock::now();
+         while (fMaxBuffered && fBuffered + fMergingBytes && fBuffered + fMergingBytes + size > fMaxBuffered) {
+            if (fMergeActive) {
+               fQueueCV.wait(lock);
+            } else {
+               lock.unlock();
+               Merge();
+               // Another thread may hold fMergeMutex without having started
+               // its merge yet: give it a chance to proceed.
+               std::this_thread::yield();
+               lock.lock();
+            }
+         }
+         fStats.fWaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      fBuffered += size;
+      fQueue.push(std::move(data));
+      ++fStats.fNBuffers;
+      fStats.fBytesPushed += size;
+      fStats.fMaxQueueSize = std::max(fStats.fMaxQueueSize, fQueue.size());
+      fStats.fMaxBufferedBytes = std::max(fStats.fMaxBufferedBytes, fBuffered + fMergingBytes);
+      merge = fBuffered > fAutoSave;
+   }
+
+   if (merge)
       Merge();
 }
 
@@ -90,23 +148,43 @@ void TBufferMerger::SetAutoSave(size_t size)
 void TBufferMerger::Merge()
 {
    if (fMergeMutex.try_lock()) {
-      std::queue<TBufferFile *> queue;
+      std::queue<TMemFile::ExternalDataPtr_t> queue;
+      size_t bytes;
       {
          std::lock_guard<std::mutex> q(fQueueMutex);
          std::swap(queue, fQueue);
+         bytes = fBuffered;
+         fMergingBytes = bytes;
          fBuffered = 0;
+         fMergeActive = true;
       }
 
+      const auto start = std::chrono::steady_clock::now();
+
+      // The memory files share the pushed buffers instead of copying them;
+      // the buffers are released when fMerger.Reset() deletes the files.
       while (!queue.empty()) {
-         std::unique_ptr<TBufferFile> buffer{queue.front()};
-         fMerger.AddAdoptFile(
-            new TMemFile(fMerger.GetOutputFileName(), buffer->Buffer(), buffer->BufferSize(), "READ"));
+         fMerger.AddAdoptFile(new TMemFile(fMerger.GetOutputFileName(), std::move(queue.front())));
          queue.pop();
       }
 
       fMerger.PartialMerge();
       fMerger.Reset();
+
+      const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      {
+         std::lock_guard<std::mutex> q(fQueueMutex);
+         fMergingBytes = 0;
+         fMergeActive = false;
+         if (bytes) {
+            ++fStats.fNMerges;
+            fStats.fBytesMerged += bytes;
+            fStats.fMergeTime += elapsed;
+            fStats.fMaxMergeTime = std::max(fStats.fMaxMergeTime, elapsed);
+         }
+      }
       fMergeMutex.unlock();
+      fQueueCV.notify_all();
    }
 }
 
@@ -11,7 +11,8 @@
 
 #include "ROOT/TBufferMerger.hxx"
 
-#include "TBufferFile.h"
+#include <memory>
+#include <vector>
 
 namespace ROOT {
 namespace Experimental {
@@ -32,10 +33,11 @@ Int_t TBufferMergerFile::Write(const char *name, Int_t opt, Int_t bufsize)
    Int_t nbytes = TMemFile::Write(name, opt, bufsize);
 
    if (nbytes) {
-      TBufferFile *buffer = new TBufferFile(TBuffer::kWrite);
-      CopyTo(*buffer);
-      buffer->SetReadMode();
-      fMerger.Push(buffer);
+      // The merger reads the buffer in place (see TMemFile(const char*, ExternalDataPtr_t)),
+      // so this is the only copy of the file content.
+      auto buffer = std::make_shared<std::vector<char>>(GetSize());
+      CopyTo(buffer->data(), buffer->size());
+      fMerger.Push(std::move(buffer));
       ResetAfterMerge(0);
    }
    return nbytes;
@@ -32,8 +32,68 @@ actions list for both are the same.
 #include "TExMap.h"
 #include "TError.h"
 
+#if __cplusplus >= 201700L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+// shortest round-trip formatting of floating-point values, e.g. libstdc++ >= 11
+#if defined(__cpp_lib_to_chars)
+#define R__HAS_FLOAT_TO_CHARS
+#endif
+#endif
+#endif
+
+#include <stdlib.h>
+
 ClassImp(TBufferText);
 
+namespace {
+
+const char gDigitPairs[] = "00010203040506070809"
+                           "10111213141516171819"
+                           "20212223242526272829"
+                           "30313233343536373839"
+                           "40414243444546474849"
+                           "50515253545556575859"
+                           "60616263646566676869"
+                           "70717273747576777879"
+                           "80818283848586878889"
+                           "90919293949596979899";
+
+/// Write the decimal digits of value ending just before end, two at a time.
+/// Returns the position of the first digit.
+char *WriteDigits(ULong64_t value, char *end)
+{
+   while (value >= 100) {
+      const unsigned pair = 2 * (value % 100);
+      value /= 100;
+      *--end = gDigitPairs[pair + 1];
+      *--end = gDigitPairs[pair];
+   }
+   if (value >= 10) {
+      *--end = gDigitPairs[2 * value + 1];
+      *--end = gDigitPairs[2 * value];
+   } else {
+      *--end = '0' + value;
+   }
+   return end;
+}
+
+/// Same as snprintf(buf, len, "%1.0f", value) for an integral value below 2^63.
+const char *ConvertIntegral(Double_t value, char *buf, unsigned len)
+{
+   if ((value == 0) && std::signbit(value)) {
+      snprintf(buf, len, "-0");
+      return buf;
+   }
+   return TBufferText::ConvertInteger((Long64_t)value, buf, len);
+}
+
+/// Largest integral value converted without snprintf: within the range of
+/// Long64_t and exactly represented in a double.
+const Double_t kMaxFastIntegral = 9007199254740992.; // 2^53
+
+} // namespace
+
 const char *TBufferText::fgFloatFmt = "%e";
 const char *TBufferText::fgDoubleFmt = "%.14e";
 
@@ -835,7 +895,7 @@ const char *TBufferText::ConvertFloat(Float_t value, char *buf, unsigned len, Bo
    if (not_optimize) {
       snprintf(buf, len, fgFloatFmt, value);
    } else if ((value == std::nearbyint(value)) && (std::abs(value) < 1e15)) {
-      snprintf(buf, len, "%1.0f", value);
+      ConvertIntegral(value, buf, len);
    } else {
       snprintf(buf, len, fgFloatFmt, value);
       CompactFloatString(buf, len);
@@ -851,10 +911,106 @@ const char *TBufferText::ConvertDouble(Double_t value, char *buf, unsigned len,
    if (not_optimize) {
       snprintf(buf, len, fgFloatFmt, value);
    } else if ((value == std::nearbyint(value)) && (std::abs(value) < 1e25)) {
-      snprintf(buf, len, "%1.0f", value);
+      if (std::abs(value) < kMaxFastIntegral)
+         ConvertIntegral(value, buf, len);
+      else
+         snprintf(buf, len, "%1.0f", value);
    } else {
       snprintf(buf, len, fgDoubleFmt, value);
       CompactFloatString(buf, len);
    }
    return buf;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// convert float to the shortest string which reads back to the same float,
+/// whatever the configured format. Integral values are written as by ConvertFloat(),
+/// others by std::to_chars when the standard library provides it or else with the
+/// smallest number of significant digits, from 6 to 9, which restores the value,
+/// then compacted by CompactFloatString()
+
+const char *TBufferText::ConvertFloatRoundTrip(Float_t value, char *buf, unsigned len)
+{
+   if ((value == std::nearbyint(value)) && (std::abs(value) < 1e15))
+      return ConvertIntegral(value, buf, len);
+#ifdef R__HAS_FLOAT_TO_CHARS
+   auto res = std::to_chars(buf, buf + len - 1, value);
+   if (res.ec == std::errc()) {
+      *res.ptr = 0;
+      return buf;
+   }
+#endif
+   for (int digits = 6; digits <= 9; ++digits) {
+      snprintf(buf, len, "%.*e", digits - 1, value);
+      if (digits == 9 || strtof(buf, nullptr) == value)
+         break;
+   }
+   CompactFloatString(buf, len);
+   return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// convert double to the shortest string which reads back to the same double,
+/// whatever the configured format. Integral values are written as by ConvertDouble(),
+/// others by std::to_chars when the standard library provides it or else with the
+/// smallest number of significant digits, from 15 to 17, which restores the value,
+/// then compacted by CompactFloatString()
+
+const char *TBufferText::ConvertDoubleRoundTrip(Double_t value, char *buf, unsigned len)
+{
+   if ((value == std::nearbyint(value)) && (std::abs(value) < kMaxFastIntegral))
+      return ConvertIntegral(value, buf, len);
+#ifdef R__HAS_FLOAT_TO_CHARS
+   auto res = std::to_chars(buf, buf + len - 1, value);
+   if (res.ec == std::errc()) {
+      *res.ptr = 0;
+      return buf;
+   }
+#endif
+   for (int digits = 15; digits <= 17; ++digits) {
+      snprintf(buf, len, "%.*e", digits - 1, value);
+      if (digits == 17 || strtod(buf, nullptr) == value)
+         break;
+   }
+   CompactFloatString(buf, len);
+   return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// convert integer to string, as snprintf(buf, len, "%lld", value) but faster
+
+const char *TBufferText::ConvertInteger(Long64_t value, char *buf, unsigned len)
+{
+   char tmp[24];
+   char *end = tmp + sizeof(tmp);
+   // negate as unsigned: -value overflows for the smallest Long64_t
+   char *first = WriteDigits(value < 0 ? 0 - (ULong64_t)value : (ULong64_t)value, end);
+   if (value < 0)
+      *--first = '-';
+   const unsigned n = end - first;
+   if (n >= len) {
+      snprintf(buf, len, "%lld", (long long)value);
+      return buf;
+   }
+   memcpy(buf, first, n);
+   buf[n] = 0;
+   return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// convert unsigned integer to string, as snprintf(buf, len, "%llu", value) but faster
+
+const char *TBufferText::ConvertUnsigned(ULong64_t value, char *buf, unsigned len)
+{
+   char tmp[24];
+   char *end = tmp + sizeof(tmp);
+   char *first = WriteDigits(value, end);
+   const unsigned n = end - first;
+   if (n >= len) {
+      snprintf(buf, len, "%llu", (unsigned long long)value);
+      return buf;
+   }
+   memcpy(buf, first, n);
+   buf[n] = 0;
+   return buf;
+}
@@ -33,6 +33,7 @@ End_Macro
 #include "TClassTable.h"
 #include "TInterpreter.h"
 #include "THashList.h"
+#include "TConcurrentHashList.h"
 #include "TBrowser.h"
 #include "TFree.h"
 #include "TKey.h"
@@ -46,8 +47,17 @@ End_Macro
 #include "TStreamerElement.h"
 #include "TProcessUUID.h"
 #include "TVirtualMutex.h"
+#include "TVirtualRWMutex.h"
 #include "TEmulatedCollectionProxy.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
@@ -322,8 +332,6 @@ void TDirectoryFile::Build(TFile* motherFile, TDirectory* motherDir)
    // don't add it here to the directory since its name is not yet known.
    // It will be added to the directory in TKey::ReadObj().
 
-   if (motherDir && strlen(GetName()) != 0) motherDir->Append(this);
-
    fModified   = kTRUE;
    fWritable   = kFALSE;
    fDatimeC.Set();
@@ -332,12 +340,24 @@ void TDirectoryFile::Build(TFile* motherFile, TDirectory* motherDir)
    fSeekDir    = 0;
    fSeekParent = 0;
    fSeekKeys   = 0;
-   fList       = new THashList(100,50);
-   fKeys       = new THashList(100,50);
+   if (ROOT::gCoreMutex) {
+      // Shared by the threads: lookups and insertions must not serialize on ROOT::gCoreMutex.
+      auto list = new TConcurrentHashList(100,50);
+      if (ROOT::IsIndexedCleanupEnabled())
+         list->SetIndexedCleanup();
+      fList    = list;
+      fKeys    = new TConcurrentHashList(100,50);
+   } else {
+      fList    = new THashList(100,50);
+      fKeys    = new THashList(100,50);
+   }
    fList->UseRWLock();
    fMother     = motherDir;
    fFile       = motherFile ? motherFile : TFile::CurrentFile();
    SetBit(kCanDelete);
+
+   // Published once built: the mother directory looks at our list.
+   if (motherDir && strlen(GetName()) != 0) motherDir->Append(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -943,16 +963,11 @@ TObject *TDirectoryFile::Get(const char *namecycle)
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObj();
-            break;
-         }
-      }
+   // GetKey does a hash lookup and returns the highest cycle not above the requested one.
+   TKey *key = GetKey(namobj, cycle);
+   if (key && ((cycle == 9999) || (cycle == key->GetCycle()))) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObj();
    }
 
    return idcur;
@@ -1064,16 +1079,10 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 //*-*---------------------Case of Key---------------------
 //                        ===========
    void *idcur = 0;
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObjectAny(expectedClass);
-            break;
-         }
-      }
+   TKey *key = GetKey(namobj, cycle);
+   if (key && ((cycle == 9999) || (cycle == key->GetCycle()))) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObjectAny(expectedClass);
    }
 
    return idcur;
@@ -1101,6 +1110,18 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
    if (!fKeys) return nullptr;
 
+   // The cycles of the key, most recent first, looked up without locking.
+   if (auto keys = dynamic_cast<TConcurrentHashList *>(fKeys)) {
+      std::vector<TObject *> cycles;
+      keys->FindObjects(name, cycles);
+      for (auto obj : cycles) {
+         TKey *key = (TKey *)obj;
+         if ((cycle == 9999) || (cycle >= key->GetCycle()))
+            return key;
+      }
+      return nullptr;
+   }
+
    // TIter::TIter() already checks for null pointers
    TIter next( ((THashList *)(GetListOfKeys()))->GetListForObject(name) );
 
@@ -1260,6 +1281,75 @@ void TDirectoryFile::Purge(Short_t)
    }
 }
 
+namespace {
+
+/// Maximum number of bytes read from the file at once by TDirectoryFile::ReadObjects.
+const Long64_t kBulkReadSize = 32 * 1024 * 1024;
+
+/// Whether the object of `key` can be read in bulk: its record is read as is
+/// from the file, and it is a TObject but not a directory.
+Bool_t IsBulkReadable(TKey *key)
+{
+   if (key->IsA() != TKey::Class())
+      return kFALSE;
+   TClass *cl = TClass::GetClass(key->GetClassName());
+   return cl && cl->IsTObject() && !cl->InheritsFrom(TDirectoryFile::Class());
+}
+
+/// Read the records of `keys` from `file` in one vectored read, and uncompress
+/// them, on the implicit multi-threading pool when it is enabled. Returns the
+/// uncompressed records, allocated with new[], null for the ones that could not
+/// be read.
+std::vector<char *> ReadRecords(TFile *file, const std::vector<TKey *> &keys)
+{
+   const UInt_t n = keys.size();
+   std::vector<char *> unzipped(n, nullptr);
+   if (!n)
+      return unzipped;
+
+   // TFile::ReadBuffers coalesces the reads of neighbouring records given in file order.
+   std::vector<UInt_t> order(n);
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(),
+             [&keys](UInt_t a, UInt_t b) { return keys[a]->GetSeekKey() < keys[b]->GetSeekKey(); });
+   std::vector<Long64_t> pos(n);
+   std::vector<Int_t> len(n);
+   std::vector<Long64_t> offset(n);
+   Long64_t total = 0;
+   for (UInt_t j = 0; j < n; ++j) {
+      TKey *key = keys[order[j]];
+      pos[j] = key->GetSeekKey();
+      len[j] = key->GetNbytes();
+      offset[order[j]] = total;
+      total += len[j];
+   }
+   std::vector<char> records(total);
+   if (file->ReadBuffers(records.data(), pos.data(), len.data(), n))
+      return unzipped;
+
+   auto unzip = [&](UInt_t i) {
+      TKey *key = keys[i];
+      char *target = new char[key->GetKeylen() + key->GetObjlen()];
+      if (key->UnzipRecord(&records[offset[i]], target))
+         unzipped[i] = target;
+      else
+         delete [] target;
+   };
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && n > 1) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(unzip, ROOT::TSeqU(n));
+   } else
+#endif
+   {
+      for (UInt_t i = 0; i < n; ++i)
+         unzip(i);
+   }
+   return unzipped;
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read objects from a ROOT file directory into memory.
 ///
@@ -1287,12 +1377,66 @@ void TDirectoryFile::ReadAll(Option_t* opt)
 
          if ((dir!=0) && (strcmp(opt,"dirs*")==0)) dir->ReadAll("dirs*");
       }
-   else
-      while ((key = (TKey *) next())) {
+   else {
+      std::vector<TKey *> keys;
+      keys.reserve(GetNkeys());
+      while ((key = (TKey *) next()))
+         keys.push_back(key);
+      ReadObjects(keys, kTRUE);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the objects of `keys`, keys of this directory, in bulk.
+///
+/// Returns the objects in the order of `keys`, null for the ones that could
+/// not be read. The result is the one of calling TKey::ReadObj() on each key
+/// in turn, including the automatic addition of the objects to this directory,
+/// but the records of the keys are read from the file with vectored reads
+/// (TFile::ReadBuffers) of up to 32 MB, and uncompressed concurrently when
+/// implicit multi-threading is enabled. The objects are then streamed one after
+/// the other, in the order of `keys`.
+///
+/// With `replace`, the object of the same name already in memory, if any, is
+/// deleted before each object is read, as done by ReadAll().
+///
+/// Subdirectories and objects of classes not deriving from TObject are read
+/// with TKey::ReadObj().
+
+std::vector<TObject *> TDirectoryFile::ReadObjects(const std::vector<TKey *> &keys, Bool_t replace)
+{
+   TDirectory::TContext ctxt(this);
+
+   std::vector<TObject *> objects(keys.size(), nullptr);
+   auto read = [&](size_t i, char *unzipped) {
+      TKey *key = keys[i];
+      if (replace) {
          TObject *thing = GetList()->FindObject(key->GetName());
          if (thing) { delete thing; }
-         key->ReadObj();
       }
+      objects[i] = unzipped ? key->ReadObjWithUnzippedBuffer(unzipped) : key->ReadObj();
+   };
+
+   size_t begin = 0;
+   while (begin < keys.size()) {
+      // Batch of consecutive keys read in bulk.
+      std::vector<TKey *> batch;
+      Long64_t nbytes = 0;
+      size_t end = begin;
+      for (; end < keys.size() && nbytes < kBulkReadSize && IsBulkReadable(keys[end]); ++end) {
+         batch.push_back(keys[end]);
+         nbytes += keys[end]->GetNbytes();
+      }
+      if (batch.empty()) {
+         read(begin++, nullptr);
+         continue;
+      }
+      std::vector<char *> unzipped = ReadRecords(GetFile(), batch);
+      for (size_t i = begin; i < end; ++i)
+         read(i, unzipped[i - begin]);
+      begin = end;
+   }
+   return objects;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +134,8 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TGlobal.h"
 #include "ROOT/RMakeUnique.hxx"
 #include "ROOT/RConcurrentHashColl.hxx"
+#include "ROOT/TStreamerInfoSnapshot.hxx"
+#include <mutex>
 
 using std::sqrt;
 
@@ -169,6 +171,18 @@ AddPseudoGlobals() {
             (TGlobalMappedFunction::GlobalFunc_t)((void*)&TFile::CurrentFile)));
 }
 } gAddPseudoGlobals;
+
+/// Install the TStreamerInfo snapshot named by the rootrc variable
+/// TFile.StreamerInfoSnapshot, once, before the first file is opened.
+void LoadStreamerInfoSnapshot()
+{
+   static std::once_flag once;
+   std::call_once(once, []() {
+      TString snapshot = gEnv->GetValue("TFile.StreamerInfoSnapshot", "");
+      if (!snapshot.IsNull() && !gSystem->ExpandPathName(snapshot))
+         ROOT::Experimental::TStreamerInfoSnapshot::Load(snapshot);
+   });
+}
 }
 ////////////////////////////////////////////////////////////////////////////////
 /// File default Constructor.
@@ -326,6 +340,8 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    if (!gROOT)
       ::Fatal("TFile::TFile", "ROOT system not initialized");
 
+   LoadStreamerInfoSnapshot();
+
    // store name without the options as name and title
    TString sfname1 = fname1;
    fNoAnchorInName = kFALSE;
@@ -805,7 +821,7 @@ void TFile::Init(Bool_t create)
       //*-* -------------Read keys of the top directory
       if (fSeekKeys > fBEGIN && fEND <= size) {
          //normal case. Recover only if file has no keys
-         TDirectoryFile::ReadKeys(kFALSE);
+         ReadKeys(kFALSE);
          gDirectory = this;
          if (!GetNkeys()) {
             if (tryrecover) {
@@ -21,6 +21,12 @@ a Grid environment where the files might be accessible via Castor,
 rfio, dcap, etc.
 The merging interface allows files containing histograms and trees
 to be merged, like the standalone hadd program.
+
+When implicit multi-threading is enabled, the histograms merged in one go
+are merged concurrently: once all the inputs of a histogram have been
+read, its merge is queued, and the queued merges run in parallel before
+the next object is written. The objects are read and written in the same
+order as without multi-threading.
 */
 
 #include "TFileMerger.h"
@@ -41,6 +47,12 @@ to be merged, like the standalone hadd program.
 #include "TMemFile.h"
 #include "TVirtualMutex.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include <vector>
+#endif
+
 #ifdef WIN32
 // For _getmaxstdio
 #include <stdio.h>
@@ -57,6 +69,53 @@ TClassRef R__TTree_Class("TTree");
 
 static const Int_t kCpProgress = BIT(14);
 static const Int_t kCintFileNumber = 100;
+
+#ifdef R__USE_IMT
+namespace {
+
+/// A histogram whose inputs have all been read, waiting to be merged.
+struct TPendingMerge {
+   TObject *fObj;    ///< Object receiving the merge, written to the target directory
+   TClass  *fClass;  ///< Class of fObj
+   TList   *fInputs; ///< Objects merged into fObj, owned
+   TString  fName;   ///< Name of the key of fObj in the target directory
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the pending histograms concurrently, then write them to `target`
+/// in the order they were queued. Returns kFALSE if a write failed.
+
+Bool_t MergePending(TDirectory *target, std::vector<TPendingMerge> &pending, const TFileMergeInfo &info)
+{
+   std::vector<Long64_t> results(pending.size());
+   ROOT::TThreadExecutor pool;
+   pool.Foreach([&](UInt_t i) {
+                   TFileMergeInfo minfo(target);
+                   minfo.fOptions = info.fOptions;
+                   minfo.fIOFeatures = info.fIOFeatures;
+                   ROOT::MergeFunc_t func = pending[i].fClass->GetMerge();
+                   results[i] = func(pending[i].fObj, pending[i].fInputs, &minfo);
+                },
+                ROOT::TSeqU(pending.size()));
+
+   Bool_t status = kTRUE;
+   target->cd();
+   for (size_t i = 0; i < pending.size(); ++i) {
+      TPendingMerge &merge = pending[i];
+      if (results[i] < 0)
+         Error("MergeRecursive", "calling Merge() on '%s'", merge.fObj->GetName());
+      merge.fInputs->Delete();
+      delete merge.fInputs;
+      if (merge.fObj->Write(merge.fName, TObject::kOverwrite) <= 0)
+         status = kFALSE;
+      merge.fClass->Destructor(merge.fObj);
+   }
+   pending.clear();
+   return status;
+}
+
+} // namespace
+#endif
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the maximum number of allowed opened files minus some wiggle room
 /// for CINT or at least of the standard library (stdio).
@@ -410,6 +469,13 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
       info.fOptions.Append(" fast");
    }
 
+#ifdef R__USE_IMT
+   // Histograms merged in one go are queued and merged concurrently by batches
+   std::vector<TPendingMerge> pending;
+   const Bool_t mergeConcurrently = fHistoOneGo && ROOT::IsImplicitMTEnabled();
+   const size_t maxPending = 2 * ROOT::GetImplicitMTPoolSize();
+#endif
+
    TFile      *current_file;
    TDirectory *current_sourcedir;
    if (type & kIncremental) {
@@ -518,6 +584,10 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
             if ( cl->InheritsFrom( TDirectory::Class() ) ) {
                // it's a subdirectory
 
+#ifdef R__USE_IMT
+               if (!pending.empty() && !MergePending(target, pending, info))
+                  status = kFALSE;
+#endif
                target->cd();
                TDirectory *newdir;
 
@@ -591,6 +661,21 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
                      nextsource = (TFile*)sourcelist->After( nextsource );
                   } while (nextsource);
                   // Merge the list, if still to be done
+#ifdef R__USE_IMT
+                  if (oneGo && mergeConcurrently) {
+                     TPendingMerge merge = {obj, cl, new TList, key->GetName()};
+                     merge.fInputs->AddAll(&inputs);
+                     inputs.Clear("nodelete");
+                     pending.push_back(merge);
+                     if (pending.size() >= maxPending) {
+                        if (!MergePending(target, pending, info))
+                           status = kFALSE;
+                     }
+                     oldkeyname = key->GetName();
+                     info.Reset();
+                     continue;
+                  }
+#endif
                   if (oneGo || info.fIsFirst) {
                      ROOT::MergeFunc_t func = cl->GetMerge();
                      func(obj, &inputs, &info);
@@ -732,6 +817,11 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
             // note that this will just store obj in the current directory level,
             // which is not persistent until the complete directory itself is stored
             // by "target->SaveSelf()" below
+#ifdef R__USE_IMT
+            // the histograms queued so far are written first
+            if (!pending.empty() && !MergePending(target, pending, info))
+               status = kFALSE;
+#endif
             target->cd();
 
             oldkeyname = key->GetName();
@@ -776,6 +866,10 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
          current_sourcedir = 0;
       }
    }
+#ifdef R__USE_IMT
+   if (!pending.empty() && !MergePending(target, pending, info))
+      status = kFALSE;
+#endif
    // save modifications to the target directory.
    if (!(type&kIncremental)) {
       // In case of incremental build, we will call Write on the top directory/file, so we do not need
@@ -408,7 +408,10 @@ TGenCollectionProxy::Value::Value(const std::string& inside_type, Bool_t silent)
 
             // R__ASSERT("FallBack, should be hardly used.");
 
-            TypeInfo_t *ti = gCling->TypeInfo_Factory();
+            // Only the interpreter knows the types which are neither fundamental
+            // nor classes, like typedefs: create it if it was deferred (see
+            // ROOT::EnableLazyInterpreter()), rather than taking them for enums.
+            TypeInfo_t *ti = gInterpreter->TypeInfo_Factory();
             gCling->TypeInfo_Init(ti,inside.c_str());
             if ( !gCling->TypeInfo_IsValid(ti) ) {
                if (intype != inside) {
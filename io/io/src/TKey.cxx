@@ -972,6 +972,126 @@ CLEAR:
    return tobj;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Uncompress the record of this key, as read from the file (fNbytes bytes
+/// starting at fSeekKey), into `target` (fKeylen+fObjlen bytes).
+///
+/// Only the record and `target` are accessed: several keys can be unzipped
+/// concurrently. Returns kFALSE if the record could not be uncompressed.
+
+Bool_t TKey::UnzipRecord(const char *record, char *target) const
+{
+   if (fObjlen <= fNbytes-fKeylen) {
+      memcpy(target, record, fKeylen+fObjlen);
+      return kTRUE;
+   }
+   memcpy(target, record, fKeylen);
+
+   char *objbuf = target + fKeylen;
+   UChar_t *bufcur = (UChar_t *)&record[fKeylen];
+   Int_t nin, nout = 0, nbuf;
+   Int_t noutot = 0;
+   while (1) {
+      Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
+      if (hc!=0) break;
+      R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
+      if (!nout) break;
+      noutot += nout;
+      if (noutot >= fObjlen) break;
+      bufcur += nin;
+      objbuf += nout;
+   }
+   return nout != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// To read a TObject* from the uncompressed record `unzipped`.
+///
+/// This function is identical to TKey::ReadObj, but the record of the key,
+/// header included, was already read and uncompressed by TKey::UnzipRecord.
+/// The buffer must hold fKeylen+fObjlen bytes, allocated with new[]: it is
+/// adopted and deleted by this function.
+///
+/// ### Note
+/// This function is called only internally by ROOT classes, see
+/// TDirectoryFile::ReadObjects.
+
+TObject *TKey::ReadObjWithUnzippedBuffer(char *unzipped)
+{
+   TClass *cl = TClass::GetClass(fClassName.Data());
+   if (!cl) {
+      Error("ReadObjWithUnzippedBuffer", "Unknown class %s", fClassName.Data());
+      delete [] unzipped;
+      return 0;
+   }
+   if (!cl->IsTObject()) {
+      delete [] unzipped;
+      // in principle user should call TKey::ReadObjectAny!
+      return (TObject*)ReadObjectAny(0);
+   }
+   if (GetFile()==0) {
+      delete [] unzipped;
+      return 0;
+   }
+
+   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen, unzipped, kTRUE);
+   fBufferRef->SetParent(GetFile());
+   fBufferRef->SetPidOffset(fPidOffset);
+
+   // get version of key
+   fBufferRef->SetBufferOffset(sizeof(fNbytes));
+   Version_t kvers = fBufferRef->ReadVersion();
+
+   fBufferRef->SetBufferOffset(fKeylen);
+   TObject *tobj = 0;
+   // Create an instance of this class
+
+   char *pobj = (char*)cl->New();
+   if (!pobj) {
+      Error("ReadObjWithUnzippedBuffer", "Cannot create new object of class %s", fClassName.Data());
+      delete fBufferRef;
+      fBufferRef = 0;
+      return 0;
+   }
+   Int_t baseOffset = cl->GetBaseClassOffset(TObject::Class());
+   if (baseOffset==-1) {
+      // cl does not inherit from TObject.
+      // Since this is not possible yet, the only reason we could reach this code
+      // is because something is screw up in the ROOT code.
+      Fatal("ReadObjWithUnzippedBuffer","Incorrect detection of the inheritance from TObject for class %s.\n",
+            fClassName.Data());
+   }
+   tobj = (TObject*)(pobj+baseOffset);
+   if (kvers > 1)
+      fBufferRef->MapObject(pobj,cl);  //register obj in map to handle self reference
+
+   tobj->Streamer(*fBufferRef);
+
+   if (gROOT->GetForceStyle()) tobj->UseCurrentStyle();
+
+   if (cl->InheritsFrom(TDirectoryFile::Class())) {
+      TDirectory *dir = static_cast<TDirectoryFile*>(tobj);
+      dir->SetName(GetName());
+      dir->SetTitle(GetTitle());
+      dir->SetMother(fMotherDir);
+      fMotherDir->Append(dir);
+   }
+
+   // Append the object to the directory if requested:
+   {
+      ROOT::DirAutoAdd_t addfunc = cl->GetDirectoryAutoAdd();
+      if (addfunc) {
+         addfunc(pobj, fMotherDir);
+      }
+   }
+
+   delete fBufferRef;
+   fBufferRef = 0;
+   fBuffer    = 0;
+
+   return tobj;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// To read an object (non deriving from TObject) from the file.
 ///
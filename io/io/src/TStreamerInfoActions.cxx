@@ -244,6 +244,166 @@ namespace TStreamerInfoActions
       return 0;
    }
 
+   class TConfFusedBasicTypes : public TConfiguration {
+      // Configuration of a run of consecutive basic type data members
+      // streamed by a single action (see TActionSequence::FuseBasicTypeActions).
+   public:
+      struct TMember {
+         Int_t fOffset;  // Offset of the data member within the object
+         Int_t fType;    // TStreamerInfo::EReadWrite type of the data member
+         Int_t fElemId;  // Identifier of the TStreamerElement
+      };
+      std::vector<TMember> fMembers;
+      Int_t fNbytes = 0; // Size of the members in the buffer
+
+      TConfFusedBasicTypes(const TConfiguration &first)
+         : TConfiguration(first.fInfo, first.fElemId, first.fCompInfo, first.fOffset) {}
+
+      void Add(Int_t offset, Int_t type, Int_t nbytes, UInt_t elemId)
+      {
+         fMembers.push_back({offset, type, (Int_t)elemId});
+         fNbytes += nbytes;
+      }
+
+      void AddToOffset(Int_t delta)
+      {
+         TConfiguration::AddToOffset(delta);
+         for (auto &member : fMembers) {
+            if (member.fOffset != TVirtualStreamerInfo::kMissing)
+               member.fOffset += delta;
+         }
+      }
+
+      void SetMissing()
+      {
+         TConfiguration::SetMissing();
+         for (auto &member : fMembers)
+            member.fOffset = TVirtualStreamerInfo::kMissing;
+      }
+
+      void Print() const
+      {
+         TStreamerInfo *info = (TStreamerInfo*)fInfo;
+         printf("StreamerInfoAction, class:%s, %zu fused basic type members, %d bytes:\n",
+                info->GetClass()->GetName(), fMembers.size(), fNbytes);
+         for (const auto &member : fMembers) {
+            TStreamerElement *aElement = (TStreamerElement*)info->GetElements()->At(member.fElemId);
+            printf("   name=%s, fType[%d]=%d, offset=%d\n", aElement ? aElement->GetName() : "?",
+                   member.fElemId, member.fType, member.fOffset);
+         }
+      }
+
+      void PrintDebug(TBuffer &buf, void *addr) const
+      {
+         if (gDebug > 1) {
+            TStreamerInfo *info = (TStreamerInfo*)fInfo;
+            printf("StreamerInfoAction, class:%s, %zu fused basic type members, bufpos=%d, arr=%p\n",
+                   info->GetClass()->GetName(), fMembers.size(), buf.Length(), addr);
+         }
+      }
+
+      virtual TConfiguration *Copy() { return new TConfFusedBasicTypes(*this); }
+   };
+
+   // Only the exact TBufferFile streams basic types with frombuf/tobuf;
+   // other buffers (TBufferText, TBufferSQL, TMessage...) may override them.
+   static inline Bool_t IsPlainBufferFile(TBuffer &buf)
+   {
+      return buf.IsA() == TBufferFile::Class();
+   }
+
+   Int_t ReadBasicTypesFused(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      const TConfFusedBasicTypes *conf = (const TConfFusedBasicTypes*)config;
+      char *obj = (char*)addr;
+      if (!IsPlainBufferFile(buf)) {
+         for (const auto &member : conf->fMembers) {
+            char *x = obj + member.fOffset;
+            switch (member.fType) {
+               case TStreamerInfo::kBool:    buf >> *(Bool_t*)x;    break;
+               case TStreamerInfo::kChar:    buf >> *(Char_t*)x;    break;
+               case TStreamerInfo::kShort:   buf >> *(Short_t*)x;   break;
+               case TStreamerInfo::kInt:     buf >> *(Int_t*)x;     break;
+               case TStreamerInfo::kLong64:  buf >> *(Long64_t*)x;  break;
+               case TStreamerInfo::kFloat:   buf >> *(Float_t*)x;   break;
+               case TStreamerInfo::kDouble:  buf >> *(Double_t*)x;  break;
+               case TStreamerInfo::kUChar:   buf >> *(UChar_t*)x;   break;
+               case TStreamerInfo::kUShort:  buf >> *(UShort_t*)x;  break;
+               case TStreamerInfo::kUInt:    buf >> *(UInt_t*)x;    break;
+               case TStreamerInfo::kULong64: buf >> *(ULong64_t*)x; break;
+            }
+         }
+         return 0;
+      }
+      // Straight-line copy (and byte swap) from the buffer, without any virtual call.
+      char *cur = buf.Buffer() + buf.Length();
+      for (const auto &member : conf->fMembers) {
+         char *x = obj + member.fOffset;
+         switch (member.fType) {
+            case TStreamerInfo::kBool:    frombuf(cur, (Bool_t*)x);    break;
+            case TStreamerInfo::kChar:    frombuf(cur, (Char_t*)x);    break;
+            case TStreamerInfo::kShort:   frombuf(cur, (Short_t*)x);   break;
+            case TStreamerInfo::kInt:     frombuf(cur, (Int_t*)x);     break;
+            case TStreamerInfo::kLong64:  frombuf(cur, (Long64_t*)x);  break;
+            case TStreamerInfo::kFloat:   frombuf(cur, (Float_t*)x);   break;
+            case TStreamerInfo::kDouble:  frombuf(cur, (Double_t*)x);  break;
+            case TStreamerInfo::kUChar:   frombuf(cur, (UChar_t*)x);   break;
+            case TStreamerInfo::kUShort:  frombuf(cur, (UShort_t*)x);  break;
+            case TStreamerInfo::kUInt:    frombuf(cur, (UInt_t*)x);    break;
+            case TStreamerInfo::kULong64: frombuf(cur, (ULong64_t*)x); break;
+         }
+      }
+      buf.SetBufferOffset(cur - buf.Buffer());
+      return 0;
+   }
+
+   Int_t WriteBasicTypesFused(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      const TConfFusedBasicTypes *conf = (const TConfFusedBasicTypes*)config;
+      char *obj = (char*)addr;
+      if (!IsPlainBufferFile(buf)) {
+         for (const auto &member : conf->fMembers) {
+            char *x = obj + member.fOffset;
+            switch (member.fType) {
+               case TStreamerInfo::kBool:    buf << *(Bool_t*)x;    break;
+               case TStreamerInfo::kChar:    buf << *(Char_t*)x;    break;
+               case TStreamerInfo::kShort:   buf << *(Short_t*)x;   break;
+               case TStreamerInfo::kInt:     buf << *(Int_t*)x;     break;
+               case TStreamerInfo::kLong64:  buf << *(Long64_t*)x;  break;
+               case TStreamerInfo::kFloat:   buf << *(Float_t*)x;   break;
+               case TStreamerInfo::kDouble:  buf << *(Double_t*)x;  break;
+               case TStreamerInfo::kUChar:   buf << *(UChar_t*)x;   break;
+               case TStreamerInfo::kUShort:  buf << *(UShort_t*)x;  break;
+               case TStreamerInfo::kUInt:    buf << *(UInt_t*)x;    break;
+               case TStreamerInfo::kULong64: buf << *(ULong64_t*)x; break;
+            }
+         }
+         return 0;
+      }
+      // Expand the buffer once for all the members, then copy without any virtual call.
+      if (buf.Length() + conf->fNbytes > buf.BufferSize())
+         buf.AutoExpand(buf.Length() + conf->fNbytes);
+      char *cur = buf.Buffer() + buf.Length();
+      for (const auto &member : conf->fMembers) {
+         char *x = obj + member.fOffset;
+         switch (member.fType) {
+            case TStreamerInfo::kBool:    tobuf(cur, *(Bool_t*)x);    break;
+            case TStreamerInfo::kChar:    tobuf(cur, *(Char_t*)x);    break;
+            case TStreamerInfo::kShort:   tobuf(cur, *(Short_t*)x);   break;
+            case TStreamerInfo::kInt:     tobuf(cur, *(Int_t*)x);     break;
+            case TStreamerInfo::kLong64:  tobuf(cur, *(Long64_t*)x);  break;
+            case TStreamerInfo::kFloat:   tobuf(cur, *(Float_t*)x);   break;
+            case TStreamerInfo::kDouble:  tobuf(cur, *(Double_t*)x);  break;
+            case TStreamerInfo::kUChar:   tobuf(cur, *(UChar_t*)x);   break;
+            case TStreamerInfo::kUShort:  tobuf(cur, *(UShort_t*)x);  break;
+            case TStreamerInfo::kUInt:    tobuf(cur, *(UInt_t*)x);    break;
+            case TStreamerInfo::kULong64: tobuf(cur, *(ULong64_t*)x); break;
+         }
+      }
+      buf.SetBufferOffset(cur - buf.Buffer());
+      return 0;
+   }
+
    INLINE_TEMPLATE_ARGS Int_t WriteTextTNamed(TBuffer &buf, void *addr, const TConfiguration *config)
    {
       void *x = (void *)(((char *)addr) + config->fOffset);
@@ -1681,14 +1841,47 @@ namespace TStreamerInfoActions
       }
    }
 
+   // Whether frombuf/tobuf stream T exactly as TBufferFile does. Long_t and
+   // ULong_t are excluded since their on-file size depends on the file version.
+   template <typename T> struct TIsBulkStreamable { static const Bool_t kValue = kFALSE; };
+   template <> struct TIsBulkStreamable<Bool_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Char_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Short_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Int_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Long64_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Float_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<Double_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<UChar_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<UShort_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<UInt_t> { static const Bool_t kValue = kTRUE; };
+   template <> struct TIsBulkStreamable<ULong64_t> { static const Bool_t kValue = kTRUE; };
+
    struct VectorLooper {
 
+      // In a member-wise streamed vector of structs, the values of one data
+      // member for all the elements are contiguous in the buffer: they are
+      // read (written) as one block, with a stride in memory.
+
       template <typename T>
       static INLINE_TEMPLATE_ARGS Int_t ReadBasicType(TBuffer &buf, void *iter, const void *end, const TLoopConfiguration *loopconfig, const TConfiguration *config)
       {
          const Int_t incr = ((TVectorLoopConfig*)loopconfig)->fIncrement;
          iter = (char*)iter + config->fOffset;
          end = (char*)end + config->fOffset;
+         const Bool_t plain = IsPlainBufferFile(buf);
+         if (plain && incr == sizeof(T)) {
+            // The values are also contiguous in memory.
+            buf.ReadFastArray((T*)iter, (Int_t)(((char*)end - (char*)iter) / incr));
+            return 0;
+         }
+         if (plain && TIsBulkStreamable<T>::kValue) {
+            char *cur = buf.Buffer() + buf.Length();
+            for(; iter != end; iter = (char*)iter + incr ) {
+               frombuf(cur, (T*)iter);
+            }
+            buf.SetBufferOffset(cur - buf.Buffer());
+            return 0;
+         }
          for(; iter != end; iter = (char*)iter + incr ) {
             T *x = (T*) ((char*) iter);
             buf >> *x;
@@ -1777,6 +1970,23 @@ namespace TStreamerInfoActions
          const Int_t incr = ((TVectorLoopConfig*)loopconfig)->fIncrement;
          iter = (char*)iter + config->fOffset;
          end = (char*)end + config->fOffset;
+         const Int_t n = (Int_t)(((char*)end - (char*)iter) / incr);
+         const Bool_t plain = IsPlainBufferFile(buf);
+         if (plain && incr == sizeof(T)) {
+            buf.WriteFastArray((T*)iter, n);
+            return 0;
+         }
+         if (plain && TIsBulkStreamable<T>::kValue) {
+            const Int_t nbytes = n * sizeof(T);
+            if (buf.Length() + nbytes > buf.BufferSize())
+               buf.AutoExpand(buf.Length() + nbytes);
+            char *cur = buf.Buffer() + buf.Length();
+            for(; iter != end; iter = (char*)iter + incr ) {
+               tobuf(cur, *(T*)iter);
+            }
+            buf.SetBufferOffset(cur - buf.Buffer());
+            return 0;
+         }
          for(; iter != end; iter = (char*)iter + incr ) {
             T *x = (T*) ((char*) iter);
             buf << *x;
@@ -3191,6 +3401,12 @@ void TStreamerInfo::Compile()
       AddReadTextAction(fReadText, i, fCompFull[i]);
       AddWriteTextAction(fWriteText, i, fCompFull[i]);
    }
+   // The object-wise sequences are only ever applied as a whole (e.g. by
+   // TBufferFile::ReadClassBuffer), so their basic type members can be fused.
+   if (!TestBit(kCannotOptimize)) {
+      fReadObjectWise->FuseBasicTypeActions(kTRUE);
+      fWriteObjectWise->FuseBasicTypeActions(kFALSE);
+   }
    ComputeSize();
 
    fOptimized = isOptimized;
@@ -4154,6 +4370,152 @@ TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::Cr
       return sequence;
 }
 
+namespace {
+   /// Size in the buffer of the basic types which TConfFusedBasicTypes streams, 0 for the others.
+   /// Long_t and ULong_t are excluded since their on-file size depends on the file version.
+   Int_t FusableSize(Int_t type)
+   {
+      switch (type) {
+         case TStreamerInfo::kBool:    return sizeof(Bool_t);
+         case TStreamerInfo::kChar:    return sizeof(Char_t);
+         case TStreamerInfo::kShort:   return sizeof(Short_t);
+         case TStreamerInfo::kInt:     return sizeof(Int_t);
+         case TStreamerInfo::kLong64:  return sizeof(Long64_t);
+         case TStreamerInfo::kFloat:   return sizeof(Float_t);
+         case TStreamerInfo::kDouble:  return sizeof(Double_t);
+         case TStreamerInfo::kUChar:   return sizeof(UChar_t);
+         case TStreamerInfo::kUShort:  return sizeof(UShort_t);
+         case TStreamerInfo::kUInt:    return sizeof(UInt_t);
+         case TStreamerInfo::kULong64: return sizeof(ULong64_t);
+         default: return 0;
+      }
+   }
+
+   template <Bool_t kRead>
+   struct TFusableActions;
+
+   template <>
+   struct TFusableActions<kTRUE> {
+      static Int_t GetType(TStreamerInfoAction_t action)
+      {
+         if (action == ReadBasicType<Bool_t>)    return TStreamerInfo::kBool;
+         if (action == ReadBasicType<Char_t>)    return TStreamerInfo::kChar;
+         if (action == ReadBasicType<Short_t>)   return TStreamerInfo::kShort;
+         if (action == ReadBasicType<Int_t>)     return TStreamerInfo::kInt;
+         if (action == ReadBasicType<Long64_t>)  return TStreamerInfo::kLong64;
+         if (action == ReadBasicType<Float_t>)   return TStreamerInfo::kFloat;
+         if (action == ReadBasicType<Double_t>)  return TStreamerInfo::kDouble;
+         if (action == ReadBasicType<UChar_t>)   return TStreamerInfo::kUChar;
+         if (action == ReadBasicType<UShort_t>)  return TStreamerInfo::kUShort;
+         if (action == ReadBasicType<UInt_t>)    return TStreamerInfo::kUInt;
+         if (action == ReadBasicType<ULong64_t>) return TStreamerInfo::kULong64;
+         return -1;
+      }
+      static TStreamerInfoAction_t Generic() { return GenericReadAction; }
+      static TStreamerInfoAction_t Fused() { return ReadBasicTypesFused; }
+   };
+
+   template <>
+   struct TFusableActions<kFALSE> {
+      static Int_t GetType(TStreamerInfoAction_t action)
+      {
+         if (action == WriteBasicType<Bool_t>)    return TStreamerInfo::kBool;
+         if (action == WriteBasicType<Char_t>)    return TStreamerInfo::kChar;
+         if (action == WriteBasicType<Short_t>)   return TStreamerInfo::kShort;
+         if (action == WriteBasicType<Int_t>)     return TStreamerInfo::kInt;
+         if (action == WriteBasicType<Long64_t>)  return TStreamerInfo::kLong64;
+         if (action == WriteBasicType<Float_t>)   return TStreamerInfo::kFloat;
+         if (action == WriteBasicType<Double_t>)  return TStreamerInfo::kDouble;
+         if (action == WriteBasicType<UChar_t>)   return TStreamerInfo::kUChar;
+         if (action == WriteBasicType<UShort_t>)  return TStreamerInfo::kUShort;
+         if (action == WriteBasicType<UInt_t>)    return TStreamerInfo::kUInt;
+         if (action == WriteBasicType<ULong64_t>) return TStreamerInfo::kULong64;
+         return -1;
+      }
+      static TStreamerInfoAction_t Generic() { return GenericWriteAction; }
+      static TStreamerInfoAction_t Fused() { return WriteBasicTypesFused; }
+   };
+
+   /// Add to conf the members streamed by action, if it can be fused. Besides
+   /// the actions for a single basic type, this includes the generic actions
+   /// for the fixed-size arrays of a basic type (kOffsetL + type) and for the
+   /// consecutive members of the same basic type regrouped by
+   /// TStreamerInfo::Compile (kRegrouped + type, the same encoding). Each
+   /// element of such an array or run is added as a member.
+   template <Bool_t kRead>
+   Bool_t AddFusable(const TConfiguredAction &action, TConfFusedBasicTypes *conf)
+   {
+      const TConfiguration *config = action.fConfiguration;
+      Int_t type = TFusableActions<kRead>::GetType(action.fAction);
+      if (type >= 0) {
+         if (conf)
+            conf->Add(config->fOffset, type, FusableSize(type), config->fElemId);
+         return kTRUE;
+      }
+      if (action.fAction != TFusableActions<kRead>::Generic() || !config->fCompInfo)
+         return kFALSE;
+      static_assert(kRegrouped == TStreamerInfo::kOffsetL, "regrouped members are streamed as fixed-size arrays");
+      type = config->fCompInfo->fType - TStreamerInfo::kOffsetL;
+      const Int_t size = (type > 0 && type < TStreamerInfo::kObject) ? FusableSize(type) : 0;
+      // Long arrays are better served by ReadFastArray/WriteFastArray.
+      const Int_t kMaxFusedLength = 64;
+      if (size == 0 || config->fCompInfo->fLength <= 0 || config->fCompInfo->fLength > kMaxFusedLength ||
+          config->fOffset == TVirtualStreamerInfo::kMissing)
+         return kFALSE;
+      if (conf) {
+         const Int_t offset = config->fOffset + config->fCompInfo->fOffset;
+         for (Int_t k = 0; k < config->fCompInfo->fLength; ++k)
+            conf->Add(offset + k * size, type, size, config->fElemId);
+      }
+      return kTRUE;
+   }
+
+   template <Bool_t kRead>
+   void FuseBasicTypeActionsImpl(ActionContainer_t &actions)
+   {
+      ActionContainer_t fused;
+      fused.reserve(actions.size());
+      for (size_t i = 0; i < actions.size();) {
+         size_t end = i;
+         Int_t nmembers = 0;
+         while (end < actions.size() && AddFusable<kRead>(actions[end], nullptr)) {
+            const TConfiguration *config = actions[end].fConfiguration;
+            nmembers += (actions[end].fAction == TFusableActions<kRead>::Generic()) ? config->fCompInfo->fLength : 1;
+            ++end;
+         }
+         if (nmembers < 2) {
+            fused.push_back(actions[i]); // This moves the configuration.
+            ++i;
+            continue;
+         }
+         TConfFusedBasicTypes *conf = new TConfFusedBasicTypes(*actions[i].fConfiguration);
+         for (; i < end; ++i)
+            AddFusable<kRead>(actions[i], conf);
+         fused.push_back(TConfiguredAction(TFusableActions<kRead>::Fused(), conf));
+      }
+      actions.swap(fused);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Replace each run of two or more consecutive basic type actions (e.g. the
+/// data members of a small struct) by a single action streaming all of them,
+/// straight from/to the buffer of a TBufferFile, without one dispatch and one
+/// virtual TBuffer call per data member.
+/// The sequence must be object-wise (no loop configuration). After fusion, the
+/// actions no longer correspond one to one to the streamer elements, so this
+/// must not be applied to a sequence used to create sub-sequences.
+
+void TStreamerInfoActions::TActionSequence::FuseBasicTypeActions(Bool_t read)
+{
+   if (fLoopConfig)
+      return;
+   if (read)
+      FuseBasicTypeActionsImpl<kTRUE>(fActions);
+   else
+      FuseBasicTypeActionsImpl<kFALSE>(fActions);
+}
+
 void TStreamerInfoActions::TActionSequence::AddToOffset(Int_t delta)
 {
    // Add the (potentially negative) delta to all the configuration's offset.  This is used by
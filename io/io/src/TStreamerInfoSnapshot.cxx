@@ -0,0 +1,287 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TStreamerInfoSnapshot.hxx"
+
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TError.h"
+#include "TInterpreter.h"
+#include "TObjArray.h"
+#include "TROOT.h"
+#include "TStreamerElement.h"
+#include "TStreamerInfo.h"
+#include "TVirtualCollectionProxy.h"
+#include "TVirtualMutex.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <iterator>
+#include <set>
+
+namespace {
+
+const UInt_t kSnapshotMagic = 0x52534e50; // "RSNP"
+const Int_t kSnapshotFormat = 2;
+/// Number of Int_t stored per streamer element: offset, new type and bits.
+const Int_t kElementRecord = 3;
+
+/// Content of a snapshot file, mapped in memory when the platform allows it.
+class TSnapshotData {
+private:
+   char *fData = nullptr;
+   size_t fSize = 0;
+   Bool_t fMapped = kFALSE;
+   std::vector<char> fCopy;
+
+public:
+   explicit TSnapshotData(const char *filename)
+   {
+#ifndef WIN32
+      int fd = open(filename, O_RDONLY);
+      if (fd >= 0) {
+         struct stat st;
+         if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            // Private mapping: the buffer may write to its pages, never to the file.
+            void *addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+               fData = static_cast<char *>(addr);
+               fSize = st.st_size;
+               fMapped = kTRUE;
+            }
+         }
+         close(fd);
+      }
+#endif
+      if (!fMapped) {
+         std::ifstream in(filename, std::ios::binary);
+         if (in)
+            fCopy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+         fData = fCopy.empty() ? nullptr : fCopy.data();
+         fSize = fCopy.size();
+      }
+   }
+
+   ~TSnapshotData()
+   {
+#ifndef WIN32
+      if (fMapped)
+         munmap(fData, fSize);
+#endif
+   }
+
+   TSnapshotData(const TSnapshotData &) = delete;
+   TSnapshotData &operator=(const TSnapshotData &) = delete;
+
+   char *GetData() const { return fData; }
+   size_t GetSize() const { return fSize; }
+};
+
+/// Whether the built TStreamerInfo can be restored from its streamed elements,
+/// their offsets and bits alone.
+Bool_t IsSnapshotable(TStreamerInfo *info)
+{
+   TIter next(info->GetElements());
+   while (auto element = static_cast<TStreamerElement *>(next())) {
+      // Artificial and cached elements come from schema rules, and custom member
+      // streamers are attached by the dictionary: none of them is streamed.
+      if (element->IsA() == TStreamerArtificial::Class() || element->TestBit(TStreamerElement::kCache) ||
+          element->TestBit(TStreamerElement::kRepeat) || element->GetStreamer())
+         return kFALSE;
+   }
+   return kTRUE;
+}
+
+/// Append to `infos` the TStreamerInfos needed to stream `cl`, the ones of the
+/// classes it streams coming first.
+void Collect(TClass *cl, std::set<TClass *> &visited, std::vector<TStreamerInfo *> &infos)
+{
+   if (!cl || !visited.insert(cl).second)
+      return;
+   if (TVirtualCollectionProxy *proxy = cl->GetCollectionProxy()) {
+      // Collections are streamed by their proxy, only their content has a TStreamerInfo.
+      Collect(proxy->GetValueClass(), visited, infos);
+      return;
+   }
+   if (!cl->IsLoaded() || cl->GetClassVersion() <= 0)
+      return;
+
+   auto info = static_cast<TStreamerInfo *>(cl->GetStreamerInfo());
+   if (!info || !info->IsCompiled())
+      return;
+   TIter next(info->GetElements());
+   while (auto element = static_cast<TStreamerElement *>(next()))
+      Collect(element->GetClassPointer(), visited, infos);
+
+   if (!IsSnapshotable(info)) {
+      Warning("TStreamerInfoSnapshot::Write", "the TStreamerInfo of %s depends on schema rules or custom streamers, "
+              "it is not written to the snapshot", cl->GetName());
+      return;
+   }
+   infos.push_back(info);
+}
+
+} // namespace
+
+namespace ROOT {
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write to `filename` the TStreamerInfos of `classes` and of all the classes
+/// they stream. Returns the number of TStreamerInfos written, -1 in case of error.
+
+Int_t TStreamerInfoSnapshot::Write(const char *filename, const std::vector<std::string> &classes)
+{
+   std::set<TClass *> visited;
+   std::vector<TStreamerInfo *> infos;
+   for (const auto &name : classes) {
+      TClass *cl = TClass::GetClass(name.c_str());
+      if (!cl) {
+         Error("TStreamerInfoSnapshot::Write", "unknown class %s", name.c_str());
+         return -1;
+      }
+      Collect(cl, visited, infos);
+   }
+
+   TBufferFile buf(TBuffer::kWrite);
+   buf << kSnapshotMagic;
+   buf << kSnapshotFormat;
+   buf << (Int_t)gROOT->GetVersionCode();
+   buf << (Int_t)infos.size();
+   for (auto info : infos) {
+      buf.WriteObjectAny(info, TStreamerInfo::Class());
+      TObjArray *elements = info->GetElements();
+      const Int_t nelements = elements->GetEntriesFast();
+      buf << info->GetClass()->Size();
+      buf << info->GetCheckSum();
+      buf << nelements;
+      for (Int_t i = 0; i < nelements; ++i) {
+         auto element = static_cast<TStreamerElement *>(elements->UncheckedAt(i));
+         buf << element->GetOffset();
+         buf << element->GetNewType();
+         buf << (Int_t)element->TestBits(TObject::kBitMask);
+      }
+   }
+
+   std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+   if (!out.write(buf.Buffer(), buf.Length())) {
+      Error("TStreamerInfoSnapshot::Write", "cannot write the snapshot %s", filename);
+      return -1;
+   }
+   return infos.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Install the TStreamerInfos of the snapshot `filename` as the current ones of
+/// their classes. Returns the number of TStreamerInfos installed, -1 if the file
+/// is not a snapshot written by this version of ROOT.
+
+Int_t TStreamerInfoSnapshot::Load(const char *filename)
+{
+   TSnapshotData data(filename);
+   if (!data.GetData()) {
+      Error("TStreamerInfoSnapshot::Load", "cannot read the snapshot %s", filename);
+      return -1;
+   }
+
+   TBufferFile buf(TBuffer::kRead, data.GetSize(), data.GetData(), kFALSE);
+   UInt_t magic = 0;
+   Int_t format = 0, version = 0, ninfos = 0;
+   buf >> magic;
+   buf >> format;
+   buf >> version;
+   buf >> ninfos;
+   if (magic != kSnapshotMagic || format != kSnapshotFormat) {
+      Error("TStreamerInfoSnapshot::Load", "%s is not a TStreamerInfo snapshot", filename);
+      return -1;
+   }
+   if (version != gROOT->GetVersionCode()) {
+      Error("TStreamerInfoSnapshot::Load", "the snapshot %s was written by another version of ROOT", filename);
+      return -1;
+   }
+
+   R__LOCKGUARD(gInterpreterMutex);
+   Int_t ninstalled = 0;
+   std::vector<Int_t> elements;
+   for (Int_t i = 0; i < ninfos; ++i) {
+      auto info = static_cast<TStreamerInfo *>(buf.ReadObjectAny(TStreamerInfo::Class()));
+      Int_t size = 0, nelements = 0;
+      UInt_t checksum = 0;
+      buf >> size;
+      buf >> checksum;
+      buf >> nelements;
+      if (!info || nelements < 0 || buf.Length() + nelements * kElementRecord * (Int_t)sizeof(Int_t) > buf.BufferSize()) {
+         Error("TStreamerInfoSnapshot::Load", "the snapshot %s is corrupted", filename);
+         delete info;
+         break;
+      }
+      elements.resize(nelements * kElementRecord);
+      for (auto &value : elements)
+         buf >> value;
+      if (Install(info, size, checksum, elements))
+         ++ninstalled;
+      else
+         delete info;
+   }
+   return ninstalled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make `info`, read from a snapshot, the current TStreamerInfo of its class,
+/// as TStreamerInfo::Build() would have: restore what is not streamed
+/// (offsets, types in memory, bits) and compile it. The class must have the
+/// version, size and checksum it had when the snapshot was written: members
+/// reordered or retyped without a version change only show in the checksum.
+
+Bool_t TStreamerInfoSnapshot::Install(TStreamerInfo *info, Int_t size, UInt_t checksum,
+                                      const std::vector<Int_t> &elements)
+{
+   TClass *cl = TClass::GetClass(info->GetName());
+   if (!cl || !cl->IsLoaded())
+      return kFALSE;
+   if (cl->GetClassVersion() != info->GetClassVersion() || cl->Size() != size || cl->GetCheckSum() != checksum) {
+      Warning("TStreamerInfoSnapshot::Load", "the layout of %s changed since the snapshot was written, ignoring it",
+              info->GetName());
+      return kFALSE;
+   }
+   // A TStreamerInfo built or read from a file before takes precedence.
+   if (cl->GetStreamerInfos()->At(info->GetClassVersion()))
+      return kFALSE;
+
+   TObjArray *infoElements = info->GetElements();
+   const Int_t nelements = infoElements->GetEntriesFast();
+   if ((Int_t)elements.size() != nelements * kElementRecord)
+      return kFALSE;
+
+   info->fClass = cl;
+   for (Int_t i = 0; i < nelements; ++i) {
+      auto element = static_cast<TStreamerElement *>(infoElements->UncheckedAt(i));
+      element->SetOffset(elements[i * kElementRecord]);
+      element->SetNewType(elements[i * kElementRecord + 1]);
+      element->SetBit(elements[i * kElementRecord + 2]);
+      element->Init(info);
+   }
+
+   cl->RegisterStreamerInfo(info);
+   info->fNumber = ++TStreamerInfo::fgCount;
+   static_cast<TObjArray *>(gROOT->GetListOfStreamerInfo())->AddAtAndExpand(info, info->fNumber);
+   info->fIsBuilt = kTRUE;
+   info->Compile();
+   return kTRUE;
+}
+
+} // namespace Experimental
+} // namespace ROOT
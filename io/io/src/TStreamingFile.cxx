@@ -0,0 +1,480 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TStreamingFile.hxx"
+
+#include "Bytes.h"
+#include "TClass.h"
+#include "TError.h"
+#include "TFree.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TVirtualMutex.h"
+
+#include <fcntl.h>
+#ifdef WIN32
+#include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/// Whether TFile would create the file for this option (only those options write).
+bool IsCreateOption(Option_t *option)
+{
+   TString opt = option;
+   opt.ToUpper();
+   return opt == "NEW" || opt == "CREATE" || opt == "RECREATE";
+}
+
+/// Number of bytes used by TString::FillBuffer for a string of `len` characters.
+UInt_t StringBufferSize(UInt_t len)
+{
+   return len < 255 ? len + 1 : len + 5;
+}
+
+struct TKeyHeader {
+   char *fBegin;
+   UInt_t fSize;
+   const char *fName;
+   UInt_t fNameLen;
+   Short_t fCycle;
+   Long64_t fSeekKey;
+};
+
+/// Offset of the cycle number in a key header, see TKey::FillBuffer.
+const Int_t kCycleOffset = sizeof(Int_t) + sizeof(Version_t) + sizeof(Int_t) + sizeof(UInt_t) + sizeof(Short_t);
+
+/// Order by name, then by decreasing cycle, as TDirectoryFile::AppendKey does.
+bool CompareNameCycle(const char *name1, UInt_t len1, Short_t cycle1, const char *name2, UInt_t len2, Short_t cycle2)
+{
+   const int cmp = std::memcmp(name1, name2, std::min(len1, len2));
+   if (cmp)
+      return cmp < 0;
+   if (len1 != len2)
+      return len1 < len2;
+   return cycle1 > cycle2;
+}
+
+/// Decode the key header at `buffer` with `scratch` and return its location.
+TKeyHeader DecodeKeyHeader(TKey &scratch, char *&buffer)
+{
+   TKeyHeader header;
+   header.fBegin = buffer;
+   scratch.ReadKeyBuffer(buffer);
+   header.fSize = buffer - header.fBegin;
+   header.fNameLen = std::strlen(scratch.GetName());
+   header.fName = buffer - StringBufferSize(std::strlen(scratch.GetTitle())) - header.fNameLen;
+   header.fCycle = scratch.GetCycle();
+   header.fSeekKey = scratch.GetSeekKey();
+   return header;
+}
+
+} // namespace
+
+namespace ROOT {
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create (options "NEW", "CREATE" or "RECREATE") or open for reading (any
+/// other option) the file `name`. Updating an existing file is not supported.
+
+TStreamingFile::TStreamingFile(const char *name, Option_t *option, const char *title, Int_t compress)
+   : TFile(name, IsCreateOption(option) ? option : "WEB", title, compress)
+{
+   if (IsCreateOption(option))
+      return;
+
+   TString opt = option;
+   opt.ToUpper();
+   if (opt == "UPDATE") {
+      Error("TStreamingFile", "file %s can only be created or read, not updated", GetName());
+      goto zombie;
+   }
+
+   {
+      // Open the file here rather than in the TFile constructor, so that Init()
+      // builds the list of keys with our ReadKeys().
+      TString fname = GetName();
+      if (gSystem->ExpandPathName(fname) || gSystem->AccessPathName(fname, kReadPermission)) {
+         Error("TStreamingFile", "file %s does not exist or can not be read", GetName());
+         goto zombie;
+      }
+      SetName(fname);
+      fRealName = fname;
+#ifndef WIN32
+      fD = SysOpen(fname, O_RDONLY, 0644);
+#else
+      fD = SysOpen(fname, O_RDONLY | O_BINARY, S_IREAD | S_IWRITE);
+#endif
+      if (fD == -1) {
+         SysError("TStreamingFile", "file %s can not be opened for reading", fname.Data());
+         goto zombie;
+      }
+      Init(kFALSE);
+      return;
+   }
+
+zombie:
+   {
+      R__LOCKGUARD(gROOTMutex);
+      gROOT->GetListOfClosedObjects()->Add(this);
+   }
+   MakeZombie();
+   gDirectory = gROOT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor, writes the index block if the file is being written.
+
+TStreamingFile::~TStreamingFile()
+{
+   Close();
+   if (fSpill)
+      std::fclose(fSpill);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Attribute a cycle number to a new key. When writing, the key is given cycle 1:
+/// the keys written several times with the same name are numbered by WriteKeys(),
+/// when the file is closed, so that no table of the names is kept in memory.
+
+Int_t TStreamingFile::AppendKey(TKey *key)
+{
+   if (!IsWritable())
+      return TFile::AppendKey(key);
+
+   fModified = kTRUE;
+   key->SetMotherDir(this);
+   // Keep the key in fKeys until it is written, see RetireKeys().
+   fKeys->Add(key);
+   return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Close the file; when writing, this is where the index block is written.
+
+void TStreamingFile::Close(Option_t *option)
+{
+   if (IsOpen() && IsWritable())
+      fWriteIndex = kTRUE;
+
+   TFile::Close(option);
+
+   // TDirectoryFile::Close deleted the keys.
+   fWriteIndex = kFALSE;
+   fKeyCache.clear();
+   fAllKeysRead = kFALSE;
+   std::vector<TIndexEntry>().swap(fEntries);
+   std::vector<char>().swap(fIndex);
+   fNIndexedKeys = 0;
+   if (fSpill) {
+      std::fclose(fSpill);
+      fSpill = nullptr;
+      fSpilledBytes = 0;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with the highest cycle not above `cycle`. When reading, the
+/// key is found by binary search in the index and created on first use; when
+/// writing, the keys already written can not be retrieved.
+
+TKey *TStreamingFile::GetKey(const char *name, Short_t cycle) const
+{
+   if (IsWritable() || fEntries.empty())
+      return TFile::GetKey(name, cycle);
+
+   const UInt_t len = std::strlen(name);
+   auto it = std::lower_bound(fEntries.begin(), fEntries.end(), name, [&](const TIndexEntry &e, const char *n) {
+      return CompareNameCycle(&fIndex[e.fName], e.fNameLen, e.fCycle, n, len, std::numeric_limits<Short_t>::max());
+   });
+   for (; it != fEntries.end() && it->fNameLen == len && !std::memcmp(&fIndex[it->fName], name, len); ++it) {
+      if (cycle == 9999 || cycle >= it->fCycle)
+         return const_cast<TStreamingFile *>(this)->MakeKey(it - fEntries.begin());
+   }
+   return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// When reading, create the keys of all the objects of the file (in the order
+/// of the file), which costs as much memory as a TFile does. When writing,
+/// only the keys not yet written are listed.
+
+TList *TStreamingFile::GetListOfKeys() const
+{
+   if (IsWritable() || fAllKeysRead || fEntries.empty())
+      return fKeys;
+
+   TStreamingFile *self = const_cast<TStreamingFile *>(this);
+   std::vector<UInt_t> order(fEntries.size());
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(),
+             [&](UInt_t a, UInt_t b) { return fEntries[a].fHeader < fEntries[b].fHeader; });
+   fKeys->Clear();
+   for (UInt_t entry : order) {
+      auto cached = fKeyCache.find(entry);
+      if (cached != fKeyCache.end())
+         fKeys->Add(cached->second);
+      else
+         self->MakeKey(entry);
+   }
+   self->fAllKeysRead = kTRUE;
+   return fKeys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of keys of the directory, including the ones not created yet.
+
+Int_t TStreamingFile::GetNkeys() const
+{
+   return fNIndexedKeys + fKeys->GetSize() - fKeyCache.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the key of an index entry (once) and add it to the list of keys.
+
+TKey *TStreamingFile::MakeKey(UInt_t entry)
+{
+   auto cached = fKeyCache.find(entry);
+   if (cached != fKeyCache.end())
+      return cached->second;
+
+   TKey *key = new TKey(this);
+   char *buffer = &fIndex[fEntries[entry].fHeader];
+   key->ReadKeyBuffer(buffer);
+   fKeys->Add(key);
+   fKeyCache[entry] = key;
+   return key;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Subdirectories are not supported when writing.
+
+TDirectory *TStreamingFile::mkdir(const char *name, const char *title)
+{
+   if (IsWritable()) {
+      Error("mkdir", "cannot create %s: subdirectories are not supported by append-only files", name);
+      return nullptr;
+   }
+   return TFile::mkdir(name, title);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the list of keys of the file into the compact sorted index.
+
+Int_t TStreamingFile::ReadKeys(Bool_t forceRead)
+{
+   if (IsWritable() || !IsBinary())
+      return TFile::ReadKeys(forceRead);
+
+   fKeys->Delete();
+   fKeyCache.clear();
+   fEntries.clear();
+   fIndex.clear();
+   fAllKeysRead = kFALSE;
+   fNIndexedKeys = 0;
+   if (fSeekKeys <= 0)
+      return 0;
+
+   TKey headerkey(fSeekKeys, fNbytesKeys, this);
+   if (!headerkey.ReadFile()) {
+      Error("ReadKeys", "cannot read the list of keys of %s", GetName());
+      return 0;
+   }
+   char *buffer = headerkey.GetBuffer();
+   char *end = buffer + fNbytesKeys;
+   headerkey.ReadKeyBuffer(buffer);
+   Int_t nkeys = 0;
+   frombuf(buffer, &nkeys);
+   fIndex.assign(buffer, end);
+   headerkey.DeleteBuffer();
+
+   TKey scratch(this);
+   const Long64_t fsize = GetSize();
+   char *begin = fIndex.data();
+   buffer = begin;
+   fEntries.reserve(nkeys);
+   for (Int_t i = 0; i < nkeys; ++i) {
+      const TKeyHeader header = DecodeKeyHeader(scratch, buffer);
+      if (buffer > begin + fIndex.size() || scratch.GetSeekKey() < 64 || scratch.GetSeekKey() > fsize ||
+          scratch.GetSeekPdir() < 64 || scratch.GetSeekPdir() > fsize) {
+         Error("ReadKeys", "reading illegal key, exiting after %d keys", i);
+         break;
+      }
+      fEntries.push_back({UInt_t(header.fBegin - begin), UInt_t(header.fName - begin), header.fNameLen, header.fCycle});
+   }
+   std::sort(fEntries.begin(), fEntries.end(), [&](const TIndexEntry &a, const TIndexEntry &b) {
+      return CompareNameCycle(&fIndex[a.fName], a.fNameLen, a.fCycle, &fIndex[b.fName], b.fNameLen, b.fCycle);
+   });
+   fNIndexedKeys = fEntries.size();
+   return fNIndexedKeys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Serialize the headers of the keys that have been written and delete the keys.
+
+void TStreamingFile::RetireKeys()
+{
+   TIter next(fKeys);
+   TKey *key;
+   while ((key = (TKey *)next())) {
+      const size_t pos = fIndex.size();
+      fIndex.resize(pos + key->Sizeof());
+      char *buffer = &fIndex[pos];
+      key->FillBuffer(buffer);
+      ++fNIndexedKeys;
+   }
+   fKeys->Delete();
+   if (fIndex.size() > fMaxIndexMemory)
+      SpillIndex();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Move the key headers held in memory to the temporary spill file.
+
+void TStreamingFile::SpillIndex()
+{
+   if (!fSpill && !(fSpill = std::tmpfile())) {
+      Warning("SpillIndex", "cannot create a temporary file, keeping the key headers in memory");
+      fMaxIndexMemory = std::numeric_limits<size_t>::max();
+      return;
+   }
+   if (std::fwrite(fIndex.data(), 1, fIndex.size(), fSpill) != fIndex.size()) {
+      Error("SpillIndex", "cannot write to the temporary file, keeping the key headers in memory");
+      fMaxIndexMemory = std::numeric_limits<size_t>::max();
+      return;
+   }
+   fSpilledBytes += fIndex.size();
+   fIndex.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the index block (the list of keys of the file) when closing; the calls
+/// made by SaveSelf() while the file is being written do nothing.
+
+void TStreamingFile::WriteKeys()
+{
+   if (!IsWritable() || !IsBinary() || !fWriteIndex)
+      return;
+
+   RetireKeys();
+
+   if (fSeekKeys != 0)
+      MakeFree(fSeekKeys, fSeekKeys + fNbytesKeys - 1);
+
+   const Int_t nkeys = fNIndexedKeys;
+   const Long64_t headerBytes = fSpilledBytes + fIndex.size();
+   Long64_t nbytes = sizeof(nkeys) + headerBytes;
+   if (GetEND() > kStartBigFile)
+      nbytes += 8;
+   if (nbytes > std::numeric_limits<Int_t>::max()) {
+      Error("WriteKeys", "the list of %d keys of %s is too large to be written", nkeys, GetName());
+      return;
+   }
+
+   TKey *headerkey = new TKey(fName, fTitle, TFile::Class(), nbytes, this);
+   if (headerkey->GetSeekKey() == 0) {
+      delete headerkey;
+      return;
+   }
+   char *buffer = headerkey->GetBuffer();
+   tobuf(buffer, nkeys);
+   char *headers = buffer;
+   if (fSpill) {
+      std::rewind(fSpill);
+      if (std::fread(buffer, 1, fSpilledBytes, fSpill) != size_t(fSpilledBytes)) {
+         Error("WriteKeys", "cannot read back the key headers from the temporary file");
+         delete headerkey;
+         return;
+      }
+      buffer += fSpilledBytes;
+   }
+   std::memcpy(buffer, fIndex.data(), fIndex.size());
+   buffer += fIndex.size();
+   std::memset(buffer, 0, nbytes - sizeof(nkeys) - headerBytes);
+
+   // Number the cycles of the keys written several times with the same name, in
+   // the order they were written, in the index and in the key stored with the
+   // object. TDirectoryFile::GetKey expects the cycles of a name to be adjacent
+   // and in decreasing order: if there are such keys, the index is sorted by name.
+   TKey scratch(this);
+   std::vector<TKeyHeader> keys;
+   keys.reserve(nkeys);
+   char *cursor = headers;
+   for (Int_t i = 0; i < nkeys; ++i)
+      keys.push_back(DecodeKeyHeader(scratch, cursor));
+   // All the cycles are 1: this orders by name, then in the order of writing.
+   std::stable_sort(keys.begin(), keys.end(), [](const TKeyHeader &a, const TKeyHeader &b) {
+      return CompareNameCycle(a.fName, a.fNameLen, a.fCycle, b.fName, b.fNameLen, b.fCycle);
+   });
+   bool sorted = true;
+   for (auto first = keys.begin(); first != keys.end();) {
+      auto last = first + 1;
+      while (last != keys.end() && last->fNameLen == first->fNameLen &&
+             !std::memcmp(last->fName, first->fName, first->fNameLen))
+         ++last;
+      for (auto key = first + 1; key != last; ++key) {
+         sorted = false;
+         key->fCycle = key - first + 1;
+         char *cycle = key->fBegin + kCycleOffset;
+         tobuf(cycle, key->fCycle);
+         Seek(key->fSeekKey + kCycleOffset);
+         if (WriteBuffer(key->fBegin + kCycleOffset, sizeof(Short_t)))
+            Error("WriteKeys", "cannot write the cycle of key %s", TString(key->fName, key->fNameLen).Data());
+      }
+      std::reverse(first, last);
+      first = last;
+   }
+   if (!sorted) {
+      std::vector<char> ordered;
+      ordered.reserve(headerBytes);
+      for (const auto &key : keys)
+         ordered.insert(ordered.end(), key.fBegin, key.fBegin + key.fSize);
+      std::memcpy(headers, ordered.data(), ordered.size());
+   }
+
+   fSeekKeys = headerkey->GetSeekKey();
+   fNbytesKeys = headerkey->GetNbytes();
+   headerkey->WriteFile();
+   delete headerkey;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream the object to disk and keep only the header of its key.
+
+Int_t TStreamingFile::WriteTObject(const TObject *obj, const char *name, Option_t *option, Int_t bufsize)
+{
+   const Int_t nbytes = TFile::WriteTObject(obj, name, option, bufsize);
+   if (IsWritable())
+      RetireKeys();
+   return nbytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream the object to disk and keep only the header of its key.
+
+Int_t TStreamingFile::WriteObjectAny(const void *obj, const TClass *cl, const char *name, Option_t *option,
+                                     Int_t bufsize)
+{
+   const Int_t nbytes = TFile::WriteObjectAny(obj, cl, name, option, bufsize);
+   if (IsWritable())
+      RetireKeys();
+   return nbytes;
+}
+
+} // namespace Experimental
+} // namespace ROOT
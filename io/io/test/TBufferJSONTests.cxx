@@ -0,0 +1,112 @@
+#include "TArrayD.h"
+#include "TBufferJSON.h"
+#include "TList.h"
+#include "TNamed.h"
+#include "TString.h"
+
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdio.h>
+
+TEST(TBufferJSON, ConvertNumbers)
+{
+   char buf[50], ref[50];
+   for (Long64_t value : {0LL, 7LL, -42LL, 1234567890123LL, std::numeric_limits<Long64_t>::max(),
+                          std::numeric_limits<Long64_t>::min()}) {
+      snprintf(ref, sizeof(ref), "%lld", (long long)value);
+      EXPECT_STREQ(TBufferText::ConvertInteger(value, buf, sizeof(buf)), ref);
+   }
+   snprintf(ref, sizeof(ref), "%llu", (unsigned long long)std::numeric_limits<ULong64_t>::max());
+   EXPECT_STREQ(TBufferText::ConvertUnsigned(std::numeric_limits<ULong64_t>::max(), buf, sizeof(buf)), ref);
+
+   EXPECT_STREQ(TBufferText::ConvertDouble(-3., buf, sizeof(buf)), "-3");
+   EXPECT_STREQ(TBufferText::ConvertDouble(-0., buf, sizeof(buf)), "-0");
+   EXPECT_STREQ(TBufferText::ConvertFloatRoundTrip(0.1f, buf, sizeof(buf)), "0.1");
+   EXPECT_STREQ(TBufferText::ConvertDoubleRoundTrip(2.5e-10, buf, sizeof(buf)), "2.5e-10");
+   for (Double_t value : {1. / 3, 1e-300, 0.1 + 0.2, 123456.789}) {
+      EXPECT_EQ(strtod(TBufferText::ConvertDoubleRoundTrip(value, buf, sizeof(buf)), nullptr), value);
+      EXPECT_EQ(strtof(TBufferText::ConvertFloatRoundTrip(value, buf, sizeof(buf)), nullptr), (Float_t)value);
+   }
+}
+
+TEST(TBufferJSON, RoundTripFloats)
+{
+   TArrayD arr(4);
+   arr[0] = 1. / 3;
+   arr[1] = 0.1;
+   arr[2] = 1e-300;
+   arr[3] = 12;
+   // Third digit of compact: shortest form reading back to the same value.
+   TString json = TBufferJSON::ToJSON(&arr, 103);
+   TArrayD *read = nullptr;
+   ASSERT_TRUE(TBufferJSON::FromJSON(read, json));
+   ASSERT_EQ(read->GetSize(), 4);
+   for (int i = 0; i < 4; ++i)
+      EXPECT_EQ(read->At(i), arr[i]);
+   delete read;
+}
+
+TEST(TBufferJSON, ExportToStream)
+{
+   TList list;
+   list.SetOwner();
+   // Output larger than the chunks passed on to the stream.
+   for (int i = 0; i < 20000; ++i)
+      list.Add(new TNamed(TString::Format("object%d", i).Data(), "title"));
+
+   for (Int_t compact : {0, 3, 23}) {
+      std::ostringstream out;
+      TString json = TBufferJSON::ConvertToJSON(&list, compact);
+      EXPECT_EQ(TBufferJSON::ExportToStream(out, &list, compact), json.Length());
+      EXPECT_EQ(out.str(), json.Data());
+   }
+}
+
+TEST(TBufferJSON, CBOR)
+{
+   TNamed named("name", "title with \"quotes\"");
+   std::vector<UChar_t> cbor = TBufferJSON::ConvertToCBOR(&named);
+   EXPECT_LT(cbor.size(), (size_t)TBufferJSON::ConvertToJSON(&named, 3).Length());
+
+   TObject *obj = TBufferJSON::ConvertFromCBOR(cbor);
+   auto read = dynamic_cast<TNamed *>(obj);
+   ASSERT_NE(read, nullptr);
+   EXPECT_STREQ(read->GetName(), "name");
+   EXPECT_STREQ(read->GetTitle(), named.GetTitle());
+   delete obj;
+
+   EXPECT_EQ(TBufferJSON::ConvertFromCBOR(std::vector<UChar_t>{0xff, 0x01}), nullptr);
+}
+
+// The CBOR encoded while streaming keeps the strings, integers and floating-point values
+TEST(TBufferJSON, CBORValues)
+{
+   TList list;
+   list.SetOwner();
+   list.Add(new TNamed("escapes", "tab\t, newline\n, slash / and backslash \\"));
+   TArrayD values(6);
+   const Double_t doubles[] = {0.1, -2.5e-10, 1e300, 123456789012., -7., 0.};
+   for (Int_t i = 0; i < values.GetSize(); ++i)
+      values[i] = doubles[i];
+
+   std::vector<UChar_t> cbor = TBufferJSON::ConvertToCBOR(&list, 100);
+   std::unique_ptr<TObject> obj(TBufferJSON::ConvertFromCBOR(cbor));
+   auto read = dynamic_cast<TList *>(obj.get());
+   ASSERT_NE(read, nullptr);
+   read->SetOwner();
+   ASSERT_EQ(read->GetSize(), 1);
+   EXPECT_STREQ(read->First()->GetTitle(), list.First()->GetTitle());
+
+   cbor = TBufferJSON::ConvertToCBOR(&values, TArrayD::Class(), 100);
+   ASSERT_FALSE(cbor.empty());
+   TClass *cl = TArrayD::Class();
+   auto readValues = static_cast<TArrayD *>(TBufferJSON::ConvertFromCBORAny(cbor, &cl));
+   ASSERT_NE(readValues, nullptr);
+   ASSERT_EQ(readValues->GetSize(), values.GetSize());
+   for (Int_t i = 0; i < values.GetSize(); ++i)
+      EXPECT_EQ(readValues->At(i), values[i]);
+   delete readValues;
+}
@@ -176,6 +176,74 @@ TEST(TBufferMerger, AutoSave)
    RemoveFile("tbuffermerger_autosave.root");
 }
 
+TEST(TBufferMerger, MaxBufferedBytes)
+{
+   int nevents = 16384;
+   int nthreads = 8;
+   int events_per_thread = nevents / nthreads;
+
+   ROOT::EnableThreadSafety();
+
+   {
+      TBufferMerger merger("tbuffermerger_maxbuffered.root");
+
+      merger.SetAutoSave(64 * 1024 * 1024); // never auto save
+      merger.SetMaxBufferedBytes(1);        // ... but only hold one buffer at a time
+      EXPECT_EQ(1u, merger.GetMaxBufferedBytes());
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < nthreads; ++i) {
+         threads.emplace_back([=, &merger]() {
+            auto myfile = merger.GetFile();
+            auto mytree = new TTree("mytree", "mytree");
+            mytree->ResetBit(kMustCleanup);
+
+            int n = 0;
+            mytree->Branch("n", &n, "n/I");
+
+            // Write four buffers per thread, each of which has to wait for the previous one to be merged
+            for (int j = 0; j < events_per_thread; ++j) {
+               n = i * events_per_thread + j;
+               mytree->Fill();
+               if ((j + 1) % (events_per_thread / 4) == 0)
+                  myfile->Write();
+            }
+            mytree->ResetBranchAddresses();
+         });
+      }
+
+      for (auto &&t : threads)
+         t.join();
+
+      auto stats = merger.GetStatistics();
+      EXPECT_EQ(size_t(4 * nthreads), stats.fNBuffers);
+      EXPECT_EQ(1u, stats.fMaxQueueSize);
+      EXPECT_GE(stats.fNMerges, size_t(4 * nthreads - 1));
+      EXPECT_LE(merger.GetBufferedBytes(), stats.fMaxBufferedBytes);
+      EXPECT_EQ(stats.fBytesPushed, stats.fBytesMerged + merger.GetBufferedBytes());
+   }
+
+   {
+      TFile f("tbuffermerger_maxbuffered.root");
+      auto t = (TTree *)f.Get("mytree");
+      ASSERT_TRUE(t != nullptr);
+
+      int n;
+      long long sum = 0;
+      int nentries = (int)t->GetEntries();
+      EXPECT_EQ(nevents, nentries);
+
+      t->SetBranchAddress("n", &n);
+      for (int i = 0; i < nentries; ++i) {
+         t->GetEntry(i);
+         sum += n;
+      }
+      EXPECT_EQ((long long)nevents * (nevents - 1) / 2, sum);
+   }
+
+   RemoveFile("tbuffermerger_maxbuffered.root");
+}
+
 TEST(TBufferMerger, CheckTreeFillResults)
 {
    int sum_s, sum_p;
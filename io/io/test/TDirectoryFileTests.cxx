@@ -0,0 +1,97 @@
+#include "TDirectoryFile.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TROOT.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+static const int kNObjects = 1000;
+
+static void WriteObjects(const char *fname)
+{
+   TFile file(fname, "RECREATE");
+   for (int i = 0; i < kNObjects; ++i) {
+      std::string name = "obj" + std::to_string(i);
+      // Titles long enough for the records to be compressed.
+      std::string title(100 + i % 200, 'a' + i % 26);
+      TNamed obj(name.c_str(), (std::to_string(i) + title).c_str());
+      file.WriteTObject(&obj);
+   }
+   TNamed inner("inner", "inner");
+   file.mkdir("dir")->WriteTObject(&inner);
+}
+
+static void CheckObjects(TFile &file, const std::vector<TKey *> &keys, const std::vector<TObject *> &objects)
+{
+   ASSERT_EQ(keys.size(), objects.size());
+   for (size_t i = 0; i < keys.size(); ++i) {
+      ASSERT_NE(nullptr, objects[i]);
+      EXPECT_STREQ(keys[i]->GetName(), objects[i]->GetName());
+      if (std::string(keys[i]->GetClassName()) == "TNamed") {
+         std::unique_ptr<TObject> expected(keys[i]->ReadObj());
+         EXPECT_STREQ(expected->GetTitle(), objects[i]->GetTitle());
+      }
+   }
+   EXPECT_NE(nullptr, file.Get("dir/inner"));
+}
+
+static void ReadObjectsAndCheck(const char *fname)
+{
+   TFile file(fname);
+   ASSERT_FALSE(file.IsZombie());
+   std::vector<TKey *> keys;
+   TIter next(file.GetListOfKeys());
+   while (auto key = static_cast<TKey *>(next()))
+      keys.push_back(key);
+   ASSERT_EQ(kNObjects + 1u, keys.size());
+
+   std::vector<TObject *> objects = file.ReadObjects(keys);
+   CheckObjects(file, keys, objects);
+   for (auto obj : objects) {
+      if (!obj->InheritsFrom(TDirectoryFile::Class()))
+         delete obj;
+   }
+}
+
+TEST(TDirectoryFile, ReadObjects)
+{
+   const char *fname = "directoryfile_readobjects.root";
+   WriteObjects(fname);
+   ReadObjectsAndCheck(fname);
+   gSystem->Unlink(fname);
+}
+
+#ifdef R__USE_IMT
+TEST(TDirectoryFile, ReadObjectsMT)
+{
+   const char *fname = "directoryfile_readobjects_mt.root";
+   WriteObjects(fname);
+   ROOT::EnableImplicitMT(4);
+   ReadObjectsAndCheck(fname);
+   ROOT::DisableImplicitMT();
+   gSystem->Unlink(fname);
+}
+#endif
+
+TEST(TDirectoryFile, ReadAll)
+{
+   const char *fname = "directoryfile_readall.root";
+   WriteObjects(fname);
+   {
+      TFile file(fname);
+      file.ReadAll();
+      // The subdirectory is read, and added to the directory.
+      EXPECT_NE(nullptr, file.GetList()->FindObject("dir"));
+      EXPECT_EQ(1, file.GetList()->GetSize());
+      // Reading again replaces the objects in memory.
+      file.ReadAll();
+      EXPECT_EQ(1, file.GetList()->GetSize());
+   }
+   gSystem->Unlink(fname);
+}
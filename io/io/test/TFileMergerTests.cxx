@@ -1,10 +1,20 @@
 #include "TFileMerger.h"
 
+#include "TGraph.h"
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TKey.h"
 #include "TMemFile.h"
+#include "TRandom3.h"
+#include "TROOT.h"
 #include "TTree.h"
 
 #include "gtest/gtest.h"
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 namespace {
 using testing::internal::GetCapturedStderr;
 using testing::internal::CaptureStderr;
@@ -96,3 +106,95 @@ TEST(TFileMerger, CreateWithUnwritableTFilePointer)
    output->SetWritable(false);
    EXPECT_ROOT_ERROR(merger.OutputFile(std::move(output)), "Error in .* output file output.root is not writable\n");
 }
+
+#ifdef R__USE_IMT
+// Histograms, with a graph and a subdirectory in between
+static std::unique_ptr<TMemFile> CreateHistograms(const char *name, UInt_t seed)
+{
+   std::unique_ptr<TMemFile> file(new TMemFile(name, "RECREATE"));
+   TRandom3 rnd(seed);
+   for (int i = 0; i < 20; ++i) {
+      TH1D h(TString::Format("h1_%d", i), "", 100, -3, 3);
+      h.SetDirectory(nullptr);
+      for (int j = 0; j < 1000; ++j)
+         h.Fill(rnd.Gaus(), rnd.Rndm());
+      file->WriteTObject(&h);
+   }
+   TGraph graph(10);
+   graph.SetName("graph");
+   for (int i = 0; i < 10; ++i)
+      graph.SetPoint(i, i, rnd.Rndm());
+   file->WriteTObject(&graph);
+   TDirectory *dir = file->mkdir("dir");
+   for (int i = 0; i < 20; ++i) {
+      TH2D h(TString::Format("h2_%d", i), "", 50, -3, 3, 50, -3, 3);
+      h.SetDirectory(nullptr);
+      for (int j = 0; j < 1000; ++j)
+         h.Fill(rnd.Gaus(), rnd.Gaus(), rnd.Rndm());
+      (i < 10 ? file.get() : dir)->WriteTObject(&h);
+   }
+   return file;
+}
+
+static void CompareDirectories(TDirectory *expected, TDirectory *actual)
+{
+   TList *keys = expected->GetListOfKeys();
+   TList *actualKeys = actual->GetListOfKeys();
+   ASSERT_EQ(keys->GetSize(), actualKeys->GetSize()) << expected->GetName();
+   TIter next(keys), nextActual(actualKeys);
+   while (auto key = static_cast<TKey *>(next())) {
+      auto actualKey = static_cast<TKey *>(nextActual());
+      ASSERT_STREQ(key->GetName(), actualKey->GetName());
+      ASSERT_STREQ(key->GetClassName(), actualKey->GetClassName());
+      if (!strcmp(key->GetClassName(), "TDirectoryFile")) {
+         CompareDirectories(expected->GetDirectory(key->GetName()), actual->GetDirectory(key->GetName()));
+         continue;
+      }
+      std::unique_ptr<TObject> obj(key->ReadObj()), actualObj(actualKey->ReadObj());
+      if (auto h = dynamic_cast<TH1 *>(obj.get())) {
+         auto actualH = static_cast<TH1 *>(actualObj.get());
+         ASSERT_EQ(h->GetNcells(), actualH->GetNcells());
+         EXPECT_EQ(h->GetEntries(), actualH->GetEntries()) << h->GetName();
+         for (int bin = 0; bin < h->GetNcells(); ++bin) {
+            EXPECT_EQ(h->GetBinContent(bin), actualH->GetBinContent(bin)) << h->GetName() << " bin " << bin;
+            EXPECT_EQ(h->GetBinError(bin), actualH->GetBinError(bin)) << h->GetName() << " bin " << bin;
+         }
+      } else if (auto g = dynamic_cast<TGraph *>(obj.get())) {
+         auto actualG = static_cast<TGraph *>(actualObj.get());
+         ASSERT_EQ(g->GetN(), actualG->GetN());
+         for (int i = 0; i < g->GetN(); ++i) {
+            EXPECT_EQ(g->GetX()[i], actualG->GetX()[i]);
+            EXPECT_EQ(g->GetY()[i], actualG->GetY()[i]);
+         }
+      }
+   }
+}
+
+// The histograms merged concurrently are the ones merged sequentially, in the same order
+TEST(TFileMerger, ConcurrentMerge)
+{
+   std::vector<std::unique_ptr<TMemFile>> inputs;
+   for (UInt_t i = 0; i < 4; ++i)
+      inputs.push_back(CreateHistograms(TString::Format("concurrent_input%u.root", i), i + 1));
+
+   ROOT::DisableImplicitMT();
+   TFileMerger sequential(kFALSE, kFALSE);
+   ASSERT_TRUE(sequential.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("sequential.root", "CREATE"))));
+   for (auto &input : inputs)
+      sequential.AddFile(input.get(), kFALSE);
+   ASSERT_TRUE(sequential.PartialMerge());
+
+   ROOT::EnableImplicitMT(4);
+   TFileMerger concurrent(kFALSE, kFALSE);
+   ASSERT_TRUE(concurrent.OutputFile(std::unique_ptr<TMemFile>(new TMemFile("concurrent.root", "CREATE"))));
+   for (auto &input : inputs)
+      concurrent.AddFile(input.get(), kFALSE);
+   ASSERT_TRUE(concurrent.PartialMerge());
+   ROOT::DisableImplicitMT();
+
+   const Bool_t addDirectory = TH1::AddDirectoryStatus();
+   TH1::AddDirectory(kFALSE);
+   CompareDirectories(sequential.GetOutputFile(), concurrent.GetOutputFile());
+   TH1::AddDirectory(addDirectory);
+}
+#endif
@@ -0,0 +1,80 @@
+#include "TAttAxis.h"
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TMD5.h"
+#include "TStreamerInfo.h"
+#include "TStreamerInfoActions.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+TEST(TStreamerInfoActions, FusedBasicTypes)
+{
+   TAttAxis axis;
+   axis.SetNdivisions(407);
+   axis.SetAxisColor(3);
+   axis.SetLabelColor(4);
+   axis.SetLabelFont(82);
+   axis.SetLabelOffset(0.125);
+   axis.SetLabelSize(0.5);
+   axis.SetTickLength(0.25);
+   axis.SetTitleOffset(1.5);
+   axis.SetTitleSize(0.0625);
+   axis.SetTitleColor(5);
+   axis.SetTitleFont(132);
+
+   auto info = static_cast<TStreamerInfo *>(TAttAxis::Class()->GetStreamerInfo());
+   ASSERT_NE(info, nullptr);
+   auto sequence = info->GetReadObjectWiseActions();
+   ASSERT_NE(sequence, nullptr);
+   // The data members of TAttAxis are all basic types: they are streamed by a single fused action.
+   EXPECT_EQ(sequence->fActions.size(), 1u);
+   EXPECT_EQ(info->GetWriteObjectWiseActions()->fActions.size(), 1u);
+
+   TBufferFile wbuf(TBuffer::kWrite, 8);  // Small buffer, to exercise its expansion.
+   wbuf.WriteClassBuffer(TAttAxis::Class(), &axis);
+   const Int_t nbytes = wbuf.Length();
+
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   TAttAxis copy;
+   rbuf.ReadClassBuffer(TAttAxis::Class(), &copy, nullptr);
+   EXPECT_EQ(rbuf.Length(), nbytes);
+
+   EXPECT_EQ(copy.GetNdivisions(), axis.GetNdivisions());
+   EXPECT_EQ(copy.GetAxisColor(), axis.GetAxisColor());
+   EXPECT_EQ(copy.GetLabelColor(), axis.GetLabelColor());
+   EXPECT_EQ(copy.GetLabelFont(), axis.GetLabelFont());
+   EXPECT_FLOAT_EQ(copy.GetLabelOffset(), axis.GetLabelOffset());
+   EXPECT_FLOAT_EQ(copy.GetLabelSize(), axis.GetLabelSize());
+   EXPECT_FLOAT_EQ(copy.GetTickLength(), axis.GetTickLength());
+   EXPECT_FLOAT_EQ(copy.GetTitleOffset(), axis.GetTitleOffset());
+   EXPECT_FLOAT_EQ(copy.GetTitleSize(), axis.GetTitleSize());
+   EXPECT_EQ(copy.GetTitleColor(), axis.GetTitleColor());
+   EXPECT_EQ(copy.GetTitleFont(), axis.GetTitleFont());
+}
+
+TEST(TStreamerInfoActions, FusedFixedSizeArray)
+{
+   TMD5 md5;
+   const char *text = "fused streamer actions";
+   md5.Update((const UChar_t *)text, strlen(text));
+   md5.Final();
+
+   auto info = static_cast<TStreamerInfo *>(TMD5::Class()->GetStreamerInfo());
+   ASSERT_NE(info, nullptr);
+   // The fixed-size array UChar_t fDigest[16] and Bool_t fFinalized are streamed by a single fused action.
+   EXPECT_EQ(info->GetReadObjectWiseActions()->fActions.size(), 1u);
+   EXPECT_EQ(info->GetWriteObjectWiseActions()->fActions.size(), 1u);
+
+   TBufferFile wbuf(TBuffer::kWrite, 8);
+   wbuf.WriteClassBuffer(TMD5::Class(), &md5);
+   const Int_t nbytes = wbuf.Length();
+
+   TBufferFile rbuf(TBuffer::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+   TMD5 copy;
+   rbuf.ReadClassBuffer(TMD5::Class(), &copy, nullptr);
+   EXPECT_EQ(rbuf.Length(), nbytes);
+   EXPECT_TRUE(copy == md5);
+   EXPECT_STREQ(copy.AsString(), md5.AsString());
+}
@@ -0,0 +1,144 @@
+#include "ROOT/TStreamerInfoSnapshot.hxx"
+#include "TAttAxis.h"
+#include "TAttFill.h"
+#include "TAttMarker.h"
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TObjArray.h"
+#include "TStreamerInfo.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#ifndef WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using ROOT::Experimental::TStreamerInfoSnapshot;
+
+TEST(TStreamerInfoSnapshot, WriteAndLoad)
+{
+   const char *filename = "TStreamerInfoSnapshot.snapshot";
+   // TNamed streams TObject and TString: TObject has its own TStreamerInfo.
+   EXPECT_GE(TStreamerInfoSnapshot::Write(filename, {"TNamed", "TAttAxis"}), 3);
+   EXPECT_TRUE(TAttAxis::Class()->GetStreamerInfo()->IsCompiled());
+
+   // The TStreamerInfos built by this process take precedence over the snapshot.
+   auto info = TAttAxis::Class()->GetStreamerInfo();
+   EXPECT_EQ(TStreamerInfoSnapshot::Load(filename), 0);
+   EXPECT_EQ(TAttAxis::Class()->GetStreamerInfo(), info);
+
+   gSystem->Unlink(filename);
+}
+
+TEST(TStreamerInfoSnapshot, LoadInvalid)
+{
+   const char *filename = "TStreamerInfoSnapshotInvalid.snapshot";
+   {
+      std::ofstream out(filename);
+      out << "not a snapshot";
+   }
+   EXPECT_EQ(TStreamerInfoSnapshot::Load(filename), -1);
+   EXPECT_EQ(TStreamerInfoSnapshot::Load("TStreamerInfoSnapshotMissing.snapshot"), -1);
+   gSystem->Unlink(filename);
+}
+
+#ifndef WIN32
+// The TStreamerInfo installed from a snapshot streams as the one it was built from
+TEST(TStreamerInfoSnapshot, RoundTrip)
+{
+   const char *filename = "TStreamerInfoSnapshotRoundTrip.snapshot";
+   const char *streamed = "TStreamerInfoSnapshotRoundTrip.buffer";
+   TAttMarker marker(6, 21, 1.5);
+
+   // The snapshot is written by a child process: this one never builds the TStreamerInfo of TAttMarker.
+   pid_t pid = fork();
+   ASSERT_NE(pid, -1);
+   if (pid == 0) {
+      Int_t status = TStreamerInfoSnapshot::Write(filename, {"TAttMarker"}) == 1 ? 0 : 1;
+      TBufferFile buf(TBuffer::kWrite);
+      buf.WriteObjectAny(&marker, TAttMarker::Class());
+      std::ofstream out(streamed, std::ios::binary | std::ios::trunc);
+      if (!out.write(buf.Buffer(), buf.Length()))
+         status = 1;
+      out.close();
+      _exit(status);
+   }
+   int status = -1;
+   ASSERT_EQ(waitpid(pid, &status, 0), pid);
+   ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+   const Version_t version = TAttMarker::Class()->GetClassVersion();
+   ASSERT_EQ(TAttMarker::Class()->GetStreamerInfos()->At(version), nullptr);
+   EXPECT_EQ(TStreamerInfoSnapshot::Load(filename), 1);
+   auto info = static_cast<TStreamerInfo *>(TAttMarker::Class()->GetStreamerInfos()->At(version));
+   ASSERT_NE(info, nullptr);
+   EXPECT_TRUE(info->IsCompiled());
+   EXPECT_EQ(TAttMarker::Class()->GetStreamerInfo(), info);
+
+   // Streamed through the installed TStreamerInfo, the object gives the same buffer as in the child.
+   TBufferFile buf(TBuffer::kWrite);
+   buf.WriteObjectAny(&marker, TAttMarker::Class());
+   std::ifstream in(streamed, std::ios::binary);
+   std::string expected((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+   EXPECT_EQ(std::string(buf.Buffer(), buf.Length()), expected);
+
+   TBufferFile read(TBuffer::kRead, buf.Length(), buf.Buffer(), kFALSE);
+   std::unique_ptr<TAttMarker> copy(static_cast<TAttMarker *>(read.ReadObjectAny(TAttMarker::Class())));
+   ASSERT_NE(copy, nullptr);
+   EXPECT_EQ(copy->GetMarkerColor(), marker.GetMarkerColor());
+   EXPECT_EQ(copy->GetMarkerStyle(), marker.GetMarkerStyle());
+   EXPECT_FLOAT_EQ(copy->GetMarkerSize(), marker.GetMarkerSize());
+
+   gSystem->Unlink(filename);
+   gSystem->Unlink(streamed);
+}
+
+// A class whose layout changed without a change of version or size is not installed
+TEST(TStreamerInfoSnapshot, ChecksumMismatch)
+{
+   const char *filename = "TStreamerInfoSnapshotChecksum.snapshot";
+
+   pid_t pid = fork();
+   ASSERT_NE(pid, -1);
+   if (pid == 0)
+      _exit(TStreamerInfoSnapshot::Write(filename, {"TAttFill"}) == 1 ? 0 : 1);
+   int status = -1;
+   ASSERT_EQ(waitpid(pid, &status, 0), pid);
+   ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+   // Change the checksum recorded after the size of the class, as if its members had been reordered.
+   TClass *cl = TAttFill::Class();
+   TBufferFile record(TBuffer::kWrite);
+   record << cl->Size();
+   record << cl->GetCheckSum();
+   const std::string layout(record.Buffer(), record.Length());
+   std::string content;
+   {
+      std::ifstream in(filename, std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+   }
+   const auto pos = content.find(layout);
+   ASSERT_NE(pos, std::string::npos);
+   content[pos + layout.size() - 1] ^= 1;
+   {
+      std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+      out.write(content.data(), content.size());
+   }
+
+   const Version_t version = cl->GetClassVersion();
+   ASSERT_EQ(cl->GetStreamerInfos()->At(version), nullptr);
+   EXPECT_EQ(TStreamerInfoSnapshot::Load(filename), 0);
+   EXPECT_EQ(cl->GetStreamerInfos()->At(version), nullptr);
+   // The TStreamerInfo is built from the class instead.
+   EXPECT_EQ(cl->GetStreamerInfo()->GetCheckSum(), cl->GetCheckSum());
+
+   gSystem->Unlink(filename);
+}
+#endif
@@ -0,0 +1,113 @@
+#include "ROOT/TStreamingFile.hxx"
+
+#include "TFile.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using ROOT::Experimental::TStreamingFile;
+
+static const int kNObjects = 2000;
+
+static void WriteObjects(TStreamingFile &file)
+{
+   for (int i = 0; i < kNObjects; ++i) {
+      std::string name = "obj" + std::to_string(i);
+      TNamed obj(name.c_str(), std::to_string(i).c_str());
+      file.WriteTObject(&obj);
+   }
+   // A second cycle for one of the objects
+   TNamed obj("obj7", "second");
+   file.WriteTObject(&obj);
+}
+
+TEST(TStreamingFile, WriteAndReadBack)
+{
+   const char *fname = "streamingfile_write.root";
+   {
+      TStreamingFile file(fname, "RECREATE");
+      ASSERT_FALSE(file.IsZombie());
+      file.SetMaxIndexMemory(4096); // force spilling the key headers
+      WriteObjects(file);
+      // Written keys are not kept in memory
+      EXPECT_EQ(0, file.GetListOfKeys()->GetSize());
+      EXPECT_EQ(kNObjects + 1, file.GetNkeys());
+      EXPECT_LE(file.GetIndexMemory(), 2 * 4096u + 1024u);
+      EXPECT_EQ(nullptr, file.mkdir("dir"));
+   }
+
+   // Read with a plain TFile
+   {
+      TFile file(fname);
+      EXPECT_EQ(kNObjects + 1, file.GetNkeys());
+      auto obj = static_cast<TNamed *>(file.Get("obj1234"));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_STREQ("1234", obj->GetTitle());
+      obj = static_cast<TNamed *>(file.Get("obj7"));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_STREQ("second", obj->GetTitle());
+      obj = static_cast<TNamed *>(file.Get("obj7;1"));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_STREQ("7", obj->GetTitle());
+
+      // The cycle is also set in the key stored with the object
+      TKey *key = file.GetKey("obj7");
+      ASSERT_NE(nullptr, key);
+      TKey stored(key->GetSeekKey(), key->GetNbytes(), &file);
+      ASSERT_TRUE(stored.ReadFile());
+      char *buffer = stored.GetBuffer();
+      stored.ReadKeyBuffer(buffer);
+      EXPECT_EQ(2, stored.GetCycle());
+      EXPECT_STREQ("obj7", stored.GetName());
+      stored.DeleteBuffer();
+   }
+
+   // Read with the compact index
+   {
+      TStreamingFile file(fname);
+      ASSERT_FALSE(file.IsZombie());
+      EXPECT_EQ(kNObjects + 1, file.GetNkeys());
+      auto obj = static_cast<TNamed *>(file.Get("obj42"));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_STREQ("42", obj->GetTitle());
+      EXPECT_EQ(nullptr, file.Get("obj42;2"));
+      EXPECT_EQ(nullptr, file.Get("nonexistent"));
+      EXPECT_EQ(2, file.GetKey("obj7")->GetCycle());
+      EXPECT_EQ(1, file.GetKey("obj7", 1)->GetCycle());
+      // Only the keys used so far have been created
+      EXPECT_LT(file.TFile::GetListOfKeys()->GetSize(), 10);
+      EXPECT_EQ(kNObjects + 1, file.GetListOfKeys()->GetSize());
+      EXPECT_EQ(kNObjects + 1, file.GetNkeys());
+   }
+
+   gSystem->Unlink(fname);
+}
+
+TEST(TStreamingFile, ReadTFile)
+{
+   const char *fname = "streamingfile_read.root";
+   {
+      TFile file(fname, "RECREATE");
+      for (int i = 0; i < 100; ++i) {
+         std::string name = "obj" + std::to_string(i);
+         TNamed obj(name.c_str(), std::to_string(i).c_str());
+         file.WriteTObject(&obj);
+      }
+   }
+   {
+      TStreamingFile file(fname);
+      EXPECT_EQ(100, file.GetNkeys());
+      auto obj = static_cast<TNamed *>(file.Get("obj99"));
+      ASSERT_NE(nullptr, obj);
+      EXPECT_STREQ("99", obj->GetTitle());
+   }
+   {
+      TStreamingFile file(fname, "UPDATE");
+      EXPECT_TRUE(file.IsZombie());
+   }
+   gSystem->Unlink(fname);
+}
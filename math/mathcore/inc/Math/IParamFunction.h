@@ -21,6 +21,8 @@
 
 
 #include <cassert>
+#include <cstddef>
+#include <vector>
 
 /**
    @defgroup ParamFunc Parameteric Function Evaluation Interfaces.
@@ -127,6 +129,28 @@ namespace ROOT {
             return DoEval(x);
          }
 
+         /**
+            Evaluate the function at n points for given parameters p, storing the values in out.
+            The coordinates are stored by dimension: the coordinate j of the point i is x[j * n + i].
+            The default implementation evaluates the points one at a time with DoEvalPar, derived
+            classes can reimplement it to evaluate them at once.
+         */
+         virtual void EvalBatch(const T *x, T *out, std::size_t n, const double *p) const
+         {
+            const unsigned int ndim = this->NDim();
+            if (ndim == 1) {
+               for (std::size_t i = 0; i < n; ++i)
+                  out[i] = DoEvalPar(x + i, p);
+               return;
+            }
+            std::vector<T> xi(ndim);
+            for (std::size_t i = 0; i < n; ++i) {
+               for (unsigned int j = 0; j < ndim; ++j)
+                  xi[j] = x[j * n + i];
+               out[i] = DoEvalPar(xi.data(), p);
+            }
+         }
+
       private:
          /**
             Implementation of the evaluation function using the x values and the parameters.
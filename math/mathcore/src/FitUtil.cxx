@@ -213,6 +213,95 @@ namespace ROOT {
             }
          }
 
+         // number of chunks of the map-reduce over the n points of the data
+         // with the given execution policy (a single one in serial mode)
+         static unsigned int MapChunks(ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks, unsigned int n)
+         {
+#ifdef R__USE_IMT
+            if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread)
+               return nChunks != 0 ? nChunks : setAutomaticChunking(n);
+#else
+            (void)executionPolicy;
+            (void)nChunks;
+            (void)n;
+#endif
+            return 1;
+         }
+
+         // values of the model function at the first n points of the data, evaluated
+         // by batches of points passed to IModelFunction::EvalBatch.
+         // The points are split in the same chunks as by TThreadExecutor::MapReduce,
+         // each chunk with its own batch buffer, so the values can be requested
+         // in parallel from the map function, which visits the points of a chunk in order.
+         // If edges is given the function is evaluated at the bin centers.
+         class ModelBatchEvaluator {
+         public:
+            ModelBatchEvaluator(const IModelFunction &func, const double *p, const FitData &data, const BinData *edges,
+                                unsigned int n, unsigned int nChunks)
+               : fFunc(func), fParams(p), fData(data), fEdges(edges), fN(n),
+                 fStep(nChunks > 1 ? (n + nChunks - 1) / nChunks : n)
+            {
+               if (fN == 0)
+                  return;
+               fBatches.resize((fN + fStep - 1) / fStep);
+               // the first batch is evaluated alone, for a function that is
+               // initialized (compiled or with the parameters set) at the first call
+               Evaluate(fBatches[0], 0, std::min(fN, fStep));
+            }
+
+            double operator()(unsigned int i)
+            {
+               const unsigned int chunk = i / fStep;
+               TBatch &batch = fBatches[chunk];
+               if (i < batch.fBegin || i >= batch.fBegin + batch.fSize)
+                  Evaluate(batch, i, std::min(fN, (chunk + 1) * fStep));
+               return batch.fValues[i - batch.fBegin];
+            }
+
+         private:
+            struct TBatch {
+               unsigned int fBegin = 0;
+               unsigned int fSize = 0;
+               std::vector<double> fValues; // model values at the points of the batch
+               std::vector<double> fX;      // coordinates of the points, stored by dimension
+            };
+
+            // evaluate the batch of points starting at begin, up to end
+            void Evaluate(TBatch &batch, unsigned int begin, unsigned int end)
+            {
+               const unsigned int batchSize = 512;
+               const unsigned int size = std::min(batchSize, end - begin);
+               const unsigned int ndim = fData.NDim();
+               batch.fBegin = begin;
+               batch.fSize = size;
+               batch.fValues.resize(batchSize);
+               if (ndim == 1 && !fEdges) {
+                  // the coordinates of the points are contiguous
+                  fFunc.EvalBatch(fData.GetCoordComponent(begin, 0), batch.fValues.data(), size, fParams);
+                  return;
+               }
+               batch.fX.resize(ndim * batchSize);
+               for (unsigned int j = 0; j < ndim; ++j) {
+                  double *xj = batch.fX.data() + j * size;
+                  for (unsigned int i = 0; i < size; ++i)
+                     xj[i] = *fData.GetCoordComponent(begin + i, j);
+                  if (fEdges) {
+                     for (unsigned int i = 0; i < size; ++i)
+                        xj[i] = 0.5 * (fEdges->GetBinUpEdgeComponent(begin + i, j) + xj[i]);
+                  }
+               }
+               fFunc.EvalBatch(batch.fX.data(), batch.fValues.data(), size, fParams);
+            }
+
+            const IModelFunction &fFunc;
+            const double *fParams;
+            const FitData &fData;
+            const BinData *fEdges;
+            unsigned int fN;
+            unsigned int fStep;            // number of points of a chunk
+            std::vector<TBatch> fBatches;  // current batch of each chunk
+         };
+
 
 
       } // end namespace  FitUtil
@@ -270,6 +359,10 @@ namespace ROOT {
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 
+   // without the integral of the bins, evaluate the function by batches of points
+   const unsigned int mapChunks = MapChunks(executionPolicy, nChunks, n);
+   ModelBatchEvaluator fvals(func, p, data, (useBinVolume ? &data : nullptr), (useBinIntegral ? 0 : n), mapChunks);
+
    auto mapFunction = [&](const unsigned i){
 
       double chi2{};
@@ -296,7 +389,7 @@ namespace ROOT {
          x = xc.data();
          // normalize the bin volume using a reference value
          binVolume *= wrefVolume;
-      } else if(data.NDim() > 1) {
+      } else if(useBinIntegral && data.NDim() > 1) {
          xc.resize(data.NDim());
          xc[0] = *x1;
          for (unsigned int j = 1; j < data.NDim(); ++j)
@@ -308,11 +401,7 @@ namespace ROOT {
 
 
       if (!useBinIntegral) {
-#ifdef USE_PARAMCACHE
-         fval = func ( x );
-#else
-         fval = func ( x, p );
-#endif
+         fval = fvals(i);
       }
       else {
          // calculate integral normalized by bin volume
@@ -391,8 +480,7 @@ namespace ROOT {
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
     ROOT::TThreadExecutor pool;
-    auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, mapChunks);
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -914,22 +1002,11 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
 
    nPoints = data.Size();  // npoints
 
-#ifdef R__USE_IMT
-         // in case parameter needs to be propagated to user function use trick to set parameters by calling one time the function
-         // this will be done in sequential mode and parameters can be set in a thread safe manner
-         if (!normalizeFunc) {
-            if (data.NDim() == 1) {
-               const double * x = data.GetCoordComponent(0,0);
-               func( x, p);
-            }
-            else {
-               std::vector<double> x(data.NDim());
-               for (unsigned int j = 0; j < data.NDim(); ++j)
-                  x[j] = *data.GetCoordComponent(0, j);
-               func( x.data(), p);
-            }
-         }
-#endif
+         // evaluate the function by batches of points. The first points are
+         // evaluated in sequential mode, so parameters that need to be propagated
+         // to the user function are set in a thread safe manner
+         const unsigned int mapChunks = MapChunks(executionPolicy, nChunks, n);
+         ModelBatchEvaluator fvals(func, p, data, nullptr, n, mapChunks);
 
          double norm = 1.0;
          if (normalizeFunc) {
@@ -962,27 +1039,7 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
          auto mapFunction = [&](const unsigned i) {
             double W = 0;
             double W2 = 0;
-            double fval = 0;
-
-            if (data.NDim() > 1) {
-               std::vector<double> x(data.NDim());
-               for (unsigned int j = 0; j < data.NDim(); ++j)
-                  x[j] = *data.GetCoordComponent(i, j);
-#ifdef USE_PARAMCACHE
-               fval = func(x.data());
-#else
-               fval = func(x.data(), p);
-#endif
-
-               // one -dim case
-            } else {
-               const auto x = data.GetCoordComponent(i, 0);
-#ifdef USE_PARAMCACHE
-               fval = func(x);
-#else
-               fval = func(x, p);
-#endif
-            }
+            double fval = fvals(i);
 
             if (normalizeFunc)
                fval = fval * (1 / norm);
@@ -1043,8 +1100,7 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
     ROOT::TThreadExecutor pool;
-    auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
-    auto resArray = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    auto resArray = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, mapChunks);
     logl=resArray.logvalue;
     sumW=resArray.weight;
     sumW2=resArray.weight2;
@@ -1415,6 +1471,10 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
    IntegralEvaluator<> igEval(func, p, useBinIntegral);
 #endif
 
+   // without the integral of the bins, evaluate the function by batches of points
+   const unsigned int mapChunks = MapChunks(executionPolicy, nChunks, n);
+   ModelBatchEvaluator fvals(func, p, data, (useBinVolume ? &data : nullptr), (useBinIntegral ? 0 : n), mapChunks);
+
    auto mapFunction = [&](const unsigned i) {
       auto x1 = data.GetCoordComponent(i, 0);
       auto y = *data.ValuePtr(i);
@@ -1436,7 +1496,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
          x = xc.data();
          // normalize the bin volume using a reference value
          binVolume *= wrefVolume;
-      } else if (data.NDim() > 1) {
+      } else if (useBinIntegral && data.NDim() > 1) {
          xc.resize(data.NDim());
          xc[0] = *x1;
          for (unsigned int j = 1; j < data.NDim(); ++j) {
@@ -1448,11 +1508,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
       }
 
       if (!useBinIntegral) {
-#ifdef USE_PARAMCACHE
-         fval = func(x);
-#else
-         fval = func(x, p);
-#endif
+         fval = fvals(i);
       } else {
          // calculate integral (normalized by bin volume)
          // need to set function and parameters here in case loop is parallelized
@@ -1542,8 +1598,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
 #ifdef R__USE_IMT
    } else if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultithread) {
       ROOT::TThreadExecutor pool;
-      auto chunks = nChunks != 0 ? nChunks : setAutomaticChunking(data.Size());
-      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, mapChunks);
 #endif
       //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
       // ROOT::TProcessExecutor pool;
@@ -0,0 +1,101 @@
+// @(#)root/test:$Id$
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "TDirectory.h"
+#include "TH1D.h"
+#include "TNamed.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+//
+// This program benchmarks the deletion of the objects held by a directory,
+// which removes each of them from all the collections which may hold it
+// (see TROOT::RecursiveRemove), with and without indexed cleanup (see
+// ROOT::EnableIndexedCleanup).
+//
+// Usage: cleanupbm -h                  - to print a usage info
+//        cleanupbm [nobjects]          - to run the benchmark
+//
+// parameters:
+//       nobjects      - number of objects held by the directory (default 10000)
+//
+// For each kind of object the program prints the mean time of a deletion.
+// With indexed cleanup, the deleted object is removed from the directory
+// through the index of the lists holding it, and only the objects of the
+// directory which may hold references to others are notified: deleting
+// named objects costs a constant time, but deleting histograms still costs a
+// time proportional to the number of histograms of the directory, as each
+// of them is notified of the deletion of the others.
+
+int nobjects = 10000;    // Number of objects held by the directory.
+
+//_____________________________________________________________
+
+static double DeleteAll(const char *title, bool histos)
+{
+   TDirectory *dir = new TDirectory(title, title);
+   TDirectory::TContext context(dir);
+   std::vector<TObject *> objects;
+   for (int i = 0; i < nobjects; ++i) {
+      TString name = TString::Format("%s%d", title, i);
+      if (histos) {
+         // appended to the current directory
+         objects.push_back(new TH1D(name, name, 10, 0., 1.));
+      } else {
+         objects.push_back(new TNamed(name, name));
+         dir->Append(objects.back());
+      }
+   }
+   if (dir->GetList()->GetSize() != nobjects)
+      printf("Error: %s holds %d objects instead of %d\n", title, dir->GetList()->GetSize(), nobjects);
+
+   TStopwatch timer;
+   timer.Start();
+   for (auto obj : objects)
+      delete obj;
+   timer.Stop();
+
+   if (dir->GetList()->GetSize() != 0)
+      printf("Error: %s still holds %d objects\n", title, dir->GetList()->GetSize());
+   delete dir;
+   return timer.RealTime();
+}
+
+//_____________________________________________________________
+
+static void Benchmark(const char *mode)
+{
+   const double named = DeleteAll(TString::Format("named_%s", mode), false);
+   const double histos = DeleteAll(TString::Format("histo_%s", mode), true);
+   printf("%-24s %14.2f %14.2f\n", mode, 1e6 * named / nobjects, 1e6 * histos / nobjects);
+}
+
+//_____________________________________________________________
+
+int main(int argc, char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: cleanupbm [nobjects]\n");
+      return 0;
+   }
+   if (argc > 1) nobjects = atoi(argv[1]);
+   if (nobjects < 1) {
+      printf("Error: at least 1 object is needed\n");
+      return 1;
+   }
+
+   ROOT::EnableThreadSafety();
+   printf("%d objects, mean time of a deletion (us)\n", nobjects);
+   printf("%-24s %14s %14s\n", "", "TNamed", "TH1D");
+   Benchmark("baseline");
+   ROOT::EnableIndexedCleanup();
+   Benchmark("indexed cleanup");
+
+   return 0;
+}
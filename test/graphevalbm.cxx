@@ -0,0 +1,163 @@
+// @(#)root/test:$Id$
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TGraph.h"
+#include "TRandom3.h"
+#include "TSpline.h"
+#include "TStopwatch.h"
+
+//
+// This program benchmarks the latency of the interpolation of a TGraph with
+// TGraph::Eval and of the evaluation of a TSpline3, one abscissa per call
+// and by batches.
+//
+// Usage: graphevalbm -h                        - to print a usage info
+//        graphevalbm [npoints] [ncalls]        - to run the benchmark
+//
+// parameters:
+//       npoints       - number of points of the graph (default 10000)
+//       ncalls        - number of abscissas evaluated (default 1000000)
+//
+// The points of the graph are not evenly spaced. For each way of evaluating
+// the graph the program prints the mean time of an evaluation, for abscissas
+// in random order and in increasing order. The results of the different ways
+// of evaluating the graph are compared, a difference is reported as an error.
+
+int npoints = 10000;      // Number of points of the graph.
+int ncalls  = 1000000;    // Number of abscissas evaluated.
+
+//_____________________________________________________________
+
+static void Report(const char *name, double seconds, int n, double seconds2, int n2)
+{
+   printf("%-32s %14.1f %14.1f\n", name, 1e9 * seconds / n, 1e9 * seconds2 / n2);
+}
+
+//_____________________________________________________________
+
+static void Compare(const char *name, const std::vector<double> &ref, const std::vector<double> &y, int n)
+{
+   for (int i = 0; i < n; ++i) {
+      if (std::abs(y[i] - ref[i]) > 1e-12 * (1 + std::abs(ref[i]))) {
+         printf("Error: %s differs at abscissa %d: %g instead of %g\n", name, i, y[i], ref[i]);
+         return;
+      }
+   }
+}
+
+//_____________________________________________________________
+
+int main(int argc, char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: graphevalbm [npoints] [ncalls]\n");
+      return 0;
+   }
+   if (argc > 1) npoints = atoi(argv[1]);
+   if (argc > 2) ncalls  = atoi(argv[2]);
+   if (npoints < 2 || ncalls < 1) {
+      printf("Error: at least 2 points and 1 call are needed\n");
+      return 1;
+   }
+
+   TRandom3 rnd(4357);
+   std::vector<double> px(npoints), py(npoints);
+   for (int i = 0; i < npoints; ++i)
+      px[i] = 10 * rnd.Rndm() * rnd.Rndm();
+   std::sort(px.begin(), px.end());
+   for (int i = 0; i < npoints; ++i)
+      py[i] = std::sin(px[i]);
+
+   // the same points in random order, and sorted in x
+   std::vector<double> ux(px), uy(py);
+   for (int i = npoints - 1; i > 0; --i) {
+      const int j = rnd.Integer(i + 1);
+      std::swap(ux[i], ux[j]);
+      std::swap(uy[i], uy[j]);
+   }
+   TGraph unsorted(npoints, ux.data(), uy.data());
+   TGraph sorted(npoints, px.data(), py.data());
+   sorted.SetBit(TGraph::kIsSortedX);
+   TGraph indexed(npoints, ux.data(), uy.data());
+   indexed.SetIndexedEval();
+   TSpline3 spline("spline", &sorted);
+
+   std::vector<double> xr(ncalls), xs(ncalls);
+   for (int i = 0; i < ncalls; ++i)
+      xr[i] = xs[i] = -0.5 + 11 * rnd.Rndm();
+   std::sort(xs.begin(), xs.end());
+
+   std::vector<double> ref(ncalls), refs(ncalls), y(ncalls), ys(ncalls);
+   TStopwatch timer;
+
+   printf("%d points, %d calls\n", npoints, ncalls);
+   printf("%-32s %14s %14s\n", "", "random (ns)", "sorted (ns)");
+
+   // the search over all the points is slow, use fewer calls
+   const int nslow = std::max(1, std::min(ncalls, int(1e8 / npoints)));
+   timer.Start();
+   for (int i = 0; i < nslow; ++i)
+      y[i] = unsorted.Eval(xr[i]);
+   const double tunsorted = timer.RealTime();
+   timer.Start();
+   for (int i = 0; i < nslow; ++i)
+      ys[i] = unsorted.Eval(xs[i]);
+   Report("TGraph::Eval, unsorted points", tunsorted, nslow, timer.RealTime(), nslow);
+
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      ref[i] = sorted.Eval(xr[i]);
+   const double tsorted = timer.RealTime();
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      refs[i] = sorted.Eval(xs[i]);
+   Report("TGraph::Eval, kIsSortedX", tsorted, ncalls, timer.RealTime(), ncalls);
+   Compare("TGraph::Eval, unsorted points", ref, y, nslow);
+
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      y[i] = indexed.Eval(xr[i]);
+   const double tindexed = timer.RealTime();
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      ys[i] = indexed.Eval(xs[i]);
+   Report("TGraph::Eval, indexed", tindexed, ncalls, timer.RealTime(), ncalls);
+   Compare("TGraph::Eval, indexed", ref, y, ncalls);
+   Compare("TGraph::Eval, indexed", refs, ys, ncalls);
+
+   timer.Start();
+   indexed.Eval(ncalls, xr.data(), y.data());
+   const double tbatch = timer.RealTime();
+   timer.Start();
+   indexed.Eval(ncalls, xs.data(), ys.data());
+   Report("TGraph::Eval, indexed batch", tbatch, ncalls, timer.RealTime(), ncalls);
+   Compare("TGraph::Eval, indexed batch", ref, y, ncalls);
+   Compare("TGraph::Eval, indexed batch", refs, ys, ncalls);
+
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      ref[i] = spline.Eval(xr[i]);
+   const double tspline = timer.RealTime();
+   timer.Start();
+   for (int i = 0; i < ncalls; ++i)
+      refs[i] = spline.Eval(xs[i]);
+   Report("TSpline3::Eval", tspline, ncalls, timer.RealTime(), ncalls);
+
+   timer.Start();
+   spline.Eval(ncalls, xr.data(), y.data());
+   const double tsplinebatch = timer.RealTime();
+   timer.Start();
+   spline.Eval(ncalls, xs.data(), ys.data());
+   Report("TSpline3::Eval, batch", tsplinebatch, ncalls, timer.RealTime(), ncalls);
+   Compare("TSpline3::Eval, batch", ref, y, ncalls);
+   Compare("TSpline3::Eval, batch", refs, ys, ncalls);
+
+   return 0;
+}
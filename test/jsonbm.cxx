@@ -0,0 +1,177 @@
+// @(#)root/test:$Id$
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <initializer_list>
+#include <sstream>
+#include <vector>
+
+#include "TBufferJSON.h"
+#include "TGeoManager.h"
+#include "TGeoMaterial.h"
+#include "TGeoMatrix.h"
+#include "TGeoMedium.h"
+#include "TGeoVolume.h"
+#include "TH2D.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+//
+// This program benchmarks the conversion of a TH2D and of a TGeo geometry
+// to JSON and to CBOR with TBufferJSON, and the conversion of the histogram
+// back from both.
+//
+// Usage: jsonbm -h                              - to print a usage info
+//        jsonbm [nbins] [nvolumes] [nloops]     - to run the benchmark
+//
+// parameters:
+//       nbins         - number of bins of each axis of the histogram (default 500)
+//       nvolumes      - number of volumes placed in the geometry (default 2000)
+//       nloops        - number of conversions timed (default 5)
+//
+// For each object and each conversion the program prints the mean time of a
+// conversion and the size of its output. The conversions are checked against
+// each other: the JSON streamed by ExportToStream must be the one returned by
+// ConvertToJSON, and the histogram read back must have the contents of the
+// original. A difference is reported as an error.
+
+int nbins    = 500;     // Number of bins of each axis of the histogram.
+int nvolumes = 2000;    // Number of volumes placed in the geometry.
+int nloops   = 5;       // Number of conversions timed.
+
+//_____________________________________________________________
+
+static void Report(const char *name, double seconds, Long64_t size)
+{
+   printf("%-40s %12.2f %14lld\n", name, 1e3 * seconds / nloops, size);
+}
+
+//_____________________________________________________________
+
+static void CompareHistos(const char *name, const TH2D &ref, const TObject *obj)
+{
+   auto h2 = dynamic_cast<const TH2D *>(obj);
+   if (!h2 || h2->GetNcells() != ref.GetNcells()) {
+      printf("Error: %s did not read back the histogram\n", name);
+      return;
+   }
+   for (int bin = 0; bin < ref.GetNcells(); ++bin) {
+      if (h2->GetBinContent(bin) != ref.GetBinContent(bin) || h2->GetBinError(bin) != ref.GetBinError(bin)) {
+         printf("Error: %s differs in bin %d: %g instead of %g\n", name, bin, h2->GetBinContent(bin),
+                ref.GetBinContent(bin));
+         return;
+      }
+   }
+}
+
+//_____________________________________________________________
+
+static void Benchmark(const char *title, const TObject *obj, const TH2D *h2)
+{
+   TStopwatch timer;
+   TString json, name;
+   printf("%s\n", title);
+
+   // the round trip formatting (third digit of compact) is needed to read back the same values
+   for (int compact : {23, 123}) {
+      name.Form("ConvertToJSON, compact %d", compact);
+      timer.Start();
+      for (int i = 0; i < nloops; ++i)
+         json = TBufferJSON::ConvertToJSON(obj, compact);
+      Report(name, timer.RealTime(), json.Length());
+
+      name.Form("ExportToStream, compact %d", compact);
+      std::ostringstream out;
+      timer.Start();
+      for (int i = 0; i < nloops; ++i) {
+         out.str("");
+         TBufferJSON::ExportToStream(out, obj, compact);
+      }
+      Report(name, timer.RealTime(), out.str().size());
+      if (out.str() != json.Data())
+         printf("Error: %s differs from ConvertToJSON\n", name.Data());
+   }
+
+   std::vector<UChar_t> cbor;
+   timer.Start();
+   for (int i = 0; i < nloops; ++i)
+      cbor = TBufferJSON::ConvertToCBOR(obj, 123);
+   Report("ConvertToCBOR, compact 123", timer.RealTime(), cbor.size());
+   if (cbor.empty())
+      printf("Error: ConvertToCBOR failed\n");
+
+   if (!h2)
+      return;
+
+   TObject *read = nullptr;
+   timer.Start();
+   for (int i = 0; i < nloops; ++i) {
+      delete read;
+      read = TBufferJSON::ConvertFromJSON(json);
+   }
+   Report("ConvertFromJSON", timer.RealTime(), json.Length());
+   CompareHistos("ConvertFromJSON", *h2, read);
+   delete read;
+   read = nullptr;
+
+   timer.Start();
+   for (int i = 0; i < nloops; ++i) {
+      delete read;
+      read = TBufferJSON::ConvertFromCBOR(cbor);
+   }
+   Report("ConvertFromCBOR", timer.RealTime(), cbor.size());
+   CompareHistos("ConvertFromCBOR", *h2, read);
+   delete read;
+}
+
+//_____________________________________________________________
+
+int main(int argc, char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: jsonbm [nbins] [nvolumes] [nloops]\n");
+      return 0;
+   }
+   if (argc > 1) nbins    = atoi(argv[1]);
+   if (argc > 2) nvolumes = atoi(argv[2]);
+   if (argc > 3) nloops   = atoi(argv[3]);
+   if (nbins < 1 || nvolumes < 1 || nloops < 1) {
+      printf("Error: at least 1 bin, 1 volume and 1 loop are needed\n");
+      return 1;
+   }
+
+   printf("%-40s %12s %14s\n", "", "time (ms)", "size (bytes)");
+
+   // a histogram filled with a gaussian: counts, non-integral errors and empty bins
+   TRandom3 rnd(4357);
+   TH2D h2("h2", "jsonbm histogram", nbins, -4, 4, nbins, -4, 4);
+   h2.SetDirectory(nullptr);
+   h2.Sumw2();
+   for (int i = 0; i < 20 * nbins * nbins; ++i)
+      h2.Fill(rnd.Gaus(), rnd.Gaus(), 0.5 + rnd.Rndm());
+   Benchmark(TString::Format("TH2D, %d x %d bins", nbins, nbins), &h2, &h2);
+
+   // a geometry of tubes placed in layers
+   auto geom = new TGeoManager("jsonbm", "jsonbm geometry");
+   auto mat = new TGeoMaterial("Al", 26.98, 13, 2.7);
+   auto med = new TGeoMedium("Al", 1, mat);
+   auto top = geom->MakeBox("top", med, 1000, 1000, 1000);
+   geom->SetTopVolume(top);
+   const int nlayers = 10;
+   const int ntubes = (nvolumes + nlayers - 1) / nlayers;
+   auto layer = geom->MakeBox("layer", med, 900, 900, 40);
+   for (int i = 0; i < ntubes; ++i) {
+      auto tube = geom->MakeTube(TString::Format("tube%d", i), med, 1, 2 + rnd.Rndm(), 30);
+      layer->AddNode(tube, i, new TGeoTranslation(-800 + 1600 * rnd.Rndm(), -800 + 1600 * rnd.Rndm(), 0));
+   }
+   for (int i = 0; i < nlayers; ++i)
+      top->AddNode(layer, i, new TGeoTranslation(0, 0, -900 + 200 * i));
+   geom->CloseGeometry();
+   Benchmark(TString::Format("TGeoManager, %d volumes", nlayers * ntubes), geom, nullptr);
+   delete geom;
+
+   return 0;
+}
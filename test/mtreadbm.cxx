@@ -0,0 +1,190 @@
+// @(#)root/test:$Id$
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TClass.h"
+#include "TFile.h"
+#include "TH1F.h"
+#include "TNamed.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+//
+// This program benchmarks the scaling of reading many trees from many
+// threads, and of TClass lookups of already loaded classes, which all the
+// reading threads perform constantly (TBranchElement, TBufferFile::ReadObjectAny,
+// TStreamerInfo...).
+//
+// Usage: mtreadbm -h                                   - to print a usage info
+//        mtreadbm [nfiles] [nentries] [maxthreads]     - to run the benchmark
+//
+// parameters:
+//       nfiles        - number of files, each holding one tree (default 16)
+//       nentries      - number of entries per tree (default 20000)
+//       maxthreads    - largest number of threads (default: number of cores)
+//
+// The files are written to the working directory and removed at the end.
+// For each number of threads (1, 2, 4, ..., maxthreads) the program prints
+// the time needed to read all the trees, each thread reading whole files,
+// and the time needed for a fixed number of TClass::GetClass calls per thread.
+
+int nfiles   = 16;        // Number of files to read.
+int nentries = 20000;     // Number of entries per tree.
+int nthreads = 0;         // Largest number of threads.
+
+//_____________________________________________________________
+
+static TString FileName(int i)
+{
+   return TString::Format("mtreadbm_%d.root", i);
+}
+
+//_____________________________________________________________
+
+static void WriteFiles()
+{
+   for (int i = 0; i < nfiles; ++i) {
+      TFile f(FileName(i), "RECREATE");
+      TTree *t = new TTree("T", "mtreadbm tree");
+      TNamed *named = new TNamed();
+      TH1F *hist = new TH1F("h", "h", 10, 0., 10.);
+      std::vector<float> values;
+      t->Branch("named", &named);
+      t->Branch("hist", &hist, 32000, 0);
+      t->Branch("values", &values);
+      for (int e = 0; e < nentries; ++e) {
+         named->SetName(TString::Format("entry%d", e));
+         hist->Fill(e % 10);
+         values.assign(e % 16, e);
+         t->Fill();
+      }
+      t->Write();
+      delete named;
+      delete hist;
+   }
+}
+
+//_____________________________________________________________
+
+static Long64_t ReadFile(int i)
+{
+   TFile f(FileName(i));
+   TTree *t = nullptr;
+   f.GetObject("T", t);
+   if (!t)
+      return 0;
+   TNamed *named = nullptr;
+   TH1F *hist = nullptr;
+   std::vector<float> *values = nullptr;
+   t->SetBranchAddress("named", &named);
+   t->SetBranchAddress("hist", &hist);
+   t->SetBranchAddress("values", &values);
+   Long64_t nbytes = 0;
+   for (Long64_t e = 0; e < t->GetEntries(); ++e)
+      nbytes += t->GetEntry(e);
+   t->ResetBranchAddresses();
+   delete named;
+   delete hist;
+   delete values;
+   return nbytes;
+}
+
+//_____________________________________________________________
+
+static double TimeRead(int nthr)
+{
+   std::atomic<int> next(0);
+   std::atomic<Long64_t> nbytes(0);
+   TStopwatch timer;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < nthr; ++t) {
+      threads.emplace_back([&]() {
+         for (int i = next++; i < nfiles; i = next++)
+            nbytes += ReadFile(i);
+      });
+   }
+   for (auto &thr : threads)
+      thr.join();
+   timer.Stop();
+   if (nbytes == 0)
+      printf("Error: no data read\n");
+   return timer.RealTime();
+}
+
+//_____________________________________________________________
+
+static double TimeLookups(int nthr)
+{
+   const int nlookups = 1000000;
+   static const char *names[] = {"TNamed", "TH1F", "TTree", "vector<float>", "TBranchElement", "TObjArray"};
+   const int nnames = sizeof(names) / sizeof(names[0]);
+   std::atomic<int> nfailed(0);
+   TStopwatch timer;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < nthr; ++t) {
+      threads.emplace_back([&]() {
+         for (int i = 0; i < nlookups; ++i) {
+            if (!TClass::GetClass(names[i % nnames]))
+               ++nfailed;
+            if (!TClass::GetClass(typeid(TNamed)))
+               ++nfailed;
+         }
+      });
+   }
+   for (auto &thr : threads)
+      thr.join();
+   timer.Stop();
+   if (nfailed)
+      printf("Error: %d lookups failed\n", nfailed.load());
+   return timer.RealTime();
+}
+
+//_____________________________________________________________
+
+int main(int argc, char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: mtreadbm [nfiles] [nentries] [maxthreads]\n");
+      return 0;
+   }
+   if (argc > 1) nfiles   = atoi(argv[1]);
+   if (argc > 2) nentries = atoi(argv[2]);
+   if (argc > 3) nthreads = atoi(argv[3]);
+   if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+   ROOT::EnableThreadSafety();
+   TH1::AddDirectory(kFALSE);
+
+   printf("Writing %d trees of %d entries\n", nfiles, nentries);
+   WriteFiles();
+
+   printf("%8s %14s %10s %16s %10s\n", "threads", "read time (s)", "speedup", "lookup time (s)", "speedup");
+   double read1 = 0, lookup1 = 0;
+   for (int nthr = 1;; nthr = std::min(2 * nthr, nthreads)) {
+      const double read = TimeRead(nthr);
+      const double lookup = TimeLookups(nthr);
+      if (nthr == 1) {
+         read1 = read;
+         lookup1 = lookup;
+      }
+      // Perfect scaling: reads are nthr times faster, lookups (nthr times more of them) take the same time.
+      printf("%8d %14.3f %10.2f %16.3f %10.2f\n", nthr, read, read > 0 ? read1 / read : 0.,
+             lookup, lookup > 0 ? nthr * lookup1 / lookup : 0.);
+      if (nthr == nthreads)
+         break;
+   }
+
+   for (int i = 0; i < nfiles; ++i)
+      gSystem->Unlink(FileName(i));
+   return 0;
+}
@@ -170,10 +170,6 @@ class FillHelper : public RActionImpl<FillHelper> {
    unsigned int fBufSize;
    /// Histograms containing "snapshots" of partial results. Non-null only if a registered callback requires it.
    Results<std::unique_ptr<Hist_t>> fPartialHists;
-   Buf_t fMin;
-   Buf_t fMax;
-
-   void UpdateMinMax(unsigned int slot, double v);
 
 public:
    FillHelper(const std::shared_ptr<Hist_t> &h, const unsigned int nSlots);
@@ -188,7 +184,6 @@ public:
    {
       auto &thisBuf = fBuffers[slot];
       for (auto &v : vs) {
-         UpdateMinMax(slot, v);
          thisBuf.emplace_back(v); // TODO: Can be optimised in case T == BufEl_t
       }
    }
@@ -199,7 +194,6 @@ public:
    {
       auto &thisBuf = fBuffers[slot];
       for (auto &v : vs) {
-         UpdateMinMax(slot, v);
          thisBuf.emplace_back(v); // TODO: Can be optimised in case T == BufEl_t
       }
 
@@ -230,9 +224,23 @@ extern template void FillHelper::Exec(unsigned int, const std::vector<int> &, co
 extern template void
 FillHelper::Exec(unsigned int, const std::vector<unsigned int> &, const std::vector<unsigned int> &);
 
+/// Whether a histogram is filled concurrently by all the threads, see TH1::SetConcurrentFill.
+template <typename HIST, typename std::enable_if<std::is_base_of<::TH1, HIST>::value, int>::type = 0>
+bool IsConcurrentFill(const HIST &h)
+{
+   return h.IsConcurrentFill();
+}
+
+template <typename HIST, typename std::enable_if<!std::is_base_of<::TH1, HIST>::value, int>::type = 0>
+bool IsConcurrentFill(const HIST &)
+{
+   return false;
+}
+
 template <typename HIST = Hist_t>
 class FillParHelper : public RActionImpl<FillParHelper<HIST>> {
    std::vector<HIST *> fObjects;
+   bool fIsShared = false; ///< All the slots fill the same histogram, filled concurrently
 
 public:
    FillParHelper(FillParHelper &&) = default;
@@ -241,6 +249,13 @@ public:
    FillParHelper(const std::shared_ptr<HIST> &h, const unsigned int nSlots) : fObjects(nSlots, nullptr)
    {
       fObjects[0] = h.get();
+      // A histogram filled concurrently is shared by the slots instead of being copied
+      if (IsConcurrentFill(*fObjects[0])) {
+         fIsShared = true;
+         for (unsigned int i = 1; i < nSlots; ++i)
+            fObjects[i] = fObjects[0];
+         return;
+      }
       // Initialise all other slots
       for (unsigned int i = 1; i < nSlots; ++i) {
          fObjects[i] = new HIST(*fObjects[0]);
@@ -336,6 +351,8 @@ public:
 
    void Finalize()
    {
+      if (fIsShared)
+         return;
       auto resObj = fObjects[0];
       const auto nSlots = fObjects.size();
       TList l;
@@ -1058,6 +1075,8 @@ public:
 
       if (fOptions.fAutoFlush)
          fOutputTree->SetAutoFlush(fOptions.fAutoFlush);
+      if (fOptions.fBasketsPerCluster)
+         fOutputTree->SetTargetBasketsPerCluster(fOptions.fBasketsPerCluster);
    }
 
    void Finalize()
@@ -1123,6 +1142,8 @@ public:
          std::make_unique<TTree>(fTreeName.c_str(), fTreeName.c_str(), fOptions.fSplitLevel, /*dir=*/treeDirectory);
       if (fOptions.fAutoFlush)
          fOutputTrees[slot]->SetAutoFlush(fOptions.fAutoFlush);
+      if (fOptions.fBasketsPerCluster)
+         fOutputTrees[slot]->SetTargetBasketsPerCluster(fOptions.fBasketsPerCluster);
       if (r) {
          // not an empty-source RDF
          fInputTrees[slot] = r->GetTree();
@@ -35,6 +35,7 @@ struct RSnapshotOptions {
    int fAutoFlush = 0;                         ///< AutoFlush value for output tree
    int fSplitLevel = 99;                       ///< Split level of output tree
    bool fLazy = false;                         ///< Delay the snapshot of the dataset
+   int fBasketsPerCluster = 0;                 ///< Target number of baskets per cluster and branch (0: TTree's default), see TTree::SetTargetBasketsPerCluster
 };
 } // ns RDF
 } // ns ROOT
@@ -9,6 +9,8 @@
  *************************************************************************/
 
 #include "ROOT/RDF/ActionHelpers.hxx"
+#include "TList.h"
+#include "TQuantileSketch.h"
 
 namespace ROOT {
 namespace Internal {
@@ -37,17 +39,8 @@ ULong64_t &CountHelper::PartialUpdate(unsigned int slot)
    return fCounts[slot];
 }
 
-void FillHelper::UpdateMinMax(unsigned int slot, double v)
-{
-   auto &thisMin = fMin[slot];
-   auto &thisMax = fMax[slot];
-   thisMin = std::min(thisMin, v);
-   thisMax = std::max(thisMax, v);
-}
-
 FillHelper::FillHelper(const std::shared_ptr<Hist_t> &h, const unsigned int nSlots)
-   : fResultHist(h), fNSlots(nSlots), fBufSize(fgTotalBufSize / nSlots), fPartialHists(fNSlots),
-     fMin(nSlots, std::numeric_limits<BufEl_t>::max()), fMax(nSlots, std::numeric_limits<BufEl_t>::lowest())
+   : fResultHist(h), fNSlots(nSlots), fBufSize(fgTotalBufSize / nSlots), fPartialHists(fNSlots)
 {
    fBuffers.reserve(fNSlots);
    fWBuffers.reserve(fNSlots);
@@ -61,13 +54,11 @@ FillHelper::FillHelper(const std::shared_ptr<Hist_t> &h, const unsigned int nSlo
 
 void FillHelper::Exec(unsigned int slot, double v)
 {
-   UpdateMinMax(slot, v);
    fBuffers[slot].emplace_back(v);
 }
 
 void FillHelper::Exec(unsigned int slot, double v, double w)
 {
-   UpdateMinMax(slot, v);
    fBuffers[slot].emplace_back(v);
    fWBuffers[slot].emplace_back(w);
 }
@@ -78,11 +69,14 @@ Hist_t &FillHelper::PartialUpdate(unsigned int slot)
    // TODO it is inefficient to re-create the partial histogram everytime the callback is called
    //      ideally we could incrementally fill it with the latest entries in the buffers
    partialHist = std::make_unique<Hist_t>(*fResultHist);
+   partialHist->SetDirectory(nullptr);
    auto weights = fWBuffers[slot].empty() ? nullptr : fWBuffers[slot].data();
    partialHist->FillN(fBuffers[slot].size(), fBuffers[slot].data(), weights);
    return *partialHist;
 }
 
+/// The axis limits are the exact range of the values of all the slots, found from the merge of a sketch of
+/// the values of each slot: they do not depend on how the entries were shared among the slots.
 void FillHelper::Finalize()
 {
    for (unsigned int i = 0; i < fNSlots; ++i) {
@@ -91,12 +85,18 @@ void FillHelper::Finalize()
       }
    }
 
-   BufEl_t globalMin = *std::min_element(fMin.begin(), fMin.end());
-   BufEl_t globalMax = *std::max_element(fMax.begin(), fMax.end());
-
-   if (fResultHist->CanExtendAllAxes() && globalMin != std::numeric_limits<BufEl_t>::max() &&
-       globalMax != std::numeric_limits<BufEl_t>::lowest()) {
-      fResultHist->SetBins(fResultHist->GetNbinsX(), globalMin, globalMax);
+   if (fResultHist->CanExtendAllAxes()) {
+      TList sketches;
+      sketches.SetOwner();
+      for (auto &buf : fBuffers) {
+         auto sketch = new TQuantileSketch;
+         sketch->FillN(buf.size(), buf.data());
+         sketches.Add(sketch);
+      }
+      TQuantileSketch range;
+      range.Merge(&sketches);
+      if (range.GetEntries())
+         fResultHist->SetBins(fResultHist->GetNbinsX(), range.GetMinimum(), range.GetMaximum());
    }
 
    for (unsigned int i = 0; i < fNSlots; ++i) {
@@ -4,6 +4,7 @@
 #include <ROOT/TSeq.hxx>
 #include <TFile.h>
 #include <TGraph.h>
+#include <TH1D.h>
 #include <TInterpreter.h>
 #include <TRandom.h>
 #include <TROOT.h>
@@ -722,6 +723,35 @@ TEST_P(RDFSimpleTests, StandardDeviationEmpty)
    EXPECT_DOUBLE_EQ(*stdDev, 0);
 }
 
+// More entries than the buffers of the histograms without model were sized for: the axis is booked on the
+// exact range of all the values, whichever slots read them, as for a histogram filled with all of them at once
+TEST_P(RDFSimpleTests, Histo1DWithoutModelRange)
+{
+   const ULong64_t nEntries = 3000000;
+   auto df = RDataFrame(nEntries).Define("x", [](ULong64_t e) { return e * 1e-6; }, {"rdfentry_"})
+                                 .Define("w", []() { return 2.; });
+   auto h = df.Histo1D<double>("x");
+   auto hw = df.Histo1D<double, double>("x", "w");
+
+   std::vector<double> x(nEntries);
+   for (ULong64_t e = 0; e < nEntries; ++e)
+      x[e] = e * 1e-6;
+   TH1D ref("ref", "", h->GetNbinsX(), x.front(), x.back());
+   ref.SetDirectory(nullptr);
+   ref.SetCanExtend(TH1::kAllAxes);
+   ref.FillN(nEntries, x.data(), nullptr);
+
+   for (auto hist : {h.GetPtr(), hw.GetPtr()}) {
+      const double w = hist == h.GetPtr() ? 1 : 2;
+      EXPECT_EQ(hist->GetEntries(), nEntries);
+      ASSERT_EQ(hist->GetNbinsX(), ref.GetNbinsX());
+      EXPECT_EQ(hist->GetXaxis()->GetXmin(), ref.GetXaxis()->GetXmin());
+      EXPECT_EQ(hist->GetXaxis()->GetXmax(), ref.GetXaxis()->GetXmax());
+      for (int bin = 0; bin <= ref.GetNbinsX() + 1; ++bin)
+         EXPECT_EQ(hist->GetBinContent(bin), w * ref.GetBinContent(bin)) << "bin " << bin;
+   }
+}
+
 static const std::string DisplayPrintDefaultRows(
    "b1 | b2  | b3        | \n0  | 1   | 2.0000000 | \n   | ... |           | \n   | 3   |           | \n0  | 1   | "
    "2.0000000 | \n   | ... |           | \n   | 3   |           | \n0  | 1   | 2.0000000 | \n   | ... |           | \n "
@@ -33,6 +33,10 @@
 #pragma link C++ class TEventList-;
 #pragma link C++ class TFriendElement+;
 #pragma link C++ class ROOT::TIOFeatures+;
+#pragma link C++ class ROOT::Experimental::TEntryBitmap;
+#pragma link C++ class ROOT::Experimental::TEntryBitmapFiller;
+#pragma link C++ class ROOT::Experimental::TParallelTreeWriter;
+#pragma link C++ class ROOT::Experimental::TParallelTreeFiller;
 #pragma link C++ class TTreeFriendLeafIter;
 #pragma link C++ class TLeaf-;
 #pragma link C++ class TLeafElement+;
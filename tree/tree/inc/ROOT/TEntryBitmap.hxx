@@ -0,0 +1,242 @@
+// @(#)root/tree:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TEntryBitmap
+#define ROOT_TEntryBitmap
+
+#include "RtypesCore.h"
+
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class TEntryList;
+
+namespace ROOT {
+namespace Experimental {
+
+namespace Internal {
+/// Index of the lowest set bit of a non-zero word.
+inline UInt_t CountTrailingZeros(ULong64_t word)
+{
+#ifdef _MSC_VER
+   unsigned long idx;
+   _BitScanForward64(&idx, word);
+   return idx;
+#else
+   return __builtin_ctzll(word);
+#endif
+}
+} // namespace Internal
+
+/**
+ * \class TEntryBitmap TEntryBitmap.hxx
+ * \ingroup tree
+ *
+ * A compressed set of TTree entry numbers, organised like a "roaring bitmap".
+ *
+ * Entry numbers are split in a high part (entry >> 16), used as key of a sorted
+ * container list, and a low 16-bit part stored in one of three container kinds:
+ *  - a sorted array of UShort_t, for sparse chunks (up to 4096 values);
+ *  - a bitmap of 65536 bits, for dense chunks;
+ *  - a sorted list of runs (begin, length-1), for chunks made of long contiguous ranges.
+ *
+ * Set operations (And(), Or(), AndNot()) work container by container and use
+ * word-wise loops on bitmaps that the compiler can vectorize. Many bitmaps can be
+ * combined at once with Union(), and filling from several threads is done with
+ * one TEntryBitmap per slot (see TEntryBitmapFiller) that are united at the end.
+ *
+ * The persistent format stays TEntryList: FromEntryList() and FillEntryList() convert
+ * between the two representations.
+ */
+
+class TEntryBitmap {
+public:
+   /// A contiguous range of entries [fBegin, fEnd).
+   struct TRange {
+      Long64_t fBegin;
+      Long64_t fEnd;
+   };
+
+   /// Storage of the low 16 bits of the entries sharing the same high bits.
+   class TContainer {
+   public:
+      enum EType : UChar_t { kArray, kBitmap, kRun };
+      enum : UInt_t {
+         kMaxArraySize = 4096, ///< above this cardinality an array is converted to a bitmap
+         kBitmapWords = 1024   ///< number of 64 bit words of a bitmap container
+      };
+
+      EType fType{kArray};            ///< representation of this container
+      UInt_t fCardinality{0};         ///< number of entries in the container
+      std::vector<UShort_t> fValues;  ///< kArray: sorted values; kRun: pairs of (begin, length-1)
+      std::vector<ULong64_t> fBits;   ///< kBitmap: kBitmapWords words
+
+      bool Add(UShort_t v);
+      bool Remove(UShort_t v);
+      bool Contains(UShort_t v) const;
+      void AddRange(UInt_t begin, UInt_t end);
+      void ToBitmap();
+      void Optimize(bool allowRuns);
+      template <typename F>
+      void ForEachRange(F &&f) const;
+   };
+
+private:
+   std::vector<ULong64_t> fKeys;        ///< high bits (entry >> 16) of each container, sorted
+   std::vector<TContainer> fContainers; ///< one container per key
+   Long64_t fN{0};                      ///< number of entries in the set
+
+   Long64_t FindKey(ULong64_t key) const;
+   TContainer &GetOrCreate(ULong64_t key);
+
+public:
+   TEntryBitmap() = default;
+
+   bool Enter(Long64_t entry);
+   bool Remove(Long64_t entry);
+   bool Contains(Long64_t entry) const;
+   void EnterRange(Long64_t begin, Long64_t end);
+   void Clear();
+
+   /// Number of entries in the set.
+   Long64_t GetN() const { return fN; }
+   bool IsEmpty() const { return fN == 0; }
+   Long64_t GetFirst() const;
+   Long64_t GetLast() const;
+   std::size_t GetMemoryUsage() const;
+   void Optimize();
+
+   TEntryBitmap &And(const TEntryBitmap &other);
+   TEntryBitmap &Or(const TEntryBitmap &other);
+   TEntryBitmap &AndNot(const TEntryBitmap &other);
+
+   TEntryBitmap &operator&=(const TEntryBitmap &other) { return And(other); }
+   TEntryBitmap &operator|=(const TEntryBitmap &other) { return Or(other); }
+   TEntryBitmap &operator-=(const TEntryBitmap &other) { return AndNot(other); }
+
+   bool operator==(const TEntryBitmap &other) const;
+   bool operator!=(const TEntryBitmap &other) const { return !(*this == other); }
+
+   static TEntryBitmap Union(const std::vector<const TEntryBitmap *> &bitmaps);
+
+   /// Call `f(begin, end)` for each maximal range [begin, end) of consecutive entries, in increasing order.
+   template <typename F>
+   void ForEachRange(F &&f) const
+   {
+      Long64_t curBegin = -1;
+      Long64_t curEnd = -1;
+      for (std::size_t i = 0; i < fKeys.size(); ++i) {
+         const Long64_t base = static_cast<Long64_t>(fKeys[i] << 16);
+         fContainers[i].ForEachRange([&](UInt_t b, UInt_t e) {
+            const Long64_t begin = base + b;
+            if (begin == curEnd) {
+               curEnd = base + e;
+               return;
+            }
+            if (curBegin >= 0)
+               f(curBegin, curEnd);
+            curBegin = begin;
+            curEnd = base + e;
+         });
+      }
+      if (curBegin >= 0)
+         f(curBegin, curEnd);
+   }
+
+   /// Call `f(entry)` for each entry of the set, in increasing order.
+   template <typename F>
+   void ForEach(F &&f) const
+   {
+      ForEachRange([&f](Long64_t b, Long64_t e) {
+         for (Long64_t entry = b; entry < e; ++entry)
+            f(entry);
+      });
+   }
+
+   std::vector<TRange> GetRanges() const;
+
+   static TEntryBitmap FromEntryList(const TEntryList &elist);
+   void FillEntryList(TEntryList &elist) const;
+};
+
+template <typename F>
+void TEntryBitmap::TContainer::ForEachRange(F &&f) const
+{
+   switch (fType) {
+   case kArray: {
+      const std::size_t n = fValues.size();
+      std::size_t i = 0;
+      while (i < n) {
+         UInt_t begin = fValues[i];
+         UInt_t end = begin + 1;
+         while (++i < n && fValues[i] == end)
+            ++end;
+         f(begin, end);
+      }
+      break;
+   }
+   case kRun:
+      for (std::size_t i = 0; i + 1 < fValues.size(); i += 2)
+         f(UInt_t(fValues[i]), UInt_t(fValues[i]) + fValues[i + 1] + 1);
+      break;
+   case kBitmap: {
+      // Walk the bitmap looking for transitions, skipping whole empty or full words.
+      UInt_t pos = 0;
+      const UInt_t nbits = kBitmapWords * 64;
+      while (pos < nbits) {
+         // find next set bit
+         UInt_t w = pos >> 6;
+         ULong64_t word = fBits[w] & (~0ULL << (pos & 63));
+         while (!word && ++w < kBitmapWords)
+            word = fBits[w];
+         if (!word)
+            break;
+         UInt_t begin = (w << 6) + Internal::CountTrailingZeros(word);
+         // find next unset bit
+         ULong64_t inv = ~fBits[w] & (~0ULL << (begin & 63));
+         while (!inv && ++w < kBitmapWords)
+            inv = ~fBits[w];
+         UInt_t end = inv ? (w << 6) + Internal::CountTrailingZeros(inv) : nbits;
+         f(begin, end);
+         pos = end;
+      }
+      break;
+   }
+   }
+}
+
+/**
+ * \class TEntryBitmapFiller TEntryBitmap.hxx
+ * \ingroup tree
+ *
+ * Lock-free filling of a TEntryBitmap from several threads: each thread (slot)
+ * fills its own bitmap, which are united by Merge() once filling is done.
+ */
+
+class TEntryBitmapFiller {
+   std::vector<TEntryBitmap> fSlots; ///< one partial bitmap per slot
+
+public:
+   explicit TEntryBitmapFiller(unsigned int nSlots) : fSlots(nSlots) {}
+
+   /// Enter `entry` in the partial bitmap of `slot`. Each slot must be used by one thread at a time.
+   bool Enter(unsigned int slot, Long64_t entry) { return fSlots[slot].Enter(entry); }
+   TEntryBitmap &GetSlot(unsigned int slot) { return fSlots[slot]; }
+   unsigned int GetNSlots() const { return fSlots.size(); }
+   TEntryBitmap Merge() const;
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
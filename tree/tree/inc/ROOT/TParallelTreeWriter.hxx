@@ -0,0 +1,150 @@
+// @(#)root/tree:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TParallelTreeWriter
+#define ROOT_TParallelTreeWriter
+
+#include "RtypesCore.h"
+#include "TString.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class TDirectory;
+class TMemFile;
+class TTree;
+
+namespace ROOT {
+namespace Experimental {
+
+class TParallelTreeFiller;
+
+/**
+ * \class TParallelTreeWriter TParallelTreeWriter.hxx
+ * \ingroup tree
+ *
+ * TParallelTreeWriter fills a single TTree from several threads.
+ *
+ * Each thread obtains its own TParallelTreeFiller with GetFiller(), defines
+ * the branches of the filler's tree (identically in all threads) and calls
+ * TParallelTreeFiller::Fill(). Every `clusterSize` entries, the filler
+ * compresses its baskets in its own thread and hands them to the writer,
+ * which appends the already compressed baskets to the output TTree (see
+ * TTreeCloner) and records the new cluster. The output TTree is thus made of
+ * clusters coming from the different threads, in commit order, with
+ * consistent entry numbering and cluster ranges.
+ *
+ * Contrary to TBufferMerger, no intermediate file is serialized and merged:
+ * each filler only ever holds one cluster worth of baskets in memory, and
+ * the only serialized step is the copy of the compressed baskets.
+ *
+ * ROOT::EnableThreadSafety() must be called before using the fillers from
+ * several threads.
+ */
+
+class TParallelTreeWriter {
+public:
+   /** Constructor
+    * @param dir Output directory, in a writable file
+    * @param name Name of the output TTree
+    * @param title Title of the output TTree
+    * @param clusterSize Number of entries per cluster
+    */
+   TParallelTreeWriter(TDirectory *dir, const char *name, const char *title = "", Long64_t clusterSize = 1000);
+
+   /** Destructor. Writes the output TTree header, see Write(). */
+   ~TParallelTreeWriter();
+
+   /** Returns a filler to be used by one thread at a time.
+    *  Pending entries are committed when the filler is destroyed or flushed.
+    */
+   std::shared_ptr<TParallelTreeFiller> GetFiller();
+
+   /** Returns the output TTree, or nullptr before the first commit. */
+   TTree *GetTree() const { return fTree; }
+
+   /** Returns the number of entries committed to the output TTree. */
+   Long64_t GetEntries() const;
+
+   /** Returns the number of clusters committed to the output TTree. */
+   Long64_t GetNClusters() const;
+
+   Long64_t GetClusterSize() const { return fClusterSize; }
+
+   /** Writes the header of the output TTree to its directory.
+    *  All the fillers must have been destroyed or flushed before.
+    */
+   Int_t Write();
+
+   friend class TParallelTreeFiller;
+
+private:
+   TParallelTreeWriter(const TParallelTreeWriter &) = delete;
+   TParallelTreeWriter &operator=(const TParallelTreeWriter &) = delete;
+
+   Bool_t Commit(TTree &cluster);
+
+   TDirectory *fDirectory{nullptr};                                ///< Output directory
+   TString fName;                                                  ///< Name of the output TTree
+   TString fTitle;                                                 ///< Title of the output TTree
+   Long64_t fClusterSize{1000};                                    ///< Number of entries per cluster
+   TTree *fTree{nullptr};                                          ///< Output TTree
+   Long64_t fNClusters{0};                                         ///< Number of committed clusters
+   mutable std::mutex fCommitMutex;                                ///< Serializes the commits to fTree
+   std::vector<std::weak_ptr<TParallelTreeFiller>> fAttachedFillers; ///< Fillers handed out by GetFiller()
+};
+
+/**
+ * \class TParallelTreeFiller TParallelTreeWriter.hxx
+ * \ingroup tree
+ *
+ * Per-thread filling end point of a TParallelTreeWriter. The filler owns an
+ * in-memory TTree, on which the user creates the branches and sets their
+ * addresses, exactly as for a normal TTree.
+ */
+
+class TParallelTreeFiller {
+private:
+   TParallelTreeWriter &fWriter;    ///< Writer this filler commits to
+   std::unique_ptr<TMemFile> fFile; ///< Memory file holding the baskets of the current cluster
+   TTree *fTree{nullptr};           ///< Tree being filled, owned by fFile
+   Long64_t fNCommitted{0};         ///< Number of entries committed by this filler
+
+   TParallelTreeFiller(TParallelTreeWriter &writer);
+
+   TParallelTreeFiller(const TParallelTreeFiller &) = delete;
+   TParallelTreeFiller &operator=(const TParallelTreeFiller &) = delete;
+
+   friend class TParallelTreeWriter;
+
+public:
+   /** Destructor, commits the pending entries. */
+   ~TParallelTreeFiller();
+
+   /** Returns the tree on which branches must be defined and addresses set. */
+   TTree *GetTree() const { return fTree; }
+
+   /** Fill one entry; compress and commit the cluster when it is complete.
+    *  Returns the number of bytes filled, or -1 if the commit failed.
+    */
+   Int_t Fill();
+
+   /** Compress and commit the pending entries as a (possibly smaller) cluster. */
+   Bool_t Flush();
+
+   /** Returns the number of entries committed by this filler. */
+   Long64_t GetNCommitted() const { return fNCommitted; }
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
@@ -102,6 +102,7 @@ protected:
    Long64_t    fFirstEntry;       ///<  Number of the first entry in this branch
    Long64_t    fTotBytes;         ///<  Total number of bytes in all leaves before compression
    Long64_t    fZipBytes;         ///<  Total number of bytes in all leaves after compression
+   Long64_t    fClusterTotBytes{0}; ///<! Value of fTotBytes when the basket size was last adapted by the tree
    TObjArray   fBranches;         ///< -> List of Branches of this branch
    TObjArray   fLeaves;           ///< -> List of leaves of this branch
    TObjArray   fBaskets;          ///< -> List of baskets of this branch
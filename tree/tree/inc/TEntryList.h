@@ -22,11 +22,19 @@ class TString;
 class TList;
 class TCollection;
 
+namespace ROOT {
+namespace Experimental {
+class TEntryBitmap;
+}
+}
+
 class TEntryList: public TNamed
 {
  private:
    TEntryList& operator=(const TEntryList&); // Not implemented
 
+   friend class ROOT::Experimental::TEntryBitmap;
+
  protected:
    TList      *fLists;                  ///<  a list of underlying entry lists for each tree of a chain
    TEntryList *fCurrent;                ///<! currently filled entry list
@@ -40,8 +40,16 @@
 
 #include "TObject.h"
 
+namespace ROOT {
+namespace Experimental {
+class TEntryBitmap;
+}
+}
+
 class TEntryListBlock:public TObject
 {
+   friend class ROOT::Experimental::TEntryBitmap;
+
  protected:
    Int_t    fNPassed;           ///< number of entries in the entry list (if fPassing=0 - number of entries
                                 ///< not in the entry list
@@ -138,9 +138,13 @@ protected:
    mutable std::atomic<ULong64_t> fAllocationTime{0}; ///<! Time spent reallocating basket memory buffers, in microseconds.
 #endif
    mutable std::atomic<UInt_t> fAllocationCount{0};   ///<! Number of reallocations basket memory buffers.
+   Int_t fTargetBasketsPerCluster{fgTargetBasketsPerCluster}; ///<! Number of baskets per cluster each branch is resized for at cluster boundaries (0: disabled)
+   Long64_t fLastAdaptEntry{0};           ///<! Value of fEntries when the basket sizes were last adapted
+   Long64_t fNBasketResizes{0};           ///<! Number of basket size changes done by AdaptBasketSizes
 
    static Int_t     fgBranchStyle;        ///<  Old/New branch style
    static Long64_t  fgMaxTreeSize;        ///<  Maximum size of a file containing a Tree
+   static Int_t     fgTargetBasketsPerCluster; ///< Default for fTargetBasketsPerCluster of new trees
 
 private:
    // For simplicity, although fIMTFlush is always disabled in non-IMT builds, we don't #ifdef it out.
@@ -152,6 +156,7 @@ private:
    void             SortBranchesByTime();
    Int_t            FlushBasketsImpl() const;
    void             MarkEventCluster();
+   void             AdaptBasketSizes();
 
 protected:
    virtual void     KeepCircular();
@@ -243,6 +248,18 @@ public:
       kSplitCollectionOfPointers = 100
    };
 
+   /// Summary of the basket layout of the branches of a tree, see GetBasketStats().
+   struct TBasketStats {
+      Int_t    fNBranches{0};          ///< Number of branches holding data (branches without sub-branches)
+      Long64_t fNClusters{0};          ///< Number of clusters
+      Long64_t fNBaskets{0};           ///< Number of baskets written, summed over the branches
+      Long64_t fNResizes{0};           ///< Number of basket size changes done at cluster boundaries
+      Int_t    fMinBasketSize{0};      ///< Smallest basket buffer size
+      Int_t    fMaxBasketSize{0};      ///< Largest basket buffer size
+      Long64_t fTotBasketSize{0};      ///< Sum of the basket buffer sizes, i.e. the memory needed to fill one entry
+      Double_t fBasketsPerCluster{0};  ///< Average number of baskets per cluster and branch
+   };
+
    class TClusterIterator
    {
    private:
@@ -384,6 +401,7 @@ public:
    ULong64_t               GetAllocationTime() const { return fAllocationTime; }
 #endif
    virtual Long64_t        GetAutoFlush() const {return fAutoFlush;}
+           TBasketStats    GetBasketStats() const;
    virtual Long64_t        GetAutoSave()  const {return fAutoSave;}
    virtual TBranch        *GetBranch(const char* name);
    virtual TBranchRef     *GetBranchRef() const { return fBranchRef; };
@@ -457,6 +475,8 @@ public:
    virtual TVirtualIndex  *GetTreeIndex() const { return fTreeIndex; }
    virtual Int_t           GetTreeNumber() const { return 0; }
    Float_t GetTargetMemoryRatio() const { return fTargetMemoryRatio; }
+   Int_t GetTargetBasketsPerCluster() const { return fTargetBasketsPerCluster; }
+   static  Int_t           GetDefaultTargetBasketsPerCluster();
    virtual Int_t           GetUpdate() const { return fUpdate; }
    virtual TList          *GetUserInfo();
    // See TSelectorDraw::GetVar
@@ -578,6 +598,8 @@ public:
    virtual void            SetPerfStats(TVirtualPerfStats* perf);
    virtual void            SetScanField(Int_t n = 50) { fScanField = n; } // *MENU*
    void SetTargetMemoryRatio(Float_t ratio) { fTargetMemoryRatio = ratio; }
+   void SetTargetBasketsPerCluster(Int_t n);
+   static  void            SetDefaultTargetBasketsPerCluster(Int_t n);
    virtual void            SetTimerInterval(Int_t msec = 333) { fTimerInterval=msec; }
    virtual void            SetTreeIndex(TVirtualIndex* index);
    virtual void            SetWeight(Double_t w = 1, Option_t* option = "");
@@ -2149,6 +2149,7 @@ void TBranch::Reset(Option_t*)
    fTotBytes = 0;
    fZipBytes = 0;
    fEntryNumber = 0;
+   fClusterTotBytes = 0;
 
    if (fBasketBytes) {
       for (Int_t i = 0; i < fMaxBaskets; ++i) {
@@ -2190,6 +2191,7 @@ void TBranch::ResetAfterMerge(TFileMergeInfo *)
    fTotBytes         = 0;
    fZipBytes         = 0;
    fEntryNumber      = 0;
+   fClusterTotBytes  = 0;
 
    if (fBasketBytes) {
       for (Int_t i = 0; i < fMaxBaskets; ++i) {
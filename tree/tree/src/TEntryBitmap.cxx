@@ -0,0 +1,834 @@
+// @(#)root/tree:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TEntryBitmap.hxx"
+
+#include "TEntryList.h"
+#include "TEntryListBlock.h"
+#include "TError.h"
+#include "TObjArray.h"
+#include "ROOT/TSeq.hxx"
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace ROOT {
+namespace Experimental {
+
+namespace {
+
+using TContainer = TEntryBitmap::TContainer;
+
+constexpr UInt_t kChunkSize = 1 << 16;
+
+inline UInt_t PopCount(ULong64_t word)
+{
+#ifdef _MSC_VER
+   return __popcnt64(word);
+#else
+   return __builtin_popcountll(word);
+#endif
+}
+
+/// Number of set bits in a bitmap container.
+UInt_t CountBits(const ULong64_t *bits)
+{
+   UInt_t n = 0;
+   for (UInt_t i = 0; i < TContainer::kBitmapWords; ++i)
+      n += PopCount(bits[i]);
+   return n;
+}
+
+/// Set bits [begin, end) of a bitmap.
+void SetBits(ULong64_t *bits, UInt_t begin, UInt_t end)
+{
+   if (begin >= end)
+      return;
+   const UInt_t firstWord = begin >> 6;
+   const UInt_t lastWord = (end - 1) >> 6;
+   const ULong64_t firstMask = ~0ULL << (begin & 63);
+   const ULong64_t lastMask = ~0ULL >> (63 - ((end - 1) & 63));
+   if (firstWord == lastWord) {
+      bits[firstWord] |= firstMask & lastMask;
+      return;
+   }
+   bits[firstWord] |= firstMask;
+   for (UInt_t w = firstWord + 1; w < lastWord; ++w)
+      bits[w] = ~0ULL;
+   bits[lastWord] |= lastMask;
+}
+
+/// Clear bits [begin, end) of a bitmap.
+void ClearBits(ULong64_t *bits, UInt_t begin, UInt_t end)
+{
+   if (begin >= end)
+      return;
+   const UInt_t firstWord = begin >> 6;
+   const UInt_t lastWord = (end - 1) >> 6;
+   const ULong64_t firstMask = ~0ULL << (begin & 63);
+   const ULong64_t lastMask = ~0ULL >> (63 - ((end - 1) & 63));
+   if (firstWord == lastWord) {
+      bits[firstWord] &= ~(firstMask & lastMask);
+      return;
+   }
+   bits[firstWord] &= ~firstMask;
+   for (UInt_t w = firstWord + 1; w < lastWord; ++w)
+      bits[w] = 0;
+   bits[lastWord] &= ~lastMask;
+}
+
+/// OR the content of container `c` into the bitmap `bits`.
+void OrInto(ULong64_t *__restrict bits, const TContainer &c)
+{
+   switch (c.fType) {
+   case TContainer::kBitmap: {
+      const ULong64_t *__restrict other = c.fBits.data();
+      for (UInt_t i = 0; i < TContainer::kBitmapWords; ++i)
+         bits[i] |= other[i];
+      break;
+   }
+   case TContainer::kArray:
+      for (UShort_t v : c.fValues)
+         bits[v >> 6] |= 1ULL << (v & 63);
+      break;
+   case TContainer::kRun:
+      c.ForEachRange([bits](UInt_t b, UInt_t e) { SetBits(bits, b, e); });
+      break;
+   }
+}
+
+/// Build a bitmap container from the bitmap `bits`, converting to an array if it is sparse enough.
+void AdoptBits(TContainer &c, std::vector<ULong64_t> &&bits)
+{
+   c.fValues.clear();
+   c.fBits = std::move(bits);
+   c.fType = TContainer::kBitmap;
+   c.fCardinality = CountBits(c.fBits.data());
+   c.Optimize(false);
+}
+
+/// Intersection of two containers.
+TContainer AndContainers(const TContainer &a, const TContainer &b)
+{
+   TContainer res;
+   if (a.fType == TContainer::kArray && b.fType == TContainer::kArray) {
+      const auto &small = a.fValues.size() <= b.fValues.size() ? a.fValues : b.fValues;
+      const auto &large = a.fValues.size() <= b.fValues.size() ? b.fValues : a.fValues;
+      res.fValues.reserve(small.size());
+      if (small.size() * 32 < large.size()) {
+         // Very different sizes: binary search the small set in the large one.
+         auto first = large.begin();
+         for (UShort_t v : small) {
+            first = std::lower_bound(first, large.end(), v);
+            if (first == large.end())
+               break;
+            if (*first == v)
+               res.fValues.push_back(v);
+         }
+      } else {
+         std::set_intersection(small.begin(), small.end(), large.begin(), large.end(),
+                               std::back_inserter(res.fValues));
+      }
+      res.fCardinality = res.fValues.size();
+      return res;
+   }
+   if (a.fType == TContainer::kArray || b.fType == TContainer::kArray) {
+      const TContainer &arr = a.fType == TContainer::kArray ? a : b;
+      const TContainer &other = a.fType == TContainer::kArray ? b : a;
+      res.fValues.reserve(arr.fValues.size());
+      for (UShort_t v : arr.fValues)
+         if (other.Contains(v))
+            res.fValues.push_back(v);
+      res.fCardinality = res.fValues.size();
+      return res;
+   }
+   std::vector<ULong64_t> bits(TContainer::kBitmapWords, 0);
+   OrInto(bits.data(), a);
+   if (b.fType == TContainer::kBitmap) {
+      ULong64_t *__restrict out = bits.data();
+      const ULong64_t *__restrict in = b.fBits.data();
+      for (UInt_t i = 0; i < TContainer::kBitmapWords; ++i)
+         out[i] &= in[i];
+   } else {
+      std::vector<ULong64_t> bbits(TContainer::kBitmapWords, 0);
+      OrInto(bbits.data(), b);
+      for (UInt_t i = 0; i < TContainer::kBitmapWords; ++i)
+         bits[i] &= bbits[i];
+   }
+   AdoptBits(res, std::move(bits));
+   return res;
+}
+
+/// Union of two containers.
+TContainer OrContainers(const TContainer &a, const TContainer &b)
+{
+   TContainer res;
+   if (a.fType == TContainer::kArray && b.fType == TContainer::kArray &&
+       a.fValues.size() + b.fValues.size() <= TContainer::kMaxArraySize) {
+      res.fValues.reserve(a.fValues.size() + b.fValues.size());
+      std::set_union(a.fValues.begin(), a.fValues.end(), b.fValues.begin(), b.fValues.end(),
+                     std::back_inserter(res.fValues));
+      res.fCardinality = res.fValues.size();
+      return res;
+   }
+   std::vector<ULong64_t> bits(TContainer::kBitmapWords, 0);
+   OrInto(bits.data(), a);
+   OrInto(bits.data(), b);
+   AdoptBits(res, std::move(bits));
+   return res;
+}
+
+/// Difference `a - b` of two containers.
+TContainer AndNotContainers(const TContainer &a, const TContainer &b)
+{
+   TContainer res;
+   if (a.fType == TContainer::kArray) {
+      res.fValues.reserve(a.fValues.size());
+      for (UShort_t v : a.fValues)
+         if (!b.Contains(v))
+            res.fValues.push_back(v);
+      res.fCardinality = res.fValues.size();
+      return res;
+   }
+   std::vector<ULong64_t> bits(TContainer::kBitmapWords, 0);
+   OrInto(bits.data(), a);
+   switch (b.fType) {
+   case TContainer::kBitmap: {
+      ULong64_t *__restrict out = bits.data();
+      const ULong64_t *__restrict in = b.fBits.data();
+      for (UInt_t i = 0; i < TContainer::kBitmapWords; ++i)
+         out[i] &= ~in[i];
+      break;
+   }
+   case TContainer::kArray:
+      for (UShort_t v : b.fValues)
+         bits[v >> 6] &= ~(1ULL << (v & 63));
+      break;
+   case TContainer::kRun:
+      b.ForEachRange([&bits](UInt_t rb, UInt_t re) { ClearBits(bits.data(), rb, re); });
+      break;
+   }
+   AdoptBits(res, std::move(bits));
+   return res;
+}
+
+/// Collect the ranges of a container, used to compare containers with different representations.
+std::vector<std::pair<UInt_t, UInt_t>> GetContainerRanges(const TContainer &c)
+{
+   std::vector<std::pair<UInt_t, UInt_t>> ranges;
+   c.ForEachRange([&ranges](UInt_t b, UInt_t e) { ranges.emplace_back(b, e); });
+   return ranges;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add `v` to the container; return false if it was already there.
+
+bool TEntryBitmap::TContainer::Add(UShort_t v)
+{
+   switch (fType) {
+   case kArray: {
+      auto it = std::lower_bound(fValues.begin(), fValues.end(), v);
+      if (it != fValues.end() && *it == v)
+         return false;
+      if (fValues.size() < kMaxArraySize) {
+         fValues.insert(it, v);
+         ++fCardinality;
+         return true;
+      }
+      ToBitmap();
+      break;
+   }
+   case kRun:
+      if (Contains(v))
+         return false;
+      ToBitmap();
+      break;
+   case kBitmap: break;
+   }
+   ULong64_t &word = fBits[v >> 6];
+   const ULong64_t mask = 1ULL << (v & 63);
+   if (word & mask)
+      return false;
+   word |= mask;
+   ++fCardinality;
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove `v` from the container; return false if it was not there.
+
+bool TEntryBitmap::TContainer::Remove(UShort_t v)
+{
+   switch (fType) {
+   case kArray: {
+      auto it = std::lower_bound(fValues.begin(), fValues.end(), v);
+      if (it == fValues.end() || *it != v)
+         return false;
+      fValues.erase(it);
+      --fCardinality;
+      return true;
+   }
+   case kRun:
+      if (!Contains(v))
+         return false;
+      ToBitmap();
+      break;
+   case kBitmap: break;
+   }
+   ULong64_t &word = fBits[v >> 6];
+   const ULong64_t mask = 1ULL << (v & 63);
+   if (!(word & mask))
+      return false;
+   word &= ~mask;
+   --fCardinality;
+   if (fCardinality < kMaxArraySize / 2)
+      Optimize(false);
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if `v` is in the container.
+
+bool TEntryBitmap::TContainer::Contains(UShort_t v) const
+{
+   switch (fType) {
+   case kArray: return std::binary_search(fValues.begin(), fValues.end(), v);
+   case kBitmap: return (fBits[v >> 6] >> (v & 63)) & 1;
+   case kRun: {
+      // Binary search for the last run starting at or before v.
+      std::size_t lo = 0;
+      std::size_t hi = fValues.size() / 2;
+      while (lo < hi) {
+         const std::size_t mid = (lo + hi) / 2;
+         if (fValues[2 * mid] <= v)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+      if (lo == 0)
+         return false;
+      const std::size_t run = 2 * (lo - 1);
+      return UInt_t(v) <= UInt_t(fValues[run]) + fValues[run + 1];
+   }
+   }
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add all values in [begin, end), with end <= 65536.
+
+void TEntryBitmap::TContainer::AddRange(UInt_t begin, UInt_t end)
+{
+   if (begin >= end)
+      return;
+   if (fCardinality == 0) {
+      fType = kRun;
+      fBits.clear();
+      fValues.assign({UShort_t(begin), UShort_t(end - begin - 1)});
+      fCardinality = end - begin;
+      return;
+   }
+   if (fType != kBitmap)
+      ToBitmap();
+   SetBits(fBits.data(), begin, end);
+   fCardinality = CountBits(fBits.data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Switch to the bitmap representation.
+
+void TEntryBitmap::TContainer::ToBitmap()
+{
+   if (fType == kBitmap)
+      return;
+   std::vector<ULong64_t> bits(kBitmapWords, 0);
+   OrInto(bits.data(), *this);
+   fBits = std::move(bits);
+   fValues.clear();
+   fValues.shrink_to_fit();
+   fType = kBitmap;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Switch to the most compact representation. Run containers are only
+/// considered if `allowRuns` is true, as they are slower to update.
+
+void TEntryBitmap::TContainer::Optimize(bool allowRuns)
+{
+   UInt_t nRuns = 0;
+   if (allowRuns || fType == kRun)
+      ForEachRange([&nRuns](UInt_t, UInt_t) { ++nRuns; });
+
+   // Sizes in bytes of the three representations.
+   const std::size_t arraySize = fCardinality <= kMaxArraySize ? 2 * fCardinality : std::size_t(-1);
+   const std::size_t bitmapSize = 8 * kBitmapWords;
+   const std::size_t runSize = (allowRuns || fType == kRun) ? 4 * nRuns : std::size_t(-1);
+
+   EType best = kBitmap;
+   if (arraySize <= bitmapSize && arraySize <= runSize)
+      best = kArray;
+   else if (runSize < bitmapSize && runSize < arraySize)
+      best = kRun;
+   if (best == fType)
+      return;
+
+   std::vector<UShort_t> values;
+   if (best == kArray) {
+      values.reserve(fCardinality);
+      ForEachRange([&values](UInt_t b, UInt_t e) {
+         for (UInt_t v = b; v < e; ++v)
+            values.push_back(v);
+      });
+   } else if (best == kRun) {
+      values.reserve(2 * nRuns);
+      ForEachRange([&values](UInt_t b, UInt_t e) {
+         values.push_back(b);
+         values.push_back(e - b - 1);
+      });
+   } else {
+      ToBitmap();
+      return;
+   }
+   fValues = std::move(values);
+   fBits.clear();
+   fBits.shrink_to_fit();
+   fType = best;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index of the container for `key`, or -1 if there is none.
+
+Long64_t TEntryBitmap::FindKey(ULong64_t key) const
+{
+   // Fast path for the (common) in-order filling and querying.
+   if (!fKeys.empty() && fKeys.back() == key)
+      return fKeys.size() - 1;
+   auto it = std::lower_bound(fKeys.begin(), fKeys.end(), key);
+   if (it == fKeys.end() || *it != key)
+      return -1;
+   return it - fKeys.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Container for `key`, created if needed.
+
+TEntryBitmap::TContainer &TEntryBitmap::GetOrCreate(ULong64_t key)
+{
+   if (fKeys.empty() || fKeys.back() < key) {
+      fKeys.push_back(key);
+      fContainers.emplace_back();
+      return fContainers.back();
+   }
+   auto it = std::lower_bound(fKeys.begin(), fKeys.end(), key);
+   const auto idx = it - fKeys.begin();
+   if (*it != key) {
+      fKeys.insert(it, key);
+      fContainers.insert(fContainers.begin() + idx, TContainer());
+   }
+   return fContainers[idx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add `entry` to the set; return false if it was already there.
+
+bool TEntryBitmap::Enter(Long64_t entry)
+{
+   if (entry < 0)
+      return false;
+   if (GetOrCreate(ULong64_t(entry) >> 16).Add(entry & 0xFFFF)) {
+      ++fN;
+      return true;
+   }
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove `entry` from the set; return false if it was not there.
+
+bool TEntryBitmap::Remove(Long64_t entry)
+{
+   if (entry < 0)
+      return false;
+   const Long64_t idx = FindKey(ULong64_t(entry) >> 16);
+   if (idx < 0 || !fContainers[idx].Remove(entry & 0xFFFF))
+      return false;
+   --fN;
+   if (fContainers[idx].fCardinality == 0) {
+      fKeys.erase(fKeys.begin() + idx);
+      fContainers.erase(fContainers.begin() + idx);
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if `entry` is in the set.
+
+bool TEntryBitmap::Contains(Long64_t entry) const
+{
+   if (entry < 0)
+      return false;
+   const Long64_t idx = FindKey(ULong64_t(entry) >> 16);
+   return idx >= 0 && fContainers[idx].Contains(entry & 0xFFFF);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add all entries in [begin, end) to the set.
+
+void TEntryBitmap::EnterRange(Long64_t begin, Long64_t end)
+{
+   if (begin < 0)
+      begin = 0;
+   while (begin < end) {
+      const ULong64_t key = ULong64_t(begin) >> 16;
+      const Long64_t chunkEnd = std::min<Long64_t>(end, Long64_t(key + 1) << 16);
+      TContainer &c = GetOrCreate(key);
+      const UInt_t before = c.fCardinality;
+      c.AddRange(begin & 0xFFFF, chunkEnd - (Long64_t(key) << 16));
+      fN += c.fCardinality - before;
+      begin = chunkEnd;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all entries.
+
+void TEntryBitmap::Clear()
+{
+   fKeys.clear();
+   fContainers.clear();
+   fN = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Smallest entry of the set, or -1 if the set is empty.
+
+Long64_t TEntryBitmap::GetFirst() const
+{
+   if (fKeys.empty())
+      return -1;
+   UInt_t first = kChunkSize;
+   fContainers.front().ForEachRange([&first](UInt_t b, UInt_t) {
+      if (b < first)
+         first = b;
+   });
+   return Long64_t(fKeys.front() << 16) + first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Largest entry of the set, or -1 if the set is empty.
+
+Long64_t TEntryBitmap::GetLast() const
+{
+   if (fKeys.empty())
+      return -1;
+   UInt_t last = 0;
+   fContainers.back().ForEachRange([&last](UInt_t, UInt_t e) { last = e - 1; });
+   return Long64_t(fKeys.back() << 16) + last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Approximate number of bytes used by this bitmap.
+
+std::size_t TEntryBitmap::GetMemoryUsage() const
+{
+   std::size_t size = sizeof(*this) + fKeys.capacity() * sizeof(ULong64_t);
+   for (const auto &c : fContainers)
+      size += sizeof(c) + c.fValues.capacity() * sizeof(UShort_t) + c.fBits.capacity() * sizeof(ULong64_t);
+   return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Switch every container to its most compact representation, including
+/// run-length encoding. Useful before long-lived storage of the bitmap.
+
+void TEntryBitmap::Optimize()
+{
+   for (auto &c : fContainers)
+      c.Optimize(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keep only the entries that are also in `other`.
+
+TEntryBitmap &TEntryBitmap::And(const TEntryBitmap &other)
+{
+   std::vector<ULong64_t> keys;
+   std::vector<TContainer> containers;
+   Long64_t n = 0;
+   std::size_t i = 0, j = 0;
+   while (i < fKeys.size() && j < other.fKeys.size()) {
+      if (fKeys[i] < other.fKeys[j]) {
+         ++i;
+      } else if (other.fKeys[j] < fKeys[i]) {
+         ++j;
+      } else {
+         TContainer c = AndContainers(fContainers[i], other.fContainers[j]);
+         if (c.fCardinality) {
+            n += c.fCardinality;
+            keys.push_back(fKeys[i]);
+            containers.push_back(std::move(c));
+         }
+         ++i;
+         ++j;
+      }
+   }
+   fKeys = std::move(keys);
+   fContainers = std::move(containers);
+   fN = n;
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add all the entries of `other`.
+
+TEntryBitmap &TEntryBitmap::Or(const TEntryBitmap &other)
+{
+   std::vector<ULong64_t> keys;
+   std::vector<TContainer> containers;
+   keys.reserve(fKeys.size() + other.fKeys.size());
+   containers.reserve(fKeys.size() + other.fKeys.size());
+   Long64_t n = 0;
+   std::size_t i = 0, j = 0;
+   while (i < fKeys.size() || j < other.fKeys.size()) {
+      if (j == other.fKeys.size() || (i < fKeys.size() && fKeys[i] < other.fKeys[j])) {
+         keys.push_back(fKeys[i]);
+         containers.push_back(std::move(fContainers[i]));
+         ++i;
+      } else if (i == fKeys.size() || other.fKeys[j] < fKeys[i]) {
+         keys.push_back(other.fKeys[j]);
+         containers.push_back(other.fContainers[j]);
+         ++j;
+      } else {
+         keys.push_back(fKeys[i]);
+         containers.push_back(OrContainers(fContainers[i], other.fContainers[j]));
+         ++i;
+         ++j;
+      }
+      n += containers.back().fCardinality;
+   }
+   fKeys = std::move(keys);
+   fContainers = std::move(containers);
+   fN = n;
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of `other`.
+
+TEntryBitmap &TEntryBitmap::AndNot(const TEntryBitmap &other)
+{
+   std::vector<ULong64_t> keys;
+   std::vector<TContainer> containers;
+   Long64_t n = 0;
+   std::size_t j = 0;
+   for (std::size_t i = 0; i < fKeys.size(); ++i) {
+      while (j < other.fKeys.size() && other.fKeys[j] < fKeys[i])
+         ++j;
+      TContainer c = (j < other.fKeys.size() && other.fKeys[j] == fKeys[i])
+                        ? AndNotContainers(fContainers[i], other.fContainers[j])
+                        : std::move(fContainers[i]);
+      if (c.fCardinality) {
+         n += c.fCardinality;
+         keys.push_back(fKeys[i]);
+         containers.push_back(std::move(c));
+      }
+   }
+   fKeys = std::move(keys);
+   fContainers = std::move(containers);
+   fN = n;
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Two bitmaps are equal if they contain the same entries, whatever their
+/// internal representation.
+
+bool TEntryBitmap::operator==(const TEntryBitmap &other) const
+{
+   if (fN != other.fN || fKeys != other.fKeys)
+      return false;
+   for (std::size_t i = 0; i < fContainers.size(); ++i) {
+      const TContainer &a = fContainers[i];
+      const TContainer &b = other.fContainers[i];
+      if (a.fCardinality != b.fCardinality)
+         return false;
+      if (a.fType == b.fType) {
+         if (a.fValues != b.fValues || a.fBits != b.fBits)
+            return false;
+      } else if (GetContainerRanges(a) != GetContainerRanges(b)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Union of many bitmaps at once.
+/// Containers with the same key are OR-ed together into a single bitmap
+/// accumulator, which is much cheaper than a sequence of pairwise Or() calls
+/// when combining hundreds of lists. With implicit multi-threading enabled,
+/// keys are processed in parallel.
+
+TEntryBitmap TEntryBitmap::Union(const std::vector<const TEntryBitmap *> &bitmaps)
+{
+   // (key, container) pairs from all inputs, grouped by key.
+   std::vector<std::pair<ULong64_t, const TContainer *>> all;
+   for (const TEntryBitmap *bm : bitmaps) {
+      if (!bm)
+         continue;
+      for (std::size_t i = 0; i < bm->fKeys.size(); ++i)
+         all.emplace_back(bm->fKeys[i], &bm->fContainers[i]);
+   }
+   std::stable_sort(all.begin(), all.end(),
+                    [](const std::pair<ULong64_t, const TContainer *> &a,
+                       const std::pair<ULong64_t, const TContainer *> &b) { return a.first < b.first; });
+
+   // Start index of each group of identical keys.
+   std::vector<std::size_t> groups;
+   for (std::size_t i = 0; i < all.size(); ++i)
+      if (i == 0 || all[i].first != all[i - 1].first)
+         groups.push_back(i);
+   const std::size_t nGroups = groups.size();
+   groups.push_back(all.size());
+
+   TEntryBitmap res;
+   res.fKeys.resize(nGroups);
+   res.fContainers.resize(nGroups);
+
+   auto unite = [&](unsigned int g) {
+      const std::size_t begin = groups[g];
+      const std::size_t end = groups[g + 1];
+      res.fKeys[g] = all[begin].first;
+      if (end - begin == 1) {
+         res.fContainers[g] = *all[begin].second;
+         return;
+      }
+      std::vector<ULong64_t> bits(TContainer::kBitmapWords, 0);
+      for (std::size_t k = begin; k < end; ++k)
+         OrInto(bits.data(), *all[k].second);
+      AdoptBits(res.fContainers[g], std::move(bits));
+   };
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && nGroups > 1) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(unite, ROOT::TSeqU(nGroups));
+   } else
+#endif
+   {
+      for (unsigned int g = 0; g < nGroups; ++g)
+         unite(g);
+   }
+
+   for (const auto &c : res.fContainers)
+      res.fN += c.fCardinality;
+   return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximal ranges of consecutive entries, in increasing order.
+/// A reader can load each range with a single sequential scan.
+
+std::vector<TEntryBitmap::TRange> TEntryBitmap::GetRanges() const
+{
+   std::vector<TRange> ranges;
+   ForEachRange([&ranges](Long64_t b, Long64_t e) { ranges.push_back(TRange{b, e}); });
+   return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build a bitmap from the entries of a TEntryList for a single TTree.
+/// The blocks of the list are read directly, without going through
+/// TEntryList::Next(), so the list is left untouched. For a TEntryList of a
+/// TChain, convert each sub-list (see TEntryList::GetLists()) separately.
+
+TEntryBitmap TEntryBitmap::FromEntryList(const TEntryList &elist)
+{
+   TEntryBitmap res;
+   if (elist.fLists) {
+      ::Error("TEntryBitmap::FromEntryList", "entry list %s has sub-lists, convert them one by one",
+              elist.GetName());
+      return res;
+   }
+   if (!elist.fBlocks)
+      return res;
+
+   const Int_t nbits = TEntryListBlock::kBlockSize * 16;
+   for (Int_t i = 0; i < elist.fNBlocks; ++i) {
+      const TEntryListBlock *block = static_cast<const TEntryListBlock *>(elist.fBlocks->UncheckedAt(i));
+      if (!block)
+         continue;
+      const Long64_t base = Long64_t(i) * TEntryList::kBlockSize;
+      const UShort_t *indices = block->fIndices;
+      if (!indices) {
+         // An empty block, or a block where all entries pass.
+         if (!block->fPassing)
+            res.EnterRange(base, base + nbits);
+         continue;
+      }
+      if (block->fType == 0) {
+         // Bits: one UShort_t word for 16 entries.
+         for (Int_t w = 0; w < TEntryListBlock::kBlockSize; ++w) {
+            UInt_t word = indices[w];
+            while (word) {
+               const UInt_t bit = Internal::CountTrailingZeros(word);
+               res.Enter(base + w * 16 + bit);
+               word &= word - 1;
+            }
+         }
+      } else if (block->fPassing) {
+         // Sorted list of the passing entries.
+         for (Int_t k = 0; k < block->fNPassed; ++k)
+            res.Enter(base + indices[k]);
+      } else {
+         // Sorted list of the entries that do not pass.
+         Long64_t next = base;
+         for (Int_t k = 0; k < block->fNPassed; ++k) {
+            res.EnterRange(next, base + indices[k]);
+            next = base + indices[k] + 1;
+         }
+         res.EnterRange(next, base + nbits);
+      }
+   }
+   return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enter all entries of this bitmap into `elist`, a TEntryList for a single
+/// TTree, and optimize its storage.
+
+void TEntryBitmap::FillEntryList(TEntryList &elist) const
+{
+   ForEach([&elist](Long64_t entry) { elist.Enter(entry); });
+   elist.OptimizeStorage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Union of the partial bitmaps of all slots.
+
+TEntryBitmap TEntryBitmapFiller::Merge() const
+{
+   std::vector<const TEntryBitmap *> bitmaps;
+   bitmaps.reserve(fSlots.size());
+   for (const auto &slot : fSlots)
+      bitmaps.push_back(&slot);
+   return TEntryBitmap::Union(bitmaps);
+}
+
+} // namespace Experimental
+} // namespace ROOT
@@ -60,6 +60,11 @@ End_Macro
                 much faster than GetEntry, and it's called when GetEntry() is called
                 for 2 or more indices in a row.
 
+When many lists have to be combined, or filled from several threads, convert
+them to ROOT::Experimental::TEntryBitmap (TEntryBitmap::FromEntryList()), which
+implements the set operations on compressed containers, and convert the result
+back with TEntryBitmap::FillEntryList() for storage.
+
 ## TTree::Draw() and TChain::Draw()
 
 Use option __entrylist__ to write the results of TTree::Draw and TChain::Draw into
@@ -0,0 +1,167 @@
+// @(#)root/tree:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2018, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TParallelTreeWriter.hxx"
+
+#include "TDirectory.h"
+#include "TError.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TMemFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include "TVirtualMutex.h"
+
+namespace ROOT {
+namespace Experimental {
+
+TParallelTreeWriter::TParallelTreeWriter(TDirectory *dir, const char *name, const char *title, Long64_t clusterSize)
+   : fDirectory(dir), fName(name), fTitle(title), fClusterSize(clusterSize)
+{
+   if (!fDirectory || !fDirectory->GetFile() || !fDirectory->IsWritable())
+      Error("TParallelTreeWriter", "the output directory must be in a writable file");
+   if (fClusterSize <= 0) {
+      Error("TParallelTreeWriter", "the cluster size must be positive (got %lld), using 1000", fClusterSize);
+      fClusterSize = 1000;
+   }
+}
+
+TParallelTreeWriter::~TParallelTreeWriter()
+{
+   for (const auto &f : fAttachedFillers)
+      if (!f.expired())
+         Fatal("TParallelTreeWriter", " TParallelTreeFillers must be destroyed before the writer");
+
+   Write();
+}
+
+std::shared_ptr<TParallelTreeFiller> TParallelTreeWriter::GetFiller()
+{
+   std::shared_ptr<TParallelTreeFiller> f(new TParallelTreeFiller(*this));
+   std::lock_guard<std::mutex> lock(fCommitMutex);
+   fAttachedFillers.push_back(f);
+   return f;
+}
+
+Long64_t TParallelTreeWriter::GetEntries() const
+{
+   std::lock_guard<std::mutex> lock(fCommitMutex);
+   return fTree ? fTree->GetEntriesFast() : 0;
+}
+
+Long64_t TParallelTreeWriter::GetNClusters() const
+{
+   std::lock_guard<std::mutex> lock(fCommitMutex);
+   return fNClusters;
+}
+
+Int_t TParallelTreeWriter::Write()
+{
+   std::lock_guard<std::mutex> lock(fCommitMutex);
+   if (!fTree || !fDirectory || !fDirectory->IsWritable())
+      return 0;
+   TDirectory::TContext ctxt(fDirectory);
+   return fTree->Write(nullptr, TObject::kOverwrite);
+}
+
+/// Append the (flushed) baskets of `cluster` to the output tree.
+/// Called by the fillers; the copy of the compressed baskets is the only
+/// serialized part of the parallel filling.
+Bool_t TParallelTreeWriter::Commit(TTree &cluster)
+{
+   std::lock_guard<std::mutex> lock(fCommitMutex);
+   if (!fTree) {
+      // The first committed cluster defines the structure of the output tree.
+      TDirectory::TContext ctxt(fDirectory);
+      fTree = cluster.CloneTree(0);
+      if (!fTree) {
+         Error("Commit", "cannot create the output tree %s", fName.Data());
+         return kFALSE;
+      }
+      // Detach the output tree from the filler's tree, as in TTree::MergeTrees.
+      cluster.GetListOfClones()->Remove(fTree);
+      fTree->ResetBranchAddresses();
+      fTree->SetTitle(fTitle);
+      // Clusters are defined by the commits, not by the output tree itself.
+      fTree->SetAutoFlush(0);
+      fTree->SetAutoSave(0);
+   }
+
+   if (fTree->CopyEntries(&cluster, -1, "fast") < 0) {
+      Error("Commit", "the tree filled by a TParallelTreeFiller does not match the output tree %s", fName.Data());
+      return kFALSE;
+   }
+   ++fNClusters;
+   return kTRUE;
+}
+
+TParallelTreeFiller::TParallelTreeFiller(TParallelTreeWriter &writer) : fWriter(writer)
+{
+   // Do not change gDirectory, and keep the memory file (and thus its tree) out
+   // of the global list of files: nobody else needs to find them there.
+   TDirectory::TContext ctxt;
+   TFile *output = fWriter.fDirectory ? fWriter.fDirectory->GetFile() : nullptr;
+   fFile.reset(new TMemFile(output ? output->GetName() : fWriter.fName.Data(), "RECREATE", "",
+                            output ? output->GetCompressionSettings() : ROOT::kUseGeneralPurposeCompressionSetting));
+   {
+      R__LOCKGUARD(gROOTMutex);
+      gROOT->GetListOfFiles()->Remove(fFile.get());
+   }
+   fTree = new TTree(fWriter.fName, fWriter.fTitle, 99, fFile.get());
+   // The filler decides when baskets are flushed: exactly once per cluster.
+   fTree->SetAutoFlush(0);
+   fTree->SetAutoSave(0);
+}
+
+TParallelTreeFiller::~TParallelTreeFiller()
+{
+   Flush();
+   // The tree is owned by the memory file.
+   fFile->Close();
+}
+
+Int_t TParallelTreeFiller::Fill()
+{
+   const Int_t nbytes = fTree->Fill();
+   if (nbytes < 0)
+      return nbytes;
+   if (fTree->GetEntriesFast() >= fWriter.fClusterSize && !Flush())
+      return -1;
+   return nbytes;
+}
+
+Bool_t TParallelTreeFiller::Flush()
+{
+   const Long64_t nentries = fTree->GetEntriesFast();
+   if (nentries == 0)
+      return kTRUE;
+
+   // Compress all the baskets of the cluster, in this thread, and mark the
+   // cluster boundary that TTree::ImportClusterRanges propagates to the output.
+   if (fTree->FlushBaskets(kTRUE) < 0) {
+      Error("Flush", "failed to flush the baskets of %s", fTree->GetName());
+      return kFALSE;
+   }
+
+   const Bool_t ok = fWriter.Commit(*fTree);
+   if (ok)
+      fNCommitted += nentries;
+
+   // Reuse the memory file and the tree for the next cluster.
+   fFile->ResetAfterMerge(nullptr);
+   {
+      R__LOCKGUARD(gROOTMutex);
+      gROOT->GetListOfFiles()->Remove(fFile.get());
+   }
+   return ok;
+}
+
+} // namespace Experimental
+} // namespace ROOT
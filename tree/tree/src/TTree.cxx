@@ -418,6 +418,7 @@ constexpr Float_t kNEntriesResortInv = 1.f/kNEntriesResort;
 
 Int_t    TTree::fgBranchStyle = 1;  // Use new TBranch style with TBranchElement.
 Long64_t TTree::fgMaxTreeSize = 100000000000LL;
+Int_t    TTree::fgTargetBasketsPerCluster = 0; // Adaptive basket sizing disabled by default.
 
 ClassImp(TTree);
 
@@ -3619,7 +3620,8 @@ void TTree::Delete(Option_t* option /* = "" */)
    }
 
    // Delete object from CINT symbol table so it can not be used anymore.
-   gCling->DeleteGlobal(this);
+   if (gCling)
+      gCling->DeleteGlobal(this);
 
    // Warning: We have intentional invalidated this object while inside a member function!
    delete this;
@@ -4489,7 +4491,11 @@ Int_t TTree::Fill()
             // When we are in one-basket-per-cluster mode, there is no need to optimize basket:
             // they will automatically grow to the size needed for an event cluster (with the basket
             // shrinking preventing them from growing too much larger than the actually-used space).
-            if (!TestBit(TTree::kOnlyFlushAtCluster)) {
+            // With a target number of baskets per cluster, the baskets are resized at each cluster
+            // boundary instead of once here.
+            if (fTargetBasketsPerCluster > 0) {
+               AdaptBasketSizes();
+            } else if (!TestBit(TTree::kOnlyFlushAtCluster)) {
                OptimizeBaskets(GetTotBytes(), 1, "");
                if (gDebug > 0)
                   Info("TTree::Fill", "OptimizeBaskets called at entry %lld, fZipBytes=%lld, fFlushedBytes=%lld\n",
@@ -4540,6 +4546,7 @@ Int_t TTree::Fill()
 
    if (autoFlush) {
       FlushBasketsImpl();
+      AdaptBasketSizes();
       if (gDebug > 0)
          Info("TTree::Fill", "FlushBaskets() called at entry %lld, fZipBytes=%lld, fFlushedBytes=%lld\n", fEntries,
               GetZipBytes(), fFlushedBytes);
@@ -4904,7 +4911,10 @@ Int_t TTree::FlushBaskets(Bool_t create_cluster) const
     Int_t retval = FlushBasketsImpl();
     if (retval == -1) return retval;
 
-    if (create_cluster) const_cast<TTree *>(this)->MarkEventCluster();
+    if (create_cluster) {
+       const_cast<TTree *>(this)->MarkEventCluster();
+       const_cast<TTree *>(this)->AdaptBasketSizes();
+    }
     return retval;
 }
 
@@ -5029,6 +5039,43 @@ const char* TTree::GetAlias(const char* aliasName) const
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a summary of the basket layout of the branches holding data: the
+/// number of clusters and of baskets written, the current basket sizes and the
+/// number of resizes done by the adaptive basket sizing (see
+/// SetTargetBasketsPerCluster()).
+
+TTree::TBasketStats TTree::GetBasketStats() const
+{
+   TBasketStats stats;
+   stats.fNResizes = fNBasketResizes;
+
+   TTree *self = const_cast<TTree *>(this);
+   TClusterIterator clusters = self->GetClusterIterator(0);
+   while (clusters.Next() < fEntries)
+      ++stats.fNClusters;
+
+   TObjArray *leaves = self->GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TBranch *branch = ((TLeaf *)leaves->UncheckedAt(i))->GetBranch();
+      if (branch->GetListOfLeaves()->UncheckedAt(0) != leaves->UncheckedAt(i) ||
+          branch->GetListOfBranches()->GetEntriesFast() > 0)
+         continue;
+      const Int_t bsize = branch->GetBasketSize();
+      if (stats.fNBranches == 0 || bsize < stats.fMinBasketSize)
+         stats.fMinBasketSize = bsize;
+      if (bsize > stats.fMaxBasketSize)
+         stats.fMaxBasketSize = bsize;
+      stats.fTotBasketSize += bsize;
+      stats.fNBaskets += branch->GetWriteBasket();
+      ++stats.fNBranches;
+   }
+   if (stats.fNBranches && stats.fNClusters)
+      stats.fBasketsPerCluster = Double_t(stats.fNBaskets) / stats.fNBranches / stats.fNClusters;
+   return stats;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return pointer to the branch with the given name in this tree or its friends.
 
@@ -5997,6 +6044,15 @@ Long64_t TTree::GetMaxTreeSize()
    return fgMaxTreeSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the number of baskets per cluster targeted by
+/// the basket sizing of newly created trees (0 if disabled).
+
+Int_t TTree::GetDefaultTargetBasketsPerCluster()
+{
+   return fgTargetBasketsPerCluster;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return minimum of column with name columname.
 /// if the Tree has an associated TEventList or TEntryList, the minimum
@@ -6119,7 +6175,9 @@ void TTree::ImportClusterRanges(TTree *fromtree)
             fClusterSize = new Long64_t[fMaxClusterRange];
          }
       }
-      if (fEntries) {
+      // Close the current range, unless it was already closed at the last
+      // entry (e.g. when appending trees that each end with a cluster mark).
+      if (fEntries && (fNClusterRange == 0 || fClusterRangeEnd[fNClusterRange - 1] != fEntries - 1)) {
          fClusterRangeEnd[fNClusterRange] = fEntries - 1;
          fClusterSize[fNClusterRange] = fAutoFlush<0 ? 0 : fAutoFlush;
          ++fNClusterRange;
@@ -6889,6 +6947,74 @@ void TTree::OptimizeBaskets(ULong64_t maxMemory, Float_t minComp, Option_t *opti
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Resize the baskets of all the branches holding data so that each of them
+/// produces about fTargetBasketsPerCluster baskets for a cluster similar to the
+/// last one. Called at each cluster boundary once the baskets have been flushed;
+/// does nothing if no target is set (see SetTargetBasketsPerCluster()).
+///
+/// Contrary to OptimizeBaskets(), which runs once with a global memory budget,
+/// the sizes follow the branches along the whole filling: a branch that becomes
+/// denser gets larger baskets, one that becomes sparser releases memory. To avoid
+/// reallocating the buffers at every cluster, a size is changed only when it
+/// differs by more than 1/8 from the current one.
+
+void TTree::AdaptBasketSizes()
+{
+   if (fTargetBasketsPerCluster <= 0 || TestBit(TTree::kOnlyFlushAtCluster))
+      return;
+
+   Long64_t nentries = fEntries - fLastAdaptEntry;
+   if (nentries < 0) // the tree has been reset since the last adaptation
+      nentries = fEntries;
+   fLastAdaptEntry = fEntries;
+   if (nentries == 0)
+      return;
+
+   static const Long64_t bmin = 512;
+   static const Long64_t bmax = 64 * 1024 * 1024;
+
+   TObjArray *leaves = GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TBranch *branch = ((TLeaf *)leaves->UncheckedAt(i))->GetBranch();
+      // Handle each branch once (a leaflist branch has several leaves), and only
+      // the ones actually holding data.
+      if (branch->GetListOfLeaves()->UncheckedAt(0) != leaves->UncheckedAt(i) ||
+          branch->GetListOfBranches()->GetEntriesFast() > 0)
+         continue;
+
+      Long64_t bytes = branch->fTotBytes - branch->fClusterTotBytes;
+      if (bytes < 0)
+         bytes = branch->fTotBytes;
+      branch->fClusterTotBytes = branch->fTotBytes;
+      if (bytes <= 0)
+         continue; // nothing written in this cluster: keep the current size
+
+      // fTotBytes already accounts for the key and the entry offsets of the
+      // baskets; leave some room for fluctuations and round up to 512 bytes.
+      Long64_t bsize = (bytes + fTargetBasketsPerCluster - 1) / fTargetBasketsPerCluster;
+      bsize += bsize / 16;
+      bsize = bsize - bsize % 512 + 512;
+      const Long64_t sizeOfOneEntry = 1 + bytes / nentries;
+      if (bsize < sizeOfOneEntry)
+         bsize = sizeOfOneEntry;
+      if (bsize < bmin)
+         bsize = bmin;
+      if (bsize > bmax)
+         bsize = bmax;
+
+      const Long64_t oldBsize = branch->GetBasketSize();
+      if (8 * TMath::Abs(bsize - oldBsize) <= oldBsize)
+         continue;
+      if (gDebug > 0)
+         Info("AdaptBasketSizes", "Changing buffer size from %6lld to %6lld bytes for %s", oldBsize, bsize,
+              branch->GetName());
+      branch->SetBasketSize(bsize);
+      ++fNBasketResizes;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface to the Principal Components Analysis class.
 ///
@@ -7688,6 +7814,11 @@ void TTree::Reset(Option_t* option)
 
 void TTree::ResetAfterMerge(TFileMergeInfo *info)
 {
+   // The entries being dropped formed one cluster of the merged output (this is
+   // how TBufferMerger and TParallelTreeWriter use this function): adapt the
+   // basket sizes to it before forgetting them.
+   AdaptBasketSizes();
+
    fEntries       = 0;
    fNClusterRange = 0;
    fTotBytes      = 0;
@@ -8789,6 +8920,17 @@ void TTree::SetMaxTreeSize(Long64_t maxsize)
    fgMaxTreeSize = maxsize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the number of baskets per cluster targeted by the
+/// basket sizing of the trees created afterwards, see SetTargetBasketsPerCluster().
+/// This also applies to the trees written through TBufferMerger or by
+/// RDataFrame's Snapshot. 0 (the default) disables the adaptive sizing.
+
+void TTree::SetDefaultTargetBasketsPerCluster(Int_t n)
+{
+   fgTargetBasketsPerCluster = n > 0 ? n : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change the name of this tree.
 
@@ -8863,6 +9005,31 @@ void TTree::SetParallelUnzip(Bool_t opt, Float_t RelSize)
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Resize the baskets of each branch at every cluster boundary so that, for a
+/// cluster similar to the previous one, the branch produces about `n` baskets.
+///
+/// By default the basket sizes are optimized once, after the first AutoFlush
+/// (see OptimizeBaskets()), and never change afterwards. With a target, the
+/// sizes keep following the size of the data written by each branch: fewer
+/// baskets per cluster means fewer read requests, while sparse branches do not
+/// keep large buffers in memory. The effect can be checked with GetBasketStats().
+/// `n` = 0 restores the default behaviour. This setting is ignored in
+/// kOnlyFlushAtCluster mode, where there is always one basket per cluster.
+
+void TTree::SetTargetBasketsPerCluster(Int_t n)
+{
+   fTargetBasketsPerCluster = n > 0 ? n : 0;
+   fLastAdaptEntry = fEntries;
+   // Start measuring the branches from the current state.
+   TObjArray *leaves = GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TBranch *branch = ((TLeaf *)leaves->UncheckedAt(i))->GetBranch();
+      branch->fClusterTotBytes = branch->fTotBytes;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set perf stats
 
@@ -1,10 +1,14 @@
+#include "TAttAxis.h"
 #include "TFile.h"
+#include "TMemFile.h"
 #include "TTree.h"
 #include "TBranch.h"
 #include "TRandom.h"
 
 #include "gtest/gtest.h"
 
+#include <vector>
+
 class TBranchTest : public ::testing::Test {
 protected:
    virtual void SetUp()
@@ -178,3 +182,38 @@ TEST_F(TBranchTest, twoPreviousTest)
    ASSERT_TRUE(branch->GetListOfBaskets()->At(7));
    delete file;
 }
+
+// The data members of a split std::vector of objects are read as blocks.
+TEST(TBranch, SplitVectorOfObjects)
+{
+   TMemFile file("splitvector.root", "RECREATE");
+   auto tree = new TTree("tree", "tree");
+   std::vector<TAttAxis> axes;
+   auto paxes = &axes;
+   tree->Branch("axes", &paxes, 32000, 99);
+   for (Int_t ev = 0; ev < 10; ++ev) {
+      axes.resize(ev);
+      for (Int_t i = 0; i < ev; ++i) {
+         axes[i].SetNdivisions(100 * ev + i);
+         axes[i].SetLabelSize(0.5f * i);
+         axes[i].SetTitleFont(ev);
+      }
+      tree->Fill();
+   }
+   tree->ResetBranchAddresses();
+
+   std::vector<TAttAxis> *read = nullptr;
+   tree->SetBranchAddress("axes", &read);
+   for (Int_t ev = 0; ev < 10; ++ev) {
+      tree->GetEntry(ev);
+      ASSERT_NE(read, nullptr);
+      ASSERT_EQ(read->size(), (size_t)ev);
+      for (Int_t i = 0; i < ev; ++i) {
+         EXPECT_EQ((*read)[i].GetNdivisions(), 100 * ev + i);
+         EXPECT_FLOAT_EQ((*read)[i].GetLabelSize(), 0.5f * i);
+         EXPECT_EQ((*read)[i].GetTitleFont(), ev);
+      }
+   }
+   tree->ResetBranchAddresses();
+   delete read;
+}
@@ -0,0 +1,119 @@
+#include "ROOT/TEntryBitmap.hxx"
+#include "TEntryList.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using ROOT::Experimental::TEntryBitmap;
+using ROOT::Experimental::TEntryBitmapFiller;
+
+static std::vector<Long64_t> GetEntries(const TEntryBitmap &bm)
+{
+   std::vector<Long64_t> entries;
+   bm.ForEach([&entries](Long64_t e) { entries.push_back(e); });
+   return entries;
+}
+
+TEST(TEntryBitmap, EnterRemoveContains)
+{
+   TEntryBitmap bm;
+   EXPECT_TRUE(bm.Enter(3));
+   EXPECT_FALSE(bm.Enter(3));
+   EXPECT_TRUE(bm.Enter(1 << 20));
+   EXPECT_TRUE(bm.Enter(70000));
+   EXPECT_EQ(bm.GetN(), 3);
+   EXPECT_TRUE(bm.Contains(70000));
+   EXPECT_FALSE(bm.Contains(70001));
+   EXPECT_TRUE(bm.Remove(70000));
+   EXPECT_FALSE(bm.Remove(70000));
+   EXPECT_EQ(GetEntries(bm), (std::vector<Long64_t>{3, 1 << 20}));
+   EXPECT_EQ(bm.GetFirst(), 3);
+   EXPECT_EQ(bm.GetLast(), 1 << 20);
+}
+
+TEST(TEntryBitmap, DenseAndRanges)
+{
+   TEntryBitmap bm;
+   // Enough entries to switch the first container to a bitmap.
+   for (Long64_t i = 0; i < 10000; ++i)
+      bm.Enter(2 * i);
+   bm.EnterRange(100000, 300000);
+   EXPECT_EQ(bm.GetN(), 10000 + 200000);
+   bm.Optimize();
+   EXPECT_EQ(bm.GetN(), 10000 + 200000);
+   EXPECT_TRUE(bm.Contains(199998));
+   EXPECT_FALSE(bm.Contains(19999));
+
+   const auto ranges = bm.GetRanges();
+   ASSERT_EQ(ranges.size(), 10001u);
+   EXPECT_EQ(ranges.back().fBegin, 100000);
+   EXPECT_EQ(ranges.back().fEnd, 300000);
+}
+
+TEST(TEntryBitmap, SetOperations)
+{
+   TEntryBitmap a, b;
+   for (Long64_t i = 0; i < 200000; i += 3)
+      a.Enter(i);
+   for (Long64_t i = 0; i < 200000; i += 5)
+      b.Enter(i);
+   b.EnterRange(150000, 250000);
+
+   TEntryBitmap both = a;
+   both &= b;
+   TEntryBitmap either = a;
+   either |= b;
+   TEntryBitmap onlyA = a;
+   onlyA -= b;
+
+   Long64_t nBoth = 0, nEither = 0, nOnlyA = 0;
+   for (Long64_t i = 0; i < 250000; ++i) {
+      const bool inA = i < 200000 && i % 3 == 0;
+      const bool inB = (i < 200000 && i % 5 == 0) || i >= 150000;
+      EXPECT_EQ(both.Contains(i), inA && inB);
+      EXPECT_EQ(either.Contains(i), inA || inB);
+      EXPECT_EQ(onlyA.Contains(i), inA && !inB);
+      nBoth += inA && inB;
+      nEither += inA || inB;
+      nOnlyA += inA && !inB;
+   }
+   EXPECT_EQ(both.GetN(), nBoth);
+   EXPECT_EQ(either.GetN(), nEither);
+   EXPECT_EQ(onlyA.GetN(), nOnlyA);
+
+   EXPECT_EQ(TEntryBitmap::Union({&a, &b}), either);
+}
+
+TEST(TEntryBitmap, Filler)
+{
+   TEntryBitmapFiller filler(4);
+   for (unsigned int slot = 0; slot < filler.GetNSlots(); ++slot)
+      for (Long64_t i = slot; i < 100000; i += filler.GetNSlots())
+         filler.Enter(slot, i);
+   const auto merged = filler.Merge();
+   EXPECT_EQ(merged.GetN(), 100000);
+   ASSERT_EQ(merged.GetRanges().size(), 1u);
+}
+
+TEST(TEntryBitmap, EntryListConversion)
+{
+   TEntryList elist("elist", "elist");
+   for (Long64_t i = 0; i < 300000; i += 7)
+      elist.Enter(i);
+   for (Long64_t i = 300000; i < 400000; ++i)
+      elist.Enter(i);
+   elist.OptimizeStorage();
+
+   const auto bm = TEntryBitmap::FromEntryList(elist);
+   EXPECT_EQ(bm.GetN(), elist.GetN());
+   for (Long64_t i = 0; i < 400000; i += 11)
+      EXPECT_EQ(bm.Contains(i), elist.Contains(i) != 0);
+
+   TEntryList copy("copy", "copy");
+   bm.FillEntryList(copy);
+   EXPECT_EQ(copy.GetN(), elist.GetN());
+   const auto entries = GetEntries(bm);
+   for (std::size_t i = 0; i < entries.size(); ++i)
+      EXPECT_EQ(copy.GetEntry(i), entries[i]);
+}
@@ -0,0 +1,69 @@
+#include "ROOT/TParallelTreeWriter.hxx"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(TParallelTreeWriter, FillFromThreads)
+{
+   ROOT::EnableThreadSafety();
+   const int nThreads = 4;
+   const int nEntries = 2500;
+   {
+      TFile f("TParallelTreeWriter.root", "RECREATE");
+      ROOT::Experimental::TParallelTreeWriter writer(&f, "tree", "parallel tree", 1000);
+
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nThreads; ++t) {
+         threads.emplace_back([&writer, t, nEntries]() {
+            auto filler = writer.GetFiller();
+            Int_t thread = t;
+            Int_t index = 0;
+            filler->GetTree()->Branch("thread", &thread);
+            filler->GetTree()->Branch("index", &index);
+            for (index = 0; index < nEntries; ++index)
+               filler->Fill();
+         });
+      }
+      for (auto &th : threads)
+         th.join();
+
+      EXPECT_EQ(writer.GetEntries(), nThreads * nEntries);
+      // Each thread commits two full clusters and one of 500 entries.
+      EXPECT_EQ(writer.GetNClusters(), 3 * nThreads);
+   }
+
+   TFile f("TParallelTreeWriter.root");
+   auto tree = static_cast<TTree *>(f.Get("tree"));
+   ASSERT_NE(tree, nullptr);
+   ASSERT_EQ(tree->GetEntries(), nThreads * nEntries);
+
+   // Every cluster comes from a single thread, with consecutive indices.
+   Int_t thread, index;
+   tree->SetBranchAddress("thread", &thread);
+   tree->SetBranchAddress("index", &index);
+   std::vector<int> counts(nThreads, 0);
+   auto clusters = tree->GetClusterIterator(0);
+   Long64_t start;
+   int nClusters = 0;
+   while ((start = clusters.Next()) < tree->GetEntries()) {
+      ++nClusters;
+      tree->GetEntry(start);
+      const Int_t clusterThread = thread;
+      const Int_t firstIndex = index;
+      for (Long64_t entry = start; entry < clusters.GetNextEntry(); ++entry) {
+         tree->GetEntry(entry);
+         EXPECT_EQ(thread, clusterThread);
+         EXPECT_EQ(index, firstIndex + (entry - start));
+         ++counts[thread];
+      }
+   }
+   EXPECT_EQ(nClusters, 3 * nThreads);
+   for (auto c : counts)
+      EXPECT_EQ(c, nEntries);
+}
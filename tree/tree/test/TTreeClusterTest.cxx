@@ -2,6 +2,9 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TRandom.h"
+#include "TSystem.h"
+
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -53,3 +56,40 @@ TEST_F(TTreeClusterTest, countBaskets)
 
    delete file;
 }
+
+TEST(TTreeCluster, adaptiveBasketSize)
+{
+   TFile file("TTreeClusterTestAdaptive.root", "RECREATE");
+   auto tree = new TTree("tree", "A tree whose branches change density");
+   tree->SetAutoFlush(1000);
+   tree->SetTargetBasketsPerCluster(2);
+   EXPECT_EQ(2, tree->GetTargetBasketsPerCluster());
+
+   Double_t x = 0;
+   std::vector<Double_t> v;
+   auto bx = tree->Branch("x", &x);
+   auto bv = tree->Branch("v", &v);
+
+   // "v" is sparse for the first five clusters and dense for the last five.
+   for (Int_t ev = 0; ev < 10000; ev++) {
+      x = ev;
+      v.assign(ev < 5000 ? 1 : 50, ev);
+      tree->Fill();
+      if (ev == 4999)
+         // 1000 entries of ~8 bytes: about 4 kB per basket for two baskets per cluster.
+         EXPECT_LT(bv->GetBasketSize(), 16000);
+   }
+   tree->FlushBaskets();
+
+   // 1000 entries of 50 doubles: the baskets of "v" must have grown to ~200 kB.
+   EXPECT_GT(bv->GetBasketSize(), 100000);
+   EXPECT_LT(bx->GetBasketSize(), 16000);
+
+   auto stats = tree->GetBasketStats();
+   EXPECT_EQ(10, stats.fNClusters);
+   EXPECT_GT(stats.fNResizes, 0);
+   EXPECT_EQ(bv->GetBasketSize(), stats.fMaxBasketSize);
+   EXPECT_LE(stats.fBasketsPerCluster, 4.);
+   file.Close();
+   gSystem->Unlink("TTreeClusterTestAdaptive.root");
+}
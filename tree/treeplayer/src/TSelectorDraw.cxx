@@ -1360,10 +1360,7 @@ void TSelectorDraw::TakeAction()
    //__________________________1-D histogram_______________________
    if (fAction ==  1)((TH1*)fObject)->FillN(fNfill, fVal[0], fW);
    //__________________________2-D histogram_______________________
-   else if (fAction ==  2) {
-      TH2 *h2 = (TH2*)fObject;
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
-   }
+   else if (fAction ==  2)((TH2*)fObject)->FillN(fNfill, fVal[1], fVal[0], fW);
    //__________________________Profile histogram_______________________
    else if (fAction ==  4)((TProfile*)fObject)->FillN(fNfill, fVal[1], fVal[0], fW);
    //__________________________Event List______________________________
@@ -1417,9 +1414,7 @@ void TSelectorDraw::TakeAction()
    //__________________________3D scatter plot_______________________
    else if (fAction ==  3) {
       TH3 *h3 = (TH3*)fObject;
-      if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
-      }
+      if (!h3->TestBit(kCanDelete)) h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
    } else if (fAction == 13) {
       TPolyMarker3D *pm3d = new TPolyMarker3D(fNfill);
       pm3d->SetMarkerStyle(fTree->GetMarkerStyle());
@@ -1430,9 +1425,7 @@ void TSelectorDraw::TakeAction()
       }
       pm3d->Draw();
       TH3 *h3 = (TH3*)fObject;
-      if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
-      }
+      if (!h3->TestBit(kCanDelete)) h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
    }
    //__________________________3D scatter plot (3rd variable = col)__
    else if (fAction == 33) {
@@ -1475,7 +1468,7 @@ void TSelectorDraw::TakeAction()
    //__________________________2D Profile Histogram__________________
    else if (fAction == 23) {
       TProfile2D *hp2 = (TProfile2D*)fObject;
-      for (i = 0; i < fNfill; i++) hp2->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+      hp2->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
    }
    //__________________________4D scatter plot_______________________
    else if (fAction ==  40) {
@@ -1580,7 +1573,7 @@ void TSelectorDraw::TakeEstimate()
          }
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h2, fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+      h2->FillN(fNfill, fVal[1], fVal[0], fW);
    //__________________________Profile histogram_______________________
    } else if (fAction ==  4) {
       TProfile *hp = (TProfile*)fObject;
@@ -1723,7 +1716,7 @@ void TSelectorDraw::TakeEstimate()
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h3, fVmin[2], fVmax[2], fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
       if (fAction == 3) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
          return;
       }
       if (!strstr(fOption.Data(), "same") && !strstr(fOption.Data(), "goff")) {
@@ -1756,9 +1749,7 @@ void TSelectorDraw::TakeEstimate()
          pm3d->SetPoint(i, fVal[2][i], fVal[1][i], fVal[0][i]);
       }
       if (!fDraw && !strstr(fOption.Data(), "goff")) pm3d->Draw();
-      if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
-      }
+      if (!h3->TestBit(kCanDelete)) h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
 
    //__________________________2D Profile Histogram__________________
    } else if (fAction == 23) {
@@ -1774,7 +1765,7 @@ void TSelectorDraw::TakeEstimate()
          }
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(hp, fVmin[2], fVmax[2], fVmin[1], fVmax[1]);
       }
-      for (i = 0; i < fNfill; i++) hp->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+      hp->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
    //__________________________4D scatter plot_______________________
    } else if (fAction == 40) {
       TH3 *h3 = (TH3*)fObject;